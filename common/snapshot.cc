@@ -961,18 +961,27 @@ absl::Status Snapshot::MemoryBytes::CanConstruct(Address start_address,
 
 Snapshot::MemoryBytes::MemoryBytes(Address start_address,
                                    const ByteData& byte_values)
-    : start_address_(start_address), byte_values_(byte_values) {
-  DCHECK_STATUS(CanConstruct(start_address_, byte_values_));
+    : start_address_(start_address),
+      byte_values_(std::make_shared<ByteData>(byte_values)) {
+  DCHECK_STATUS(CanConstruct(start_address_, *byte_values_));
 }
 
 Snapshot::MemoryBytes::MemoryBytes(Address start_address,
                                    ByteData&& byte_values)
-    : start_address_(start_address), byte_values_(std::move(byte_values)) {
-  DCHECK_STATUS(CanConstruct(start_address_, byte_values_));
+    : start_address_(start_address),
+      byte_values_(std::make_shared<ByteData>(std::move(byte_values))) {
+  DCHECK_STATUS(CanConstruct(start_address_, *byte_values_));
+}
+
+// static
+const Snapshot::ByteData& Snapshot::MemoryBytes::EmptyByteData() {
+  static const ByteData* const empty = new ByteData();
+  return *empty;
 }
 
 bool Snapshot::MemoryBytes::operator==(const MemoryBytes& y) const {
-  return start_address_ == y.start_address_ && byte_values_ == y.byte_values_;
+  return start_address_ == y.start_address_ &&
+         (byte_values_ == y.byte_values_ || byte_values() == y.byte_values());
 }
 
 bool Snapshot::MemoryBytes::operator<(const MemoryBytes& y) const {
@@ -982,17 +991,27 @@ bool Snapshot::MemoryBytes::operator<(const MemoryBytes& y) const {
 }
 
 void Snapshot::MemoryBytes::append_bytes(ByteDataView bytes) {
-  byte_values_.append(bytes);
-  DCHECK_STATUS(CanConstruct(start_address_, byte_values_));
+  if (byte_values_ == nullptr || byte_values_.use_count() > 1) {
+    // Copy on write.
+    auto byte_values = std::make_shared<ByteData>();
+    byte_values->reserve(num_bytes() + bytes.size());
+    byte_values->append(this->byte_values());
+    byte_values_ = std::move(byte_values);
+  }
+  byte_values_->append(bytes);
+  DCHECK_STATUS(CanConstruct(start_address_, *byte_values_));
 }
 
 Snapshot::MemoryBytes Snapshot::MemoryBytes::Range(Address start,
-                                                   Address limit) {
+                                                   Address limit) const {
   CHECK_GE(start, start_address_);
   CHECK_LE(limit, limit_address());
+  if (start == start_address_ && limit == limit_address()) {
+    return *this;
+  }
   const size_t offset = start - start_address_;
   const size_t length = limit - start;
-  return MemoryBytes(start, byte_values_.substr(offset, length));
+  return MemoryBytes(start, byte_values().substr(offset, length));
 }
 
 std::string Snapshot::MemoryBytes::DebugString() const {
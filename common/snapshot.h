@@ -608,6 +608,10 @@ class Snapshot::TraceData {
 // ========================================================================= //
 
 // Describes a single contiguous range of byte values in memory.
+//
+// The byte values are immutable and shared by all copies of a MemoryBytes,
+// so copying one, and hence copying a Snapshot, does not copy the bytes.
+// append_bytes() copies them first if they are shared.
 class Snapshot::MemoryBytes final {
  public:
   // Returns iff constructing MemoryBytes from these is valid:
@@ -619,7 +623,7 @@ class Snapshot::MemoryBytes final {
   MemoryBytes(Address start_address, const ByteData& byte_values);
   MemoryBytes(Address start_address, ByteData&& byte_values);
 
-  // Intentionally movable and copyable.
+  // Intentionally movable and copyable. Copies share the byte values.
 
   bool operator==(const MemoryBytes& y) const;
   bool operator!=(const MemoryBytes& y) const { return !(*this == y); }
@@ -628,16 +632,19 @@ class Snapshot::MemoryBytes final {
   // Where byte_values() start and end:
   // [start_address, limit_address) address range.
   Address start_address() const { return start_address_; }
-  Address limit_address() const { return start_address_ + byte_values_.size(); }
+  Address limit_address() const { return start_address_ + num_bytes(); }
 
   // The bytes to exist in the [start_address, limit_address) address range.
-  const ByteData& byte_values() const { return byte_values_; }
+  const ByteData& byte_values() const {
+    return byte_values_ != nullptr ? *byte_values_ : EmptyByteData();
+  }
   void append_bytes(ByteDataView bytes);
-  ByteSize num_bytes() const { return byte_values_.size(); }
+  ByteSize num_bytes() const { return byte_values().size(); }
 
   // Returns a new MemoryBytes in of contents in range [start, limit).
+  // The result shares the byte values if the range covers all of this.
   // REQUIRES: [start, limit) must be within this.
-  MemoryBytes Range(Address start, Address limit);
+  MemoryBytes Range(Address start, Address limit) const;
 
   // For logging.
   std::string DebugString() const;
@@ -646,8 +653,11 @@ class Snapshot::MemoryBytes final {
   // See start_address().
   Address start_address_;
 
-  // See byte_values().
-  ByteData byte_values_;
+  // Returns the byte values of a moved-from MemoryBytes.
+  static const ByteData& EmptyByteData();
+
+  // See byte_values(). Only modified in place if not shared.
+  std::shared_ptr<ByteData> byte_values_;
 };
 
 // ========================================================================= //
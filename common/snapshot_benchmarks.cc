@@ -0,0 +1,72 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "./common/memory_mapping.h"
+#include "./common/memory_perms.h"
+#include "./common/snapshot.h"
+#include "./common/snapshot_test_enum.h"
+#include "./common/snapshot_test_util.h"
+#include "./util/arch.h"
+#include "./util/checks.h"
+
+namespace silifuzz {
+namespace {
+
+// Returns a test snapshot with `num_pages` extra pages of data.
+Snapshot MakeSnapshot(size_t num_pages) {
+  Snapshot snapshot = CreateTestSnapshot<Host>(TestSnapshot::kEndsAsExpected);
+  const Snapshot::Address start = 0x10000000;
+  const size_t page_size = snapshot.page_size();
+  const MemoryMapping mapping = MemoryMapping::MakeSized(
+      start, num_pages * page_size, MemoryPerms::RW());
+  CHECK_STATUS(snapshot.can_add_memory_mapping(mapping));
+  snapshot.add_memory_mapping(mapping);
+  for (size_t i = 0; i < num_pages; ++i) {
+    Snapshot::MemoryBytes bytes(start + i * page_size,
+                                Snapshot::ByteData(page_size, i % 256));
+    CHECK_STATUS(snapshot.can_add_memory_bytes(bytes));
+    snapshot.add_memory_bytes(std::move(bytes));
+  }
+  return snapshot;
+}
+
+void BM_SnapshotCopy(benchmark::State& state) {
+  const Snapshot snapshot = MakeSnapshot(state.range(0));
+  for (auto s : state) {
+    Snapshot copy = snapshot.Copy();
+    benchmark::DoNotOptimize(copy);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Copies a snapshot and modifies one MemoryBytes, which copies its bytes.
+void BM_SnapshotCopyAndAppend(benchmark::State& state) {
+  const Snapshot snapshot = MakeSnapshot(state.range(0));
+  for (auto s : state) {
+    Snapshot::MemoryBytesList memory_bytes = snapshot.Copy().memory_bytes();
+    memory_bytes.back().append_bytes("x");
+    benchmark::DoNotOptimize(memory_bytes);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_SnapshotCopy)->RangeMultiplier(8)->Range(1, 4096);
+BENCHMARK(BM_SnapshotCopyAndAppend)->RangeMultiplier(8)->Range(1, 4096);
+
+}  // namespace
+}  // namespace silifuzz
@@ -0,0 +1,409 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./common/snapshot_container.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "./common/snapshot.h"
+#include "./common/snapshot_proto.h"
+#include "./proto/snapshot.pb.h"
+#include "./util/checks.h"
+#include "./util/math.h"
+#include "./util/mmapped_memory_ptr.h"
+#include "./util/owned_file_descriptor.h"
+#include "./util/page_util.h"
+
+namespace silifuzz {
+
+namespace {
+
+template <typename T>
+absl::string_view AsStringView(const T* data, size_t count) {
+  return absl::string_view(reinterpret_cast<const char*>(data),
+                           count * sizeof(T));
+}
+
+// Reads exactly `size` bytes at `offset` of `fd` into `data`.
+absl::Status ReadAt(int fd, uint64_t offset, size_t size, void* data) {
+  char* dst = reinterpret_cast<char*>(data);
+  while (size > 0) {
+    ssize_t n = pread(fd, dst, size, offset);
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0) return absl::ErrnoToStatus(errno, "pread");
+    if (n == 0) return absl::DataLossError("container is truncated");
+    dst += n;
+    offset += n;
+    size -= n;
+  }
+  return absl::OkStatus();
+}
+
+// Checks the footer against a file of `file_size` bytes.
+absl::Status CheckFooter(const SnapshotContainerFooter& footer,
+                         uint64_t file_size) {
+  if (footer.magic != kSnapshotContainerMagic) {
+    return absl::DataLossError("bad footer magic, was the container finished?");
+  }
+  const uint64_t tables_size =
+      footer.num_snapshots * sizeof(SnapshotContainerIndexEntry) +
+      footer.num_memory_bytes * sizeof(SnapshotContainerBytesEntry) +
+      footer.ids_size;
+  if (footer.index_offset < sizeof(SnapshotContainerHeader) ||
+      footer.index_offset > file_size ||
+      footer.index_offset % alignof(SnapshotContainerIndexEntry) != 0 ||
+      footer.num_snapshots > file_size || footer.num_memory_bytes > file_size ||
+      footer.ids_size > file_size ||
+      footer.index_offset + tables_size + sizeof(footer) != file_size) {
+    return absl::DataLossError("corrupt footer");
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+// ========================================================================= //
+
+SnapshotContainerWriter::SnapshotContainerWriter(std::string path,
+                                                 OwnedFileDescriptor fd,
+                                                 uint64_t offset)
+    : path_(std::move(path)), fd_(std::move(fd)), offset_(offset) {}
+
+// static
+absl::StatusOr<SnapshotContainerWriter> SnapshotContainerWriter::Create(
+    absl::string_view path) {
+  std::string path_str(path);
+  OwnedFileDescriptor fd(
+      open(path_str.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+  if (fd.borrow() < 0) {
+    return absl::ErrnoToStatus(errno, absl::StrCat("open ", path));
+  }
+  SnapshotContainerWriter writer(std::move(path_str), std::move(fd), 0);
+  const SnapshotContainerHeader header = {
+      .magic = kSnapshotContainerMagic,
+      .version = kSnapshotContainerVersion,
+      .reserved = 0,
+  };
+  RETURN_IF_NOT_OK(writer.Write(AsStringView(&header, 1)));
+  return writer;
+}
+
+// static
+absl::StatusOr<SnapshotContainerWriter> SnapshotContainerWriter::Append(
+    absl::string_view path) {
+  std::string path_str(path);
+  OwnedFileDescriptor fd(open(path_str.c_str(), O_RDWR | O_CLOEXEC));
+  if (fd.borrow() < 0) {
+    return absl::ErrnoToStatus(errno, absl::StrCat("open ", path));
+  }
+  struct stat st;
+  if (fstat(fd.borrow(), &st) != 0) {
+    return absl::ErrnoToStatus(errno, absl::StrCat("fstat ", path));
+  }
+  const uint64_t file_size = st.st_size;
+  SnapshotContainerHeader header;
+  SnapshotContainerFooter footer;
+  if (file_size < sizeof(header) + sizeof(footer)) {
+    return absl::DataLossError(absl::StrCat(path, " is truncated"));
+  }
+  RETURN_IF_NOT_OK(ReadAt(fd.borrow(), 0, sizeof(header), &header));
+  if (header.magic != kSnapshotContainerMagic ||
+      header.version != kSnapshotContainerVersion) {
+    return absl::FailedPreconditionError(
+        absl::StrCat(path, " is not a snapshot container of version ",
+                     kSnapshotContainerVersion));
+  }
+  RETURN_IF_NOT_OK(ReadAt(fd.borrow(), file_size - sizeof(footer),
+                          sizeof(footer), &footer));
+  RETURN_IF_NOT_OK_PLUS(CheckFooter(footer, file_size),
+                        absl::StrCat(path, ": "));
+
+  SnapshotContainerWriter writer(std::move(path_str), std::move(fd),
+                                 footer.index_offset);
+  writer.index_.resize(footer.num_snapshots);
+  writer.memory_bytes_.resize(footer.num_memory_bytes);
+  writer.ids_.resize(footer.ids_size);
+  uint64_t offset = footer.index_offset;
+  const size_t index_size =
+      writer.index_.size() * sizeof(SnapshotContainerIndexEntry);
+  RETURN_IF_NOT_OK(ReadAt(writer.fd_.borrow(), offset, index_size,
+                          writer.index_.data()));
+  offset += index_size;
+  const size_t memory_bytes_size =
+      writer.memory_bytes_.size() * sizeof(SnapshotContainerBytesEntry);
+  RETURN_IF_NOT_OK(ReadAt(writer.fd_.borrow(), offset, memory_bytes_size,
+                          writer.memory_bytes_.data()));
+  offset += memory_bytes_size;
+  RETURN_IF_NOT_OK(
+      ReadAt(writer.fd_.borrow(), offset, footer.ids_size, writer.ids_.data()));
+
+  for (size_t i = 0; i < writer.index_.size(); ++i) {
+    const SnapshotContainerIndexEntry& entry = writer.index_[i];
+    if (entry.id_offset > writer.ids_.size() ||
+        entry.id_size > writer.ids_.size() - entry.id_offset) {
+      return absl::DataLossError(absl::StrCat(path, ": corrupt index"));
+    }
+    writer.id_map_.emplace(writer.ids_.substr(entry.id_offset, entry.id_size),
+                           i);
+  }
+  return writer;
+}
+
+absl::Status SnapshotContainerWriter::Write(absl::string_view data) {
+  while (!data.empty()) {
+    ssize_t n = pwrite(fd_.borrow(), data.data(), data.size(), offset_);
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0) {
+      return absl::ErrnoToStatus(errno, absl::StrCat("write ", path_));
+    }
+    data.remove_prefix(n);
+    offset_ += n;
+  }
+  return absl::OkStatus();
+}
+
+absl::Status SnapshotContainerWriter::Add(const Snapshot& snapshot) {
+  if (fd_.borrow() < 0) {
+    return absl::FailedPreconditionError("container is already finished");
+  }
+  RETURN_IF_NOT_OK(snapshot.IsCompleteSomeState());
+  if (id_map_.contains(snapshot.id())) {
+    return absl::AlreadyExistsError(
+        absl::StrCat("snapshot ", snapshot.id(), " is already in ", path_));
+  }
+
+  // Byte values are page-aligned in the file so that they can be mapped.
+  // Skipping to the next page leaves a hole rather than writing padding.
+  SnapshotContainerIndexEntry entry = {
+      .first_memory_bytes = memory_bytes_.size(),
+      .num_memory_bytes = snapshot.memory_bytes().size(),
+      .id_offset = ids_.size(),
+      .id_size = snapshot.id().size(),
+  };
+  for (const Snapshot::MemoryBytes& bytes : snapshot.memory_bytes()) {
+    offset_ = RoundUpToPageAlignment(offset_);
+    memory_bytes_.push_back({
+        .start_address = bytes.start_address(),
+        .offset = offset_,
+        .size = bytes.num_bytes(),
+    });
+    RETURN_IF_NOT_OK(Write(bytes.byte_values()));
+  }
+
+  proto::Snapshot proto;
+  SnapshotProto::ToProtoWithoutMemoryBytes(snapshot, &proto);
+  const std::string record = proto.SerializeAsString();
+  entry.record_offset = offset_;
+  entry.record_size = record.size();
+  RETURN_IF_NOT_OK(Write(record));
+
+  id_map_.emplace(snapshot.id(), index_.size());
+  ids_.append(snapshot.id());
+  index_.push_back(entry);
+  return absl::OkStatus();
+}
+
+absl::Status SnapshotContainerWriter::Finish() {
+  if (fd_.borrow() < 0) {
+    return absl::FailedPreconditionError("container is already finished");
+  }
+  offset_ = RoundUpToPowerOfTwo(offset_, alignof(SnapshotContainerIndexEntry));
+  const SnapshotContainerFooter footer = {
+      .index_offset = offset_,
+      .num_snapshots = index_.size(),
+      .num_memory_bytes = memory_bytes_.size(),
+      .ids_size = ids_.size(),
+      .magic = kSnapshotContainerMagic,
+  };
+  RETURN_IF_NOT_OK(Write(AsStringView(index_.data(), index_.size())));
+  RETURN_IF_NOT_OK(
+      Write(AsStringView(memory_bytes_.data(), memory_bytes_.size())));
+  RETURN_IF_NOT_OK(Write(ids_));
+  RETURN_IF_NOT_OK(Write(AsStringView(&footer, 1)));
+
+  // After Append() the old index may extend past the new end of the file.
+  if (ftruncate(fd_.borrow(), offset_) != 0) {
+    return absl::ErrnoToStatus(errno, absl::StrCat("ftruncate ", path_));
+  }
+  fd_ = OwnedFileDescriptor();
+  return absl::OkStatus();
+}
+
+// ========================================================================= //
+
+SnapshotContainerReader::SnapshotContainerReader(
+    MmappedMemoryPtr<const char> data)
+    : data_(std::move(data)) {}
+
+// static
+absl::StatusOr<SnapshotContainerReader> SnapshotContainerReader::Open(
+    absl::string_view path) {
+  const std::string path_str(path);
+  OwnedFileDescriptor fd(open(path_str.c_str(), O_RDONLY | O_CLOEXEC));
+  if (fd.borrow() < 0) {
+    return absl::ErrnoToStatus(errno, absl::StrCat("open ", path));
+  }
+  struct stat st;
+  if (fstat(fd.borrow(), &st) != 0) {
+    return absl::ErrnoToStatus(errno, absl::StrCat("fstat ", path));
+  }
+  const size_t file_size = st.st_size;
+  if (file_size <
+      sizeof(SnapshotContainerHeader) + sizeof(SnapshotContainerFooter)) {
+    return absl::DataLossError(absl::StrCat(path, " is truncated"));
+  }
+  void* ptr = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd.borrow(), 0);
+  if (ptr == MAP_FAILED) {
+    return absl::ErrnoToStatus(errno, absl::StrCat("mmap ", path));
+  }
+  SnapshotContainerReader reader(
+      MakeMmappedMemoryPtr(reinterpret_cast<const char*>(ptr), file_size));
+  const char* base = reader.data_.get();
+
+  SnapshotContainerHeader header;
+  memcpy(&header, base, sizeof(header));
+  if (header.magic != kSnapshotContainerMagic ||
+      header.version != kSnapshotContainerVersion) {
+    return absl::FailedPreconditionError(
+        absl::StrCat(path, " is not a snapshot container of version ",
+                     kSnapshotContainerVersion));
+  }
+  SnapshotContainerFooter footer;
+  memcpy(&footer, base + file_size - sizeof(footer), sizeof(footer));
+  RETURN_IF_NOT_OK_PLUS(CheckFooter(footer, file_size),
+                        absl::StrCat(path, ": "));
+
+  // The tables are aligned in the file and the mapping is page-aligned, so
+  // they can be used in place.
+  const char* tables = base + footer.index_offset;
+  reader.index_ =
+      reinterpret_cast<const SnapshotContainerIndexEntry*>(tables);
+  reader.num_snapshots_ = footer.num_snapshots;
+  tables += footer.num_snapshots * sizeof(SnapshotContainerIndexEntry);
+  reader.memory_bytes_ =
+      reinterpret_cast<const SnapshotContainerBytesEntry*>(tables);
+  reader.num_memory_bytes_ = footer.num_memory_bytes;
+  tables += footer.num_memory_bytes * sizeof(SnapshotContainerBytesEntry);
+  reader.ids_ = tables;
+
+  reader.id_map_.reserve(reader.num_snapshots_);
+  for (size_t i = 0; i < reader.num_snapshots_; ++i) {
+    const SnapshotContainerIndexEntry& entry = reader.index_[i];
+    if (entry.id_offset > footer.ids_size ||
+        entry.id_size > footer.ids_size - entry.id_offset ||
+        !reader.InFile(entry.record_offset, entry.record_size) ||
+        entry.first_memory_bytes > reader.num_memory_bytes_ ||
+        entry.num_memory_bytes >
+            reader.num_memory_bytes_ - entry.first_memory_bytes) {
+      return absl::DataLossError(
+          absl::StrCat(path, ": corrupt index entry ", i));
+    }
+    if (!reader.id_map_.emplace(reader.id(i), i).second) {
+      return absl::DataLossError(
+          absl::StrCat(path, ": duplicate snapshot ", reader.id(i)));
+    }
+  }
+  for (size_t i = 0; i < reader.num_memory_bytes_; ++i) {
+    const SnapshotContainerBytesEntry& entry = reader.memory_bytes_[i];
+    if (!reader.InFile(entry.offset, entry.size)) {
+      return absl::DataLossError(
+          absl::StrCat(path, ": corrupt MemoryBytes entry ", i));
+    }
+  }
+  return reader;
+}
+
+bool SnapshotContainerReader::InFile(uint64_t offset, uint64_t size) const {
+  const uint64_t file_size = MmappedMemorySize(data_);
+  return offset <= file_size && size <= file_size - offset;
+}
+
+absl::string_view SnapshotContainerReader::id(size_t i) const {
+  CHECK_LT(i, num_snapshots_);
+  return absl::string_view(ids_ + index_[i].id_offset, index_[i].id_size);
+}
+
+std::optional<size_t> SnapshotContainerReader::Find(
+    absl::string_view id) const {
+  auto it = id_map_.find(id);
+  if (it == id_map_.end()) return std::nullopt;
+  return it->second;
+}
+
+absl::StatusOr<Snapshot> SnapshotContainerReader::Read(size_t i) const {
+  CHECK_LT(i, num_snapshots_);
+  const SnapshotContainerIndexEntry& entry = index_[i];
+  proto::Snapshot proto;
+  if (!proto.ParseFromArray(data_.get() + entry.record_offset,
+                            entry.record_size)) {
+    return absl::DataLossError(
+        absl::StrCat("cannot parse snapshot ", id(i)));
+  }
+  if (proto.id() != id(i)) {
+    return absl::DataLossError(
+        absl::StrCat("snapshot ", id(i), " has id ", proto.id()));
+  }
+
+  // The byte values are copied once, straight from the mapping.
+  Snapshot::MemoryBytesList memory_bytes;
+  memory_bytes.reserve(entry.num_memory_bytes);
+  for (size_t j = 0; j < entry.num_memory_bytes; ++j) {
+    const SnapshotContainerBytesEntry& bytes =
+        memory_bytes_[entry.first_memory_bytes + j];
+    Snapshot::ByteData byte_values(data_.get() + bytes.offset, bytes.size);
+    RETURN_IF_NOT_OK(
+        Snapshot::MemoryBytes::CanConstruct(bytes.start_address, byte_values));
+    memory_bytes.emplace_back(bytes.start_address, std::move(byte_values));
+  }
+  return SnapshotProto::FromProto(proto, std::move(memory_bytes));
+}
+
+absl::StatusOr<Snapshot> SnapshotContainerReader::Read(
+    absl::string_view id) const {
+  std::optional<size_t> i = Find(id);
+  if (!i.has_value()) {
+    return absl::NotFoundError(absl::StrCat("snapshot ", id, " not found"));
+  }
+  return Read(*i);
+}
+
+absl::Status SnapshotContainerReader::ForEach(
+    absl::FunctionRef<absl::Status(Snapshot)> fn) const {
+  // Snapshots are laid out in index order, let the kernel read ahead.
+  madvise(const_cast<char*>(data_.get()), MmappedMemorySize(data_),
+          MADV_SEQUENTIAL);
+  for (size_t i = 0; i < num_snapshots_; ++i) {
+    ASSIGN_OR_RETURN_IF_NOT_OK(Snapshot snapshot, Read(i));
+    RETURN_IF_NOT_OK(fn(std::move(snapshot)));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace silifuzz
@@ -0,0 +1,212 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_SILIFUZZ_COMMON_SNAPSHOT_CONTAINER_H_
+#define THIRD_PARTY_SILIFUZZ_COMMON_SNAPSHOT_CONTAINER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "./common/snapshot.h"
+#include "./util/mmapped_memory_ptr.h"
+#include "./util/owned_file_descriptor.h"
+
+namespace silifuzz {
+
+// A snapshot container is a single append-only file holding many Snapshots.
+// It is meant for pipelines that handle too many snapshots for one
+// proto::Snapshot file per snapshot: the memory bytes, which are most of the
+// data, are stored raw and never go through protobuf.
+//
+// File layout, in native byte order:
+//
+//   SnapshotContainerHeader
+//   for each snapshot, in the order they were added:
+//     byte values of each MemoryBytes, each starting on a page boundary
+//     the rest of the snapshot as a proto::Snapshot without memory_bytes
+//   SnapshotContainerIndexEntry[num_snapshots]
+//   SnapshotContainerBytesEntry[num_memory_bytes]
+//   snapshot ids, concatenated
+//   SnapshotContainerFooter
+//
+// The reader maps the whole file, so byte values are read straight from the
+// page cache and the index is used in place.
+
+inline constexpr uint64_t kSnapshotContainerMagic = 0x4352'544e'4350'4e53;
+
+// Bump when the layout changes.
+inline constexpr uint32_t kSnapshotContainerVersion = 1;
+
+struct SnapshotContainerHeader {
+  // Must be kSnapshotContainerMagic.
+  uint64_t magic;
+
+  // Must be kSnapshotContainerVersion.
+  uint32_t version;
+
+  uint32_t reserved;
+};
+
+// Describes one snapshot.
+struct SnapshotContainerIndexEntry {
+  // File range of the proto::Snapshot record.
+  uint64_t record_offset;
+  uint64_t record_size;
+
+  // Range of the snapshot's MemoryBytes in the SnapshotContainerBytesEntry
+  // table.
+  uint64_t first_memory_bytes;
+  uint64_t num_memory_bytes;
+
+  // Range of the snapshot's id in the concatenated ids.
+  uint64_t id_offset;
+  uint64_t id_size;
+};
+
+// Describes one MemoryBytes.
+struct SnapshotContainerBytesEntry {
+  uint64_t start_address;
+
+  // File range of the byte values.
+  uint64_t offset;
+  uint64_t size;
+};
+
+struct SnapshotContainerFooter {
+  // File offset of the index. The tables and the ids follow it.
+  uint64_t index_offset;
+
+  uint64_t num_snapshots;
+  uint64_t num_memory_bytes;
+  uint64_t ids_size;
+
+  // Must be kSnapshotContainerMagic.
+  uint64_t magic;
+};
+
+// Writes a snapshot container.
+//
+// The index is only written by Finish(). Until then the file is not a valid
+// container.
+class SnapshotContainerWriter {
+ public:
+  // Creates a new container at `path`, replacing any existing file.
+  static absl::StatusOr<SnapshotContainerWriter> Create(absl::string_view path);
+
+  // Opens the existing container at `path` to add more snapshots to it.
+  // New snapshots overwrite the old index, so the file is not valid again until
+  // Finish() is called.
+  static absl::StatusOr<SnapshotContainerWriter> Append(absl::string_view path);
+
+  // Movable, but not copyable.
+  SnapshotContainerWriter(SnapshotContainerWriter&&) = default;
+  SnapshotContainerWriter& operator=(SnapshotContainerWriter&&) = default;
+  SnapshotContainerWriter(const SnapshotContainerWriter&) = delete;
+  SnapshotContainerWriter& operator=(const SnapshotContainerWriter&) = delete;
+
+  // Adds `snapshot` to the container.
+  // Fails if a snapshot with the same id was added before.
+  // REQUIRES: snapshot.IsCompleteSomeState()
+  absl::Status Add(const Snapshot& snapshot);
+
+  // Writes the index and closes the file. No snapshot can be added afterwards.
+  absl::Status Finish();
+
+  // Number of snapshots in the container, including ones added before Append().
+  size_t size() const { return index_.size(); }
+
+ private:
+  SnapshotContainerWriter(std::string path, OwnedFileDescriptor fd,
+                          uint64_t offset);
+
+  // Writes `data` at `offset_` and advances it.
+  absl::Status Write(absl::string_view data);
+
+  std::string path_;
+  OwnedFileDescriptor fd_;
+
+  // Where the next write goes.
+  uint64_t offset_;
+
+  std::vector<SnapshotContainerIndexEntry> index_;
+  std::vector<SnapshotContainerBytesEntry> memory_bytes_;
+  std::string ids_;
+
+  // Maps ids to positions in `index_`.
+  absl::flat_hash_map<std::string, size_t> id_map_;
+};
+
+// Reads a snapshot container.
+class SnapshotContainerReader {
+ public:
+  // Maps the container at `path` and validates its index. Snapshots are only
+  // validated when they are read.
+  static absl::StatusOr<SnapshotContainerReader> Open(absl::string_view path);
+
+  // Movable, but not copyable.
+  SnapshotContainerReader(SnapshotContainerReader&&) = default;
+  SnapshotContainerReader& operator=(SnapshotContainerReader&&) = default;
+  SnapshotContainerReader(const SnapshotContainerReader&) = delete;
+  SnapshotContainerReader& operator=(const SnapshotContainerReader&) = delete;
+
+  // Number of snapshots in the container.
+  size_t size() const { return num_snapshots_; }
+
+  // Returns the id of the i-th snapshot without reading the snapshot.
+  absl::string_view id(size_t i) const;
+
+  // Returns the position of the snapshot with `id`, if there is one.
+  std::optional<size_t> Find(absl::string_view id) const;
+
+  // Reads the i-th snapshot.
+  absl::StatusOr<Snapshot> Read(size_t i) const;
+
+  // Reads the snapshot with `id`.
+  absl::StatusOr<Snapshot> Read(absl::string_view id) const;
+
+  // Reads all snapshots in file order and passes each to `fn`.
+  // Stops at the first error, either from reading or returned by `fn`.
+  absl::Status ForEach(absl::FunctionRef<absl::Status(Snapshot)> fn) const;
+
+ private:
+  explicit SnapshotContainerReader(MmappedMemoryPtr<const char> data);
+
+  // Checks that the range [offset, offset + size) is within the file.
+  bool InFile(uint64_t offset, uint64_t size) const;
+
+  // The whole file, mapped read-only.
+  MmappedMemoryPtr<const char> data_;
+
+  // Tables of the footer index, pointing into `data_`.
+  const SnapshotContainerIndexEntry* index_ = nullptr;
+  const SnapshotContainerBytesEntry* memory_bytes_ = nullptr;
+  const char* ids_ = nullptr;
+  size_t num_snapshots_ = 0;
+  size_t num_memory_bytes_ = 0;
+
+  // Maps ids to positions in `index_`.
+  absl::flat_hash_map<absl::string_view, size_t> id_map_;
+};
+
+}  // namespace silifuzz
+
+#endif  // THIRD_PARTY_SILIFUZZ_COMMON_SNAPSHOT_CONTAINER_H_
@@ -0,0 +1,151 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./common/snapshot_container.h"
+
+#include <unistd.h>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "./common/snapshot.h"
+#include "./common/snapshot_test_enum.h"
+#include "./common/snapshot_test_util.h"
+#include "./util/arch.h"
+#include "./util/checks.h"
+#include "./util/file_util.h"
+#include "./util/page_util.h"
+#include "./util/path_util.h"
+#include "./util/testing/status_macros.h"
+
+namespace silifuzz {
+namespace {
+
+using ::testing::UnitTest;
+
+std::string TempContainerPath() {
+  absl::StatusOr<std::string> path = CreateTempFile(
+      UnitTest::GetInstance()->current_test_info()->name(), ".snapc");
+  CHECK_STATUS(path.status());
+  return *path;
+}
+
+std::vector<Snapshot> TestSnapshots() {
+  std::vector<Snapshot> snapshots;
+  for (TestSnapshot type :
+       {TestSnapshot::kEndsAsExpected, TestSnapshot::kRegsMismatch,
+        TestSnapshot::kMemoryMismatch}) {
+    snapshots.push_back(CreateTestSnapshot<Host>(type));
+  }
+  return snapshots;
+}
+
+TEST(SnapshotContainer, RoundTrip) {
+  const std::string path = TempContainerPath();
+  std::vector<Snapshot> snapshots = TestSnapshots();
+  {
+    ASSERT_OK_AND_ASSIGN(SnapshotContainerWriter writer,
+                         SnapshotContainerWriter::Create(path));
+    for (const Snapshot& snapshot : snapshots) {
+      ASSERT_OK(writer.Add(snapshot));
+    }
+    EXPECT_EQ(writer.Add(snapshots[0]).code(),
+              absl::StatusCode::kAlreadyExists);
+    EXPECT_EQ(writer.size(), snapshots.size());
+    ASSERT_OK(writer.Finish());
+  }
+
+  ASSERT_OK_AND_ASSIGN(SnapshotContainerReader reader,
+                       SnapshotContainerReader::Open(path));
+  ASSERT_EQ(reader.size(), snapshots.size());
+  for (size_t i = 0; i < snapshots.size(); ++i) {
+    EXPECT_EQ(reader.id(i), snapshots[i].id());
+    EXPECT_EQ(reader.Find(snapshots[i].id()), i);
+    ASSERT_OK_AND_ASSIGN(Snapshot read, reader.Read(i));
+    EXPECT_EQ(read, snapshots[i]);
+  }
+  EXPECT_EQ(reader.Find("no_such_snapshot"), std::nullopt);
+  EXPECT_EQ(reader.Read("no_such_snapshot").status().code(),
+            absl::StatusCode::kNotFound);
+
+  size_t i = 0;
+  ASSERT_OK(reader.ForEach([&](Snapshot snapshot) {
+    EXPECT_EQ(snapshot, snapshots[i++]);
+    return absl::OkStatus();
+  }));
+  EXPECT_EQ(i, snapshots.size());
+  unlink(path.c_str());
+}
+
+TEST(SnapshotContainer, Append) {
+  const std::string path = TempContainerPath();
+  std::vector<Snapshot> snapshots = TestSnapshots();
+  {
+    ASSERT_OK_AND_ASSIGN(SnapshotContainerWriter writer,
+                         SnapshotContainerWriter::Create(path));
+    ASSERT_OK(writer.Add(snapshots[0]));
+    ASSERT_OK(writer.Finish());
+  }
+  {
+    ASSERT_OK_AND_ASSIGN(SnapshotContainerWriter writer,
+                         SnapshotContainerWriter::Append(path));
+    EXPECT_EQ(writer.size(), 1);
+    EXPECT_EQ(writer.Add(snapshots[0]).code(),
+              absl::StatusCode::kAlreadyExists);
+    for (size_t i = 1; i < snapshots.size(); ++i) {
+      ASSERT_OK(writer.Add(snapshots[i]));
+    }
+    ASSERT_OK(writer.Finish());
+  }
+
+  ASSERT_OK_AND_ASSIGN(SnapshotContainerReader reader,
+                       SnapshotContainerReader::Open(path));
+  ASSERT_EQ(reader.size(), snapshots.size());
+  for (const Snapshot& snapshot : snapshots) {
+    ASSERT_OK_AND_ASSIGN(Snapshot read, reader.Read(snapshot.id()));
+    EXPECT_EQ(read, snapshot);
+  }
+  unlink(path.c_str());
+}
+
+TEST(SnapshotContainer, Unfinished) {
+  const std::string path = TempContainerPath();
+  {
+    ASSERT_OK_AND_ASSIGN(SnapshotContainerWriter writer,
+                         SnapshotContainerWriter::Create(path));
+    ASSERT_OK(writer.Add(TestSnapshots()[0]));
+  }
+  EXPECT_EQ(SnapshotContainerReader::Open(path).status().code(),
+            absl::StatusCode::kDataLoss);
+  unlink(path.c_str());
+}
+
+TEST(SnapshotContainer, NotAContainer) {
+  const std::string path = TempContainerPath();
+  ASSERT_TRUE(SetContents(path, std::string(kPageSize, 'x')));
+  EXPECT_EQ(SnapshotContainerReader::Open(path).status().code(),
+            absl::StatusCode::kFailedPrecondition);
+  EXPECT_EQ(SnapshotContainerWriter::Append(path).status().code(),
+            absl::StatusCode::kFailedPrecondition);
+  unlink(path.c_str());
+}
+
+}  // namespace
+}  // namespace silifuzz
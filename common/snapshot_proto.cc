@@ -254,6 +254,29 @@ absl::StatusOr<Snapshot::TraceData> SnapshotProto::FromProto(
 // static
 absl::StatusOr<Snapshot> SnapshotProto::FromProto(
     const proto::Snapshot& proto) {
+  MemoryBytesList memory_bytes;
+  memory_bytes.reserve(proto.memory_bytes_size());
+  for (const proto::MemoryBytes& p : proto.memory_bytes()) {
+    auto s = FromProto(p);
+    RETURN_IF_NOT_OK_PLUS(s.status(), "Bad MemoryBytes: ");
+    memory_bytes.push_back(std::move(s).value());
+  }
+  return FromProtoImpl(proto, std::move(memory_bytes));
+}
+
+// static
+absl::StatusOr<Snapshot> SnapshotProto::FromProto(
+    const proto::Snapshot& proto, MemoryBytesList memory_bytes) {
+  if (!proto.memory_bytes().empty()) {
+    return absl::InvalidArgumentError(
+        "MemoryBytes given both in the proto and separately");
+  }
+  return FromProtoImpl(proto, std::move(memory_bytes));
+}
+
+// static
+absl::StatusOr<Snapshot> SnapshotProto::FromProtoImpl(
+    const proto::Snapshot& proto, MemoryBytesList memory_bytes) {
   PROTO_MUST_HAVE_FIELD(proto, architecture);
   PROTO_MUST_HAVE_FIELD(proto, registers);
   const Id& id = proto.has_id() ? proto.id() : Snapshot::UnsetId();
@@ -277,12 +300,10 @@ absl::StatusOr<Snapshot> SnapshotProto::FromProto(
                           "Can't add negative MemoryMapping: ");
     snap.add_negative_memory_mapping(s.value());
   }
-  for (const proto::MemoryBytes& p : proto.memory_bytes()) {
-    auto s = FromProto(p);
-    RETURN_IF_NOT_OK_PLUS(s.status(), "Bad MemoryBytes: ");
-    RETURN_IF_NOT_OK_PLUS(snap.can_add_memory_bytes(s.value()),
+  for (MemoryBytes& b : memory_bytes) {
+    RETURN_IF_NOT_OK_PLUS(snap.can_add_memory_bytes(b),
                           "Can't add MemoryBytes: ");
-    snap.add_memory_bytes(std::move(s).value());
+    snap.add_memory_bytes(std::move(b));
   }
   {
     auto s = FromProto(proto.registers());
@@ -427,6 +448,15 @@ void SnapshotProto::ToProto(const TraceData& metadata,
 
 // static
 void SnapshotProto::ToProto(const Snapshot& snap, proto::Snapshot* proto) {
+  ToProtoWithoutMemoryBytes(snap, proto);
+  for (const MemoryBytes& s : snap.memory_bytes()) {
+    ToProto(s, proto->add_memory_bytes());
+  }
+}
+
+// static
+void SnapshotProto::ToProtoWithoutMemoryBytes(const Snapshot& snap,
+                                              proto::Snapshot* proto) {
   DCHECK_STATUS(snap.IsCompleteSomeState());
   proto->Clear();
   proto->set_architecture(
@@ -438,9 +468,6 @@ void SnapshotProto::ToProto(const Snapshot& snap, proto::Snapshot* proto) {
   for (const MemoryMapping& s : snap.negative_memory_mappings()) {
     ToProto(s, proto->add_negative_memory_mappings());
   }
-  for (const MemoryBytes& s : snap.memory_bytes()) {
-    ToProto(s, proto->add_memory_bytes());
-  }
   ToProto(snap.registers(), proto->mutable_registers());
   for (const EndState& s : snap.expected_end_states()) {
     ToProto(s, proto->add_expected_end_states());
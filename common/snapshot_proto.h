@@ -36,6 +36,12 @@ class SnapshotProto : private SnapshotTypeNames {
   // PROVIDES: Snapshot::IsCompleteSomeState() for the returned snapshot.
   static absl::StatusOr<Snapshot> FromProto(const proto::Snapshot& proto);
 
+  // Like the above but takes the memory bytes of the snapshot from
+  // `memory_bytes` instead of from proto.memory_bytes(), which must be empty.
+  // Used by readers that keep byte data outside of the proto.
+  static absl::StatusOr<Snapshot> FromProto(const proto::Snapshot& proto,
+                                            MemoryBytesList memory_bytes);
+
   // Returns true iff the given snapshot proto is valid
   // (a Snapshot can be made from it with FromProto()).
   // A convenience helper: is as expensive as FromProto().
@@ -50,6 +56,12 @@ class SnapshotProto : private SnapshotTypeNames {
   // REQUIRES: snap.IsCompleteSomeState()
   static void ToProto(const Snapshot& snap, proto::Snapshot* proto);
 
+  // Like ToProto() but leaves proto->memory_bytes() empty, for writers that
+  // store byte data outside of the proto.
+  // REQUIRES: snap.IsCompleteSomeState()
+  static void ToProtoWithoutMemoryBytes(const Snapshot& snap,
+                                        proto::Snapshot* proto);
+
   // Like the above but for EndState submessage. Used by PlayerResultProto.
   static absl::StatusOr<EndState> FromProto(const proto::EndState& proto);
   static void ToProto(const EndState& snap, proto::EndState* proto);
@@ -74,6 +86,12 @@ class SnapshotProto : private SnapshotTypeNames {
   static void ToProto(const Metadata& metadata, proto::SnapshotMetadata* proto);
   static void ToProto(const TraceData& metadata,
                       proto::SnapshotTraceData* proto);
+
+ private:
+  // Implements FromProto() for a snapshot whose memory bytes are already
+  // converted. proto.memory_bytes() is ignored.
+  static absl::StatusOr<Snapshot> FromProtoImpl(const proto::Snapshot& proto,
+                                                MemoryBytesList memory_bytes);
 };
 
 }  // namespace silifuzz
@@ -397,6 +397,36 @@ TEST(MemoryBytes, Appending) {
   EXPECT_EQ(mb.byte_values(), "foobar");
 }
 
+TEST(MemoryBytes, CopiesShareBytes) {
+  Snapshot::MemoryBytes mb(42, "foo");
+  Snapshot::MemoryBytes copy = mb;
+  EXPECT_EQ(&copy.byte_values(), &mb.byte_values());
+  EXPECT_EQ(&mb.Range(42, 45).byte_values(), &mb.byte_values());
+
+  // Appending to a copy leaves the original alone.
+  copy.append_bytes("bar");
+  EXPECT_EQ(copy.byte_values(), "foobar");
+  EXPECT_EQ(mb.byte_values(), "foo");
+  EXPECT_NE(copy, mb);
+
+  // Appending to unshared bytes does not copy them again.
+  const Snapshot::ByteData* byte_values = &copy.byte_values();
+  copy.append_bytes("baz");
+  EXPECT_EQ(&copy.byte_values(), byte_values);
+  EXPECT_EQ(copy.byte_values(), "foobarbaz");
+}
+
+TEST(MemoryBytes, SnapshotCopySharesBytes) {
+  Snapshot snapshot = CreateTestSnapshot<Host>(TestSnapshot::kEndsAsExpected);
+  Snapshot copy = snapshot.Copy();
+  ASSERT_EQ(copy.memory_bytes().size(), snapshot.memory_bytes().size());
+  for (size_t i = 0; i < snapshot.memory_bytes().size(); ++i) {
+    EXPECT_EQ(&copy.memory_bytes()[i].byte_values(),
+              &snapshot.memory_bytes()[i].byte_values());
+  }
+  EXPECT_EQ(copy, snapshot);
+}
+
 TEST(MemoryBytesDeathTest, FailsToExtendPastkMaxAddr) {
   Snapshot::MemoryBytes mb(Snapshot::kMaxAddress - 5, "foo");
   EXPECT_DEBUG_DEATH(mb.append_bytes("bar"), "");
@@ -0,0 +1,293 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./fuzzer/hashtest/corpus_cache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/casts.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "third_party/cityhash/city.h"
+#include "./fuzzer/hashtest/candidate.h"
+#include "./fuzzer/hashtest/hashtest_runner.h"
+#include "./fuzzer/hashtest/instruction_pool.h"
+#include "./fuzzer/hashtest/synthesize_test.h"
+#include "./fuzzer/hashtest/version.h"
+#include "./util/file_util.h"
+#include "./util/owned_file_descriptor.h"
+#include "./util/page_util.h"
+
+extern "C" {
+#include "third_party/libxed/xed-interface.h"
+}
+
+namespace silifuzz {
+
+namespace {
+
+void AddCandidates(const std::vector<InstructionCandidate>& candidates,
+                   std::vector<uint64_t>& words) {
+  words.push_back(candidates.size());
+  for (const InstructionCandidate& candidate : candidates) {
+    words.push_back(xed_inst_iform_enum(candidate.instruction));
+    words.push_back(candidate.vector_width);
+    words.push_back(candidate.width_16 | candidate.width_32 << 1 |
+                    candidate.width_64 << 2 | candidate.writemask << 3);
+  }
+}
+
+uint64_t Checksum(const uint8_t* begin, const uint8_t* end) {
+  return CityHash64(reinterpret_cast<const char*>(begin), end - begin);
+}
+
+}  // namespace
+
+uint64_t CorpusCacheKey(xed_chip_enum_t chip,
+                        const SynthesisConfig& synthesis_config,
+                        absl::Span<const Test> tests,
+                        const TestConfig& test_config, uint32_t mxcsr,
+                        absl::Span<const Input> inputs) {
+  std::vector<uint64_t> words = {
+      kCorpusCacheVersion,
+      kHashTestVersionMajor,
+      kHashTestVersionMinor,
+      kHashTestVersionPatch,
+      static_cast<uint64_t>(chip),
+      absl::bit_cast<uint32_t>(synthesis_config.flag_capture_rate),
+      synthesis_config.mask_trap_flag,
+      absl::bit_cast<uint32_t>(synthesis_config.min_duplication_rate),
+      absl::bit_cast<uint32_t>(synthesis_config.max_duplication_rate),
+      static_cast<uint64_t>(synthesis_config.branch_test_bits),
+      test_config.vector_width,
+      test_config.num_iterations,
+      test_config.in_register_hash,
+      mxcsr,
+  };
+
+  const InstructionPool& ipool = *synthesis_config.ipool;
+  AddCandidates(ipool.no_effect, words);
+  AddCandidates(ipool.flag_manipulation, words);
+  AddCandidates(ipool.compare, words);
+  AddCandidates(ipool.greg, words);
+  AddCandidates(ipool.vreg, words);
+  AddCandidates(ipool.mreg, words);
+  AddCandidates(ipool.mmxreg, words);
+
+  words.push_back(tests.size());
+  for (const Test& test : tests) {
+    words.push_back(test.seed);
+  }
+
+  // The input seed names the input, but hash the actual entropy so that the
+  // key does not depend on how the entropy is derived from the seed.
+  words.push_back(inputs.size());
+  for (const Input& input : inputs) {
+    words.push_back(input.seed);
+    words.push_back(
+        CityHash64(reinterpret_cast<const char*>(input.entropy.bytes),
+                   sizeof(input.entropy.bytes)));
+  }
+
+  return CityHash64(reinterpret_cast<const char*>(words.data()),
+                    words.size() * sizeof(words[0]));
+}
+
+std::string CorpusCachePath(const std::string& dir, uint64_t key) {
+  return absl::StrCat(dir, "/hashtest_corpus_", FormatSeed(key), ".cache");
+}
+
+absl::Status WriteCorpusCache(const std::string& path, uint64_t key,
+                              const Corpus& corpus, size_t num_inputs,
+                              absl::Span<const EndState> end_states) {
+  const size_t num_tests = corpus.tests.size();
+  if (end_states.size() != num_tests * num_inputs) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("expected ", num_tests * num_inputs, " end states, got ",
+                     end_states.size()));
+  }
+
+  // The code of the tests is packed end to end within each partition but
+  // there are gaps between partitions. The size of a test is not recorded, so
+  // bound each test by the start of the next one and by kMaxTestBytes and
+  // compact the code while copying it.
+  const uint8_t* mapping_begin =
+      reinterpret_cast<const uint8_t*>(corpus.mapping.Ptr());
+  const uint8_t* mapping_end = mapping_begin + corpus.mapping.AllocatedSize();
+  std::vector<const uint8_t*> starts;
+  starts.reserve(num_tests);
+  for (const Test& test : corpus.tests) {
+    starts.push_back(reinterpret_cast<const uint8_t*>(test.code));
+  }
+  std::sort(starts.begin(), starts.end());
+
+  std::vector<CorpusCacheTest> cache_tests(num_tests);
+  std::string code;
+  for (size_t i = 0; i < num_tests; ++i) {
+    const uint8_t* start =
+        reinterpret_cast<const uint8_t*>(corpus.tests[i].code);
+    if (start < mapping_begin || start >= mapping_end) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("test ", i, " is outside of the corpus mapping"));
+    }
+    auto next = std::upper_bound(starts.begin(), starts.end(), start);
+    const uint8_t* end =
+        std::min(next != starts.end() ? *next : mapping_end,
+                 std::min(start + kMaxTestBytes, mapping_end));
+    cache_tests[i] = {.seed = corpus.tests[i].seed, .code_offset = code.size()};
+    code.append(reinterpret_cast<const char*>(start), end - start);
+  }
+
+  CorpusCacheHeader header = {
+      .magic = kCorpusCacheMagic,
+      .version = kCorpusCacheVersion,
+      .reserved = 0,
+      .key = key,
+      .num_tests = num_tests,
+      .num_inputs = num_inputs,
+  };
+  header.tests_offset = sizeof(header);
+  header.end_states_offset =
+      header.tests_offset + num_tests * sizeof(CorpusCacheTest);
+  header.code_offset = RoundUpToPageAlignment(
+      header.end_states_offset + end_states.size() * sizeof(EndState));
+  header.code_size = code.size();
+  header.file_size = header.code_offset + header.code_size;
+
+  std::string contents(header.file_size, '\0');
+  uint8_t* base = reinterpret_cast<uint8_t*>(contents.data());
+  memcpy(base + header.tests_offset, cache_tests.data(),
+         num_tests * sizeof(CorpusCacheTest));
+  memcpy(base + header.end_states_offset, end_states.data(),
+         end_states.size() * sizeof(EndState));
+  memcpy(base + header.code_offset, code.data(), code.size());
+  header.checksum = Checksum(base + sizeof(header), base + header.file_size);
+  memcpy(base, &header, sizeof(header));
+
+  // Write under a unique name and rename into place so that other runners
+  // sharing the cache directory either see the complete file or nothing.
+  const std::string tmp_path = absl::StrCat(path, ".tmp.", getpid());
+  if (!SetContents(tmp_path, contents)) {
+    unlink(tmp_path.c_str());
+    return absl::InternalError(absl::StrCat("failed to write ", tmp_path));
+  }
+  if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+    const int rename_errno = errno;
+    unlink(tmp_path.c_str());
+    return absl::ErrnoToStatus(rename_errno,
+                               absl::StrCat("rename to ", path, " failed"));
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<CachedCorpus> LoadCorpusCache(const std::string& path,
+                                             uint64_t key, size_t num_tests,
+                                             size_t num_inputs) {
+  OwnedFileDescriptor fd(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+  if (fd.borrow() < 0) {
+    return absl::ErrnoToStatus(errno, absl::StrCat("open ", path));
+  }
+  struct stat st;
+  if (fstat(fd.borrow(), &st) != 0) {
+    return absl::ErrnoToStatus(errno, absl::StrCat("fstat ", path));
+  }
+  const size_t file_size = st.st_size;
+  if (file_size < sizeof(CorpusCacheHeader)) {
+    return absl::DataLossError(absl::StrCat(path, " is truncated"));
+  }
+
+  void* ptr = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd.borrow(), 0);
+  if (ptr == MAP_FAILED) {
+    return absl::ErrnoToStatus(errno, absl::StrCat("mmap ", path));
+  }
+  // Takes ownership of the mapping, it is released on every error path.
+  CorpusMemoryMapping mapping(ptr, file_size, 0);
+  const uint8_t* base = reinterpret_cast<const uint8_t*>(ptr);
+
+  CorpusCacheHeader header;
+  memcpy(&header, base, sizeof(header));
+  if (header.magic != kCorpusCacheMagic ||
+      header.version != kCorpusCacheVersion) {
+    return absl::FailedPreconditionError(
+        absl::StrCat(path, " is not a corpus cache of version ",
+                     kCorpusCacheVersion));
+  }
+  if (header.key != key || header.num_tests != num_tests ||
+      header.num_inputs != num_inputs) {
+    return absl::FailedPreconditionError(
+        absl::StrCat(path, " was generated with a different configuration"));
+  }
+  const size_t end_states_size = num_tests * num_inputs * sizeof(EndState);
+  if (header.file_size != file_size ||
+      header.tests_offset != sizeof(header) ||
+      header.end_states_offset !=
+          header.tests_offset + num_tests * sizeof(CorpusCacheTest) ||
+      header.code_offset !=
+          RoundUpToPageAlignment(header.end_states_offset + end_states_size) ||
+      header.code_offset + header.code_size != file_size) {
+    return absl::DataLossError(absl::StrCat(path, " has a corrupt layout"));
+  }
+  if (header.checksum != Checksum(base + sizeof(header), base + file_size)) {
+    return absl::DataLossError(absl::StrCat(path, " has a bad checksum"));
+  }
+
+  const CorpusCacheTest* cache_tests =
+      reinterpret_cast<const CorpusCacheTest*>(base + header.tests_offset);
+  uint8_t* code = reinterpret_cast<uint8_t*>(ptr) + header.code_offset;
+  std::vector<Test> tests(num_tests);
+  for (size_t i = 0; i < num_tests; ++i) {
+    if (cache_tests[i].code_offset >= header.code_size) {
+      return absl::DataLossError(
+          absl::StrCat(path, ": test ", i, " is outside of the code"));
+    }
+    tests[i] = {.seed = cache_tests[i].seed,
+                .code = code + cache_tests[i].code_offset};
+  }
+
+  if (header.code_size > 0 &&
+      mprotect(code, RoundUpToPageAlignment(header.code_size),
+               PROT_READ | PROT_EXEC) != 0) {
+    return absl::ErrnoToStatus(errno, absl::StrCat("mprotect code of ", path));
+  }
+  mapping.SetUsedSize(header.code_size);
+
+  const EndState* end_states =
+      reinterpret_cast<const EndState*>(base + header.end_states_offset);
+  return CachedCorpus{
+      .corpus =
+          Corpus{
+              .tests = std::move(tests),
+              .mapping = std::move(mapping),
+          },
+      .end_states = absl::MakeConstSpan(end_states, num_tests * num_inputs),
+  };
+}
+
+}  // namespace silifuzz
@@ -0,0 +1,126 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_SILIFUZZ_FUZZER_HASHTEST_CORPUS_CACHE_H_
+#define THIRD_PARTY_SILIFUZZ_FUZZER_HASHTEST_CORPUS_CACHE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "./fuzzer/hashtest/hashtest_runner.h"
+#include "./fuzzer/hashtest/synthesize_test.h"
+
+extern "C" {
+#include "third_party/libxed/xed-interface.h"
+}
+
+namespace silifuzz {
+
+// A corpus cache file holds a synthesized corpus together with its reconciled
+// end states so that later runs can skip both SynthesizeTests() and
+// DetermineEndStates() and go straight to RunTests().
+//
+// File layout, in native byte order (the cache is only meant to be reused on
+// the machine that wrote it):
+//
+//   CorpusCacheHeader
+//   CorpusCacheTest[num_tests]
+//   EndState[num_tests * num_inputs]
+//   <padding to a page boundary>
+//   packed test code (code_size bytes)
+//
+// The whole file is mapped read-only and the code pages are then made
+// executable, so the test table, the end states and the code are all used in
+// place without copying.
+
+inline constexpr uint64_t kCorpusCacheMagic = 0x6568'6361'6374'6868;
+
+// Bump when the layout changes.
+inline constexpr uint32_t kCorpusCacheVersion = 1;
+
+struct CorpusCacheHeader {
+  // Must be kCorpusCacheMagic.
+  uint64_t magic;
+
+  // Must be kCorpusCacheVersion.
+  uint32_t version;
+
+  uint32_t reserved;
+
+  // CorpusCacheKey() of the configuration the corpus was generated with.
+  uint64_t key;
+
+  uint64_t num_tests;
+  uint64_t num_inputs;
+
+  // File offsets of the test table, the end states and the code.
+  uint64_t tests_offset;
+  uint64_t end_states_offset;
+  uint64_t code_offset;
+  uint64_t code_size;
+
+  // Total size of the file.
+  uint64_t file_size;
+
+  // CityHash64 of everything after the header.
+  uint64_t checksum;
+};
+
+// On-disk form of Test. The code pointer is replaced by an offset into the
+// code section.
+struct CorpusCacheTest {
+  uint64_t seed;
+  uint64_t code_offset;
+};
+
+// Returns a key identifying everything that determines the content of a cache
+// file: the hashtest version, the target chip, the synthesis configuration
+// (including the instructions in the pool), the test seeds, the configuration
+// the end states were computed with and the inputs.
+uint64_t CorpusCacheKey(xed_chip_enum_t chip,
+                        const SynthesisConfig& synthesis_config,
+                        absl::Span<const Test> tests,
+                        const TestConfig& test_config, uint32_t mxcsr,
+                        absl::Span<const Input> inputs);
+
+// Returns the name of the cache file for `key` inside `dir`.
+std::string CorpusCachePath(const std::string& dir, uint64_t key);
+
+// Writes `corpus` and its `end_states` to `path`. The file is written under a
+// temporary name and renamed into place so concurrent readers never see a
+// partially written file.
+absl::Status WriteCorpusCache(const std::string& path, uint64_t key,
+                              const Corpus& corpus, size_t num_inputs,
+                              absl::Span<const EndState> end_states);
+
+// A corpus loaded from a cache file. The end states live in the same mapping
+// as the test code and are valid as long as `corpus` is.
+struct CachedCorpus {
+  Corpus corpus;
+  absl::Span<const EndState> end_states;
+};
+
+// Maps the cache file at `path` and validates it against `key`,
+// `num_tests` and `num_inputs`. Returns NotFoundError if there is no such file
+// and another error if the file exists but cannot be used.
+absl::StatusOr<CachedCorpus> LoadCorpusCache(const std::string& path,
+                                             uint64_t key, size_t num_tests,
+                                             size_t num_inputs);
+
+}  // namespace silifuzz
+
+#endif  // THIRD_PARTY_SILIFUZZ_FUZZER_HASHTEST_CORPUS_CACHE_H_
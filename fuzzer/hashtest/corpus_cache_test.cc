@@ -0,0 +1,221 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./fuzzer/hashtest/corpus_cache.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "./fuzzer/hashtest/hashtest_runner.h"
+#include "./fuzzer/hashtest/instruction_pool.h"
+#include "./fuzzer/hashtest/mxcsr.h"
+#include "./fuzzer/hashtest/synthesize_base.h"
+#include "./fuzzer/hashtest/synthesize_test.h"
+#include "./instruction/xed_util.h"
+#include "./util/platform.h"
+#include "./util/testing/status_matchers.h"
+
+namespace silifuzz {
+
+namespace {
+
+using silifuzz::testing::StatusIs;
+using ::testing::TempDir;
+
+class CorpusCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    InitXedIfNeeded();
+    chip_ = PlatformIdToChip(CurrentPlatformId());
+    if (chip_ == XED_CHIP_INVALID) {
+      GTEST_SKIP() << "Unsupported chip.";
+    }
+    Rng rng(0);
+    GenerateInstructionPool(rng, chip_, ipool_, false);
+    synthesis_config_ = {.ipool = &ipool_};
+    test_config_ = {
+        .vector_width = ChipVectorRegisterWidth(chip_),
+        .num_iterations = 1,
+    };
+    inputs_.resize(2);
+    for (Input& input : inputs_) {
+      input.seed = GetSeed(rng);
+      RandomizeEntropyBuffer(input.seed, input.entropy);
+    }
+  }
+
+  // Synthesizes a corpus of `num_tests` tests in two partitions, like the
+  // runner does with two workers.
+  Corpus MakeCorpus(uint64_t seed, size_t num_tests) {
+    Rng rng(seed);
+    Corpus corpus = AllocateCorpus(rng, num_tests);
+    const size_t first = num_tests / 2;
+    uint8_t* code = reinterpret_cast<uint8_t*>(corpus.mapping.Ptr());
+    size_t used = SynthesizeTests(absl::MakeSpan(corpus.tests).first(first),
+                                  code, chip_, synthesis_config_);
+    used += SynthesizeTests(absl::MakeSpan(corpus.tests).subspan(first),
+                            code + first * kMaxTestBytes, chip_,
+                            synthesis_config_);
+    FinalizeCorpus(corpus, used);
+    return corpus;
+  }
+
+  std::vector<EndState> EndStates(const Corpus& corpus) {
+    std::vector<EndState> end_states(corpus.tests.size() * inputs_.size());
+    ComputeEndStates(corpus.tests, test_config_, inputs_,
+                     absl::MakeSpan(end_states));
+    return end_states;
+  }
+
+  uint64_t Key(const Corpus& corpus) {
+    return CorpusCacheKey(chip_, synthesis_config_, corpus.tests, test_config_,
+                          kMXCSRMaskAll, inputs_);
+  }
+
+  xed_chip_enum_t chip_;
+  InstructionPool ipool_;
+  SynthesisConfig synthesis_config_;
+  TestConfig test_config_;
+  std::vector<Input> inputs_;
+};
+
+TEST_F(CorpusCacheTest, RoundTrip) {
+  Corpus corpus = MakeCorpus(1, 5);
+  std::vector<EndState> end_states = EndStates(corpus);
+  const uint64_t key = Key(corpus);
+  const std::string path = CorpusCachePath(TempDir(), key);
+  ASSERT_TRUE(
+      WriteCorpusCache(path, key, corpus, inputs_.size(), end_states).ok());
+
+  absl::StatusOr<CachedCorpus> cached =
+      LoadCorpusCache(path, key, corpus.tests.size(), inputs_.size());
+  ASSERT_TRUE(cached.ok()) << cached.status();
+  ASSERT_EQ(cached->corpus.tests.size(), corpus.tests.size());
+  for (size_t i = 0; i < corpus.tests.size(); ++i) {
+    EXPECT_EQ(cached->corpus.tests[i].seed, corpus.tests[i].seed);
+    EXPECT_NE(cached->corpus.tests[i].code, corpus.tests[i].code);
+  }
+  ASSERT_EQ(cached->end_states.size(), end_states.size());
+  for (size_t i = 0; i < end_states.size(); ++i) {
+    EXPECT_EQ(cached->end_states[i].hash, end_states[i].hash) << i;
+  }
+
+  // The cached code is executable and produces the cached end states.
+  std::vector<EndState> recomputed = EndStates(cached->corpus);
+  for (size_t i = 0; i < end_states.size(); ++i) {
+    EXPECT_EQ(recomputed[i].hash, end_states[i].hash) << i;
+  }
+  const RunConfig run_config = {
+      .test = test_config_,
+      .batch_size = 1,
+      .num_repeat = 1,
+  };
+  ThreadStats stats{};
+  ResultReporter result(absl::Now(), false);
+  RunTests(cached->corpus.tests, inputs_, cached->end_states, run_config, 0,
+           absl::Seconds(1), stats, result);
+  EXPECT_GT(stats.num_run, 0);
+  EXPECT_EQ(stats.num_failed, 0);
+}
+
+TEST_F(CorpusCacheTest, KeyDependsOnConfiguration) {
+  Corpus corpus = MakeCorpus(2, 2);
+  const uint64_t key = Key(corpus);
+  EXPECT_EQ(Key(corpus), key);
+
+  EXPECT_NE(Key(MakeCorpus(3, 2)), key);
+  EXPECT_NE(CorpusCacheKey(chip_, synthesis_config_, corpus.tests,
+                           test_config_, kMXCSRMaskAll | kMXCSRFlushToZero,
+                           inputs_),
+            key);
+
+  SynthesisConfig other_config = synthesis_config_;
+  other_config.branch_test_bits += 1;
+  EXPECT_NE(CorpusCacheKey(chip_, other_config, corpus.tests, test_config_,
+                           kMXCSRMaskAll, inputs_),
+            key);
+
+  InstructionPool smaller_pool = ipool_;
+  smaller_pool.greg.pop_back();
+  other_config = synthesis_config_;
+  other_config.ipool = &smaller_pool;
+  EXPECT_NE(CorpusCacheKey(chip_, other_config, corpus.tests, test_config_,
+                           kMXCSRMaskAll, inputs_),
+            key);
+
+  TestConfig other_test_config = test_config_;
+  other_test_config.num_iterations += 1;
+  EXPECT_NE(CorpusCacheKey(chip_, synthesis_config_, corpus.tests,
+                           other_test_config, kMXCSRMaskAll, inputs_),
+            key);
+
+  EXPECT_NE(CorpusCacheKey(chip_, synthesis_config_, corpus.tests,
+                           test_config_, kMXCSRMaskAll,
+                           absl::MakeConstSpan(inputs_).first(1)),
+            key);
+}
+
+TEST_F(CorpusCacheTest, Validation) {
+  Corpus corpus = MakeCorpus(4, 2);
+  std::vector<EndState> end_states = EndStates(corpus);
+  const uint64_t key = Key(corpus);
+  const std::string path =
+      absl::StrCat(TempDir(), "/CorpusCacheTest_Validation.cache");
+  unlink(path.c_str());
+
+  EXPECT_THAT(LoadCorpusCache(path, key, 2, inputs_.size()).status(),
+              StatusIs(absl::StatusCode::kNotFound));
+
+  ASSERT_TRUE(
+      WriteCorpusCache(path, key, corpus, inputs_.size(), end_states).ok());
+  EXPECT_TRUE(LoadCorpusCache(path, key, 2, inputs_.size()).ok());
+  EXPECT_THAT(LoadCorpusCache(path, key + 1, 2, inputs_.size()).status(),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+  EXPECT_THAT(LoadCorpusCache(path, key, 3, inputs_.size()).status(),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+
+  // Flip a bit in the last byte of the code.
+  int fd = open(path.c_str(), O_RDWR);
+  ASSERT_GE(fd, 0);
+  off_t size = lseek(fd, 0, SEEK_END);
+  uint8_t byte;
+  ASSERT_EQ(pread(fd, &byte, 1, size - 1), 1);
+  byte ^= 1;
+  ASSERT_EQ(pwrite(fd, &byte, 1, size - 1), 1);
+  close(fd);
+  EXPECT_THAT(LoadCorpusCache(path, key, 2, inputs_.size()).status(),
+              StatusIs(absl::StatusCode::kDataLoss));
+
+  // Truncated file.
+  ASSERT_EQ(truncate(path.c_str(), size - 1), 0);
+  EXPECT_THAT(LoadCorpusCache(path, key, 2, inputs_.size()).status(),
+              StatusIs(absl::StatusCode::kDataLoss));
+}
+
+}  // namespace
+
+}  // namespace silifuzz
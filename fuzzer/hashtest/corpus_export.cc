@@ -0,0 +1,290 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./fuzzer/hashtest/corpus_export.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "./common/snapshot.h"
+#include "./fuzzer/hashtest/parallel_worker_pool.h"
+#include "./fuzzer/hashtest/synthesize_base.h"
+#include "./fuzzer/hashtest/synthesize_snapshot.h"
+#include "./runner/snap_maker.h"
+#include "./snap/gen/relocatable_snap_generator.h"
+#include "./tool_libs/corpus_partitioner_lib.h"
+#include "./tool_libs/snap_group.h"
+#include "./util/arch.h"
+#include "./util/checks.h"
+#include "./util/file_util.h"
+#include "./util/itoa.h"
+#include "./util/mmapped_memory_ptr.h"
+
+namespace silifuzz {
+
+namespace {
+
+// Per-worker state. Each worker handles the tests whose index is congruent to
+// its own index modulo the number of workers.
+struct ExportWorker {
+  size_t index;
+  absl::Status status;
+  CorpusExportStats stats;
+  std::vector<Snapshot> exported;
+};
+
+SnapMaker::Options MakerOptions(const CorpusExportConfig& config, int cpu) {
+  SnapMaker::Options opts;
+  opts.runner_path = config.runner_path;
+  opts.cpu = cpu;
+  return opts;
+}
+
+// Records the end state of the made `snapshot` on `cpu`.
+absl::StatusOr<Snapshot> RecordOnCpu(const Snapshot& snapshot,
+                                     const CorpusExportConfig& config,
+                                     int cpu) {
+  SnapMaker maker(MakerOptions(config, cpu));
+  ASSIGN_OR_RETURN_IF_NOT_OK(Snapshot recorded,
+                             maker.RecordEndState(snapshot));
+  const Snapshot::Endpoint& ep = recorded.expected_end_states()[0].endpoint();
+  if (ep.type() != snapshot_types::Endpoint::kInstruction) {
+    return absl::InternalError(absl::StrCat("Cannot export ",
+                                            EnumStr(ep.sig_cause()), "/",
+                                            EnumStr(ep.sig_num())));
+  }
+  return recorded;
+}
+
+// Makes the code of one test and records the end state of every input.
+void ExportTest(const std::vector<Snapshot>& inputs,
+                const CorpusExportConfig& config, ExportWorker& worker) {
+  const size_t num_cpus = config.cpus.size();
+  const int cpus[] = {
+      config.cpus[worker.index],
+      config.cpus[(worker.index + 1) % num_cpus],
+      config.cpus[(worker.index + 2) % num_cpus],
+  };
+
+  // All inputs share the code, so the end point and the exit sequence only
+  // need to be found once.
+  SnapMaker maker(MakerOptions(config, cpus[0]));
+  absl::StatusOr<Snapshot> made = maker.Make(inputs[0]);
+  if (!made.ok()) {
+    VLOG_INFO(1, "Could not make ", inputs[0].id(), ": ",
+              made.status().message());
+    worker.stats.num_make_failed += inputs.size();
+    return;
+  }
+
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    Snapshot snapshot = made->Copy();
+    if (i > 0) {
+      if (!snapshot.can_set_registers(inputs[i].registers()).ok()) {
+        ++worker.stats.num_make_failed;
+        continue;
+      }
+      snapshot.set_registers(inputs[i].registers());
+      snapshot.set_id(inputs[i].id());
+    }
+
+    // Record on two CPUs and only go to a third one if they disagree.
+    std::vector<Snapshot> recorded;
+    std::vector<Snapshot::EndState> end_states;
+    for (int cpu : cpus) {
+      absl::StatusOr<Snapshot> result = RecordOnCpu(snapshot, config, cpu);
+      if (!result.ok()) {
+        VLOG_INFO(1, "Could not record ", snapshot.id(), " on CPU ", cpu, ": ",
+                  result.status().message());
+        continue;
+      }
+      end_states.push_back(result->expected_end_states()[0]);
+      recorded.push_back(*std::move(result));
+      if (end_states.size() == 2 && end_states[0].DataEquals(end_states[1])) {
+        break;
+      }
+    }
+    if (recorded.empty()) {
+      ++worker.stats.num_make_failed;
+      continue;
+    }
+    std::optional<size_t> picked = PickReconciledEndState(end_states);
+    if (!picked.has_value()) {
+      ++worker.stats.num_unreconciled;
+      continue;
+    }
+    worker.exported.push_back(std::move(recorded[*picked]));
+  }
+}
+
+// Partitions `snapshots` into `num_shards` groups without conflicting memory
+// mappings. Snapshots that do not fit are left in `snapshots`.
+std::vector<std::vector<Snapshot>> Partition(int num_shards,
+                                             int num_iterations,
+                                             std::vector<Snapshot>& snapshots) {
+  SnapshotGroup::SnapshotSummaryList ungrouped;
+  ungrouped.reserve(snapshots.size());
+  for (const Snapshot& snapshot : snapshots) {
+    ungrouped.emplace_back(snapshot);
+  }
+  SnapshotPartition partition =
+      PartitionCorpus(num_shards, num_iterations, ungrouped);
+
+  absl::flat_hash_map<Snapshot::Id, size_t> group_map;
+  for (size_t i = 0; i < partition.snapshot_groups().size(); ++i) {
+    for (const Snapshot::Id& id : partition.snapshot_groups()[i].id_list()) {
+      group_map[id] = i;
+    }
+  }
+
+  std::vector<std::vector<Snapshot>> shards(
+      partition.snapshot_groups().size());
+  std::vector<Snapshot> leftover;
+  for (Snapshot& snapshot : snapshots) {
+    auto it = group_map.find(snapshot.id());
+    if (it != group_map.end()) {
+      shards[it->second].push_back(std::move(snapshot));
+    } else {
+      leftover.push_back(std::move(snapshot));
+    }
+  }
+  snapshots.swap(leftover);
+  return shards;
+}
+
+}  // namespace
+
+double CorpusExportStats::SnapshotsPerSecond() const {
+  const double seconds =
+      absl::ToDoubleSeconds(synthesis_time + end_state_time + write_time);
+  return seconds > 0 ? num_exported / seconds : 0;
+}
+
+std::optional<size_t> PickReconciledEndState(
+    absl::Span<const Snapshot::EndState> end_states) {
+  for (size_t i = 0; i < end_states.size(); ++i) {
+    for (size_t j = i + 1; j < end_states.size(); ++j) {
+      if (end_states[i].DataEquals(end_states[j])) {
+        return i;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+absl::StatusOr<CorpusExportStats> ExportHashTestCorpus(
+    Rng& rng, const CorpusExportConfig& config,
+    const std::string& output_prefix) {
+  if (config.cpus.empty()) {
+    return absl::InvalidArgumentError("no CPUs to record end states on");
+  }
+  if (config.num_inputs == 0 || config.num_shards <= 0) {
+    return absl::InvalidArgumentError(
+        "num_inputs and num_shards must be positive");
+  }
+
+  CorpusExportStats stats;
+  absl::Time synthesis_begin = absl::Now();
+
+  // Derive a seed per test up front so the tests do not depend on how they
+  // are distributed over the workers.
+  std::vector<uint64_t> seeds(config.num_tests);
+  for (uint64_t& seed : seeds) {
+    seed = rng();
+  }
+
+  ParallelWorkerPool workers(config.cpus.size());
+  std::vector<ExportWorker> worker_state(workers.NumWorkers());
+  for (size_t i = 0; i < worker_state.size(); ++i) {
+    worker_state[i].index = i;
+  }
+
+  std::vector<std::vector<Snapshot>> tests(config.num_tests);
+  workers.DoWork(worker_state, [&](ExportWorker& worker) {
+    for (size_t t = worker.index; t < tests.size();
+         t += worker_state.size()) {
+      Rng test_rng(seeds[t]);
+      absl::StatusOr<std::vector<Snapshot>> snapshots = SynthesizeTestSnapshots(
+          test_rng, config.chip, config.synthesis_config, config.num_inputs);
+      if (!snapshots.ok()) {
+        worker.status = snapshots.status();
+        return;
+      }
+      tests[t] = *std::move(snapshots);
+    }
+  });
+  for (const ExportWorker& worker : worker_state) {
+    RETURN_IF_NOT_OK(worker.status);
+  }
+  stats.num_tests = tests.size();
+  stats.num_snapshots = tests.size() * config.num_inputs;
+
+  absl::Time end_state_begin = absl::Now();
+  stats.synthesis_time = end_state_begin - synthesis_begin;
+
+  workers.DoWork(worker_state, [&](ExportWorker& worker) {
+    for (size_t t = worker.index; t < tests.size();
+         t += worker_state.size()) {
+      ExportTest(tests[t], config, worker);
+      tests[t].clear();
+    }
+  });
+
+  std::vector<Snapshot> snapshots;
+  for (ExportWorker& worker : worker_state) {
+    stats.num_make_failed += worker.stats.num_make_failed;
+    stats.num_unreconciled += worker.stats.num_unreconciled;
+    for (Snapshot& snapshot : worker.exported) {
+      snapshots.push_back(std::move(snapshot));
+    }
+    worker.exported.clear();
+  }
+
+  absl::Time write_begin = absl::Now();
+  stats.end_state_time = write_begin - end_state_begin;
+
+  std::vector<std::vector<Snapshot>> shards = Partition(
+      config.num_shards, config.num_partitioning_iterations, snapshots);
+  stats.num_ungrouped = snapshots.size();
+  for (size_t i = 0; i < shards.size(); ++i) {
+    MmappedMemoryPtr<char> relocatable =
+        GenerateRelocatableSnaps(Host::architecture_id, shards[i]);
+    const std::string file_name =
+        absl::StrFormat("%s.%05d", output_prefix, i);
+    if (!SetContents(file_name,
+                     absl::string_view(relocatable.get(),
+                                       MmappedMemorySize(relocatable)))) {
+      return absl::InternalError(absl::StrCat("failed to write ", file_name));
+    }
+    stats.num_exported += shards[i].size();
+  }
+  stats.write_time = absl::Now() - write_begin;
+
+  return stats;
+}
+
+}  // namespace silifuzz
@@ -0,0 +1,112 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_SILIFUZZ_FUZZER_HASHTEST_CORPUS_EXPORT_H_
+#define THIRD_PARTY_SILIFUZZ_FUZZER_HASHTEST_CORPUS_EXPORT_H_
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "./common/snapshot.h"
+#include "./fuzzer/hashtest/synthesize_base.h"
+#include "./fuzzer/hashtest/synthesize_test.h"
+
+extern "C" {
+#include "third_party/libxed/xed-interface.h"
+}
+
+namespace silifuzz {
+
+// Configuration for exporting hashtests as relocatable Snap corpus shards that
+// can be run by the regular runner and orchestrator.
+struct CorpusExportConfig {
+  // The chip to generate tests for.
+  xed_chip_enum_t chip;
+
+  // Settings for test synthesis.
+  SynthesisConfig synthesis_config;
+
+  // Number of tests to synthesize.
+  size_t num_tests = 1000;
+
+  // Number of snapshots per test. Every input runs the code of the test from
+  // a different random initial register state.
+  size_t num_inputs = 1;
+
+  // Number of corpus shards to write.
+  int num_shards = 1;
+
+  // See PartitionCorpus().
+  int num_partitioning_iterations = 10;
+
+  // Location of the runner binary used to record end states.
+  std::string runner_path;
+
+  // CPUs to record end states on. One worker thread is used per CPU.
+  std::vector<int> cpus;
+};
+
+struct CorpusExportStats {
+  // Number of tests and snapshots synthesized.
+  size_t num_tests = 0;
+  size_t num_snapshots = 0;
+
+  // Snapshots dropped because they could not be made or recorded.
+  size_t num_make_failed = 0;
+
+  // Snapshots dropped because no two CPUs agreed on the end state.
+  size_t num_unreconciled = 0;
+
+  // Snapshots dropped because they did not fit into any shard.
+  size_t num_ungrouped = 0;
+
+  // Snapshots written to the shards.
+  size_t num_exported = 0;
+
+  absl::Duration synthesis_time = absl::ZeroDuration();
+  absl::Duration end_state_time = absl::ZeroDuration();
+  absl::Duration write_time = absl::ZeroDuration();
+
+  // Exported snapshots per second of wall time.
+  double SnapshotsPerSecond() const;
+};
+
+// Given end states of the same snapshot recorded on different CPUs, returns
+// the index of an end state that was recorded more than once, or nullopt if
+// all of them differ. This mirrors ReconcileEndStates() in the hashtest
+// runner: an SDC is unlikely to corrupt the same end state twice.
+std::optional<size_t> PickReconciledEndState(
+    absl::Span<const Snapshot::EndState> end_states);
+
+// Synthesizes config.num_tests x config.num_inputs snapshots, records their
+// end states redundantly on different CPUs and writes the snapshots whose end
+// states reconcile as config.num_shards relocatable corpus files named
+// <output_prefix>.00000, <output_prefix>.00001, ...
+//
+// The code of each test is made (end point and exit sequence fixed up) once
+// and shared by all of its inputs. Each input is then recorded on two CPUs
+// and, if those disagree, on a third one. Unlike MakeSnapshot() there is no
+// separate verification pass: the redundant recordings take its place.
+absl::StatusOr<CorpusExportStats> ExportHashTestCorpus(
+    Rng& rng, const CorpusExportConfig& config,
+    const std::string& output_prefix);
+
+}  // namespace silifuzz
+
+#endif  // THIRD_PARTY_SILIFUZZ_FUZZER_HASHTEST_CORPUS_EXPORT_H_
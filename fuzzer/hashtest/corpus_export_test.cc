@@ -0,0 +1,84 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./fuzzer/hashtest/corpus_export.h"
+
+#include <optional>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "./common/snapshot.h"
+#include "./fuzzer/hashtest/instruction_pool.h"
+#include "./fuzzer/hashtest/synthesize_base.h"
+#include "./fuzzer/hashtest/synthesize_snapshot.h"
+#include "./fuzzer/hashtest/synthesize_test.h"
+#include "./instruction/xed_util.h"
+#include "./util/platform.h"
+
+namespace silifuzz {
+
+namespace {
+
+Snapshot::EndState EndStateAt(Snapshot::Address address) {
+  return Snapshot::EndState(Snapshot::Endpoint(address));
+}
+
+TEST(CorpusExport, PickReconciledEndState) {
+  EXPECT_EQ(PickReconciledEndState({}), std::nullopt);
+  EXPECT_EQ(PickReconciledEndState({EndStateAt(0x1000)}), std::nullopt);
+  EXPECT_EQ(PickReconciledEndState({EndStateAt(0x1000), EndStateAt(0x1000)}),
+            0);
+  EXPECT_EQ(PickReconciledEndState({EndStateAt(0x1000), EndStateAt(0x2000)}),
+            std::nullopt);
+  EXPECT_EQ(PickReconciledEndState(
+                {EndStateAt(0x1000), EndStateAt(0x2000), EndStateAt(0x2000)}),
+            1);
+  EXPECT_EQ(PickReconciledEndState(
+                {EndStateAt(0x1000), EndStateAt(0x2000), EndStateAt(0x3000)}),
+            std::nullopt);
+}
+
+TEST(CorpusExport, SynthesizeTestSnapshots) {
+  InitXedIfNeeded();
+  xed_chip_enum_t chip = PlatformIdToChip(CurrentPlatformId());
+  if (chip == XED_CHIP_INVALID) {
+    GTEST_SKIP() << "Unsupported chip.";
+  }
+  Rng rng(0);
+  InstructionPool ipool{};
+  GenerateInstructionPool(rng, chip, ipool, false);
+  SynthesisConfig config = {
+      .ipool = &ipool,
+  };
+
+  absl::StatusOr<std::vector<Snapshot>> snapshots =
+      SynthesizeTestSnapshots(rng, chip, config, 3);
+  ASSERT_TRUE(snapshots.ok()) << snapshots.status();
+  ASSERT_EQ(snapshots->size(), 3);
+
+  // Same code, different inputs.
+  for (int i = 1; i < 3; ++i) {
+    const Snapshot& first = (*snapshots)[0];
+    const Snapshot& other = (*snapshots)[i];
+    EXPECT_NE(other.id(), first.id());
+    EXPECT_EQ(other.memory_mappings(), first.memory_mappings());
+    EXPECT_EQ(other.memory_bytes(), first.memory_bytes());
+    EXPECT_NE(other.registers(), first.registers());
+  }
+}
+
+}  // namespace
+
+}  // namespace silifuzz
@@ -26,15 +26,19 @@
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
 #include "./common/snapshot.h"
 #include "./common/snapshot_file_util.h"
 #include "./common/snapshot_printer.h"
+#include "./fuzzer/hashtest/corpus_export.h"
 #include "./fuzzer/hashtest/instruction_pool.h"
 #include "./fuzzer/hashtest/synthesize_base.h"
 #include "./fuzzer/hashtest/synthesize_snapshot.h"
 #include "./fuzzer/hashtest/synthesize_test.h"
 #include "./instruction/xed_util.h"
+#include "./runner/runner_provider.h"
 #include "./util/checks.h"
+#include "./util/cpu_id.h"
 #include "./util/enum_flag_types.h"
 #include "./util/itoa.h"
 #include "./util/line_printer.h"
@@ -53,6 +57,17 @@ ABSL_FLAG(size_t, n, 1, "Number of tests to generate.");
 ABSL_FLAG(std::string, outdir, "", "Output directory to write tests to.");
 ABSL_FLAG(std::optional<uint64_t>, seed, std::nullopt,
           "Fixed seed to use for random number generation.");
+ABSL_FLAG(std::string, corpus_prefix, "",
+          "If set, make the tests and write them as relocatable corpus shards "
+          "named <corpus_prefix>.00000, <corpus_prefix>.00001, ... instead of "
+          "individual snapshots.");
+ABSL_FLAG(size_t, inputs, 1,
+          "Number of snapshots per test when writing a corpus. Each one runs "
+          "the test from a different initial register state.");
+ABSL_FLAG(int, shards, 1, "Number of corpus shards to write.");
+ABSL_FLAG(size_t, j, 0,
+          "Maximum number of CPUs to record end states on when writing a "
+          "corpus. Uses all available CPUs by default.");
 
 namespace silifuzz {
 
@@ -97,6 +112,49 @@ absl::Status SynthesizeSnapshots(Rng& rng, xed_chip_enum_t chip,
   return absl::OkStatus();
 }
 
+absl::Status ExportCorpus(Rng& rng, xed_chip_enum_t chip,
+                          const InstructionPool& ipool) {
+  LinePrinter line_printer(LinePrinter::StdOutPrinter);
+
+  CorpusExportConfig config = {
+      .chip = chip,
+      .synthesis_config =
+          {
+              .ipool = &ipool,
+          },
+      .num_tests = absl::GetFlag(FLAGS_n),
+      .num_inputs = absl::GetFlag(FLAGS_inputs),
+      .num_shards = absl::GetFlag(FLAGS_shards),
+      .runner_path = RunnerLocation(),
+  };
+  ForEachAvailableCPU([&](int cpu) { config.cpus.push_back(cpu); });
+  size_t cpu_limit = absl::GetFlag(FLAGS_j);
+  if (cpu_limit > 0 && cpu_limit < config.cpus.size()) {
+    config.cpus.resize(cpu_limit);
+  }
+
+  const std::string corpus_prefix = absl::GetFlag(FLAGS_corpus_prefix);
+  ASSIGN_OR_RETURN_IF_NOT_OK(CorpusExportStats stats,
+                             ExportHashTestCorpus(rng, config, corpus_prefix));
+
+  line_printer.Line("Tests: ", stats.num_tests);
+  line_printer.Line("Snapshots: ", stats.num_snapshots);
+  line_printer.Line("Could not be made: ", stats.num_make_failed);
+  line_printer.Line("Unreconciled end states: ", stats.num_unreconciled);
+  line_printer.Line("Did not fit into a shard: ", stats.num_ungrouped);
+  line_printer.Line("Exported: ", stats.num_exported, " to ", config.num_shards,
+                    " shards at ", corpus_prefix);
+  line_printer.Line("Synthesis time: ",
+                    absl::FormatDuration(stats.synthesis_time));
+  line_printer.Line("End state time: ",
+                    absl::FormatDuration(stats.end_state_time), " on ",
+                    config.cpus.size(), " CPUs");
+  line_printer.Line("Write time: ", absl::FormatDuration(stats.write_time));
+  line_printer.Line("Throughput: ", stats.SnapshotsPerSecond(),
+                    " snapshots per second");
+  return absl::OkStatus();
+}
+
 int ToolMain(std::vector<char*> positional_args) {
   InitXedIfNeeded();
 
@@ -117,7 +175,11 @@ int ToolMain(std::vector<char*> positional_args) {
 
   InstructionPool ipool{};
   GenerateInstructionPool(rng, chip, ipool, verbose);
-  CHECK_STATUS(SynthesizeSnapshots(rng, chip, ipool));
+  if (!absl::GetFlag(FLAGS_corpus_prefix).empty()) {
+    CHECK_STATUS(ExportCorpus(rng, chip, ipool));
+  } else {
+    CHECK_STATUS(SynthesizeSnapshots(rng, chip, ipool));
+  }
 
   return 0;
 }
@@ -58,12 +58,30 @@ void RandomizeEntropyBuffer(uint64_t seed, EntropyBuffer& buffer) {
   std::generate(std::begin(buffer.bytes), std::end(buffer.bytes), engine);
 }
 
-MemoryMapping::~MemoryMapping() {
+CorpusMemoryMapping::~CorpusMemoryMapping() {
   if (ptr_ != nullptr) {
     CHECK_EQ(munmap(ptr_, allocated_size_), 0);
   }
 }
 
+CorpusMemoryMapping::CorpusMemoryMapping(CorpusMemoryMapping&& other)
+    : ptr_(std::exchange(other.ptr_, nullptr)),
+      allocated_size_(std::exchange(other.allocated_size_, 0)),
+      used_size_(std::exchange(other.used_size_, 0)) {}
+
+CorpusMemoryMapping& CorpusMemoryMapping::operator=(
+    CorpusMemoryMapping&& other) {
+  if (this != &other) {
+    if (ptr_ != nullptr) {
+      CHECK_EQ(munmap(ptr_, allocated_size_), 0);
+    }
+    ptr_ = std::exchange(other.ptr_, nullptr);
+    allocated_size_ = std::exchange(other.allocated_size_, 0);
+    used_size_ = std::exchange(other.used_size_, 0);
+  }
+  return *this;
+}
+
 void DumpTest(uint64_t start_address, InstructionBlock& body) {
   xed_decoded_inst_t xed_insn;
   char formatted_insn_buf[96];
@@ -124,7 +142,7 @@ Corpus AllocateCorpus(Rng& rng, size_t num_tests) {
 
   return Corpus{
       .tests = std::move(tests),
-      .mapping = MemoryMapping(ptr, mapping_size, 0),
+      .mapping = CorpusMemoryMapping(ptr, mapping_size, 0),
   };
 }
 
@@ -208,16 +226,91 @@ uint64_t EntropyBufferHash(const EntropyBuffer& buffer, size_t vector_width) {
                     buffer.NumBytes(vector_width));
 }
 
+namespace {
+
+// Constants shared with the DIGEST_* macros in hashtest_runner_widgits.S.
+constexpr uint64_t kDigestSeed = 0x9e3779b97f4a7c15;
+constexpr uint64_t kDigestMultiplier = 0x87c37b91114253d5;
+constexpr int kDigestLaneRotate = 17;
+constexpr int kDigestRotate = 23;
+
+uint64_t RotateLeft(uint64_t value, int amount) {
+  return (value << amount) | (value >> (64 - amount));
+}
+
+uint64_t DigestStep(uint64_t hash, uint64_t value) {
+  return (RotateLeft(hash, kDigestRotate) ^ value) * kDigestMultiplier;
+}
+
+}  // namespace
+
+uint64_t EntropyBufferDigest(const EntropyBuffer& buffer, size_t vector_width) {
+  const size_t num_lanes = vector_width / 64;
+  const size_t num_words = buffer.NumBytes(vector_width) / sizeof(uint64_t);
+  uint64_t words[kEntropyBytes512 / sizeof(uint64_t)];
+  memcpy(words, buffer.bytes, num_words * sizeof(uint64_t));
+
+  // Fold the vector registers together lane-wise. Each step is a bijection of
+  // the incoming register, so a corrupted register always changes the result.
+  uint64_t lanes[512 / 64];
+  for (size_t l = 0; l < num_lanes; ++l) {
+    lanes[l] = words[l];
+    for (size_t r = 1; r < kVecEntropyRegs; ++r) {
+      lanes[l] =
+          RotateLeft(lanes[l], kDigestLaneRotate) ^ words[r * num_lanes + l];
+    }
+  }
+
+  // Fold the lanes and the rest of the registers in memory order.
+  uint64_t hash = kDigestSeed;
+  for (size_t l = 0; l < num_lanes; ++l) {
+    hash = DigestStep(hash, lanes[l]);
+  }
+  for (size_t i = kVecEntropyRegs * num_lanes; i < num_words; ++i) {
+    hash = DigestStep(hash, words[i]);
+  }
+
+  // MurmurHash3 finalizer, so that every bit of the state affects every bit
+  // of the hash.
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccd;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+uint64_t RunHashTestAndHash(void* test, const TestConfig& config,
+                            const EntropyBuffer& input) {
+  if (!config.in_register_hash) {
+    EntropyBuffer output;
+    RunHashTest(test, config, input, output);
+    return EntropyBufferHash(output, config.vector_width);
+  }
+  uint64_t hash;
+  if (config.vector_width == 512) {
+    hash = RunHashTestDigest512(test, config.num_iterations, &input);
+  } else if (config.vector_width == 256) {
+    hash = RunHashTestDigest256(test, config.num_iterations, &input);
+  } else if (config.vector_width == 128) {
+    hash = RunHashTestDigest128(test, config.num_iterations, &input);
+  } else {
+    CHECK(false) << "Unsupported vector width: " << config.vector_width;
+  }
+#if defined(MEMORY_SANITIZER)
+  __msan_unpoison(&hash, sizeof(hash));
+#endif
+  return hash;
+}
+
 void ComputeEndStates(absl::Span<const Test> tests, const TestConfig& config,
                       absl::Span<const Input> inputs,
                       absl::Span<EndState> end_states) {
   CHECK_EQ(tests.size() * inputs.size(), end_states.size());
   for (size_t t = 0; t < tests.size(); ++t) {
     for (size_t i = 0; i < inputs.size(); i++) {
-      EntropyBuffer output;
-      RunHashTest(tests[t].code, config, inputs[i].entropy, output);
       end_states[t * inputs.size() + i].hash =
-          EntropyBufferHash(output, config.vector_width);
+          RunHashTestAndHash(tests[t].code, config, inputs[i].entropy);
     }
   }
 }
@@ -260,13 +353,12 @@ void RunTest(size_t test_index, const Test& test, const TestConfig& config,
              size_t input_index, const Input& input, const EndState& expected,
              ThreadStats& stats, ResultReporter& result) {
   // Run the test.
-  EntropyBuffer actual;
-  RunHashTest(test.code, config, input.entropy, actual);
+  uint64_t actual = RunHashTestAndHash(test.code, config, input.entropy);
   ++stats.num_run;
   ++stats.time_estimator.num_run;
 
   // Compare the end state.
-  bool ok = expected.hash == EntropyBufferHash(actual, config.vector_width);
+  bool ok = expected.hash == actual;
 
   if (!ok) {
     ++stats.num_failed;
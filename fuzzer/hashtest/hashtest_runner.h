@@ -104,20 +104,22 @@ struct Test {
   void* code;
 };
 
-class MemoryMapping {
+// Owns the executable memory of a Corpus.
+// Not named MemoryMapping to avoid clashing with common/memory_mapping.h.
+class CorpusMemoryMapping {
  public:
-  MemoryMapping(void* ptr, size_t allocated_size, size_t used_size)
+  CorpusMemoryMapping(void* ptr, size_t allocated_size, size_t used_size)
       : ptr_(ptr), allocated_size_(allocated_size), used_size_(used_size) {}
 
-  ~MemoryMapping();
+  ~CorpusMemoryMapping();
 
   // No copy.
-  MemoryMapping(const MemoryMapping&) = delete;
-  MemoryMapping& operator=(const MemoryMapping&) = delete;
+  CorpusMemoryMapping(const CorpusMemoryMapping&) = delete;
+  CorpusMemoryMapping& operator=(const CorpusMemoryMapping&) = delete;
 
-  // Move allowed.
-  MemoryMapping(const MemoryMapping&&) = default;
-  MemoryMapping& operator=(const MemoryMapping&&) = default;
+  // Move allowed. The moved-from mapping is left empty.
+  CorpusMemoryMapping(CorpusMemoryMapping&& other);
+  CorpusMemoryMapping& operator=(CorpusMemoryMapping&& other);
 
   void* Ptr() const { return ptr_; }
 
@@ -135,7 +137,7 @@ class MemoryMapping {
 // A collection of tests.
 struct Corpus {
   std::vector<Test> tests;
-  MemoryMapping mapping;
+  CorpusMemoryMapping mapping;
 
   size_t MemoryUse() {
     return sizeof(Corpus) + tests.size() * sizeof(Test) + mapping.UsedSize();
@@ -162,6 +164,12 @@ void FinalizeCorpus(Corpus& corpus, size_t used_size);
 struct TestConfig {
   size_t vector_width;
   size_t num_iterations;
+
+  // Hash the end state in registers at the end of the test rather than storing
+  // it to an EntropyBuffer and hashing the buffer. This avoids a round trip
+  // through memory for every test run. The two modes produce different hashes,
+  // so end states must be computed and checked in the same mode.
+  bool in_register_hash = false;
 };
 
 // The expected end state of a test + input.
@@ -351,6 +359,17 @@ void RunTests(absl::Span<const Test> tests, absl::Span<const Input> inputs,
 void RunHashTest(void* test, const TestConfig& config,
                  const EntropyBuffer& input, EntropyBuffer& output);
 
+// Run `test` with `input` and return the hash of the end state, computed as
+// specified by `config`.
+// Internal function, exported for testing and benchmarking.
+uint64_t RunHashTestAndHash(void* test, const TestConfig& config,
+                            const EntropyBuffer& input);
+
+// The hash computed in registers by the RunHashTestDigest* widgets, for an
+// end state that has been stored to `buffer`.
+// Internal function, exported for testing.
+uint64_t EntropyBufferDigest(const EntropyBuffer& buffer, size_t vector_width);
+
 }  // namespace silifuzz
 
 #endif  // THIRD_PARTY_SILIFUZZ_FUZZER_HASHTEST_HASHTEST_RUNNER_H_
@@ -0,0 +1,94 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/types/span.h"
+#include "./fuzzer/hashtest/hashtest_runner.h"
+#include "./fuzzer/hashtest/instruction_pool.h"
+#include "./fuzzer/hashtest/synthesize_base.h"
+#include "./fuzzer/hashtest/synthesize_test.h"
+#include "./instruction/xed_util.h"
+#include "./util/platform.h"
+
+namespace silifuzz {
+
+namespace {
+
+constexpr size_t kNumTests = 100;
+constexpr size_t kNumInputs = 10;
+
+// Runs a corpus of synthesized tests the same way RunTests() does, with the
+// end state hashed either in memory or in registers.
+// Reports tests run per second on a single core.
+// Arguments: in_register_hash, num_iterations.
+void BM_RunTest(benchmark::State& state) {
+  InitXedIfNeeded();
+  xed_chip_enum_t chip = PlatformIdToChip(CurrentPlatformId());
+  if (chip == XED_CHIP_INVALID) {
+    state.SkipWithError("Unsupported chip.");
+    return;
+  }
+
+  const TestConfig config = {
+      .vector_width = ChipVectorRegisterWidth(chip),
+      .num_iterations = static_cast<size_t>(state.range(1)),
+      .in_register_hash = state.range(0) != 0,
+  };
+
+  Rng rng(0);
+  InstructionPool ipool{};
+  GenerateInstructionPool(rng, chip, ipool, false);
+  SynthesisConfig synthesis_config = {
+      .ipool = &ipool,
+  };
+  Corpus corpus = AllocateCorpus(rng, kNumTests);
+  size_t used = SynthesizeTests(
+      absl::MakeSpan(corpus.tests),
+      reinterpret_cast<uint8_t*>(corpus.mapping.Ptr()), chip, synthesis_config);
+  FinalizeCorpus(corpus, used);
+
+  std::vector<Input> inputs(kNumInputs);
+  for (Input& input : inputs) {
+    input.seed = GetSeed(rng);
+    RandomizeEntropyBuffer(input.seed, input.entropy);
+  }
+  std::vector<EndState> end_states(kNumTests * kNumInputs);
+  ComputeEndStates(corpus.tests, config, inputs, absl::MakeSpan(end_states));
+
+  size_t num_failed = 0;
+  for (auto s : state) {
+    for (size_t i = 0; i < kNumInputs; ++i) {
+      for (size_t t = 0; t < kNumTests; ++t) {
+        uint64_t hash =
+            RunHashTestAndHash(corpus.tests[t].code, config, inputs[i].entropy);
+        num_failed += hash != end_states[t * kNumInputs + i].hash;
+      }
+    }
+  }
+  benchmark::DoNotOptimize(num_failed);
+  // items_per_second is the number of tests run per second.
+  state.SetItemsProcessed(state.iterations() * kNumTests * kNumInputs);
+}
+
+BENCHMARK(BM_RunTest)
+    ->ArgNames({"in_register_hash", "iterations"})
+    ->ArgsProduct({{0, 1}, {1, 10, 100}});
+
+}  // namespace
+
+}  // namespace silifuzz
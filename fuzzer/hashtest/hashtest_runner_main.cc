@@ -29,17 +29,24 @@
 
 #include "google/protobuf/timestamp.pb.h"
 #include "absl/container/btree_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
 #include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "./common/snapshot.h"
+#include "./common/snapshot_file_util.h"
 #include "./fuzzer/hashtest/candidate.h"
+#include "./fuzzer/hashtest/corpus_cache.h"
 #include "./fuzzer/hashtest/hashtest_result.pb.h"
 #include "./fuzzer/hashtest/hashtest_runner.h"
+#include "./fuzzer/hashtest/hit_minimizer.h"
 #include "./fuzzer/hashtest/instruction_pool.h"
 #include "./fuzzer/hashtest/json.h"
 #include "./fuzzer/hashtest/mxcsr.h"
@@ -68,6 +75,9 @@ ABSL_FLAG(size_t, repeat, 10,
           "Number of times to repeat each test+input combination.");
 ABSL_FLAG(size_t, iterations, 100,
           "Number of internal iterations for each test.");
+ABSL_FLAG(bool, in_register_hash, false,
+          "Hash the end state of each test in registers rather than storing "
+          "it to memory and hashing it there.");
 ABSL_FLAG(std::optional<uint64_t>, seed, std::nullopt,
           "Fixed seed to use for random number generation.");
 ABSL_FLAG(absl::Duration, corpus_time, absl::Seconds(10),
@@ -79,6 +89,16 @@ ABSL_FLAG(bool, print_proto, false,
           "Dump a binary proto to stdout rather than text. Intended for cases "
           "where a machine-readable result is needed.");
 ABSL_FLAG(bool, verbose, false, "Print additional debugging information.");
+ABSL_FLAG(std::string, corpus_cache_dir, "",
+          "If set, synthesized tests and their end states are stored in this "
+          "directory and reused by later runs with the same seed and "
+          "configuration.");
+ABSL_FLAG(std::string, minimize_dir, "",
+          "If set, minimize each test that hit after testing, on the CPU it "
+          "hit on, and write a reproducer snapshot to this directory.");
+ABSL_FLAG(size_t, minimize_attempts, 10000,
+          "Number of times to run each variant of a test while minimizing "
+          "before concluding it no longer fails.");
 
 namespace silifuzz {
 
@@ -234,6 +254,9 @@ struct CorpusConfig {
 
   // How the tests should be run.
   RunConfig run_config;
+
+  // Directory of the corpus cache. Empty if caching is disabled.
+  std::string corpus_cache_dir;
 };
 
 std::string TagsToName(const std::vector<std::string>& tags) {
@@ -252,6 +275,9 @@ struct CorpusStats {
   // Time consumed running the tests.
   absl::Duration test_time;
 
+  // The number of corpora loaded from the corpus cache.
+  size_t corpus_cache_hits;
+
   // The number of different tests that were run.
   size_t distinct_tests;
   // The number of times a test was run.
@@ -265,6 +291,7 @@ struct CorpusStats {
     code_gen_time += other.code_gen_time;
     end_state_gen_time += other.end_state_gen_time;
     test_time += other.test_time;
+    corpus_cache_hits += other.corpus_cache_hits;
     distinct_tests += other.distinct_tests;
     test_instance_run += other.test_instance_run;
     test_iteration_run += other.test_iteration_run;
@@ -273,6 +300,35 @@ struct CorpusStats {
   }
 };
 
+// Run a corpus whose tests and end states are ready.
+void RunCorpus(size_t test_index, ParallelWorkerPool& workers,
+               const CorpusConfig& corpus_config, const Corpus& corpus,
+               absl::Span<const EndState> end_states,
+               CorpusStats& corpus_stats, absl::Duration testing_time,
+               ResultReporter& result, bool printing_allowed) {
+  absl::Time test_begin = absl::Now();
+
+  // Run test corpus.
+  if (printing_allowed) {
+    std::cout << "Running tests" << std::endl;
+  }
+  std::vector<ThreadStats> stats(workers.NumWorkers());
+  workers.DoWork(stats, [&](ThreadStats& s) {
+    RunTests(corpus.tests, corpus_config.inputs, end_states,
+             corpus_config.run_config, test_index, testing_time, s, result);
+  });
+
+  // Aggregate thread stats.
+  for (const ThreadStats& s : stats) {
+    corpus_stats.test_instance_run += s.num_run;
+    corpus_stats.test_iteration_run +=
+        s.num_run * corpus_config.run_config.test.num_iterations;
+    corpus_stats.test_instance_hit += s.num_failed;
+  }
+  corpus_stats.test_time += absl::Now() - test_begin;
+  corpus_stats.distinct_tests += corpus.tests.size();
+}
+
 void RunTestCorpus(size_t test_index, Rng& test_rng,
                    ParallelWorkerPool& workers,
                    const CorpusConfig& corpus_config, CorpusStats& corpus_stats,
@@ -287,8 +343,45 @@ void RunTestCorpus(size_t test_index, Rng& test_rng,
   absl::Time corpus_begin = absl::Now();
 
   // Allocate the corpus.
+  // Always done, even if the corpus ends up being loaded from the cache, so
+  // that the test seeds consumed from `test_rng` do not depend on the cache.
+  // The pages of the unused mapping are never touched.
   Corpus corpus = AllocateCorpus(test_rng, corpus_config.num_tests);
 
+  uint64_t cache_key = 0;
+  std::string cache_path;
+  if (!corpus_config.corpus_cache_dir.empty()) {
+    cache_key = CorpusCacheKey(corpus_config.chip,
+                               corpus_config.synthesis_config, corpus.tests,
+                               corpus_config.run_config.test,
+                               corpus_config.run_config.mxcsr,
+                               corpus_config.inputs);
+    cache_path = CorpusCachePath(corpus_config.corpus_cache_dir, cache_key);
+    absl::StatusOr<CachedCorpus> cached =
+        LoadCorpusCache(cache_path, cache_key, corpus_config.num_tests,
+                        corpus_config.inputs.size());
+    if (cached.ok()) {
+      if (printing_allowed) {
+        std::cout << "Loaded corpus from " << cache_path << std::endl;
+      }
+      corpus = std::move(cached->corpus);
+      // Affects test running and needs to be set on each worker thread.
+      std::vector<uint32_t> mxcsr(workers.NumWorkers(),
+                                  corpus_config.run_config.mxcsr);
+      workers.DoWork(mxcsr, [](uint32_t value) { SetMxcsr(value); });
+      corpus_stats.corpus_cache_hits += 1;
+      absl::Time test_begin = absl::Now();
+      corpus_stats.code_gen_time += test_begin - corpus_begin;
+      RunCorpus(test_index, workers, corpus_config, corpus, cached->end_states,
+                corpus_stats, run_time - (test_begin - corpus_begin), result,
+                printing_allowed);
+      return;
+    }
+    if (printing_allowed && !absl::IsNotFound(cached.status())) {
+      std::cout << "Ignoring corpus cache: " << cached.status() << std::endl;
+    }
+  }
+
   // Generate the tests in parallel.
   // TODO(ncbray): generate tests redundantly to catch SDCs?
   struct SynthesizeTestsTask {
@@ -356,35 +449,28 @@ void RunTestCorpus(size_t test_index, Rng& test_rng,
               << " MB" << std::endl;
   }
 
+  if (!cache_path.empty()) {
+    absl::Status status =
+        WriteCorpusCache(cache_path, cache_key, corpus,
+                         corpus_config.inputs.size(), end_states);
+    if (printing_allowed && !status.ok()) {
+      std::cout << "Failed to write corpus cache: " << status << std::endl;
+    }
+  }
+
   absl::Time test_begin = absl::Now();
   corpus_stats.end_state_gen_time += test_begin - end_state_begin;
 
-  // Run test corpus.
-  if (printing_allowed) {
-    std::cout << "Running tests" << std::endl;
-  }
-  std::vector<ThreadStats> stats(workers.NumWorkers());
-  absl::Duration testing_time = run_time - (test_begin - corpus_begin);
-  workers.DoWork(stats, [&](ThreadStats& s) {
-    RunTests(corpus.tests, corpus_config.inputs, end_states,
-             corpus_config.run_config, test_index, testing_time, s, result);
-  });
-
-  // Aggregate thread stats.
-  for (const ThreadStats& s : stats) {
-    corpus_stats.test_instance_run += s.num_run;
-    corpus_stats.test_iteration_run +=
-        s.num_run * corpus_config.run_config.test.num_iterations;
-    corpus_stats.test_instance_hit += s.num_failed;
-  }
-  corpus_stats.test_time += absl::Now() - test_begin;
-  corpus_stats.distinct_tests += corpus.tests.size();
+  RunCorpus(test_index, workers, corpus_config, corpus, end_states,
+            corpus_stats, run_time - (test_begin - corpus_begin), result,
+            printing_allowed);
 }
 
 void FormatTestConfigJSON(const TestConfig& test_config, JSONFormatter& out) {
   out.Object([&] {
     out.Field("vector_width", test_config.vector_width);
     out.Field("num_iterations", test_config.num_iterations);
+    out.Field("in_register_hash", test_config.in_register_hash);
   });
 }
 
@@ -419,6 +505,7 @@ void FormatCorpusStatsJSON(const CorpusStats& corpus_stats,
     out.Field("end_state_gen_time",
               absl::ToDoubleSeconds(corpus_stats.end_state_gen_time));
     out.Field("test_time", absl::ToDoubleSeconds(corpus_stats.test_time));
+    out.Field("corpus_cache_hits", corpus_stats.corpus_cache_hits);
     out.Field("distinct_tests", corpus_stats.distinct_tests);
     out.Field("test_instance_run", corpus_stats.test_instance_run);
     out.Field("test_iteration_run", corpus_stats.test_iteration_run);
@@ -434,6 +521,8 @@ void PrintCorpusStats(const std::string& name, const CorpusStats& corpus_stats,
   std::cout << corpus_stats.end_state_gen_time << " generating end states"
             << std::endl;
   std::cout << corpus_stats.test_time << " testing" << std::endl;
+  std::cout << corpus_stats.corpus_cache_hits << " corpora loaded from cache"
+            << std::endl;
   std::cout << corpus_stats.distinct_tests << " tests" << std::endl;
   std::cout << corpus_stats.test_instance_run << " runs" << std::endl;
   std::cout << (corpus_stats.test_iteration_run /
@@ -451,6 +540,118 @@ void PrintCorpusStats(const std::string& name, const CorpusStats& corpus_stats,
             << " per billion iteration hit rate" << std::endl;
 }
 
+// The tests starting at `first_test_index` were generated and run with the
+// corpus config at index `variant`.
+struct CorpusRun {
+  size_t first_test_index;
+  size_t variant;
+};
+
+MinimizeConfig MakeMinimizeConfig(const CorpusConfig& corpus_config,
+                                  const std::vector<int>& cpu_list,
+                                  size_t worker_index, size_t num_attempts) {
+  MinimizeConfig config = {
+      .chip = corpus_config.chip,
+      .synthesis_config = corpus_config.synthesis_config,
+      .test_config = corpus_config.run_config.test,
+      .mxcsr = corpus_config.run_config.mxcsr,
+      .num_attempts = num_attempts,
+  };
+  // Compute expected end states on the next two CPUs, like
+  // DetermineEndStates() does.
+  for (size_t i = 1; i <= 2 && i < cpu_list.size(); ++i) {
+    config.reference_cpus.push_back(
+        cpu_list[(worker_index + i) % cpu_list.size()]);
+  }
+  return config;
+}
+
+// Minimize each test that hit, once per CPU, and write a reproducer snapshot
+// for it to `minimize_dir` if the snapshot fails on that CPU too. Each worker
+// minimizes the hits reported on its own CPU, so the failing CPUs are
+// minimized in parallel.
+void MinimizeHits(ParallelWorkerPool& workers, const std::vector<int>& cpu_list,
+                  const std::vector<CorpusConfig>& corpus_config,
+                  const std::vector<CorpusRun>& corpus_runs,
+                  absl::Span<const Input> inputs, absl::Span<const Hit> hits,
+                  const std::string& minimize_dir, size_t num_attempts,
+                  bool printing_allowed) {
+  struct MinimizeTask {
+    std::vector<Hit> hits;
+    std::vector<MinimizeConfig> configs;
+    std::vector<MinimizedHit> results;
+  };
+  std::vector<MinimizeTask> tasks(workers.NumWorkers());
+
+  absl::flat_hash_set<std::pair<int, uint64_t>> seen;
+  for (const Hit& hit : hits) {
+    if (!seen.insert({hit.cpu, hit.test_seed}).second) {
+      continue;
+    }
+    auto cpu = std::find(cpu_list.begin(), cpu_list.end(), hit.cpu);
+    if (cpu == cpu_list.end()) {
+      continue;
+    }
+    // Find the last corpus run that started at or before the test.
+    auto run = std::upper_bound(corpus_runs.begin(), corpus_runs.end(),
+                                hit.test_index,
+                                [](size_t index, const CorpusRun& run) {
+                                  return index < run.first_test_index;
+                                });
+    CHECK(run != corpus_runs.begin());
+    const size_t worker_index = cpu - cpu_list.begin();
+    MinimizeTask& task = tasks[worker_index];
+    task.hits.push_back(hit);
+    task.configs.push_back(
+        MakeMinimizeConfig(corpus_config[std::prev(run)->variant], cpu_list,
+                           worker_index, num_attempts));
+  }
+
+  if (printing_allowed) {
+    std::cout << std::endl;
+    std::cout << "Minimizing " << seen.size() << " hits" << std::endl;
+  }
+  workers.DoWork(tasks, [&](MinimizeTask& task) {
+    for (size_t i = 0; i < task.hits.size(); ++i) {
+      const Hit& hit = task.hits[i];
+      task.results.push_back(
+          MinimizeHit(hit, inputs[hit.input_index], task.configs[i]));
+    }
+  });
+
+  for (const MinimizeTask& task : tasks) {
+    for (size_t i = 0; i < task.results.size(); ++i) {
+      const MinimizedHit& minimized = task.results[i];
+      const std::string name =
+          absl::StrCat(FormatSeed(minimized.hit.test_seed), "_cpu",
+                       minimized.hit.cpu);
+      if (!minimized.reproduced) {
+        if (printing_allowed) {
+          std::cout << name << ": did not reproduce" << std::endl;
+        }
+        continue;
+      }
+      absl::StatusOr<Snapshot> snapshot =
+          MakeHitReproducer(minimized, task.configs[i]);
+      absl::Status status = snapshot.status();
+      const std::string path = absl::StrCat(minimize_dir, "/", name, ".pb");
+      if (status.ok()) {
+        status = WriteSnapshotToFile(*snapshot, path);
+      }
+      if (printing_allowed) {
+        std::cout << name << ": " << minimized.NumKept() << " of "
+                  << minimized.num_steps << " steps after "
+                  << minimized.num_variants << " variants";
+        if (status.ok()) {
+          std::cout << ", wrote " << path << std::endl;
+        } else {
+          std::cout << ", " << status.message() << std::endl;
+        }
+      }
+    }
+  }
+}
+
 void SetTestTimes(proto::HashTestResult& result_proto, absl::Time started,
                   absl::Time ended) {
   google::protobuf::Timestamp started_proto;
@@ -528,6 +729,7 @@ int TestMain(std::vector<char*> positional_args) {
   size_t num_inputs = absl::GetFlag(FLAGS_inputs);
   size_t num_repeat = absl::GetFlag(FLAGS_repeat);
   size_t num_iterations = absl::GetFlag(FLAGS_iterations);
+  bool in_register_hash = absl::GetFlag(FLAGS_in_register_hash);
   size_t batch_size = absl::GetFlag(FLAGS_batch);
   bool verbose = absl::GetFlag(FLAGS_verbose);
 
@@ -543,6 +745,7 @@ int TestMain(std::vector<char*> positional_args) {
     std::cout << "Inputs: " << num_inputs << std::endl;
     std::cout << "Repeat: " << num_repeat << std::endl;
     std::cout << "Iterations: " << num_iterations << std::endl;
+    std::cout << "In-register hash: " << in_register_hash << std::endl;
 
     // Display seed so that we can recreate this run later, if needed.
     std::cout << std::endl;
@@ -588,6 +791,8 @@ int TestMain(std::vector<char*> positional_args) {
   // all the tests.
   std::vector<Input> inputs = GenerateInputs(input_rng, num_inputs);
 
+  const std::string corpus_cache_dir = absl::GetFlag(FLAGS_corpus_cache_dir);
+
   const CorpusConfig default_corpus_config = {
       .name = "default",
       .tags = {},
@@ -604,11 +809,13 @@ int TestMain(std::vector<char*> positional_args) {
                   {
                       .vector_width = vector_width,
                       .num_iterations = num_iterations,
+                      .in_register_hash = in_register_hash,
                   },
               .batch_size = batch_size,
               .num_repeat = num_repeat,
               .mxcsr = kMXCSRMaskAll,
           },
+      .corpus_cache_dir = corpus_cache_dir,
   };
 
   std::vector<CorpusConfig> corpus_config;
@@ -712,6 +919,7 @@ int TestMain(std::vector<char*> positional_args) {
 
   size_t test_index = 0;
   std::vector<CorpusStats> corpus_stats(corpus_config.size());
+  std::vector<CorpusRun> corpus_runs;
   size_t current_variant = 0;
   while (true) {
     if (result.ShouldStopRunning()) {
@@ -725,6 +933,10 @@ int TestMain(std::vector<char*> positional_args) {
     }
     absl::Duration clamped_corpus_time =
         std::min(corpus_time, testing_time_remaining);
+    corpus_runs.push_back({
+        .first_test_index = test_index,
+        .variant = current_variant,
+    });
     RunTestCorpus(test_index, test_rng, workers, corpus_config[current_variant],
                   corpus_stats[current_variant], clamped_corpus_time, result,
                   printing_allowed);
@@ -864,6 +1076,13 @@ int TestMain(std::vector<char*> positional_args) {
     result_proto.SerializeToOstream(&std::cout);
   }
 
+  const std::string minimize_dir = absl::GetFlag(FLAGS_minimize_dir);
+  if (!minimize_dir.empty() && !result.hits.empty()) {
+    MinimizeHits(workers, cpu_list, corpus_config, corpus_runs, inputs,
+                 result.hits, minimize_dir,
+                 absl::GetFlag(FLAGS_minimize_attempts), printing_allowed);
+  }
+
   return failed ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
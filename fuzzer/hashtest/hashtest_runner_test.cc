@@ -97,6 +97,38 @@ void SmokeTest(uint64_t seed, size_t vector_width) {
   }
 }
 
+// The in-register hash of a test's end state should match the reference
+// implementation applied to the stored end state.
+void DigestTest(uint64_t seed, size_t vector_width) {
+  TestConfig config = {
+      .vector_width = vector_width,
+      .num_iterations = 1,
+      .in_register_hash = true,
+  };
+  EntropyBuffer input = {};
+  EntropyBuffer output = {};
+  RandomizeEntropyBuffer(seed, input);
+
+  void* test = reinterpret_cast<void*>(&NopTest);
+  RunHashTest(test, config, input, output);
+  const uint64_t digest = EntropyBufferDigest(output, vector_width);
+  EXPECT_EQ(RunHashTestAndHash(test, config, input), digest);
+
+  // Flipping any bit of the end state should change the hash.
+  size_t num_bytes = output.NumBytes(vector_width);
+  for (size_t i = 0; i < num_bytes * 8; i++) {
+    output.bytes[i / 8] ^= 1 << (i % 8);
+    EXPECT_NE(EntropyBufferDigest(output, vector_width), digest) << i;
+    output.bytes[i / 8] ^= 1 << (i % 8);
+  }
+
+  // The hash only covers the bytes used at this vector width.
+  for (size_t i = num_bytes; i < sizeof(output.bytes); i++) {
+    output.bytes[i] ^= 0xff;
+  }
+  EXPECT_EQ(EntropyBufferDigest(output, vector_width), digest);
+}
+
 TEST(Runner, Run512) {
   constexpr size_t kVectorWidth = 512;
   if (CurrentVectorWidth() < kVectorWidth) {
@@ -105,6 +137,8 @@ TEST(Runner, Run512) {
   // Test with two different bit patterns.
   SmokeTest(0, kVectorWidth);
   SmokeTest(1, kVectorWidth);
+  DigestTest(0, kVectorWidth);
+  DigestTest(1, kVectorWidth);
 }
 
 TEST(Runner, Run256) {
@@ -116,6 +150,8 @@ TEST(Runner, Run256) {
   // Test with two different bit patterns.
   SmokeTest(2, kVectorWidth);
   SmokeTest(3, kVectorWidth);
+  DigestTest(2, kVectorWidth);
+  DigestTest(3, kVectorWidth);
 }
 
 TEST(Runner, Run128) {
@@ -127,9 +163,11 @@ TEST(Runner, Run128) {
   // Test with two different bit patterns.
   SmokeTest(4, kVectorWidth);
   SmokeTest(5, kVectorWidth);
+  DigestTest(4, kVectorWidth);
+  DigestTest(5, kVectorWidth);
 }
 
-TEST(Runner, EndToEnd) {
+void EndToEndTest(bool in_register_hash) {
   InitXedIfNeeded();
   xed_chip_enum_t chip = PlatformIdToChip(CurrentPlatformId());
   if (chip == XED_CHIP_INVALID) {
@@ -143,6 +181,7 @@ TEST(Runner, EndToEnd) {
           {
               .vector_width = ChipVectorRegisterWidth(chip),
               .num_iterations = 1,
+              .in_register_hash = in_register_hash,
           },
       .batch_size = 1,
       .num_repeat = 1,
@@ -181,6 +220,10 @@ TEST(Runner, EndToEnd) {
   EXPECT_EQ(result.hits.size(), 0);
 }
 
+TEST(Runner, EndToEnd) { EndToEndTest(false); }
+
+TEST(Runner, EndToEndInRegisterHash) { EndToEndTest(true); }
+
 TEST(MXCSR, GetSet) {
   uint32_t old = GetMxcsr();
 
@@ -16,6 +16,7 @@
 #define THIRD_PARTY_SILIFUZZ_FUZZER_HASHTEST_HASHTEST_WIDGITS_H_
 
 #include <cstddef>
+#include <cstdint>
 
 namespace silifuzz {
 
@@ -45,6 +46,20 @@ extern "C" void RunHashTest128(void* test, size_t num_iterations,
                                const EntropyBuffer* input,
                                EntropyBuffer* output);
 
+// Like RunHashTest512, but rather than storing the register state after
+// executing the test, hash it in registers and return the hash.
+// The result is equal to EntropyBufferDigest() of the output of RunHashTest512.
+extern "C" uint64_t RunHashTestDigest512(void* test, size_t num_iterations,
+                                         const EntropyBuffer* input);
+
+// Like RunHashTest256, but returns the hash of the register state.
+extern "C" uint64_t RunHashTestDigest256(void* test, size_t num_iterations,
+                                         const EntropyBuffer* input);
+
+// Like RunHashTest128, but returns the hash of the register state.
+extern "C" uint64_t RunHashTestDigest128(void* test, size_t num_iterations,
+                                         const EntropyBuffer* input);
+
 // A function that does nothing but return.
 // Registers should be undisturbed.
 // Useful for testing the other functions in this header.
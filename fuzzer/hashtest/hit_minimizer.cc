@@ -0,0 +1,229 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./fuzzer/hashtest/hit_minimizer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "./common/snapshot.h"
+#include "./fuzzer/hashtest/hashtest_runner.h"
+#include "./fuzzer/hashtest/mxcsr.h"
+#include "./fuzzer/hashtest/synthesize_base.h"
+#include "./fuzzer/hashtest/synthesize_snapshot.h"
+#include "./fuzzer/hashtest/synthesize_test.h"
+#include "./runner/driver/runner_driver.h"
+#include "./runner/make_snapshot.h"
+#include "./runner/runner_provider.h"
+#include "./util/checks.h"
+#include "./util/cpu_id.h"
+
+namespace silifuzz {
+
+namespace {
+
+// A test synthesized with some of its steps disabled.
+struct Variant {
+  Corpus corpus;
+  size_t num_steps;
+};
+
+Variant SynthesizeVariant(uint64_t test_seed, const std::vector<bool>& keep,
+                          const MinimizeConfig& config) {
+  StepFilter filter{.keep = keep};
+  SynthesisConfig synthesis_config = config.synthesis_config;
+  synthesis_config.step_filter = &filter;
+
+  // The RNG is only used to generate a test seed, which is overwritten.
+  Rng rng(0);
+  Corpus corpus = AllocateCorpus(rng, 1);
+  corpus.tests[0].seed = test_seed;
+  size_t used = SynthesizeTests(
+      absl::MakeSpan(corpus.tests),
+      reinterpret_cast<uint8_t*>(corpus.mapping.Ptr()), config.chip,
+      synthesis_config);
+  FinalizeCorpus(corpus, used);
+  return Variant{
+      .corpus = std::move(corpus),
+      .num_steps = filter.num_steps,
+  };
+}
+
+// Computes the end state of `test` three times on the reference CPUs and
+// reconciles them, like the runner does for a corpus. Returns to `home_cpu`
+// afterwards.
+EndState ExpectedEndState(const Test& test, const Input& input,
+                          const MinimizeConfig& config, int home_cpu) {
+  std::vector<EndState> end_states(3);
+  for (size_t i = 0; i < end_states.size(); ++i) {
+    if (!config.reference_cpus.empty()) {
+      SetCPUAffinity(
+          config.reference_cpus[i % config.reference_cpus.size()]);
+    }
+    ComputeEndStates(absl::MakeConstSpan(&test, 1), config.test_config,
+                     absl::MakeConstSpan(&input, 1),
+                     absl::MakeSpan(end_states).subspan(i, 1));
+  }
+  if (!config.reference_cpus.empty()) {
+    SetCPUAffinity(home_cpu);
+  }
+  ReconcileEndStates(absl::MakeSpan(end_states).subspan(0, 1),
+                     absl::MakeConstSpan(end_states).subspan(1, 1),
+                     absl::MakeConstSpan(end_states).subspan(2, 1));
+  return end_states[0];
+}
+
+// Returns true if the test still fails with the steps in `keep`.
+bool VariantFails(const Hit& hit, const Input& input,
+                  const std::vector<bool>& keep, const MinimizeConfig& config,
+                  absl::Time deadline) {
+  Variant variant = SynthesizeVariant(hit.test_seed, keep, config);
+  const Test& test = variant.corpus.tests[0];
+  EndState expected = ExpectedEndState(test, input, config, hit.cpu);
+  if (expected.CouldNotBeComputed()) {
+    return false;
+  }
+  for (size_t i = 0; i < config.num_attempts; ++i) {
+    if (RunHashTestAndHash(test.code, config.test_config, input.entropy) !=
+        expected.hash) {
+      return true;
+    }
+    // Reading the clock is not free, check it once in a while.
+    if (i % 1024 == 1023 && absl::Now() >= deadline) {
+      break;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+size_t MinimizedHit::NumKept() const {
+  return std::count(keep.begin(), keep.end(), true);
+}
+
+std::vector<bool> DeltaDebugSteps(
+    size_t num_steps, absl::FunctionRef<bool(const std::vector<bool>&)> fails) {
+  std::vector<size_t> kept(num_steps);
+  for (size_t i = 0; i < num_steps; ++i) {
+    kept[i] = i;
+  }
+  auto to_keep = [num_steps](const std::vector<size_t>& steps) {
+    std::vector<bool> keep(num_steps, false);
+    for (size_t step : steps) {
+      keep[step] = true;
+    }
+    return keep;
+  };
+
+  size_t granularity = 2;
+  while (kept.size() >= 2) {
+    const size_t chunk_size = (kept.size() + granularity - 1) / granularity;
+    bool reduced = false;
+    for (size_t begin = 0; begin < kept.size(); begin += chunk_size) {
+      // Try removing the chunk.
+      const size_t end = std::min(begin + chunk_size, kept.size());
+      std::vector<size_t> complement(kept.begin(), kept.begin() + begin);
+      complement.insert(complement.end(), kept.begin() + end, kept.end());
+      if (fails(to_keep(complement))) {
+        kept = std::move(complement);
+        granularity = std::max<size_t>(granularity - 1, 2);
+        reduced = true;
+        break;
+      }
+    }
+    if (!reduced) {
+      if (granularity >= kept.size()) {
+        break;
+      }
+      granularity = std::min(granularity * 2, kept.size());
+    }
+  }
+  return to_keep(kept);
+}
+
+MinimizedHit MinimizeHit(const Hit& hit, const Input& input,
+                         const MinimizeConfig& config) {
+  const uint32_t old_mxcsr = GetMxcsr();
+  SetMxcsr(config.mxcsr);
+  const absl::Time deadline = absl::Now() + config.time_limit;
+
+  MinimizedHit result{.hit = hit};
+  result.num_steps = SynthesizeVariant(hit.test_seed, {}, config).num_steps;
+  result.keep.assign(result.num_steps, true);
+
+  auto fails = [&](const std::vector<bool>& keep) {
+    if (absl::Now() >= deadline) {
+      return false;
+    }
+    ++result.num_variants;
+    return VariantFails(hit, input, keep, config, deadline);
+  };
+  result.reproduced = fails(result.keep);
+  if (result.reproduced) {
+    result.keep = DeltaDebugSteps(result.num_steps, fails);
+  }
+
+  SetMxcsr(old_mxcsr);
+  return result;
+}
+
+absl::StatusOr<Snapshot> MinimizedHitSnapshot(const MinimizedHit& minimized,
+                                              const MinimizeConfig& config) {
+  StepFilter filter{.keep = minimized.keep};
+  SynthesisConfig synthesis_config = config.synthesis_config;
+  synthesis_config.step_filter = &filter;
+  Rng rng(minimized.hit.test_seed);
+  return SynthesizeTestSnapshot(rng, config.chip, synthesis_config,
+                                /*make=*/false);
+}
+
+absl::StatusOr<Snapshot> MakeHitReproducer(const MinimizedHit& minimized,
+                                           const MinimizeConfig& config) {
+  ASSIGN_OR_RETURN_IF_NOT_OK(Snapshot snapshot,
+                             MinimizedHitSnapshot(minimized, config));
+  MakingConfig making_config = MakingConfig::Default(RunnerLocation());
+  if (!config.reference_cpus.empty()) {
+    making_config.cpu = config.reference_cpus[0];
+  }
+  ASSIGN_OR_RETURN_IF_NOT_OK(Snapshot made,
+                             MakeSnapshot(snapshot, making_config));
+
+  ASSIGN_OR_RETURN_IF_NOT_OK(RunnerDriver runner,
+                             RunnerDriverFromSnapshot(made, RunnerLocation()));
+  RunnerDriver::RunResult result = runner.VerifyOneRepeatedly(
+      made.id(), config.num_reproducer_attempts, minimized.hit.cpu);
+  if (result.success()) {
+    return absl::NotFoundError(
+        absl::StrCat("Snapshot did not fail in ",
+                     config.num_reproducer_attempts, " attempts"));
+  }
+  if (!result.has_failed_player_result()) {
+    return absl::InternalError(absl::StrCat(
+        "Cannot play snapshot: ", result.execution_result().DebugString()));
+  }
+  return made;
+}
+
+}  // namespace silifuzz
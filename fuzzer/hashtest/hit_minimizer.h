@@ -0,0 +1,118 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_SILIFUZZ_FUZZER_HASHTEST_HIT_MINIMIZER_H_
+#define THIRD_PARTY_SILIFUZZ_FUZZER_HASHTEST_HIT_MINIMIZER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "./common/snapshot.h"
+#include "./fuzzer/hashtest/hashtest_runner.h"
+#include "./fuzzer/hashtest/mxcsr.h"
+#include "./fuzzer/hashtest/synthesize_test.h"
+
+extern "C" {
+#include "third_party/libxed/xed-interface.h"
+}
+
+namespace silifuzz {
+
+// Configuration for minimizing hits of a single corpus.
+struct MinimizeConfig {
+  // The configuration the test was synthesized and run with.
+  xed_chip_enum_t chip;
+  SynthesisConfig synthesis_config;
+  TestConfig test_config;
+  uint32_t mxcsr = kMXCSRMaskAll;
+
+  // CPUs used to compute the expected end state of each variant of the test.
+  // These should not include the CPU the hit was reported on. If empty, the
+  // expected end state is computed on the reporting CPU.
+  std::vector<int> reference_cpus;
+
+  // How many times each variant is run before concluding it does not fail.
+  // SDCs are often intermittent, so this should be fairly large.
+  size_t num_attempts = 10000;
+
+  // Stop minimizing a hit after this long and return the smallest variant
+  // found so far.
+  absl::Duration time_limit = absl::Minutes(1);
+
+  // How many times the reproducer Snapshot is played on the CPU that
+  // reported the hit before concluding it does not reproduce the hit. Each
+  // play starts a runner, so this is much smaller than `num_attempts`.
+  int num_reproducer_attempts = 100;
+};
+
+// The result of minimizing a hit.
+struct MinimizedHit {
+  Hit hit;
+
+  // The number of test steps in the loop body of the original test.
+  size_t num_steps = 0;
+
+  // The test steps that are needed to reproduce the hit. See StepFilter.
+  std::vector<bool> keep;
+
+  // Did the original test fail again? If not, `keep` keeps every step.
+  bool reproduced = false;
+
+  // The number of variants of the test that were run.
+  size_t num_variants = 0;
+
+  size_t NumKept() const;
+};
+
+// Delta debugging. Returns a 1-minimal subset of `num_steps` steps for which
+// `fails` returns true, assuming `fails` returns true for all steps.
+// Only subsets that are complements of a chunk of the current subset are
+// tried, which is enough to find single culprits quickly.
+// Exported for testing.
+std::vector<bool> DeltaDebugSteps(
+    size_t num_steps, absl::FunctionRef<bool(const std::vector<bool>&)> fails);
+
+// Finds a minimal set of test steps with which the test of `hit` still fails
+// with `input` on the CPU that reported the hit. Test steps are removed by
+// re-synthesizing the test with a StepFilter.
+// Must be called on a thread bound to hit.cpu, such as a worker of the runner's
+// ParallelWorkerPool. The thread temporarily moves to the reference CPUs to
+// compute expected end states and sets the MXCSR.
+MinimizedHit MinimizeHit(const Hit& hit, const Input& input,
+                         const MinimizeConfig& config);
+
+// Synthesizes a Snapshot that runs the loop body of the minimized test.
+// The loop body is the same as the one run by the hashtest runner, but the
+// initial register state is derived from the test seed rather than the input,
+// since the input does not fit into a Snapshot (e.g. mask registers).
+// The Snapshot is not made and may not reproduce the hit at all, see
+// MakeHitReproducer().
+absl::StatusOr<Snapshot> MinimizedHitSnapshot(const MinimizedHit& minimized,
+                                              const MinimizeConfig& config);
+
+// Makes the Snapshot of MinimizedHitSnapshot() on a reference CPU, which
+// records its expected end state, and plays it up to
+// config.num_reproducer_attempts times on the CPU that reported the hit.
+// RETURNS: the made Snapshot if it failed on that CPU, a NotFound error if
+// it never failed or another error if it could not be made or played.
+absl::StatusOr<Snapshot> MakeHitReproducer(const MinimizedHit& minimized,
+                                           const MinimizeConfig& config);
+
+}  // namespace silifuzz
+
+#endif  // THIRD_PARTY_SILIFUZZ_FUZZER_HASHTEST_HIT_MINIMIZER_H_
@@ -0,0 +1,148 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./fuzzer/hashtest/hit_minimizer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "./common/snapshot.h"
+#include "./fuzzer/hashtest/hashtest_runner.h"
+#include "./fuzzer/hashtest/instruction_pool.h"
+#include "./fuzzer/hashtest/synthesize_base.h"
+#include "./fuzzer/hashtest/synthesize_test.h"
+#include "./instruction/xed_util.h"
+#include "./util/cpu_id.h"
+#include "./util/platform.h"
+
+namespace silifuzz {
+
+namespace {
+
+TEST(HitMinimizer, DeltaDebugSteps) {
+  size_t num_calls = 0;
+  std::vector<bool> keep =
+      DeltaDebugSteps(40, [&](const std::vector<bool>& keep) {
+        ++num_calls;
+        return keep[3] && keep[27];
+      });
+  std::vector<bool> expected(40, false);
+  expected[3] = true;
+  expected[27] = true;
+  EXPECT_EQ(keep, expected);
+  EXPECT_LT(num_calls, 100);
+
+  // Nothing can be removed.
+  keep = DeltaDebugSteps(5, [](const std::vector<bool>& keep) {
+    return keep == std::vector<bool>(5, true);
+  });
+  EXPECT_EQ(keep, std::vector<bool>(5, true));
+
+  EXPECT_TRUE(
+      DeltaDebugSteps(0, [](const std::vector<bool>&) { return true; })
+          .empty());
+}
+
+class HitMinimizerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    InitXedIfNeeded();
+    chip_ = PlatformIdToChip(CurrentPlatformId());
+    if (chip_ == XED_CHIP_INVALID) {
+      GTEST_SKIP() << "Unsupported chip.";
+    }
+    Rng rng(0);
+    GenerateInstructionPool(rng, chip_, ipool_, false);
+    config_ = {
+        .chip = chip_,
+        .synthesis_config = {.ipool = &ipool_},
+        .test_config =
+            {
+                .vector_width = ChipVectorRegisterWidth(chip_),
+                .num_iterations = 1,
+            },
+        .num_attempts = 10,
+        .time_limit = absl::Seconds(10),
+    };
+    input_.seed = 1;
+    RandomizeEntropyBuffer(input_.seed, input_.entropy);
+  }
+
+  std::vector<uint8_t> Synthesize(uint64_t seed, StepFilter* filter) {
+    SynthesisConfig synthesis_config = config_.synthesis_config;
+    synthesis_config.step_filter = filter;
+    Rng rng(seed);
+    RegisterPool rpool{};
+    InitRegisterLayout(chip_, rpool);
+    InstructionBlock block{};
+    SynthesizeLoopBody(rng, rpool, synthesis_config, block);
+    return block.bytes;
+  }
+
+  xed_chip_enum_t chip_;
+  InstructionPool ipool_;
+  MinimizeConfig config_;
+  Input input_;
+};
+
+TEST_F(HitMinimizerTest, StepFilter) {
+  StepFilter filter;
+  std::vector<uint8_t> unfiltered = Synthesize(2, nullptr);
+  EXPECT_EQ(Synthesize(2, &filter), unfiltered);
+  ASSERT_GT(filter.num_steps, 2);
+  const size_t num_steps = filter.num_steps;
+
+  // Disabling a step changes the code but not the number of steps.
+  filter.keep.assign(num_steps, true);
+  filter.keep[1] = false;
+  std::vector<uint8_t> filtered = Synthesize(2, &filter);
+  EXPECT_NE(filtered, unfiltered);
+  EXPECT_EQ(filter.num_steps, num_steps);
+
+  // Disabling every step gives the same result each time.
+  filter.keep.assign(num_steps, false);
+  std::vector<uint8_t> empty = Synthesize(2, &filter);
+  EXPECT_LT(empty.size(), filtered.size());
+  EXPECT_EQ(Synthesize(2, &filter), empty);
+}
+
+TEST_F(HitMinimizerTest, NoFailure) {
+  // A test that works does not reproduce, and is left alone.
+  Hit hit = {
+      .cpu = GetCPUId(),
+      .test_index = 0,
+      .test_seed = 3,
+      .input_index = 0,
+      .input_seed = input_.seed,
+  };
+  MinimizedHit minimized = MinimizeHit(hit, input_, config_);
+  EXPECT_FALSE(minimized.reproduced);
+  EXPECT_GT(minimized.num_steps, 0);
+  EXPECT_EQ(minimized.NumKept(), minimized.num_steps);
+  EXPECT_EQ(minimized.num_variants, 1);
+
+  // Disable a step and emit the reproducer.
+  minimized.keep[0] = false;
+  absl::StatusOr<Snapshot> snapshot = MinimizedHitSnapshot(minimized, config_);
+  ASSERT_TRUE(snapshot.ok()) << snapshot.status();
+  EXPECT_FALSE(snapshot->memory_bytes().empty());
+}
+
+}  // namespace
+
+}  // namespace silifuzz
@@ -86,6 +86,8 @@ class JSONFormatter {
     out_ << '"' << absl::CEscape(value) << '"';
   }
 
+  void Format(bool value) { out_ << (value ? "true" : "false"); }
+
   template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
   void Format(T value) {
     out_ << value;
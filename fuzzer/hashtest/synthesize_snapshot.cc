@@ -17,6 +17,8 @@
 #include <cstddef>
 #include <cstdint>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -189,10 +191,13 @@ absl::StatusOr<Snapshot> CreateSnapshot(Rng& rng, const RegisterPool& rpool,
   }
 }
 
-absl::StatusOr<Snapshot> SynthesizeTestSnapshot(Rng& rng, xed_chip_enum_t chip,
-                                                const SynthesisConfig& config,
-                                                bool make) {
-  RegisterPool rpool{};
+namespace {
+
+// Synthesizes the code of a test into `block` and returns how many times the
+// loop body should be iterated.
+size_t SynthesizeTestBlock(Rng& rng, xed_chip_enum_t chip,
+                           const SynthesisConfig& config, RegisterPool& rpool,
+                           InstructionBlock& block) {
   InitRegisterLayout(chip, rpool);
 
   // Synthesize the body first, so we know how many instructions it contains.
@@ -202,8 +207,6 @@ absl::StatusOr<Snapshot> SynthesizeTestSnapshot(Rng& rng, xed_chip_enum_t chip,
   // Decrement the loop counter at the end of the loop body.
   SynthesizeGPRegDec(kLoopIndex, body);
 
-  InstructionBlock block{};
-
   // Preamble
   if (rpool.mask_width > 0) {
     // Initialize the mask entropy pool.
@@ -237,7 +240,39 @@ absl::StatusOr<Snapshot> SynthesizeTestSnapshot(Rng& rng, xed_chip_enum_t chip,
   // or jump to a negative index.
   SynthesizeBackwardJnle(-(int32_t)body.bytes.size(), block);
 
+  return iteration_count;
+}
+
+}  // namespace
+
+absl::StatusOr<Snapshot> SynthesizeTestSnapshot(Rng& rng, xed_chip_enum_t chip,
+                                                const SynthesisConfig& config,
+                                                bool make) {
+  RegisterPool rpool{};
+  InstructionBlock block{};
+  size_t iteration_count =
+      SynthesizeTestBlock(rng, chip, config, rpool, block);
   return CreateSnapshot(rng, rpool, iteration_count, block, make);
 }
 
+absl::StatusOr<std::vector<Snapshot>> SynthesizeTestSnapshots(
+    Rng& rng, xed_chip_enum_t chip, const SynthesisConfig& config,
+    size_t num_inputs) {
+  RegisterPool rpool{};
+  InstructionBlock block{};
+  size_t iteration_count =
+      SynthesizeTestBlock(rng, chip, config, rpool, block);
+  std::vector<Snapshot> snapshots;
+  snapshots.reserve(num_inputs);
+  for (size_t i = 0; i < num_inputs; ++i) {
+    ASSIGN_OR_RETURN_IF_NOT_OK(
+        Snapshot snapshot,
+        CreateSnapshot(rng, rpool, iteration_count, block, /*make=*/false));
+    // The ID only depends on the code, tell the inputs apart.
+    snapshot.set_id(absl::StrCat(snapshot.id(), "_", i));
+    snapshots.push_back(std::move(snapshot));
+  }
+  return snapshots;
+}
+
 }  // namespace silifuzz
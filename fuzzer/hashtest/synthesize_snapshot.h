@@ -15,6 +15,9 @@
 #ifndef THIRD_PARTY_SILIFUZZ_FUZZER_HASHTEST_SYNTHESIZE_SNAPSHOT_H_
 #define THIRD_PARTY_SILIFUZZ_FUZZER_HASHTEST_SYNTHESIZE_SNAPSHOT_H_
 
+#include <cstddef>
+#include <vector>
+
 #include "absl/status/statusor.h"
 #include "./common/snapshot.h"
 #include "./fuzzer/hashtest/synthesize_base.h"
@@ -26,6 +29,13 @@ absl::StatusOr<Snapshot> SynthesizeTestSnapshot(Rng& rng, xed_chip_enum_t chip,
                                                 const SynthesisConfig& config,
                                                 bool make);
 
+// Synthesizes a single test and returns `num_inputs` unmade snapshots that
+// run its code from different random initial register states. The snapshot
+// IDs are the ID of the code suffixed with the index of the input.
+absl::StatusOr<std::vector<Snapshot>> SynthesizeTestSnapshots(
+    Rng& rng, xed_chip_enum_t chip, const SynthesisConfig& config,
+    size_t num_inputs);
+
 }  // namespace silifuzz
 
 #endif  // THIRD_PARTY_SILIFUZZ_FUZZER_HASHTEST_SYNTHESIZE_SNAPSHOT_H_
@@ -381,6 +381,60 @@ std::vector<TestRegisters> GenerateRegisterSchedule(
   return schedule;
 }
 
+// Returns true if the next test step should be synthesized normally.
+bool KeepNextStep(StepFilter* filter) {
+  if (filter == nullptr) {
+    return true;
+  }
+  size_t index = filter->num_steps++;
+  return index >= filter->keep.size() || filter->keep[index];
+}
+
+// Synthesize a disabled test step: an instruction without effect, if there is
+// one, followed by a copy of the mix register into the dead register so that
+// entropy keeps cycling through the registers.
+void SynthesizeDisabledStep(size_t step_index, const InstructionPool* ipool,
+                            const RegisterPool& original_rpool,
+                            RegisterID entropy_output, RegisterID entropy_mixin,
+                            InstructionBlock& block) {
+  RegisterPool rpool = original_rpool;
+  if (!ipool->no_effect.empty()) {
+    // Use a separate RNG so the main RNG is not affected.
+    Rng rng(step_index);
+    const InstructionCandidate& candidate =
+        ChooseRandomElement(rng, ipool->no_effect);
+    std::vector<RegisterID> reg_needs_init;
+    std::vector<unsigned int> reg_is_written;
+    uint8_t ibuf[16];
+    size_t actual_len = sizeof(ibuf);
+    CHECK(SynthesizeTestInstruction(
+        candidate, rpool, rng, RandomEffectiveOpWidth(rng, candidate),
+        reg_needs_init, reg_is_written, ibuf, actual_len));
+    SynthesizeInits(rng, reg_needs_init, rpool, block);
+    block.EmitInstruction(ibuf, actual_len);
+  }
+
+  switch (entropy_output.bank) {
+    case RegisterBank::kGP:
+      SynthesizeGPRegMov(entropy_mixin.index, entropy_output.index, block);
+      break;
+    case RegisterBank::kVec:
+      SynthesizeVecRegMov(entropy_mixin.index, entropy_output.index, rpool,
+                          block);
+      break;
+    case RegisterBank::kMask:
+      SynthesizeMaskRegMov(entropy_mixin.index, entropy_output.index, rpool,
+                           block);
+      break;
+    case RegisterBank::kMMX:
+      SynthesizeMMXRegMov(entropy_mixin.index, entropy_output.index, block);
+      break;
+    default:
+      LOG(FATAL) << "Unknown output mode: "
+                 << static_cast<int>(entropy_output.bank);
+  }
+}
+
 }  // namespace
 
 void SynthesizeGPRegDec(unsigned int dst, InstructionBlock& block) {
@@ -585,9 +639,20 @@ static size_t SynthesizeBasicBlock(Rng& rng,
   size_t existing_instructions = block.num_instructions;
   for (const TestRegisters& step : schedule) {
     // Generate the test instruction + setup + output collection.
-    SynthesizeTestStep(rng,
-                       ChooseRandomCandidate(rng, config.ipool, step.mix.bank),
-                       dead_pool, step.dead, step.mix, config, block);
+    const InstructionCandidate& candidate =
+        ChooseRandomCandidate(rng, config.ipool, step.mix.bank);
+    if (KeepNextStep(config.step_filter)) {
+      SynthesizeTestStep(rng, candidate, dead_pool, step.dead, step.mix, config,
+                         block);
+    } else {
+      // Synthesize the step anyway and throw it away, so that the RNG advances
+      // exactly as if the step had been kept.
+      InstructionBlock discarded;
+      SynthesizeTestStep(rng, candidate, dead_pool, step.dead, step.mix, config,
+                         discarded);
+      SynthesizeDisabledStep(config.step_filter->num_steps, config.ipool,
+                             dead_pool, step.dead, step.mix, block);
+    }
     // The mix register has been consumed, and is now dead.
     dead_pool.entropy.Set(step.mix, false, true);
     // The old dead register now has entropy.
@@ -630,6 +695,10 @@ static size_t SynthesizeBlock(Rng& rng,
 size_t SynthesizeLoopBody(Rng& rng, const RegisterPool& rpool,
                           const SynthesisConfig& config,
                           InstructionBlock& block) {
+  if (config.step_filter != nullptr) {
+    config.step_filter->num_steps = 0;
+  }
+
   std::vector<TestRegisters> greg_schedule =
       GenerateRegisterSchedule(rng, RegisterBank::kGP, rpool.entropy.gp);
   std::vector<TestRegisters> vreg_schedule =
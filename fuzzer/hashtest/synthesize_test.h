@@ -17,12 +17,28 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include "./fuzzer/hashtest/instruction_pool.h"
 #include "./fuzzer/hashtest/synthesize_base.h"
 
 namespace silifuzz {
 
+// Selects which test steps of a loop body are synthesized. A test step is a
+// test instruction plus the instructions that feed it and collect its outputs.
+// A disabled step is replaced by an instruction without effect and a copy of
+// the step's mix register into its dead register. Disabling a step does not
+// change how the other steps are synthesized, which makes it possible to
+// minimize a test by disabling steps one at a time.
+struct StepFilter {
+  // keep[i] is true if the i-th test step of the loop body, in the order the
+  // steps are synthesized, should be kept. Steps past the end are kept.
+  std::vector<bool> keep;
+
+  // The number of test steps in the last loop body that was synthesized.
+  size_t num_steps = 0;
+};
+
 struct SynthesisConfig {
   // The set of instructions that can be used as test instructions.
   const InstructionPool* ipool;
@@ -57,6 +73,11 @@ struct SynthesisConfig {
   // branch misses (or slower execution?) but most seem to like the throughput
   // that comes from semi-predictable branches.
   int branch_test_bits = 3;
+
+  // If set, only the test steps selected by the filter are synthesized.
+  // The filter records the number of steps, so it must not be shared between
+  // threads. Used for test minimization, not part of the test configuration.
+  StepFilter* step_filter = nullptr;
 };
 
 // Generate a single iteration of a randomized hash function.
@@ -25,11 +25,13 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <string>
 #include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
+#include "absl/base/const_init.h"
 #include "absl/cleanup/cleanup.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -37,14 +39,19 @@
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "third_party/liblzma/lzma.h"
 #include "./snap/snap.h"
 #include "./snap/snap_checksum.h"
+#include "./snap/snap_relocator.h"
+#include "./util/arch.h"
 #include "./util/byte_io.h"
 #include "./util/checks.h"
 #include "./util/itoa.h"
 #include "./util/math.h"
+#include "./util/misc_util.h"
+#include "./util/mmapped_memory_ptr.h"
 #include "./util/owned_file_descriptor.h"
 #include "./util/path_util.h"
 #include "./util/span_util.h"
@@ -83,6 +90,87 @@ absl::StatusOr<absl::Cord> ReadCord(int fd) {
   return cord;
 }
 
+// Creates a mem file and writes `contents` to it. See WriteSharedMemoryFile().
+absl::StatusOr<OwnedFileDescriptor> CreateSharedMemoryFile(
+    const absl::Cord& contents, absl::string_view name) {
+  int memfd = memfd_create(std::string(name).c_str(),
+                           O_RDWR | MFD_ALLOW_SEALING | MFD_CLOEXEC);
+  if (memfd == -1) {
+    return absl::ErrnoToStatus(errno, "memfd_create()");
+  }
+  OwnedFileDescriptor owned_fd(memfd);
+  RETURN_IF_NOT_OK(WriteCord(contents, owned_fd.borrow()));
+  return owned_fd;
+}
+
+// Seals the mem file `fd` and moves its file offset to the beginning.
+absl::Status SealSharedMemoryFile(int fd, absl::string_view name) {
+  // Seal file after write to prevent modification of its contents and seals.
+  // There appears to be a kernel bug that happens with large enough number of
+  // concurrent threads calling fcntl(2). The bug manifests as fcntl returning
+  // errno=EBUSY when passed F_SEAL_WRITE.
+  if (fcntl(fd, F_ADD_SEALS, F_SEAL_SEAL | F_SEAL_SHRINK | F_SEAL_GROW) != 0) {
+    return absl::ErrnoToStatus(errno,
+                               absl::StrCat("fcntl(F_ADD_SEALS): ", name));
+  }
+
+  // Move file descriptor to beginning of file.
+  if (lseek(fd, 0, SEEK_SET) != 0) {
+    return absl::ErrnoToStatus(errno, "lseek()");
+  }
+  return absl::OkStatus();
+}
+
+// Serializes RelocateShard(), which maps every shard at the same address.
+ABSL_CONST_INIT absl::Mutex relocate_shard_mutex(absl::kConstInit);
+
+// Relocates `shard` in place for `load_address` and updates its header and
+// checksum to match the relocated contents.
+// RETURNS: an error if the shard could not be mapped at `load_address` or
+// relocated. `shard` is unchanged on error but the contents of its file are
+// undefined.
+absl::Status RelocateShard(InMemoryShard& shard, uint64_t load_address) {
+  absl::MutexLock lock(&relocate_shard_mutex);
+  void* const address = reinterpret_cast<void*>(load_address);
+  void* mapped = mmap(address, shard.file_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_FIXED_NOREPLACE,
+                      shard.file_descriptor.borrow(), 0);
+  if (mapped == MAP_FAILED) {
+    return absl::ErrnoToStatus(errno, "mmap()");
+  }
+  MmappedMemoryPtr<char> relocatable =
+      MakeMmappedMemoryPtr(reinterpret_cast<char*>(mapped), shard.file_size);
+  if (mapped != address) {
+    return absl::UnavailableError("MAP_FIXED_NOREPLACE is not supported");
+  }
+
+  // The checksum was verified by ValidateShard().
+  SnapRelocatorError error;
+  MmappedMemoryPtr<const SnapCorpus<Host>> corpus =
+      SnapRelocator<Host>::RelocateCorpus(std::move(relocatable),
+                                          /*verify=*/false, &error);
+  if (error != SnapRelocatorError::kOk) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Relocation failed, code=", ToInt(error)));
+  }
+
+  // The mapping is read-only now. Write the new checksum through the file.
+  CorpusChecksumCalculator checksum;
+  checksum.AddData(corpus.get(), shard.file_size);
+  const uint32_t relocated_checksum = checksum.Checksum();
+  if (pwrite(shard.file_descriptor.borrow(), &relocated_checksum,
+             sizeof(relocated_checksum),
+             offsetof(SnapCorpusHeader, checksum)) !=
+      sizeof(relocated_checksum)) {
+    return absl::ErrnoToStatus(errno, "pwrite()");
+  }
+  shard.checksum = relocated_checksum;
+  shard.header_bytes.assign(reinterpret_cast<const char*>(&corpus->header),
+                            sizeof(SnapCorpusHeader));
+  shard.load_address = load_address;
+  return absl::OkStatus();
+}
+
 // Returns the size of the file (in bytes) at `path` or an error status.
 absl::StatusOr<off_t> GetFileSize(const std::string& path) {
   struct stat st;
@@ -192,29 +280,9 @@ absl::StatusOr<absl::Cord> ReadXzipFile(const std::string& path) {
 
 absl::StatusOr<OwnedFileDescriptor> WriteSharedMemoryFile(
     const absl::Cord& contents, absl::string_view name) {
-  int memfd = memfd_create(std::string(name).c_str(),
-                           O_RDWR | MFD_ALLOW_SEALING | MFD_CLOEXEC);
-  if (memfd == -1) {
-    return absl::ErrnoToStatus(errno, "memfd_create()");
-  }
-  OwnedFileDescriptor owned_fd(memfd);
-  int fd = owned_fd.borrow();
-  RETURN_IF_NOT_OK(WriteCord(contents, fd));
-
-  // Seal file after write to prevent modification of its contents and seals.
-  // There appears to be a kernel bug that happens with large enough number of
-  // concurrent threads calling fcntl(2). The bug manifests as fcntl returning
-  // errno=EBUSY when passed F_SEAL_WRITE.
-  if (fcntl(fd, F_ADD_SEALS, F_SEAL_SEAL | F_SEAL_SHRINK | F_SEAL_GROW) != 0) {
-    return absl::ErrnoToStatus(errno,
-                               absl::StrCat("fcntl(F_ADD_SEALS): ", name));
-  }
-
-  // Move file descriptor to beginning of file.
-  if (lseek(fd, 0, SEEK_SET) != 0) {
-    return absl::ErrnoToStatus(errno, "lseek()");
-  }
-
+  ASSIGN_OR_RETURN_IF_NOT_OK(OwnedFileDescriptor owned_fd,
+                             CreateSharedMemoryFile(contents, name));
+  RETURN_IF_NOT_OK(SealSharedMemoryFile(owned_fd.borrow(), name));
   return owned_fd;
 }
 
@@ -253,11 +321,11 @@ absl::StatusOr<InMemoryShard> LoadCorpus(const std::string& path) {
 
   // Set linked name in /proc/self/fd/ for ease of debugging.
   ASSIGN_OR_RETURN_IF_NOT_OK(OwnedFileDescriptor owned_fd,
-                             WriteSharedMemoryFile(contents, name));
+                             CreateSharedMemoryFile(contents, name));
 
   std::string file_path = FilePathForFD(owned_fd);
 
-  return InMemoryShard{
+  InMemoryShard shard{
       .file_descriptor = std::move(owned_fd),
       .file_path = std::move(file_path),
       .name = std::move(name),
@@ -265,6 +333,29 @@ absl::StatusOr<InMemoryShard> LoadCorpus(const std::string& path) {
       .file_size = contents.size(),
       .checksum = checksum.Checksum(),
   };
+
+  // Relocate the shard once here rather than in every runner. Invalid shards
+  // are left for ValidateCorpus() to report.
+  const SnapCorpusHeader& header =
+      *reinterpret_cast<const SnapCorpusHeader*>(shard.header_bytes.data());
+  if (ValidateShard(shard).ok() &&
+      header.architecture_id == ToInt(Host::architecture_id) &&
+      header.load_address == 0) {
+    absl::Status status = RelocateShard(shard, kShardLoadAddress);
+    if (!status.ok()) {
+      LOG_INFO("Runners will relocate shard ", shard.name, ": ",
+               status.message());
+      // Restore the relocatable contents.
+      const int fd = shard.file_descriptor.borrow();
+      if (lseek(fd, 0, SEEK_SET) != 0) {
+        return absl::ErrnoToStatus(errno, "lseek()");
+      }
+      RETURN_IF_NOT_OK(WriteCord(contents, fd));
+    }
+  }
+  RETURN_IF_NOT_OK(SealSharedMemoryFile(shard.file_descriptor.borrow(),
+                                        shard.name));
+  return shard;
 }
 
 absl::StatusOr<uint64_t> EstimateLargestCorpusSizeMB(
@@ -50,8 +50,19 @@ struct InMemoryShard {
 
   // The checksum of the file.
   uint32_t checksum;
+
+  // The address the shard is relocated for or 0 if it is relocatable.
+  // See kShardLoadAddress.
+  uint64_t load_address = 0;
 };
 
+// The address LoadCorpus() relocates valid shards for. Runners map such a
+// shard shared and read-only at this address instead of each relocating a
+// private copy, and fall back to relocation if the address is taken. It is
+// far away from the ranges Snaps map and from where the kernel places
+// mappings by default.
+inline constexpr uint64_t kShardLoadAddress = 0x6000'0000'0000;
+
 struct InMemoryCorpora {
   std::vector<InMemoryShard> shards;
 };
@@ -84,6 +95,9 @@ absl::StatusOr<OwnedFileDescriptor> WriteSharedMemoryFile(
 // file descriptor of a temp file containing uncompressed corpus contents in
 // RAM. LoadCorpus determines the decompression algorithm to use based on
 // suffix of `path`. Currently only .xz is recognized.
+// A shard for the host that passes ValidateShard() is relocated for
+// kShardLoadAddress if that address can be mapped. Otherwise it is left
+// relocatable.
 absl::StatusOr<InMemoryShard> LoadCorpus(const std::string& path);
 
 // Reads and decompresses gzipped relocatable Snap corpora whose paths are in
@@ -25,6 +25,7 @@
 #include <cstdint>
 #include <cstdio>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -34,9 +35,17 @@
 #include "absl/strings/cord.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
+#include "./common/snapshot.h"
+#include "./common/snapshot_test_enum.h"
+#include "./snap/gen/relocatable_snap_generator.h"
+#include "./snap/gen/snap_generator.h"
 #include "./snap/snap.h"
+#include "./snap/snap_corpus_util.h"
+#include "./snap/testing/snap_test_snapshots.h"
+#include "./util/arch.h"
 #include "./util/byte_io.h"
 #include "./util/data_dependency.h"
+#include "./util/mmapped_memory_ptr.h"
 #include "./util/owned_file_descriptor.h"
 #include "./util/testing/status_macros.h"
 #include "./util/testing/status_matchers.h"
@@ -257,6 +266,40 @@ TEST(CorpusUtil, LoadCorporaUncompressed) {
   }
 }
 
+TEST(CorpusUtil, LoadCorpusRelocatesShard) {
+  std::vector<Snapshot> snapified_corpus;
+  {
+    Snapshot snapshot =
+        MakeSnapRunnerTestSnapshot<Host>(TestSnapshot::kEndsAsExpected);
+    SnapifyOptions opts =
+        SnapifyOptions::V2InputRunOpts(snapshot.architecture_id());
+    ASSERT_OK_AND_ASSIGN(Snapshot snapified, Snapify(snapshot, opts));
+    snapified_corpus.emplace_back(std::move(snapified));
+  }
+  MmappedMemoryPtr<char> buffer =
+      GenerateRelocatableSnaps(Host::architecture_id, snapified_corpus);
+  const std::string path =
+      absl::StrCat(TempDir(), "/LoadCorpusRelocatesShardTest");
+  const int fd =
+      open(path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, S_IRUSR | S_IWUSR);
+  ASSERT_NE(fd, -1);
+  const size_t size = MmappedMemorySize(buffer);
+  ASSERT_EQ(Write(fd, buffer.get(), size), size);
+  ASSERT_EQ(close(fd), 0);
+
+  ASSERT_OK_AND_ASSIGN(InMemoryShard shard, LoadCorpus(path));
+  EXPECT_EQ(shard.load_address, kShardLoadAddress);
+  // The checksum matches the relocated contents.
+  EXPECT_OK(ValidateShard(shard));
+
+  // The shard is used without relocation.
+  auto corpus = LoadCorpusFromFile<Host>(shard.file_path.c_str(),
+                                         /*preload=*/false, /*verify=*/true);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(corpus.get()), kShardLoadAddress);
+  ASSERT_EQ(corpus->snaps.size, 1);
+  EXPECT_EQ(corpus->snaps.at(0)->id, snapified_corpus[0].id());
+}
+
 TEST(CorpusUtil, EstimateLargestCorpusSize) {
   std::vector<std::string> shards = {
       GetDataDependencyFilepath("orchestrator/testdata/one_mb_of_zeros.xz")};
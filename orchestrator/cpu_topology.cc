@@ -0,0 +1,330 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./orchestrator/cpu_topology.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <fstream>
+#include <optional>
+#include <string>
+#include <system_error>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/random/bit_gen_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "./proto/session_summary.pb.h"
+#include "./util/checks.h"
+#include "./util/span_util.h"
+#include "./util/time_proto_util.h"
+
+namespace silifuzz {
+namespace fs = std::filesystem;
+
+namespace {
+
+// Reads the first line of `path`.
+std::optional<std::string> ReadLine(const fs::path& path) {
+  std::ifstream ifs(path);
+  std::string line;
+  if (!ifs.good() || !std::getline(ifs, line)) {
+    return std::nullopt;
+  }
+  return line;
+}
+
+std::optional<int> ReadInt(const fs::path& path) {
+  std::optional<std::string> line = ReadLine(path);
+  int value;
+  if (!line.has_value() || !absl::SimpleAtoi(*line, &value)) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+// Returns the smallest CPU of a cpulist like "0-3,8-11" or nullopt if the
+// list cannot be parsed.
+std::optional<int> MinCpuOfList(absl::string_view cpu_list) {
+  std::optional<int> min_cpu;
+  for (absl::string_view range : absl::StrSplit(cpu_list, ',')) {
+    int cpu;
+    if (!absl::SimpleAtoi(range.substr(0, range.find('-')), &cpu)) {
+      return std::nullopt;
+    }
+    min_cpu = std::min(min_cpu.value_or(cpu), cpu);
+  }
+  return min_cpu;
+}
+
+// Returns the smallest CPU sharing the L3 cache with the CPU at `cpu_dir`.
+std::optional<int> L3Key(const fs::path& cpu_dir) {
+  std::error_code ec;
+  for (const auto& index : fs::directory_iterator(cpu_dir / "cache", ec)) {
+    if (ReadInt(index.path() / "level") != 3) {
+      continue;
+    }
+    if (std::optional<std::string> cpu_list =
+            ReadLine(index.path() / "shared_cpu_list");
+        cpu_list.has_value()) {
+      return MinCpuOfList(*cpu_list);
+    }
+  }
+  return std::nullopt;
+}
+
+// Returns the CPUs of `cores` interleaved by sibling: first sibling of every
+// core, then the second one, etc.
+std::vector<int> InterleaveSiblings(
+    const std::vector<const PhysicalCore*>& cores) {
+  std::vector<int> cpus;
+  for (size_t sibling = 0;; ++sibling) {
+    const size_t num_cpus = cpus.size();
+    for (const PhysicalCore* core : cores) {
+      if (sibling < core->cpus.size()) {
+        cpus.push_back(core->cpus[sibling]);
+      }
+    }
+    if (cpus.size() == num_cpus) {
+      return cpus;
+    }
+  }
+}
+
+// Splits `cores` evenly among at most `num_threads` threads.
+std::vector<std::vector<int>> SplitCores(
+    std::vector<const PhysicalCore*> cores, size_t num_threads) {
+  std::vector<std::vector<int>> result;
+  for (absl::Span<const PhysicalCore*> part :
+       PartitionEvenly(cores, std::min(num_threads, cores.size()))) {
+    result.push_back(InterleaveSiblings({part.begin(), part.end()}));
+  }
+  return result;
+}
+
+std::vector<const PhysicalCore*> ShuffledCores(const CpuTopology& topology,
+                                                absl::BitGenRef gen) {
+  std::vector<const PhysicalCore*> cores;
+  for (const PhysicalCore& core : topology.cores()) {
+    cores.push_back(&core);
+  }
+  std::shuffle(cores.begin(), cores.end(), gen);
+  return cores;
+}
+
+std::vector<std::vector<int>> AssignShuffled(const CpuTopology& topology,
+                                             size_t num_threads,
+                                             absl::BitGenRef gen) {
+  std::vector<int> cpus;
+  for (const PhysicalCore& core : topology.cores()) {
+    cpus.insert(cpus.end(), core.cpus.begin(), core.cpus.end());
+  }
+  std::shuffle(cpus.begin(), cpus.end(), gen);
+  std::vector<std::vector<int>> result;
+  for (absl::Span<int> part :
+       PartitionEvenly(cpus, std::min(num_threads, cpus.size()))) {
+    result.emplace_back(part.begin(), part.end());
+  }
+  return result;
+}
+
+std::vector<std::vector<int>> AssignSpreadL3(const CpuTopology& topology,
+                                             size_t num_threads,
+                                             absl::BitGenRef gen) {
+  std::vector<std::vector<const PhysicalCore*>> domains(
+      topology.num_l3_domains());
+  for (const PhysicalCore* core : ShuffledCores(topology, gen)) {
+    domains[core->l3_domain].push_back(core);
+  }
+  std::shuffle(domains.begin(), domains.end(), gen);
+  std::vector<std::vector<int>> result;
+  if (num_threads <= domains.size()) {
+    // Every thread gets one or more whole domains.
+    for (absl::Span<std::vector<const PhysicalCore*>> part :
+         PartitionEvenly(domains, num_threads)) {
+      std::vector<const PhysicalCore*> cores;
+      for (const std::vector<const PhysicalCore*>& domain : part) {
+        cores.insert(cores.end(), domain.begin(), domain.end());
+      }
+      result.push_back(InterleaveSiblings(cores));
+    }
+    return result;
+  }
+  // Every domain gets one or more threads.
+  for (size_t d = 0; d < domains.size(); ++d) {
+    const size_t domain_threads =
+        num_threads / domains.size() + (d < num_threads % domains.size());
+    for (std::vector<int>& cpus : SplitCores(domains[d], domain_threads)) {
+      result.push_back(std::move(cpus));
+    }
+  }
+  return result;
+}
+
+std::vector<std::vector<int>> AssignSiblingPairs(const CpuTopology& topology,
+                                                 size_t num_threads,
+                                                 absl::BitGenRef gen) {
+  std::vector<const PhysicalCore*> smt_cores, single_cores;
+  for (const PhysicalCore* core : ShuffledCores(topology, gen)) {
+    (core->cpus.size() > 1 ? smt_cores : single_cores).push_back(core);
+  }
+  const size_t num_pairs = std::min(num_threads / 2, smt_cores.size());
+  if (num_pairs == 0) {
+    return SplitCores(ShuffledCores(topology, gen), num_threads);
+  }
+  // Both threads of a pair walk the same cores in the same order, one on
+  // each sibling. Siblings beyond the second alternate between them.
+  std::vector<std::vector<int>> result;
+  for (absl::Span<const PhysicalCore*> part :
+       PartitionEvenly(smt_cores, num_pairs)) {
+    result.resize(result.size() + 2);
+    std::vector<int>& first = result[result.size() - 2];
+    std::vector<int>& second = result.back();
+    for (size_t sibling = 0;; ++sibling) {
+      bool added = false;
+      for (const PhysicalCore* core : part) {
+        if (sibling < core->cpus.size()) {
+          (sibling % 2 == 0 ? first : second).push_back(core->cpus[sibling]);
+          added = true;
+        }
+      }
+      if (!added) {
+        break;
+      }
+    }
+  }
+  // Cores without siblings go to a spare thread if there is one.
+  if (!single_cores.empty()) {
+    if (result.size() < num_threads) {
+      result.push_back(InterleaveSiblings(single_cores));
+    } else {
+      for (size_t i = 0; i < single_cores.size(); ++i) {
+        result[i % result.size()].push_back(single_cores[i]->cpus[0]);
+      }
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+CpuTopology CpuTopology::Read(const std::vector<int>& cpus,
+                              absl::string_view sysfs_cpu_dir) {
+  CpuTopology topology;
+  std::vector<int> sorted_cpus = cpus;
+  std::sort(sorted_cpus.begin(), sorted_cpus.end());
+  absl::flat_hash_map<std::pair<int, int>, int> core_index;
+  absl::flat_hash_map<int, int> l3_index;
+  for (int cpu : sorted_cpus) {
+    const fs::path cpu_dir =
+        fs::path(std::string(sysfs_cpu_dir)) / absl::StrCat("cpu", cpu);
+    const std::optional<int> package_id =
+        ReadInt(cpu_dir / "topology/physical_package_id");
+    const std::optional<int> core_id = ReadInt(cpu_dir / "topology/core_id");
+    if (!package_id.has_value() || !core_id.has_value()) {
+      VLOG_INFO(1, "No topology information for CPU ", cpu);
+    }
+    // CPUs without topology information are cores of their own.
+    const std::pair<int, int> core_key =
+        core_id.has_value() ? std::make_pair(package_id.value_or(0), *core_id)
+                            : std::make_pair(-1, cpu);
+    auto [core_it, new_core] =
+        core_index.try_emplace(core_key, topology.cores_.size());
+    if (new_core) {
+      const int l3_key = L3Key(cpu_dir).value_or(-1);
+      auto [l3_it, new_domain] =
+          l3_index.try_emplace(l3_key, topology.num_l3_domains_);
+      topology.num_l3_domains_ += new_domain;
+      topology.cores_.push_back({.package_id = package_id.value_or(0),
+                                 .core_id = core_id.value_or(cpu),
+                                 .l3_domain = l3_it->second});
+    }
+    topology.cores_[core_it->second].cpus.push_back(cpu);
+    topology.core_of_cpu_[cpu] = core_it->second;
+  }
+  return topology;
+}
+
+int CpuTopology::CoreOf(int cpu) const {
+  auto it = core_of_cpu_.find(cpu);
+  return it == core_of_cpu_.end() ? -1 : it->second;
+}
+
+absl::StatusOr<CpuPlacement> ParseCpuPlacement(absl::string_view name) {
+  if (name == "shuffle") return CpuPlacement::kShuffle;
+  if (name == "one_per_core") return CpuPlacement::kOnePerCore;
+  if (name == "sibling_pairs") return CpuPlacement::kSiblingPairs;
+  if (name == "spread_l3") return CpuPlacement::kSpreadL3;
+  return absl::InvalidArgumentError(
+      absl::StrCat("Unknown CPU placement: ", name));
+}
+
+std::vector<std::vector<int>> AssignCpus(const CpuTopology& topology,
+                                         CpuPlacement placement,
+                                         size_t num_threads,
+                                         absl::BitGenRef gen) {
+  CHECK_GT(num_threads, 0);
+  CHECK(!topology.cores().empty());
+  switch (placement) {
+    case CpuPlacement::kShuffle:
+      return AssignShuffled(topology, num_threads, gen);
+    case CpuPlacement::kOnePerCore:
+      return SplitCores(ShuffledCores(topology, gen), num_threads);
+    case CpuPlacement::kSiblingPairs:
+      return AssignSiblingPairs(topology, num_threads, gen);
+    case CpuPlacement::kSpreadL3:
+      return AssignSpreadL3(topology, num_threads, gen);
+  }
+}
+
+CoreCoverage::CoreCoverage(const CpuTopology& topology)
+    : topology_(topology), stats_(topology.cores().size()) {}
+
+void CoreCoverage::Record(int cpu, absl::Duration cpu_time) {
+  const int core = topology_.CoreOf(cpu);
+  if (core < 0) {
+    return;
+  }
+  absl::MutexLock l(&mu_);
+  ++stats_[core].num_runs;
+  stats_[core].cpu_time += cpu_time;
+}
+
+std::vector<proto::logging::CoreCoverage> CoreCoverage::ToProto() const {
+  absl::MutexLock l(&mu_);
+  std::vector<proto::logging::CoreCoverage> table;
+  for (size_t i = 0; i < stats_.size(); ++i) {
+    const PhysicalCore& core = topology_.cores()[i];
+    proto::logging::CoreCoverage& entry = table.emplace_back();
+    entry.set_package_id(core.package_id);
+    entry.set_core_id(core.core_id);
+    entry.mutable_cpus()->Add(core.cpus.begin(), core.cpus.end());
+    entry.set_num_runs(stats_[i].num_runs);
+    EncodeGoogleApiProto(stats_[i].cpu_time, entry.mutable_cpu_time())
+        .IgnoreError();
+  }
+  return table;
+}
+
+}  // namespace silifuzz
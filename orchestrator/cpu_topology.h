@@ -0,0 +1,141 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_SILIFUZZ_ORCHESTRATOR_CPU_TOPOLOGY_H_
+#define THIRD_PARTY_SILIFUZZ_ORCHESTRATOR_CPU_TOPOLOGY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/random/bit_gen_ref.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "./proto/session_summary.pb.h"
+
+namespace silifuzz {
+
+// SMT siblings sharing a physical core.
+struct PhysicalCore {
+  // Values of topology/{physical_package_id,core_id} in sysfs.
+  int package_id = 0;
+  int core_id = 0;
+
+  // Index of the L3 cache domain the core belongs to.
+  int l3_domain = 0;
+
+  // Logical CPUs of the core in ascending order.
+  std::vector<int> cpus;
+};
+
+// Physical layout of a set of logical CPUs.
+class CpuTopology {
+ public:
+  // Reads the topology of `cpus` from `sysfs_cpu_dir`. CPUs whose topology
+  // cannot be read are treated as separate cores in a shared L3 domain.
+  static CpuTopology Read(
+      const std::vector<int>& cpus,
+      absl::string_view sysfs_cpu_dir = "/sys/devices/system/cpu");
+
+  // Copyable and movable.
+  CpuTopology(const CpuTopology&) = default;
+  CpuTopology(CpuTopology&&) = default;
+  CpuTopology& operator=(const CpuTopology&) = default;
+  CpuTopology& operator=(CpuTopology&&) = default;
+
+  const std::vector<PhysicalCore>& cores() const { return cores_; }
+
+  // Returns the index in cores() of the core `cpu` belongs to or -1 if `cpu`
+  // is not part of the topology.
+  int CoreOf(int cpu) const;
+
+  int num_l3_domains() const { return num_l3_domains_; }
+
+ private:
+  CpuTopology() = default;
+
+  std::vector<PhysicalCore> cores_;
+  absl::flat_hash_map<int, int> core_of_cpu_;
+  int num_l3_domains_ = 0;
+};
+
+// How worker threads are mapped to CPUs.
+enum class CpuPlacement {
+  // Shuffle all CPUs and split them evenly, ignoring the topology.
+  kShuffle,
+
+  // Every physical core is scanned by a single thread, so SMT siblings never
+  // run two runners at the same time.
+  kOnePerCore,
+
+  // Threads come in pairs that scan the two SMT siblings of the same cores
+  // side by side. Exposes defects that only show under sibling contention.
+  kSiblingPairs,
+
+  // Like kOnePerCore but all cores of a thread share an L3 domain and threads
+  // are spread evenly across the domains.
+  kSpreadL3,
+};
+
+// Parses "shuffle", "one_per_core", "sibling_pairs" or "spread_l3".
+absl::StatusOr<CpuPlacement> ParseCpuPlacement(absl::string_view name);
+
+// Returns the CPUs to be scanned by each of at most `num_threads` threads
+// according to `placement`. Every CPU of `topology` is assigned to exactly
+// one thread and no returned list is empty. Fewer than `num_threads` lists
+// are returned if the placement cannot use more threads, e.g. kOnePerCore
+// returns at most one list per core.
+std::vector<std::vector<int>> AssignCpus(const CpuTopology& topology,
+                                         CpuPlacement placement,
+                                         size_t num_threads,
+                                         absl::BitGenRef gen);
+
+// Per-physical-core tally of runner invocations.
+//
+// This class is thread-safe.
+class CoreCoverage {
+ public:
+  explicit CoreCoverage(const CpuTopology& topology);
+
+  // Not copyable or moveable -- not just a data holder.
+  CoreCoverage(const CoreCoverage&) = delete;
+  CoreCoverage(CoreCoverage&&) = delete;
+  CoreCoverage& operator=(const CoreCoverage&) = delete;
+  CoreCoverage& operator=(CoreCoverage&&) = delete;
+
+  // Records a runner that ran on `cpu` for `cpu_time`.
+  void Record(int cpu, absl::Duration cpu_time);
+
+  // Returns one entry per core of the topology.
+  std::vector<proto::logging::CoreCoverage> ToProto() const;
+
+ private:
+  struct Stats {
+    uint64_t num_runs = 0;
+    absl::Duration cpu_time = absl::ZeroDuration();
+  };
+
+  const CpuTopology topology_;
+
+  mutable absl::Mutex mu_;
+  std::vector<Stats> stats_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace silifuzz
+
+#endif  // THIRD_PARTY_SILIFUZZ_ORCHESTRATOR_CPU_TOPOLOGY_H_
@@ -0,0 +1,182 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./orchestrator/cpu_topology.h"
+
+#include <algorithm>
+#include <filesystem>  // NOLINT
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
+#include "./proto/session_summary.pb.h"
+#include "./util/checks.h"
+#include "./util/file_util.h"
+
+namespace silifuzz {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::TempDir;
+using ::testing::UnorderedElementsAreArray;
+
+// Creates a fake sysfs CPU directory with 4 cores of 2 SMT siblings each.
+// CPU i and i + 4 share core i. Cores 0-1 and 2-3 share an L3 cache.
+std::string MakeFakeSysfs(const std::string& name) {
+  const std::string root = absl::StrCat(TempDir(), "/", name);
+  for (int cpu = 0; cpu < 8; ++cpu) {
+    const std::string dir = absl::StrCat(root, "/cpu", cpu);
+    std::filesystem::create_directories(dir + "/topology");
+    std::filesystem::create_directories(dir + "/cache/index2");
+    std::filesystem::create_directories(dir + "/cache/index3");
+    const int core = cpu % 4;
+    CHECK(SetContents(dir + "/topology/physical_package_id", "0\n"));
+    CHECK(SetContents(dir + "/topology/core_id", absl::StrCat(core, "\n")));
+    CHECK(SetContents(dir + "/cache/index2/level", "2\n"));
+    CHECK(SetContents(dir + "/cache/index2/shared_cpu_list",
+                      absl::StrCat(core, ",", core + 4, "\n")));
+    CHECK(SetContents(dir + "/cache/index3/level", "3\n"));
+    CHECK(SetContents(dir + "/cache/index3/shared_cpu_list",
+                      core < 2 ? "0-1,4-5\n" : "2-3,6-7\n"));
+  }
+  return root;
+}
+
+// Returns the sorted concatenation of `lists`.
+std::vector<int> Flatten(const std::vector<std::vector<int>>& lists) {
+  std::vector<int> all;
+  for (const std::vector<int>& list : lists) {
+    EXPECT_FALSE(list.empty());
+    all.insert(all.end(), list.begin(), list.end());
+  }
+  std::sort(all.begin(), all.end());
+  return all;
+}
+
+const std::vector<int> kAllCpus = {0, 1, 2, 3, 4, 5, 6, 7};
+
+TEST(CpuTopology, Read) {
+  const CpuTopology topology =
+      CpuTopology::Read(kAllCpus, MakeFakeSysfs("Read"));
+  ASSERT_EQ(topology.cores().size(), 4);
+  EXPECT_EQ(topology.num_l3_domains(), 2);
+  for (int i = 0; i < 4; ++i) {
+    const PhysicalCore& core = topology.cores()[i];
+    EXPECT_EQ(core.core_id, i);
+    EXPECT_THAT(core.cpus, ElementsAre(i, i + 4));
+    EXPECT_EQ(core.l3_domain, i / 2);
+    EXPECT_EQ(topology.CoreOf(i + 4), i);
+  }
+  EXPECT_EQ(topology.CoreOf(8), -1);
+}
+
+TEST(CpuTopology, ReadWithoutSysfs) {
+  const CpuTopology topology =
+      CpuTopology::Read({3, 1}, absl::StrCat(TempDir(), "/does_not_exist"));
+  ASSERT_EQ(topology.cores().size(), 2);
+  EXPECT_EQ(topology.num_l3_domains(), 1);
+  EXPECT_THAT(topology.cores()[0].cpus, ElementsAre(1));
+  EXPECT_THAT(topology.cores()[1].cpus, ElementsAre(3));
+}
+
+TEST(CpuTopology, ParseCpuPlacement) {
+  EXPECT_EQ(*ParseCpuPlacement("sibling_pairs"), CpuPlacement::kSiblingPairs);
+  EXPECT_FALSE(ParseCpuPlacement("nope").ok());
+}
+
+TEST(AssignCpus, Shuffle) {
+  const CpuTopology topology =
+      CpuTopology::Read(kAllCpus, MakeFakeSysfs("Shuffle"));
+  std::mt19937_64 gen(0);
+  const auto lists = AssignCpus(topology, CpuPlacement::kShuffle, 3, gen);
+  EXPECT_EQ(lists.size(), 3);
+  EXPECT_EQ(Flatten(lists), kAllCpus);
+}
+
+TEST(AssignCpus, OnePerCore) {
+  const CpuTopology topology =
+      CpuTopology::Read(kAllCpus, MakeFakeSysfs("OnePerCore"));
+  std::mt19937_64 gen(0);
+  const auto lists = AssignCpus(topology, CpuPlacement::kOnePerCore, 8, gen);
+  // At most one thread per core.
+  ASSERT_EQ(lists.size(), 4);
+  EXPECT_EQ(Flatten(lists), kAllCpus);
+  for (const std::vector<int>& list : lists) {
+    EXPECT_THAT(list, UnorderedElementsAreArray(
+                          topology.cores()[topology.CoreOf(list[0])].cpus));
+  }
+}
+
+TEST(AssignCpus, SiblingPairs) {
+  const CpuTopology topology =
+      CpuTopology::Read(kAllCpus, MakeFakeSysfs("SiblingPairs"));
+  std::mt19937_64 gen(0);
+  const auto lists = AssignCpus(topology, CpuPlacement::kSiblingPairs, 4, gen);
+  ASSERT_EQ(lists.size(), 4);
+  EXPECT_EQ(Flatten(lists), kAllCpus);
+  for (int pair = 0; pair < 2; ++pair) {
+    const std::vector<int>& first = lists[2 * pair];
+    const std::vector<int>& second = lists[2 * pair + 1];
+    ASSERT_EQ(first.size(), second.size());
+    // Both threads of a pair visit the same cores in the same order.
+    for (int i = 0; i < first.size(); ++i) {
+      EXPECT_NE(first[i], second[i]);
+      EXPECT_EQ(topology.CoreOf(first[i]), topology.CoreOf(second[i]));
+    }
+  }
+}
+
+TEST(AssignCpus, SpreadL3) {
+  const CpuTopology topology =
+      CpuTopology::Read(kAllCpus, MakeFakeSysfs("SpreadL3"));
+  std::mt19937_64 gen(0);
+  for (size_t num_threads : {1, 2, 3, 4}) {
+    const auto lists =
+        AssignCpus(topology, CpuPlacement::kSpreadL3, num_threads, gen);
+    EXPECT_EQ(lists.size(), num_threads);
+    EXPECT_EQ(Flatten(lists), kAllCpus);
+    // No thread crosses an L3 domain unless it owns whole domains.
+    if (num_threads >= 2) {
+      for (const std::vector<int>& list : lists) {
+        const int domain = topology.cores()[topology.CoreOf(list[0])].l3_domain;
+        for (int cpu : list) {
+          EXPECT_EQ(topology.cores()[topology.CoreOf(cpu)].l3_domain, domain);
+        }
+      }
+    }
+  }
+}
+
+TEST(CoreCoverage, ToProto) {
+  const CpuTopology topology =
+      CpuTopology::Read(kAllCpus, MakeFakeSysfs("CoreCoverage"));
+  CoreCoverage coverage(topology);
+  coverage.Record(1, absl::Seconds(1));
+  coverage.Record(5, absl::Seconds(2));
+  coverage.Record(42, absl::Seconds(3));
+  const std::vector<proto::logging::CoreCoverage> table = coverage.ToProto();
+  ASSERT_EQ(table.size(), 4);
+  EXPECT_EQ(table[0].num_runs(), 0);
+  EXPECT_EQ(table[1].core_id(), 1);
+  EXPECT_THAT(table[1].cpus(), ElementsAre(1, 5));
+  EXPECT_EQ(table[1].num_runs(), 2);
+  EXPECT_EQ(table[1].cpu_time().seconds(), 3);
+}
+
+}  // namespace
+}  // namespace silifuzz
@@ -0,0 +1,126 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./orchestrator/failure_confirmation.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "./proto/snapshot_execution_result.pb.h"
+#include "./runner/driver/runner_driver.h"
+#include "./util/checks.h"
+
+namespace silifuzz {
+
+namespace {
+
+// Plays the snapshot `num_attempts` times on `cpu` and records the outcome.
+proto::FailureConfirmation::CpuReplay Replay(
+    int cpu, int num_attempts, FailureConfirmer::ReplayFn replay) {
+  proto::FailureConfirmation::CpuReplay cpu_replay;
+  cpu_replay.set_cpu(cpu);
+  cpu_replay.set_num_attempts(num_attempts);
+  int num_failures = 0;
+  for (int i = 0; i < num_attempts; ++i) {
+    num_failures += replay(cpu);
+  }
+  cpu_replay.set_num_failures(num_failures);
+  return cpu_replay;
+}
+
+}  // namespace
+
+FailureConfirmer::FailureConfirmer(const std::vector<int>& cpus,
+                                   const Options& options, uint64_t seed)
+    : cpus_(cpus), options_(options), random_(seed) {
+  CHECK_GT(options_.num_attempts, 0);
+  CHECK_GE(options_.num_other_cpus, 0);
+  CHECK_GT(options_.num_other_cpu_attempts, 0);
+}
+
+proto::FailureConfirmation FailureConfirmer::Confirm(
+    const RunnerDriver& driver, absl::string_view snap_id, int cpu) {
+  return Confirm(snap_id, cpu, [&driver, snap_id](int cpu) {
+    RunnerDriver::RunResult result = driver.PlayOne(snap_id, cpu);
+    return !result.success() && result.has_failed_player_result();
+  });
+}
+
+proto::FailureConfirmation FailureConfirmer::Confirm(absl::string_view snap_id,
+                                                     int cpu, ReplayFn replay) {
+  proto::FailureConfirmation confirmation;
+  std::vector<int> other_cpus;
+  {
+    absl::MutexLock l(&mu_);
+    if (auto it = global_.find(snap_id); it != global_.end()) {
+      return it->second;
+    }
+    if (quarantined_.contains(cpu)) {
+      // Runners that were already running on the CPU keep reporting.
+      confirmation.set_quarantined(true);
+      return confirmation;
+    }
+    for (int other_cpu : cpus_) {
+      if (other_cpu != cpu && !quarantined_.contains(other_cpu)) {
+        other_cpus.push_back(other_cpu);
+      }
+    }
+    std::shuffle(other_cpus.begin(), other_cpus.end(), random_);
+  }
+  if (other_cpus.size() > static_cast<size_t>(options_.num_other_cpus)) {
+    other_cpus.resize(options_.num_other_cpus);
+  }
+
+  *confirmation.mutable_failing_cpu() =
+      Replay(cpu, options_.num_attempts, replay);
+  bool reproduced_elsewhere = false;
+  for (int other_cpu : other_cpus) {
+    proto::FailureConfirmation::CpuReplay& cpu_replay =
+        *confirmation.add_other_cpus() =
+            Replay(other_cpu, options_.num_other_cpu_attempts, replay);
+    reproduced_elsewhere |= cpu_replay.num_failures() > 0;
+  }
+
+  absl::MutexLock l(&mu_);
+  if (reproduced_elsewhere) {
+    confirmation.set_verdict(proto::FailureConfirmation::GLOBAL);
+    global_.try_emplace(std::string(snap_id), confirmation);
+  } else if (confirmation.failing_cpu().num_failures() == 0) {
+    confirmation.set_verdict(proto::FailureConfirmation::FLAKY);
+  } else if (!other_cpus.empty()) {
+    confirmation.set_verdict(proto::FailureConfirmation::CORE_LOCAL);
+    quarantined_.insert(cpu);
+    confirmation.set_quarantined(true);
+  }
+  // Otherwise there was no other CPU to compare with and the verdict stays
+  // UNCONFIRMED.
+  return confirmation;
+}
+
+bool FailureConfirmer::IsQuarantined(int cpu) const {
+  absl::MutexLock l(&mu_);
+  return quarantined_.contains(cpu);
+}
+
+int FailureConfirmer::num_quarantined() const {
+  absl::MutexLock l(&mu_);
+  return quarantined_.size();
+}
+
+}  // namespace silifuzz
@@ -0,0 +1,105 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_SILIFUZZ_ORCHESTRATOR_FAILURE_CONFIRMATION_H_
+#define THIRD_PARTY_SILIFUZZ_ORCHESTRATOR_FAILURE_CONFIRMATION_H_
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/functional/function_ref.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "./proto/snapshot_execution_result.pb.h"
+#include "./runner/driver/runner_driver.h"
+
+namespace silifuzz {
+
+// FailureConfirmer replays snapshots that failed during scanning to tell
+// defective cores from flaky failures and from bad snapshots.
+//
+// The snapshot is played Options::num_attempts times on the CPU that reported
+// the failure and Options::num_other_cpu_attempts times on each of up to
+// Options::num_other_cpus randomly picked other CPUs. A failure that
+// reproduces only on the reporting CPU is CORE_LOCAL and the CPU is
+// quarantined: IsQuarantined() returns true and workers stop scanning it. A
+// failure that reproduces elsewhere is GLOBAL and is not replayed again, a
+// failure that does not reproduce at all is FLAKY.
+//
+// This class is thread-safe.
+class FailureConfirmer {
+ public:
+  struct Options {
+    // Number of times the snapshot is played on the reporting CPU.
+    int num_attempts = 20;
+
+    // Number of other CPUs the snapshot is played on.
+    int num_other_cpus = 3;
+
+    // Number of times the snapshot is played on each of the other CPUs.
+    int num_other_cpu_attempts = 5;
+  };
+
+  // Plays the failed snapshot once on `cpu`. Returns true if it failed.
+  using ReplayFn = absl::FunctionRef<bool(int cpu)>;
+
+  // `cpus` are all the CPUs being scanned.
+  FailureConfirmer(const std::vector<int>& cpus, const Options& options,
+                   uint64_t seed);
+
+  // Not copyable or moveable -- not just a data holder.
+  FailureConfirmer(const FailureConfirmer&) = delete;
+  FailureConfirmer(FailureConfirmer&&) = delete;
+  FailureConfirmer& operator=(const FailureConfirmer&) = delete;
+  FailureConfirmer& operator=(FailureConfirmer&&) = delete;
+
+  // Replays `snap_id` that failed on `cpu` using `driver`, which must be able
+  // to play snapshots from the corpus that contains `snap_id`.
+  proto::FailureConfirmation Confirm(const RunnerDriver& driver,
+                                     absl::string_view snap_id, int cpu);
+
+  // Same as above with a custom `replay` function. Exposed for testing.
+  proto::FailureConfirmation Confirm(absl::string_view snap_id, int cpu,
+                                     ReplayFn replay);
+
+  // Tests if `cpu` was withdrawn from scanning.
+  bool IsQuarantined(int cpu) const;
+
+  // Returns the number of quarantined CPUs.
+  int num_quarantined() const;
+
+ private:
+  const std::vector<int> cpus_;
+  const Options options_;
+
+  mutable absl::Mutex mu_;
+
+  // CPUs with CORE_LOCAL failures.
+  absl::flat_hash_set<int> quarantined_ ABSL_GUARDED_BY(mu_);
+
+  // Confirmations of GLOBAL failures by snapshot ID.
+  absl::flat_hash_map<std::string, proto::FailureConfirmation> global_
+      ABSL_GUARDED_BY(mu_);
+
+  std::mt19937_64 random_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace silifuzz
+
+#endif  // THIRD_PARTY_SILIFUZZ_ORCHESTRATOR_FAILURE_CONFIRMATION_H_
@@ -0,0 +1,105 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./orchestrator/failure_confirmation.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "./proto/snapshot_execution_result.pb.h"
+
+namespace silifuzz {
+namespace {
+
+using Verdict = proto::FailureConfirmation::Verdict;
+
+FailureConfirmer::Options TestOptions() {
+  return {.num_attempts = 4, .num_other_cpus = 2, .num_other_cpu_attempts = 3};
+}
+
+TEST(FailureConfirmer, CoreLocal) {
+  FailureConfirmer confirmer({0, 1, 2, 3}, TestOptions(), 0);
+  std::vector<int> replayed_cpus;
+  proto::FailureConfirmation confirmation =
+      confirmer.Confirm("snap", 2, [&](int cpu) {
+        replayed_cpus.push_back(cpu);
+        return cpu == 2;
+      });
+  EXPECT_EQ(confirmation.verdict(), proto::FailureConfirmation::CORE_LOCAL);
+  EXPECT_TRUE(confirmation.quarantined());
+  EXPECT_EQ(confirmation.failing_cpu().cpu(), 2);
+  EXPECT_EQ(confirmation.failing_cpu().num_attempts(), 4);
+  EXPECT_EQ(confirmation.failing_cpu().num_failures(), 4);
+  ASSERT_EQ(confirmation.other_cpus_size(), 2);
+  for (const auto& other : confirmation.other_cpus()) {
+    EXPECT_NE(other.cpu(), 2);
+    EXPECT_EQ(other.num_attempts(), 3);
+    EXPECT_EQ(other.num_failures(), 0);
+  }
+  EXPECT_EQ(replayed_cpus.size(), 4 + 2 * 3);
+  EXPECT_TRUE(confirmer.IsQuarantined(2));
+  EXPECT_FALSE(confirmer.IsQuarantined(0));
+
+  // Further failures on a quarantined CPU are not replayed.
+  replayed_cpus.clear();
+  confirmation = confirmer.Confirm("snap", 2, [&](int cpu) {
+    replayed_cpus.push_back(cpu);
+    return true;
+  });
+  EXPECT_EQ(confirmation.verdict(), proto::FailureConfirmation::UNCONFIRMED);
+  EXPECT_TRUE(confirmation.quarantined());
+  EXPECT_TRUE(replayed_cpus.empty());
+  EXPECT_EQ(confirmer.num_quarantined(), 1);
+}
+
+TEST(FailureConfirmer, Flaky) {
+  FailureConfirmer confirmer({0, 1}, TestOptions(), 0);
+  proto::FailureConfirmation confirmation =
+      confirmer.Confirm("snap", 0, [](int cpu) { return false; });
+  EXPECT_EQ(confirmation.verdict(), proto::FailureConfirmation::FLAKY);
+  EXPECT_FALSE(confirmation.quarantined());
+  EXPECT_EQ(confirmer.num_quarantined(), 0);
+}
+
+TEST(FailureConfirmer, Global) {
+  FailureConfirmer confirmer({0, 1, 2}, TestOptions(), 0);
+  int num_replays = 0;
+  auto replay = [&](int cpu) {
+    ++num_replays;
+    return true;
+  };
+  proto::FailureConfirmation confirmation =
+      confirmer.Confirm("snap", 0, replay);
+  EXPECT_EQ(confirmation.verdict(), proto::FailureConfirmation::GLOBAL);
+  EXPECT_FALSE(confirmation.quarantined());
+  EXPECT_FALSE(confirmer.IsQuarantined(0));
+
+  // Known bad snapshots are not replayed again.
+  num_replays = 0;
+  confirmation = confirmer.Confirm("snap", 1, replay);
+  EXPECT_EQ(confirmation.verdict(), proto::FailureConfirmation::GLOBAL);
+  EXPECT_EQ(num_replays, 0);
+}
+
+TEST(FailureConfirmer, NoOtherCpus) {
+  FailureConfirmer confirmer({0}, TestOptions(), 0);
+  proto::FailureConfirmation confirmation =
+      confirmer.Confirm("snap", 0, [](int cpu) { return true; });
+  EXPECT_EQ(confirmation.verdict(), proto::FailureConfirmation::UNCONFIRMED);
+  EXPECT_EQ(confirmation.failing_cpu().num_failures(), 4);
+  EXPECT_FALSE(confirmer.IsQuarantined(0));
+}
+
+}  // namespace
+}  // namespace silifuzz
@@ -0,0 +1,116 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./orchestrator/memory_admission.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "./proto/session_summary.pb.h"
+#include "./util/checks.h"
+
+namespace silifuzz {
+
+MemoryAdmissionController::MemoryAdmissionController(
+    const std::vector<uint64_t>& shard_sizes, const Options& options)
+    : shard_sizes_(shard_sizes),
+      options_(options),
+      peak_rss_(shard_sizes.size(), 0) {
+  CHECK(!shard_sizes_.empty());
+  CHECK_GE(options_.safety_factor, 1.0);
+}
+
+std::optional<MemoryAdmissionController::Reservation>
+MemoryAdmissionController::Admit(int shard_idx, absl::Duration timeout) {
+  absl::MutexLock l(&mu_);
+  const auto fits = [this, shard_idx]() ABSL_SHARED_LOCKS_REQUIRED(mu_) {
+    return num_admitted_ == 0 ||
+           reserved_bytes_ + EstimateLocked(shard_idx) <=
+               options_.memory_limit_bytes;
+  };
+  if (!fits()) {
+    ++num_deferred_;
+    if (timeout <= absl::ZeroDuration() ||
+        !mu_.AwaitWithTimeout(absl::Condition(&fits), timeout)) {
+      return std::nullopt;
+    }
+  }
+  const Reservation reservation = {.shard_idx = shard_idx,
+                                   .bytes = EstimateLocked(shard_idx)};
+  reserved_bytes_ += reservation.bytes;
+  ++num_admitted_;
+  max_num_admitted_ = std::max(max_num_admitted_, num_admitted_);
+  max_reserved_bytes_ = std::max(max_reserved_bytes_, reserved_bytes_);
+  return reservation;
+}
+
+void MemoryAdmissionController::Release(const Reservation& reservation,
+                                        uint64_t peak_rss_bytes) {
+  absl::MutexLock l(&mu_);
+  CHECK_GT(num_admitted_, 0);
+  CHECK_GE(reserved_bytes_, reservation.bytes);
+  reserved_bytes_ -= reservation.bytes;
+  --num_admitted_;
+  if (peak_rss_bytes == 0) {
+    return;
+  }
+  if (peak_rss_bytes > reservation.bytes) {
+    // The runner used more memory than projected. The limit may have been
+    // exceeded for a while.
+    ++num_underestimated_;
+  }
+  max_peak_rss_bytes_ = std::max(max_peak_rss_bytes_, peak_rss_bytes);
+  uint64_t& peak_rss = peak_rss_[reservation.shard_idx];
+  peak_rss = std::max(peak_rss, peak_rss_bytes);
+  const uint64_t shard_size = shard_sizes_[reservation.shard_idx];
+  const uint64_t overhead =
+      peak_rss_bytes > shard_size ? peak_rss_bytes - shard_size : 0;
+  runner_overhead_ = std::max(runner_overhead_.value_or(0), overhead);
+}
+
+uint64_t MemoryAdmissionController::Estimate(int shard_idx) const {
+  absl::ReaderMutexLock l(&mu_);
+  return EstimateLocked(shard_idx);
+}
+
+uint64_t MemoryAdmissionController::EstimateLocked(int shard_idx) const {
+  if (peak_rss_[shard_idx] != 0) {
+    return static_cast<uint64_t>(peak_rss_[shard_idx] *
+                                 options_.safety_factor);
+  }
+  if (runner_overhead_.has_value()) {
+    return static_cast<uint64_t>(
+        (*runner_overhead_ + shard_sizes_[shard_idx]) * options_.safety_factor);
+  }
+  return std::max(options_.initial_runner_estimate_bytes,
+                  shard_sizes_[shard_idx]);
+}
+
+proto::logging::MemoryAdmission MemoryAdmissionController::ToProto() const {
+  absl::ReaderMutexLock l(&mu_);
+  proto::logging::MemoryAdmission summary;
+  summary.set_memory_limit_bytes(options_.memory_limit_bytes);
+  summary.set_max_admitted_runners(max_num_admitted_);
+  summary.set_max_reserved_bytes(max_reserved_bytes_);
+  summary.set_max_runner_rss_bytes(max_peak_rss_bytes_);
+  summary.set_num_deferred_launches(num_deferred_);
+  summary.set_num_underestimated_runners(num_underestimated_);
+  return summary;
+}
+
+}  // namespace silifuzz
@@ -0,0 +1,124 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_SILIFUZZ_ORCHESTRATOR_MEMORY_ADMISSION_H_
+#define THIRD_PARTY_SILIFUZZ_ORCHESTRATOR_MEMORY_ADMISSION_H_
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "./proto/session_summary.pb.h"
+
+namespace silifuzz {
+
+// MemoryAdmissionController decides whether another runner can be started
+// without exceeding the memory limit of the orchestrator.
+//
+// Every runner holds a reservation of its projected peak RSS while it runs.
+// The projection is learned per shard from the peak RSS of past runners of
+// that shard. Shards that have not finished a run yet are projected from the
+// shard size plus the largest runner overhead (peak RSS minus shard size)
+// measured so far, or Options::initial_runner_estimate_bytes before any
+// measurement arrives. A new runner is admitted only while the sum of all
+// reservations fits in Options::memory_limit_bytes, so concurrency starts
+// conservatively and ramps up as the model learns how small runners are.
+//
+// A single runner is always admitted when nothing else is running. Otherwise
+// an oversized shard would stall all the workers.
+//
+// This class is thread-safe.
+class MemoryAdmissionController {
+ public:
+  struct Options {
+    // Memory available to all runners together.
+    uint64_t memory_limit_bytes = 0;
+
+    // Projected peak RSS of a runner before any measurement is available.
+    uint64_t initial_runner_estimate_bytes = uint64_t{512} << 20;
+
+    // Measured peak RSS is multiplied by this factor to account for variance
+    // between runs of the same shard.
+    double safety_factor = 1.25;
+  };
+
+  // Memory reserved for a single admitted runner.
+  struct Reservation {
+    int shard_idx;
+    uint64_t bytes;
+  };
+
+  // `shard_sizes` are the sizes of the corpus shards in bytes, indexed by
+  // shard_idx.
+  MemoryAdmissionController(const std::vector<uint64_t>& shard_sizes,
+                            const Options& options);
+
+  // Not copyable or moveable -- not just a data holder.
+  MemoryAdmissionController(const MemoryAdmissionController&) = delete;
+  MemoryAdmissionController(MemoryAdmissionController&&) = delete;
+  MemoryAdmissionController& operator=(const MemoryAdmissionController&) =
+      delete;
+  MemoryAdmissionController& operator=(MemoryAdmissionController&&) = delete;
+
+  // Reserves memory for a runner of `shard_idx`. Waits up to `timeout` for
+  // other runners to release enough memory. Returns nullopt if the runner
+  // still does not fit.
+  std::optional<Reservation> Admit(
+      int shard_idx, absl::Duration timeout = absl::ZeroDuration());
+
+  // Releases `reservation` once the runner exited and records its
+  // `peak_rss_bytes`. Pass 0 when the peak RSS is unknown, e.g. when the
+  // runner could not be started.
+  void Release(const Reservation& reservation, uint64_t peak_rss_bytes);
+
+  // Returns the projected peak RSS of a runner of `shard_idx`.
+  uint64_t Estimate(int shard_idx) const;
+
+  // Returns the counters collected so far.
+  proto::logging::MemoryAdmission ToProto() const;
+
+ private:
+  uint64_t EstimateLocked(int shard_idx) const
+      ABSL_SHARED_LOCKS_REQUIRED(mu_);
+
+  const std::vector<uint64_t> shard_sizes_;
+  const Options options_;
+
+  mutable absl::Mutex mu_;
+
+  // Largest measured peak RSS per shard, 0 if never measured.
+  std::vector<uint64_t> peak_rss_ ABSL_GUARDED_BY(mu_);
+
+  // Largest measured peak RSS minus shard size over all shards or nullopt if
+  // nothing was measured yet.
+  std::optional<uint64_t> runner_overhead_ ABSL_GUARDED_BY(mu_);
+
+  // Sum of all outstanding reservations.
+  uint64_t reserved_bytes_ ABSL_GUARDED_BY(mu_) = 0;
+  int num_admitted_ ABSL_GUARDED_BY(mu_) = 0;
+
+  // Counters reported by ToProto().
+  int max_num_admitted_ ABSL_GUARDED_BY(mu_) = 0;
+  uint64_t max_reserved_bytes_ ABSL_GUARDED_BY(mu_) = 0;
+  uint64_t max_peak_rss_bytes_ ABSL_GUARDED_BY(mu_) = 0;
+  uint64_t num_deferred_ ABSL_GUARDED_BY(mu_) = 0;
+  uint64_t num_underestimated_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace silifuzz
+
+#endif  // THIRD_PARTY_SILIFUZZ_ORCHESTRATOR_MEMORY_ADMISSION_H_
@@ -0,0 +1,92 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./orchestrator/memory_admission.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "./proto/session_summary.pb.h"
+
+namespace silifuzz {
+namespace {
+
+constexpr uint64_t kMb = 1 << 20;
+
+using Reservation = MemoryAdmissionController::Reservation;
+
+TEST(MemoryAdmissionController, InitialEstimate) {
+  MemoryAdmissionController controller(
+      {10 * kMb, 600 * kMb},
+      {.memory_limit_bytes = 1024 * kMb,
+       .initial_runner_estimate_bytes = 512 * kMb});
+  EXPECT_EQ(controller.Estimate(0), 512 * kMb);
+  EXPECT_EQ(controller.Estimate(1), 600 * kMb);
+
+  std::optional<Reservation> r1 = controller.Admit(0);
+  ASSERT_TRUE(r1.has_value());
+  std::optional<Reservation> r2 = controller.Admit(0);
+  ASSERT_TRUE(r2.has_value());
+  EXPECT_FALSE(controller.Admit(0).has_value());
+  controller.Release(*r1, 0);
+  controller.Release(*r2, 0);
+
+  proto::logging::MemoryAdmission summary = controller.ToProto();
+  EXPECT_EQ(summary.max_admitted_runners(), 2);
+  EXPECT_EQ(summary.num_deferred_launches(), 1);
+  EXPECT_EQ(summary.max_reserved_bytes(), 1024 * kMb);
+}
+
+TEST(MemoryAdmissionController, RampsUpWithMeasurements) {
+  MemoryAdmissionController controller(
+      {10 * kMb, 20 * kMb},
+      {.memory_limit_bytes = 1024 * kMb,
+       .initial_runner_estimate_bytes = 512 * kMb,
+       .safety_factor = 1.0});
+  std::optional<Reservation> r = controller.Admit(0);
+  ASSERT_TRUE(r.has_value());
+  controller.Release(*r, 50 * kMb);
+  EXPECT_EQ(controller.Estimate(0), 50 * kMb);
+  // Unmeasured shards are projected from the measured runner overhead.
+  EXPECT_EQ(controller.Estimate(1), 60 * kMb);
+
+  std::vector<Reservation> reservations;
+  while (std::optional<Reservation> r = controller.Admit(0)) {
+    reservations.push_back(*r);
+  }
+  EXPECT_EQ(reservations.size(), 20);
+  for (const Reservation& r : reservations) {
+    controller.Release(r, 40 * kMb);
+  }
+  // The model keeps the largest measurement.
+  EXPECT_EQ(controller.Estimate(0), 50 * kMb);
+  EXPECT_EQ(controller.ToProto().max_admitted_runners(), 20);
+}
+
+TEST(MemoryAdmissionController, AlwaysAdmitsOne) {
+  MemoryAdmissionController controller(
+      {4096 * kMb}, {.memory_limit_bytes = 1024 * kMb});
+  std::optional<Reservation> r = controller.Admit(0);
+  ASSERT_TRUE(r.has_value());
+  EXPECT_FALSE(controller.Admit(0, absl::Milliseconds(10)).has_value());
+  controller.Release(*r, 5000 * kMb);
+  EXPECT_EQ(controller.ToProto().num_underestimated_runners(), 1);
+  EXPECT_TRUE(controller.Admit(0).has_value());
+}
+
+}  // namespace
+}  // namespace silifuzz
@@ -37,6 +37,9 @@ struct Statm {
 struct OrchestratorResources {
   uint64_t num_concurrent_runners;
   std::vector<std::string> shards;
+
+  // Memory limit of the orchestrator and all runners or 0 if unlimited.
+  uint64_t memory_usage_limit_mb = 0;
 };
 
 // Returns max RSS of the immediate children of `pid` as reported by the
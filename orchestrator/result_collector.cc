@@ -23,6 +23,7 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "google/protobuf/duration.pb.h"
 #include "google/protobuf/timestamp.pb.h"
@@ -176,9 +177,18 @@ ResultCollector::ResultCollector(int binary_log_channel_fd,
 }
 
 // Processes a single execution result.
-bool ResultCollector::operator()(const RunnerDriver::RunResult &result) {
+bool ResultCollector::operator()(
+    const RunnerDriver::RunResult &result,
+    const proto::FailureConfirmation *confirmation) {
   ++summary_.play_count;
   max_rss_kb_ = std::max(max_rss_kb_, MaxRunnerRssSizeBytes(getpid()) / 1024);
+  for (const std::string &id : result.excluded_snapshot_ids()) {
+    // Every runner of the shard reports the same snapshots, log them once.
+    if (excluded_snapshot_ids_.insert(id).second) {
+      LOG_ERROR("Runner excluded snapshot ", id,
+                ": its memory mappings conflict with the runner's");
+    }
+  }
   bool should_stop = false;
   if (!result.success()) {
     if (!result.execution_result().ok()) {
@@ -199,6 +209,13 @@ bool ResultCollector::operator()(const RunnerDriver::RunResult &result) {
       LogV1SingleSnapFailure(result);
       absl::StatusOr<proto::BinaryLogEntry> entry =
           RunResultToSnapshotExecutionResult(result, absl::Now(), session_id_);
+      if (entry.ok() && confirmation != nullptr) {
+        *entry->mutable_snapshot_execution_result()->mutable_confirmation() =
+            *confirmation;
+        if (confirmation->verdict() == proto::FailureConfirmation::CORE_LOCAL) {
+          ++summary_.num_core_local_failures;
+        }
+      }
       if (entry.ok()) {
         if (binary_log_producer_) {
           if (absl::Status s = binary_log_producer_->Send(*entry); !s.ok()) {
@@ -253,7 +270,10 @@ absl::Status ResultCollector::LogSessionStart(
 
 absl::Status ResultCollector::LogSessionSummary(
     const proto::CorpusMetadata &corpus_metadata,
-    absl::string_view orchestrator_version) {
+    absl::string_view orchestrator_version,
+    const std::vector<proto::logging::ShardCost> &shard_costs,
+    const proto::logging::MemoryAdmission *memory_admission,
+    const std::vector<proto::logging::CoreCoverage> &core_coverage) {
   if (binary_log_producer_ == nullptr) {
     return absl::OkStatus();
   }
@@ -274,6 +294,11 @@ absl::Status ResultCollector::LogSessionSummary(
   playback_summary->set_num_failed_snapshots(summary_.num_failed_snapshots);
   playback_summary->set_play_count(summary_.play_count);
   playback_summary->set_num_runaway_snapshots(summary_.num_runaway_snapshots);
+  playback_summary->set_num_core_local_failures(
+      summary_.num_core_local_failures);
+  for (const std::string &id : excluded_snapshot_ids_) {
+    playback_summary->add_excluded_snapshot_id(id);
+  }
 
   *entry.mutable_session_summary()->mutable_duration() =
       DurationToProto(now - start_time_);
@@ -288,6 +313,16 @@ absl::Status ResultCollector::LogSessionSummary(
       std::string(ShortHostname()));
 
   *entry.mutable_session_summary()->mutable_corpus_metadata() = corpus_metadata;
+  for (const proto::logging::ShardCost &shard_cost : shard_costs) {
+    *entry.mutable_session_summary()->add_shard_cost() = shard_cost;
+  }
+  if (memory_admission != nullptr) {
+    *entry.mutable_session_summary()->mutable_memory_admission() =
+        *memory_admission;
+  }
+  for (const proto::logging::CoreCoverage &core : core_coverage) {
+    *entry.mutable_session_summary()->add_core_coverage() = core;
+  }
 
   return binary_log_producer_->Send(entry);
 }
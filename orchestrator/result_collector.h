@@ -20,12 +20,16 @@
 #include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "absl/container/btree_set.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "./orchestrator/binary_log_channel.h"
 #include "./proto/corpus_metadata.pb.h"
+#include "./proto/session_summary.pb.h"
+#include "./proto/snapshot_execution_result.pb.h"
 #include "./runner/driver/runner_driver.h"
 
 namespace silifuzz {
@@ -40,6 +44,9 @@ struct Summary {
 
   // Number of runaways detected.
   uint64_t num_runaway_snapshots = 0;
+
+  // Number of failures confirmed as CORE_LOCAL by FailureConfirmer.
+  uint64_t num_core_local_failures = 0;
 };
 
 // ResultCollector handles execution results produced by worker threads. When
@@ -64,10 +71,23 @@ class ResultCollector {
 
   // Processes a single execution result. Returns true if the orchestrator
   // should stop.
-  bool operator()(const RunnerDriver::RunResult &result);
+  bool operator()(const RunnerDriver::RunResult &result) {
+    return (*this)(result, nullptr);
+  }
+
+  // Same as above. When not null, `confirmation` is the outcome of replaying
+  // the failed snapshot and is logged with the failure.
+  bool operator()(const RunnerDriver::RunResult &result,
+                  const proto::FailureConfirmation *confirmation);
   // Current execution summary.
   const Summary &summary() const { return summary_; }
 
+  // IDs of the snapshots that any runner reported as excluded because their
+  // memory mappings conflict with the runner's own.
+  const absl::btree_set<std::string> &excluded_snapshot_ids() const {
+    return excluded_snapshot_ids_;
+  }
+
   // Logs the current execution summary to stderr. When `always` is true,
   // disables time-based throttling.
   void LogSummary(bool always = false);
@@ -76,9 +96,16 @@ class ResultCollector {
   absl::Status LogSessionStart(const proto::CorpusMetadata &corpus_metadata,
                                absl::string_view orchestrator_version);
 
-  // Logs session summary to binary_log_channel (if any).
-  absl::Status LogSessionSummary(const proto::CorpusMetadata &corpus_metadata,
-                                 absl::string_view orchestrator_version);
+  // Logs session summary to binary_log_channel (if any). `shard_costs` is the
+  // table learned by ShardScheduler, empty if adaptive scheduling is off.
+  // `memory_admission` holds the MemoryAdmissionController counters, if any.
+  // `core_coverage` is the per-physical-core tally from CoreCoverage.
+  absl::Status LogSessionSummary(
+      const proto::CorpusMetadata &corpus_metadata,
+      absl::string_view orchestrator_version,
+      const std::vector<proto::logging::ShardCost> &shard_costs = {},
+      const proto::logging::MemoryAdmission *memory_admission = nullptr,
+      const std::vector<proto::logging::CoreCoverage> &core_coverage = {});
 
  private:
   std::unique_ptr<BinaryLogProducer> binary_log_producer_;
@@ -89,6 +116,7 @@ class ResultCollector {
   Options options_;
   std::string session_id_;
   uint64_t max_rss_kb_ = 0;
+  absl::btree_set<std::string> excluded_snapshot_ids_;
 };
 
 }  // namespace silifuzz
@@ -16,7 +16,11 @@
 
 #include <unistd.h>
 
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
+#include "gmock/gmock.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/clock.h"
 #include "./orchestrator/binary_log_channel.h"
@@ -36,6 +40,13 @@ class RunResultPeer {
         RunnerDriver::ExecutionResult::SnapshotFailed(snapshot_id), result, {},
         snapshot_id);
   }
+
+  static RunnerDriver::RunResult SuccessfulWithExclusions(
+      const std::vector<std::string>& excluded_snapshot_ids) {
+    RunnerDriver::RunResult result = RunnerDriver::RunResult::Successful({});
+    result.excluded_snapshot_ids_ = excluded_snapshot_ids;
+    return result;
+  }
 };
 
 namespace {
@@ -64,6 +75,44 @@ TEST(ResultCollector, BinaryLogging) {
   ASSERT_EQ(fd_log_entry.snapshot_execution_result().snapshot_id(), "snap_id");
 }
 
+TEST(ResultCollector, FailureConfirmation) {
+  int pipefd[2] = {-1, -1};
+  ASSERT_EQ(pipe(pipefd), 0);
+  {
+    ResultCollector collector(pipefd[1], absl::Now(), {});
+    proto::FailureConfirmation confirmation;
+    confirmation.set_verdict(proto::FailureConfirmation::CORE_LOCAL);
+    confirmation.mutable_failing_cpu()->set_cpu(3);
+    collector(RunResultPeer::SnapshotFailed("snap_id"), &confirmation);
+    ASSERT_EQ(collector.summary().num_core_local_failures, 1);
+  }
+  BinaryLogConsumer consumer(pipefd[0]);
+  ASSERT_OK_AND_ASSIGN(proto::BinaryLogEntry fd_log_entry, consumer.Receive());
+  const proto::FailureConfirmation& logged =
+      fd_log_entry.snapshot_execution_result().confirmation();
+  EXPECT_EQ(logged.verdict(), proto::FailureConfirmation::CORE_LOCAL);
+  EXPECT_EQ(logged.failing_cpu().cpu(), 3);
+}
+
+TEST(ResultCollector, ExcludedSnapshots) {
+  int pipefd[2] = {-1, -1};
+  ASSERT_EQ(pipe(pipefd), 0);
+  {
+    ResultCollector collector(pipefd[1], absl::Now(), {});
+    collector(RunResultPeer::SuccessfulWithExclusions({"b", "a"}));
+    collector(RunResultPeer::SuccessfulWithExclusions({"a"}));
+    collector(RunnerDriver::RunResult::Successful({}));
+    EXPECT_THAT(collector.excluded_snapshot_ids(),
+                ::testing::ElementsAre("a", "b"));
+    ASSERT_OK(collector.LogSessionSummary({}, ""));
+  }
+  BinaryLogConsumer consumer(pipefd[0]);
+  ASSERT_OK_AND_ASSIGN(proto::BinaryLogEntry fd_log_entry, consumer.Receive());
+  EXPECT_THAT(
+      fd_log_entry.session_summary().playback_summary().excluded_snapshot_id(),
+      ::testing::ElementsAre("a", "b"));
+}
+
 }  // namespace
 
 }  // namespace silifuzz
@@ -0,0 +1,104 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the CPU overhead of the orchestrator when supervising N concurrent
+// runners with one RunnerThread each vs. a single RunnerSupervisor. The runner
+// is /bin/true so the measurement is dominated by process management.
+
+#include <sys/resource.h>
+
+#include <cstdint>
+#include <functional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "./orchestrator/corpus_util.h"
+#include "./orchestrator/silifuzz_orchestrator.h"
+#include "./runner/driver/runner_driver.h"
+
+namespace silifuzz {
+namespace {
+
+constexpr absl::Duration kSessionDuration = absl::Milliseconds(500);
+
+// CPU time used by this process, not including reaped children.
+absl::Duration SelfCpuTime() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return absl::DurationFromTimeval(usage.ru_utime) +
+         absl::DurationFromTimeval(usage.ru_stime);
+}
+
+void RunSession(benchmark::State& state, bool use_supervisor) {
+  const int num_runners = state.range(0);
+  InMemoryCorpora corpora;
+  corpora.shards.resize(1);
+  corpora.shards[0].name = "shard";
+  std::vector<RunnerThreadArgs> args;
+  for (int i = 0; i < num_runners; ++i) {
+    args.push_back({.thread_idx = i,
+                    .runner = "/bin/true",
+                    .corpora = &corpora,
+                    .cpus = {0}});
+  }
+
+  int64_t num_runs = 0;
+  absl::Duration cpu_time = absl::ZeroDuration();
+  for (auto s : state) {
+    ExecutionContext ctx(absl::Now() + kSessionDuration, num_runners,
+                         [&num_runs](const RunnerDriver::RunResult&) {
+                           ++num_runs;
+                           return false;
+                         });
+    const absl::Duration start_cpu_time = SelfCpuTime();
+    std::vector<std::thread> threads;
+    if (use_supervisor) {
+      threads.emplace_back(RunnerSupervisor, &ctx, std::cref(args));
+    } else {
+      for (const RunnerThreadArgs& a : args) {
+        threads.emplace_back(RunnerThread, &ctx, a);
+      }
+    }
+    ctx.EventLoop();
+    for (std::thread& t : threads) {
+      t.join();
+    }
+    ctx.ProcessResultQueue();
+    cpu_time += SelfCpuTime() - start_cpu_time;
+  }
+  state.SetItemsProcessed(num_runs);
+  state.counters["orchestrator_cpu_us_per_run"] =
+      num_runs > 0 ? absl::ToDoubleMicroseconds(cpu_time) / num_runs : 0;
+}
+
+void BM_RunnerThreads(benchmark::State& state) { RunSession(state, false); }
+
+void BM_RunnerSupervisor(benchmark::State& state) { RunSession(state, true); }
+
+BENCHMARK(BM_RunnerThreads)
+    ->RangeMultiplier(4)
+    ->Range(1, 256)
+    ->Iterations(3)
+    ->UseRealTime();
+BENCHMARK(BM_RunnerSupervisor)
+    ->RangeMultiplier(4)
+    ->Range(1, 256)
+    ->Iterations(3)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace silifuzz
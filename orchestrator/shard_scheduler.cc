@@ -0,0 +1,195 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./orchestrator/shard_scheduler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "./proto/session_summary.pb.h"
+#include "./util/checks.h"
+#include "./util/time_proto_util.h"
+
+namespace silifuzz {
+
+namespace {
+
+// A run that consumed at least this fraction of the CPU time budget is treated
+// as a timeout. The runner exits gracefully on SIGXCPU so a timeout looks
+// exactly like a successful run otherwise.
+constexpr double kTimeoutBudgetFraction = 0.9;
+
+}  // namespace
+
+ShardScheduler::ShardScheduler(const std::vector<std::string>& shard_names,
+                               const Options& options, uint64_t seed)
+    : shard_names_(shard_names),
+      options_(options),
+      stats_(shard_names.size()),
+      random_(seed) {
+  CHECK(!shard_names_.empty());
+  CHECK_GT(options_.probe_iterations, 0);
+  CHECK_GE(options_.max_iterations, options_.probe_iterations);
+  for (ShardStats& stats : stats_) {
+    stats.iteration_cap = options_.max_iterations;
+  }
+}
+
+int ShardScheduler::NextShard(int cpu) {
+  absl::MutexLock l(&mu_);
+  std::vector<int64_t>& coverage = coverage_[cpu];
+  if (coverage.empty()) {
+    coverage.resize(shard_names_.size(), 0);
+  }
+  // Pick uniformly among the least covered shards.
+  int selected = 0;
+  int num_ties = 0;
+  for (int i = 0; i < coverage.size(); ++i) {
+    if (num_ties == 0 || coverage[i] < coverage[selected]) {
+      selected = i;
+      num_ties = 1;
+    } else if (coverage[i] == coverage[selected]) {
+      ++num_ties;
+      if (random_() % num_ties == 0) {
+        selected = i;
+      }
+    }
+  }
+  return selected;
+}
+
+int64_t ShardScheduler::NumIterations(int shard_idx) const {
+  absl::ReaderMutexLock l(&mu_);
+  const ShardStats& stats = stats_[shard_idx];
+  const int64_t upper_bound = std::max(
+      options_.probe_iterations,
+      std::min(options_.max_iterations, stats.iteration_cap));
+  if (stats.n == 0) {
+    return std::min(options_.probe_iterations, upper_bound);
+  }
+  const ShardCostEstimate estimate = EstimateLocked(stats);
+  const double available_seconds = absl::ToDoubleSeconds(
+      options_.target_runner_cpu_time - estimate.startup_cpu_time);
+  const double num_iterations = available_seconds * estimate.snaps_per_second;
+  if (num_iterations <= options_.probe_iterations) {
+    return options_.probe_iterations;
+  }
+  if (num_iterations >= upper_bound) {
+    return upper_bound;
+  }
+  return static_cast<int64_t>(num_iterations);
+}
+
+void ShardScheduler::Record(int shard_idx, int cpu, int64_t num_iterations,
+                            absl::Duration cpu_time) {
+  absl::MutexLock l(&mu_);
+  ShardStats& stats = stats_[shard_idx];
+  ++stats.num_runs;
+  stats.num_iterations += num_iterations;
+  stats.cpu_time += cpu_time;
+  AddCoverageLocked(shard_idx, cpu, num_iterations);
+
+  if (options_.runner_cpu_time_budget != absl::InfiniteDuration() &&
+      cpu_time >= options_.runner_cpu_time_budget * kTimeoutBudgetFraction) {
+    // The runner did not finish `num_iterations`, the sample says nothing
+    // about the cost. Back off instead.
+    ++stats.num_timeouts;
+    stats.iteration_cap = std::max(options_.probe_iterations,
+                                   std::min(stats.iteration_cap,
+                                            num_iterations / 2));
+    return;
+  }
+  const double x = num_iterations;
+  const double y = absl::ToDoubleSeconds(cpu_time);
+  stats.n += 1;
+  stats.sum_x += x;
+  stats.sum_y += y;
+  stats.sum_xx += x * x;
+  stats.sum_xy += x * y;
+}
+
+void ShardScheduler::RecordCoverage(int shard_idx, int cpu,
+                                    int64_t num_iterations) {
+  absl::MutexLock l(&mu_);
+  AddCoverageLocked(shard_idx, cpu, num_iterations);
+}
+
+void ShardScheduler::AddCoverageLocked(int shard_idx, int cpu,
+                                       int64_t num_iterations) {
+  std::vector<int64_t>& coverage = coverage_[cpu];
+  if (coverage.empty()) {
+    coverage.resize(shard_names_.size(), 0);
+  }
+  coverage[shard_idx] += num_iterations;
+}
+
+ShardCostEstimate ShardScheduler::Estimate(int shard_idx) const {
+  absl::ReaderMutexLock l(&mu_);
+  return EstimateLocked(stats_[shard_idx]);
+}
+
+ShardCostEstimate ShardScheduler::EstimateLocked(
+    const ShardStats& stats) const {
+  ShardCostEstimate estimate;
+  if (stats.n == 0 || stats.sum_x == 0 || stats.sum_y == 0) {
+    return estimate;
+  }
+  // Least squares fit of y = startup + x / snaps_per_second.
+  const double denominator = stats.n * stats.sum_xx - stats.sum_x * stats.sum_x;
+  if (denominator > 1e-9 * stats.n * stats.sum_xx) {
+    const double slope =
+        (stats.n * stats.sum_xy - stats.sum_x * stats.sum_y) / denominator;
+    const double intercept = (stats.sum_y - slope * stats.sum_x) / stats.n;
+    if (slope > 0 && intercept >= 0) {
+      estimate.startup_cpu_time = absl::Seconds(intercept);
+      estimate.snaps_per_second = 1 / slope;
+      return estimate;
+    }
+  }
+  // All runs had the same length or the fit is nonsensical. Attribute all the
+  // cost to snap execution. This underestimates the throughput which is the
+  // safe direction.
+  estimate.snaps_per_second = stats.sum_xx / stats.sum_xy;
+  return estimate;
+}
+
+std::vector<proto::logging::ShardCost> ShardScheduler::ToProto() const {
+  absl::ReaderMutexLock l(&mu_);
+  std::vector<proto::logging::ShardCost> table;
+  for (int i = 0; i < stats_.size(); ++i) {
+    const ShardStats& stats = stats_[i];
+    if (stats.num_runs == 0) {
+      continue;
+    }
+    const ShardCostEstimate estimate = EstimateLocked(stats);
+    proto::logging::ShardCost& shard_cost = table.emplace_back();
+    shard_cost.set_shard_name(shard_names_[i]);
+    shard_cost.set_num_runs(stats.num_runs);
+    shard_cost.set_num_timeouts(stats.num_timeouts);
+    shard_cost.set_num_iterations(stats.num_iterations);
+    EncodeGoogleApiProto(stats.cpu_time, shard_cost.mutable_cpu_time())
+        .IgnoreError();
+    EncodeGoogleApiProto(estimate.startup_cpu_time,
+                         shard_cost.mutable_startup_cpu_time())
+        .IgnoreError();
+    shard_cost.set_snaps_per_second(estimate.snaps_per_second);
+  }
+  return table;
+}
+
+}  // namespace silifuzz
@@ -0,0 +1,147 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_SILIFUZZ_ORCHESTRATOR_SHARD_SCHEDULER_H_
+#define THIRD_PARTY_SILIFUZZ_ORCHESTRATOR_SHARD_SCHEDULER_H_
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "./proto/session_summary.pb.h"
+
+namespace silifuzz {
+
+// Learned cost model of a single shard: running N snaps costs
+// startup_cpu_time + N / snaps_per_second of CPU time.
+struct ShardCostEstimate {
+  // CPU time spent loading the shard and setting up the runner.
+  absl::Duration startup_cpu_time = absl::ZeroDuration();
+
+  // Snap execution throughput. 0 when not known yet.
+  double snaps_per_second = 0;
+};
+
+// ShardScheduler decides which shard each runner invocation uses and how many
+// snaps it executes.
+//
+// Shards differ a lot in load time and per-snap cost. Instead of a fixed
+// iteration count the scheduler learns a ShardCostEstimate for every shard from
+// the CPU time consumed by past runners and picks the iteration count such that
+// each runner lands near Options::target_runner_cpu_time. The first run of
+// every shard is a short probe.
+//
+// Shards are picked to equalize per-CPU coverage: for every CPU the scheduler
+// tracks how many snaps of each shard were executed on it and returns one of
+// the least covered shards.
+//
+// This class is thread-safe.
+class ShardScheduler {
+ public:
+  struct Options {
+    // Desired CPU time of a single runner invocation.
+    absl::Duration target_runner_cpu_time = absl::Seconds(5);
+
+    // CPU time budget of a single runner invocation. Runs that consumed most
+    // of it are assumed to have timed out before executing all snaps.
+    absl::Duration runner_cpu_time_budget = absl::InfiniteDuration();
+
+    // Iteration count of the first run of every shard. Also the lower bound
+    // for all subsequent runs.
+    int64_t probe_iterations = 1000;
+
+    // Upper bound for the iteration count of any run.
+    int64_t max_iterations = 5000000;
+  };
+
+  ShardScheduler(const std::vector<std::string>& shard_names,
+                 const Options& options, uint64_t seed);
+
+  // Not copyable or moveable -- not just a data holder.
+  ShardScheduler(const ShardScheduler&) = delete;
+  ShardScheduler(ShardScheduler&&) = delete;
+  ShardScheduler& operator=(const ShardScheduler&) = delete;
+  ShardScheduler& operator=(ShardScheduler&&) = delete;
+
+  // Returns the index of the shard that should run next on `cpu`.
+  int NextShard(int cpu);
+
+  // Returns the number of snaps the next run of `shard_idx` should execute.
+  int64_t NumIterations(int shard_idx) const;
+
+  // Records that a runner executing `num_iterations` snaps of `shard_idx` on
+  // `cpu` consumed `cpu_time`. The run counts towards the coverage of `cpu`
+  // and is a sample for the cost estimate of the shard.
+  void Record(int shard_idx, int cpu, int64_t num_iterations,
+              absl::Duration cpu_time);
+
+  // Records that a runner of `shard_idx` asked to execute `num_iterations`
+  // snaps on `cpu` finished without a usable cost sample, e.g. because it
+  // found a failure. The run only counts towards the coverage of `cpu`, so
+  // that a shard that keeps failing is not picked over and over again.
+  void RecordCoverage(int shard_idx, int cpu, int64_t num_iterations);
+
+  // Returns the current cost estimate for `shard_idx`.
+  ShardCostEstimate Estimate(int shard_idx) const;
+
+  // Returns the learned table, one entry per shard that ran at least once.
+  std::vector<proto::logging::ShardCost> ToProto() const;
+
+ private:
+  // Per-shard accumulated samples.
+  struct ShardStats {
+    uint64_t num_runs = 0;
+    uint64_t num_timeouts = 0;
+    int64_t num_iterations = 0;
+    absl::Duration cpu_time = absl::ZeroDuration();
+
+    // Sums for the least squares fit of cpu_time (in seconds) against the
+    // iteration count over all runs that did not time out.
+    double n = 0;
+    double sum_x = 0;
+    double sum_y = 0;
+    double sum_xx = 0;
+    double sum_xy = 0;
+
+    // Upper bound on the iteration count lowered on every timeout.
+    int64_t iteration_cap;
+  };
+
+  ShardCostEstimate EstimateLocked(const ShardStats& stats) const
+      ABSL_SHARED_LOCKS_REQUIRED(mu_);
+
+  void AddCoverageLocked(int shard_idx, int cpu, int64_t num_iterations)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const std::vector<std::string> shard_names_;
+  const Options options_;
+
+  mutable absl::Mutex mu_;
+  std::vector<ShardStats> stats_ ABSL_GUARDED_BY(mu_);
+
+  // Number of snaps executed per CPU per shard.
+  absl::flat_hash_map<int, std::vector<int64_t>> coverage_
+      ABSL_GUARDED_BY(mu_);
+
+  std::mt19937_64 random_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace silifuzz
+
+#endif  // THIRD_PARTY_SILIFUZZ_ORCHESTRATOR_SHARD_SCHEDULER_H_
@@ -0,0 +1,144 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./orchestrator/shard_scheduler.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "./proto/session_summary.pb.h"
+
+namespace silifuzz {
+namespace {
+
+using ::testing::UnorderedElementsAre;
+
+// Simulated runner cost: `startup` plus `snap_cost` per iteration.
+absl::Duration RunnerCost(int64_t num_iterations, absl::Duration startup,
+                          absl::Duration snap_cost) {
+  return startup + snap_cost * num_iterations;
+}
+
+TEST(ShardScheduler, ProbeFirst) {
+  ShardScheduler scheduler({"a", "b"},
+                           {.target_runner_cpu_time = absl::Seconds(1),
+                            .probe_iterations = 10,
+                            .max_iterations = 1000},
+                           0);
+  EXPECT_EQ(scheduler.NumIterations(0), 10);
+  EXPECT_EQ(scheduler.NumIterations(1), 10);
+  EXPECT_EQ(scheduler.Estimate(0).snaps_per_second, 0);
+}
+
+TEST(ShardScheduler, LearnsCost) {
+  const absl::Duration startup = absl::Milliseconds(100);
+  const absl::Duration snap_cost = absl::Microseconds(100);
+  ShardScheduler scheduler({"a"},
+                           {.target_runner_cpu_time = absl::Seconds(1),
+                            .probe_iterations = 100,
+                            .max_iterations = 1000000},
+                           0);
+  for (int i = 0; i < 5; ++i) {
+    const int64_t num_iterations = scheduler.NumIterations(0);
+    scheduler.Record(0, 0, num_iterations,
+                     RunnerCost(num_iterations, startup, snap_cost));
+  }
+  const ShardCostEstimate estimate = scheduler.Estimate(0);
+  EXPECT_NEAR(absl::ToDoubleMilliseconds(estimate.startup_cpu_time), 100, 1);
+  EXPECT_NEAR(estimate.snaps_per_second, 10000, 10);
+  // (1s - 100ms) / 100us
+  EXPECT_NEAR(scheduler.NumIterations(0), 9000, 10);
+}
+
+TEST(ShardScheduler, BacksOffOnTimeout) {
+  ShardScheduler scheduler({"a"},
+                           {.target_runner_cpu_time = absl::Seconds(5),
+                            .runner_cpu_time_budget = absl::Seconds(10),
+                            .probe_iterations = 10,
+                            .max_iterations = 1000},
+                           0);
+  scheduler.Record(0, 0, 10, absl::Seconds(1));
+  EXPECT_EQ(scheduler.NumIterations(0), 50);
+  scheduler.Record(0, 0, 50, absl::Seconds(10));
+  EXPECT_EQ(scheduler.NumIterations(0), 25);
+  // The timed out run is not used for the estimate.
+  EXPECT_EQ(scheduler.Estimate(0).snaps_per_second, 10);
+}
+
+TEST(ShardScheduler, PrefersLeastCovered) {
+  ShardScheduler scheduler({"a", "b", "c"}, {}, 0);
+  scheduler.Record(0, 1, 100, absl::Seconds(1));
+  scheduler.Record(2, 1, 50, absl::Seconds(1));
+  EXPECT_EQ(scheduler.NextShard(1), 1);
+  scheduler.Record(1, 1, 10, absl::Seconds(1));
+  EXPECT_EQ(scheduler.NextShard(1), 1);
+  scheduler.Record(1, 1, 100, absl::Seconds(1));
+  EXPECT_EQ(scheduler.NextShard(1), 2);
+
+  // Coverage is tracked per CPU.
+  std::vector<int> picked;
+  for (int i = 0; i < 3; ++i) {
+    const int shard_idx = scheduler.NextShard(0);
+    picked.push_back(shard_idx);
+    scheduler.Record(shard_idx, 0, 1, absl::Seconds(1));
+  }
+  EXPECT_THAT(picked, UnorderedElementsAre(0, 1, 2));
+}
+
+TEST(ShardScheduler, FailingShardStillGainsCoverage) {
+  ShardScheduler scheduler({"a", "b"},
+                           {.probe_iterations = 10, .max_iterations = 1000},
+                           0);
+  // Shard 0 fails every time it runs, shard 1 always succeeds.
+  std::vector<int> num_picked(2, 0);
+  std::vector<int64_t> num_snaps(2, 0);
+  for (int i = 0; i < 100; ++i) {
+    const int shard_idx = scheduler.NextShard(0);
+    ++num_picked[shard_idx];
+    const int64_t num_iterations = scheduler.NumIterations(shard_idx);
+    num_snaps[shard_idx] += num_iterations;
+    if (shard_idx == 0) {
+      scheduler.RecordCoverage(shard_idx, 0, num_iterations);
+    } else {
+      scheduler.Record(shard_idx, 0, num_iterations, absl::Seconds(1));
+    }
+  }
+  // The failing shard does not monopolize the CPU, both shards get about the
+  // same number of snaps.
+  EXPECT_GT(num_picked[1], 1);
+  EXPECT_LE(std::abs(num_snaps[0] - num_snaps[1]), 1000);
+  // Failed runs are not cost samples.
+  EXPECT_EQ(scheduler.Estimate(0).snaps_per_second, 0);
+  EXPECT_EQ(scheduler.NumIterations(0), 10);
+}
+
+TEST(ShardScheduler, ToProto) {
+  ShardScheduler scheduler({"a", "b"}, {}, 0);
+  scheduler.Record(1, 0, 1000, absl::Seconds(1));
+  scheduler.Record(1, 3, 2000, absl::Seconds(1));
+  std::vector<proto::logging::ShardCost> table = scheduler.ToProto();
+  ASSERT_EQ(table.size(), 1);
+  EXPECT_EQ(table[0].shard_name(), "b");
+  EXPECT_EQ(table[0].num_runs(), 2);
+  EXPECT_EQ(table[0].num_iterations(), 3000);
+  EXPECT_EQ(table[0].cpu_time().seconds(), 2);
+  EXPECT_GT(table[0].snaps_per_second(), 0);
+}
+
+}  // namespace
+}  // namespace silifuzz
@@ -14,7 +14,17 @@
 
 #include "./orchestrator/silifuzz_orchestrator.h"
 
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <optional>
 #include <random>
 #include <string>
 #include <utility>
@@ -22,6 +32,7 @@
 
 #include "absl/base/log_severity.h"
 #include "absl/log/check.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -29,9 +40,16 @@
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "./orchestrator/corpus_util.h"
+#include "./orchestrator/cpu_topology.h"
+#include "./orchestrator/failure_confirmation.h"
+#include "./orchestrator/memory_admission.h"
+#include "./orchestrator/shard_scheduler.h"
+#include "./proto/snapshot_execution_result.pb.h"
 #include "./runner/driver/runner_driver.h"
 #include "./runner/driver/runner_options.h"
 #include "./util/checks.h"
+#include "./util/cpu_id.h"
+#include "./util/subprocess.h"
 
 namespace silifuzz {
 
@@ -50,6 +68,46 @@ std::string RunResultToDebugString(const RunnerDriver::RunResult &run_result) {
       return "unknown";
   }
 }
+
+// Runs `shard_idx` in a zygote from `zygotes`, starting one if needed.
+// `zygotes` is ordered from least to most recently used and holds at most
+// args.max_zygotes entries.
+RunnerDriver::RunResult RunInZygote(
+    const RunnerThreadArgs &args, int shard_idx,
+    const RunnerOptions &runner_options,
+    std::vector<std::pair<int, RunnerDriver>> &zygotes) {
+  auto it = std::find_if(
+      zygotes.begin(), zygotes.end(),
+      [shard_idx](const auto &z) { return z.first == shard_idx; });
+  if (it != zygotes.end()) {
+    std::rotate(it, it + 1, zygotes.end());
+  } else {
+    if (zygotes.size() >= static_cast<size_t>(args.max_zygotes)) {
+      zygotes.erase(zygotes.begin());
+    }
+    const InMemoryShard &shard = args.corpora->shards[shard_idx];
+    RunnerDriver driver =
+        RunnerDriver::ReadingRunner(args.runner, shard.file_path, shard.name);
+    if (absl::Status s = driver.StartZygote(args.runner_options); !s.ok()) {
+      return RunnerDriver::RunResult::InternalError(s.message());
+    }
+    zygotes.emplace_back(shard_idx, std::move(driver));
+  }
+  RunnerDriver::RunResult run_result =
+      zygotes.back().second.Run(runner_options);
+  if (run_result.execution_result().code ==
+      RunnerDriver::ExecutionResult::Code::kInternalError) {
+    // The zygote may be gone. Start a fresh one next time.
+    zygotes.pop_back();
+  }
+  return run_result;
+}
+
+// Returns the total CPU time recorded in `rusage`.
+absl::Duration CpuTime(const struct rusage &rusage) {
+  return absl::DurationFromTimeval(rusage.ru_utime) +
+         absl::DurationFromTimeval(rusage.ru_stime);
+}
 }  // namespace
 
 ExecutionContext::~ExecutionContext() {
@@ -68,7 +126,8 @@ ExecutionContext::~ExecutionContext() {
 // Attempts to post RunResult on the result queue. Returns true if the element
 // was added, false otherwise.
 bool ExecutionContext::OfferRunResult(
-    absl::StatusOr<RunnerDriver::RunResult> &&result) {
+    absl::StatusOr<RunnerDriver::RunResult> &&result,
+    std::optional<proto::FailureConfirmation> confirmation) {
   absl::MutexLock l(&mu_);
   if (!result.ok()) {
     // Currently, no-Ok() results are not reported to the result queue. It is
@@ -81,7 +140,8 @@ bool ExecutionContext::OfferRunResult(
   if (invocation_results_.size() >= num_threads_) {
     return false;
   }
-  invocation_results_.emplace_back(*result);
+  invocation_results_.push_back(
+      {.result = *std::move(result), .confirmation = std::move(confirmation)});
   return true;
 }
 
@@ -90,7 +150,7 @@ bool ExecutionContext::OfferRunResult(
 void ExecutionContext::EventLoop() {
   constexpr absl::Duration kTimeout = absl::Seconds(10);
   while (!ShouldStop()) {
-    std::vector<RunnerDriver::RunResult> current_results;
+    std::vector<QueuedResult> current_results;
     current_results.reserve(num_threads_);
     {
       bool timed_out = mu_.LockWhenWithTimeout(
@@ -115,9 +175,11 @@ void ExecutionContext::ProcessResultQueue() {
 }
 
 void ExecutionContext::ProcessResultQueueImpl(
-    const std::vector<RunnerDriver::RunResult> &results) {
-  for (const auto &result : results) {
-    if (result_cb_(result)) {
+    const std::vector<QueuedResult> &results) {
+  for (const QueuedResult &queued : results) {
+    if (result_cb_(queued.result, queued.confirmation.has_value()
+                                      ? &*queued.confirmation
+                                      : nullptr)) {
       Stop();
     }
   }
@@ -143,67 +205,409 @@ int NextCorpusGenerator::operator()() {
 }
 
 // ==================================================================
-//
+
+namespace {
+
+// A single runner invocation planned by RunnerWorker.
+struct RunnerInvocation {
+  absl::Time start_time;
+  int target_cpu;
+  int shard_idx;
+  int64_t num_iterations;
+  RunnerOptions runner_options;
+
+  // Memory held by the runner, if memory admission control is enabled.
+  std::optional<MemoryAdmissionController::Reservation> reservation;
+};
+
+// Scheduling and result reporting of a single worker. Shared by RunnerThread
+// and RunnerSupervisor which differ only in how they wait for runners.
+class RunnerWorker {
+ public:
+  explicit RunnerWorker(const RunnerThreadArgs &args)
+      : args_(args),
+        next_corpus_generator_(args.corpora->shards.size(),
+                               args.runner_options.sequential_mode(),
+                               args.thread_idx),
+        shard_scheduler_(args.runner_options.sequential_mode()
+                             ? nullptr
+                             : args.shard_scheduler) {}
+
+  // Returns the next runner invocation or nullopt if the worker should stop.
+  std::optional<RunnerInvocation> Next(ExecutionContext *ctx);
+
+  // Reserves memory for `invocation` if memory admission control is enabled.
+  // Waits up to `timeout` for other runners to release memory. Returns false
+  // if the runner does not fit yet or the deadline passed while waiting.
+  bool Admit(ExecutionContext *ctx, RunnerInvocation &invocation,
+             absl::Duration timeout);
+
+  // Records `run_result` of `invocation` and posts it to `ctx`.
+  void Finish(ExecutionContext *ctx, const RunnerInvocation &invocation,
+              RunnerDriver::RunResult &&run_result);
+
+  const RunnerThreadArgs &args() const { return args_; }
+  int num_invocations() const { return num_invocations_; }
+
+ private:
+  // Returns the next CPU to scan or nullopt if all CPUs are quarantined.
+  std::optional<int> NextCpu();
+
+  const RunnerThreadArgs &args_;
+  NextCorpusGenerator next_corpus_generator_;
+  ShardScheduler *shard_scheduler_;
+  int num_invocations_ = 0;
+  size_t next_cpu_idx_ = 0;
+};
+
+std::optional<int> RunnerWorker::NextCpu() {
+  for (size_t i = 0; i < args_.cpus.size(); ++i) {
+    const int cpu = args_.cpus[next_cpu_idx_++ % args_.cpus.size()];
+    if (args_.failure_confirmer == nullptr ||
+        !args_.failure_confirmer->IsQuarantined(cpu)) {
+      return cpu;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<RunnerInvocation> RunnerWorker::Next(ExecutionContext *ctx) {
+  if (ctx->ShouldStop() || args_.cpus.empty()) {
+    return std::nullopt;
+  }
+  const absl::Time start_time = absl::Now();
+  absl::Duration time_budget = ctx->deadline() - start_time;
+  if (time_budget <= absl::ZeroDuration()) {
+    return std::nullopt;
+  }
+  const std::optional<int> target_cpu = NextCpu();
+  if (!target_cpu.has_value()) {
+    VLOG_INFO(0, "T", args_.thread_idx, " All CPUs are quarantined");
+    return std::nullopt;
+  }
+  RunnerInvocation invocation = {
+      .start_time = start_time,
+      .target_cpu = *target_cpu,
+      .shard_idx = 0,
+      .num_iterations = 0,
+      .runner_options = args_.runner_options,
+  };
+  invocation.runner_options.set_cpu(invocation.target_cpu);
+  invocation.runner_options.set_wall_time_budget(time_budget);
+  VLOG_INFO(1, "T", args_.thread_idx, " time budget ",
+            absl::FormatDuration(time_budget));
+  if (shard_scheduler_ != nullptr) {
+    invocation.shard_idx = shard_scheduler_->NextShard(invocation.target_cpu);
+    invocation.num_iterations =
+        shard_scheduler_->NumIterations(invocation.shard_idx);
+    invocation.runner_options.set_num_iterations(invocation.num_iterations);
+  } else {
+    invocation.shard_idx = next_corpus_generator_();
+  }
+
+  if (invocation.shard_idx == NextCorpusGenerator::kEndOfStream) {
+    VLOG_INFO(0, "T", args_.thread_idx,
+              " Reached end of stream in sequential mode");
+    return std::nullopt;
+  }
+  ++num_invocations_;
+  return invocation;
+}
+
+bool RunnerWorker::Admit(ExecutionContext *ctx, RunnerInvocation &invocation,
+                         absl::Duration timeout) {
+  MemoryAdmissionController *memory_admission = args_.memory_admission;
+  if (memory_admission == nullptr) {
+    return true;
+  }
+  invocation.reservation =
+      memory_admission->Admit(invocation.shard_idx, timeout);
+  if (!invocation.reservation.has_value()) {
+    return false;
+  }
+  // Waiting for memory ate into the time budget computed by Next().
+  invocation.start_time = absl::Now();
+  absl::Duration time_budget = ctx->deadline() - invocation.start_time;
+  if (time_budget <= absl::ZeroDuration()) {
+    memory_admission->Release(*invocation.reservation, 0);
+    invocation.reservation.reset();
+    return false;
+  }
+  invocation.runner_options.set_wall_time_budget(time_budget);
+  return true;
+}
+
+void RunnerWorker::Finish(ExecutionContext *ctx,
+                          const RunnerInvocation &invocation,
+                          RunnerDriver::RunResult &&run_result) {
+  absl::Duration elapsed_time = absl::Now() - invocation.start_time;
+
+  if (invocation.reservation.has_value()) {
+    args_.memory_admission->Release(
+        *invocation.reservation,
+        static_cast<uint64_t>(run_result.rusage().ru_maxrss) * 1024);
+  }
+
+  if (args_.core_coverage != nullptr) {
+    args_.core_coverage->Record(invocation.target_cpu,
+                                CpuTime(run_result.rusage()));
+  }
+
+  // Only complete runs say anything about the cost of the shard. Runs that
+  // found a failure or were cut short by the deadline stopped early, they
+  // still count towards coverage.
+  if (shard_scheduler_ != nullptr) {
+    if (run_result.success() && !ctx->ShouldStop()) {
+      shard_scheduler_->Record(invocation.shard_idx, invocation.target_cpu,
+                               invocation.num_iterations,
+                               CpuTime(run_result.rusage()));
+    } else {
+      shard_scheduler_->RecordCoverage(invocation.shard_idx,
+                                       invocation.target_cpu,
+                                       invocation.num_iterations);
+    }
+  }
+
+  const InMemoryShard &shard = args_.corpora->shards[invocation.shard_idx];
+  std::string log_msg = absl::StrCat(
+      "T", args_.thread_idx, " cpu: ", invocation.target_cpu,
+      " corpus: ", shard.name,
+      " time: ", absl::ToInt64Seconds(elapsed_time),
+      " exit_status: ", RunResultToDebugString(run_result));
+  if (!run_result.execution_result().ok()) {
+    LOG_ERROR(log_msg, " ", run_result.execution_result().DebugString());
+    if (run_result.postfailure_checksum_status() ==
+        RunnerPostfailureChecksumStatus::kMismatch) {
+      LOG_ERROR("Snapshot checksum mismatch");
+    }
+  } else {
+    VLOG_INFO(0, log_msg);
+  }
+
+  std::optional<proto::FailureConfirmation> confirmation;
+  if (args_.failure_confirmer != nullptr &&
+      run_result.has_failed_player_result() && !ctx->ShouldStop()) {
+    int failing_cpu = run_result.failed_player_result().cpu_id;
+    if (failing_cpu == kUnknownCPUId) {
+      failing_cpu = invocation.target_cpu;
+    }
+    confirmation = args_.failure_confirmer->Confirm(
+        RunnerDriver::ReadingRunner(args_.runner, shard.file_path, shard.name),
+        run_result.failed_snapshot_id(), failing_cpu);
+    LOG_ERROR("T", args_.thread_idx, " Snapshot ",
+              run_result.failed_snapshot_id(), " on CPU ", failing_cpu, ": ",
+              proto::FailureConfirmation::Verdict_Name(
+                  confirmation->verdict()),
+              confirmation->quarantined() ? ", CPU quarantined" : "");
+  }
+
+  if (!ctx->OfferRunResult(std::move(run_result), std::move(confirmation))) {
+    LOG_ERROR(
+        "T", args_.thread_idx,
+        " Result processing queue is stuck, some results won't be logged");
+  }
+}
+
+}  // namespace
+
 // The main worker thread. Each such thread executes runners with corpora in a
 // loop until it is told to stop.
 void RunnerThread(ExecutionContext *ctx, const RunnerThreadArgs &args) {
   VLOG_INFO(0, "T", args.thread_idx, " started");
-  NextCorpusGenerator next_corpus_generator(
-      args.corpora->shards.size(), args.runner_options.sequential_mode(),
-      args.thread_idx);
-
-  int iteration = 0;
-  for (iteration = 0; !ctx->ShouldStop() && !args.cpus.empty(); iteration++) {
-    absl::Time start_time = absl::Now();
-    absl::Duration time_budget = ctx->deadline() - start_time;
-    if (time_budget <= absl::ZeroDuration()) {
-      break;
+  RunnerWorker worker(args);
+  const bool use_zygotes =
+      args.max_zygotes > 0 && !args.runner_options.sequential_mode();
+  std::vector<std::pair<int, RunnerDriver>> zygotes;
+
+  while (std::optional<RunnerInvocation> invocation = worker.Next(ctx)) {
+    // Wait until the runner fits into the memory limit.
+    bool admitted = worker.Admit(ctx, *invocation, absl::Seconds(1));
+    while (!admitted && !ctx->ShouldStop()) {
+      admitted = worker.Admit(ctx, *invocation, absl::Seconds(1));
     }
-    RunnerOptions runner_options = args.runner_options;
-    int target_cpu = args.cpus[iteration % args.cpus.size()];
-    runner_options.set_cpu(target_cpu);
-    runner_options.set_wall_time_budget(time_budget);
-    VLOG_INFO(1, "T", args.thread_idx, " time budget ",
-              absl::FormatDuration(time_budget));
-    int shard_idx = next_corpus_generator();
-
-    if (shard_idx == NextCorpusGenerator::kEndOfStream) {
-      VLOG_INFO(0, "T", args.thread_idx,
-                " Reached end of stream in sequential mode");
+    if (!admitted) {
       break;
     }
+    const InMemoryShard &shard = args.corpora->shards[invocation->shard_idx];
+    RunnerDriver::RunResult run_result =
+        use_zygotes
+            ? RunInZygote(args, invocation->shard_idx,
+                          invocation->runner_options, zygotes)
+            : RunnerDriver::ReadingRunner(args.runner, shard.file_path,
+                                          shard.name)
+                  .Run(invocation->runner_options);
+    worker.Finish(ctx, *invocation, std::move(run_result));
+  }
 
-    const InMemoryShard &shard = args.corpora->shards[shard_idx];
-    RunnerDriver driver =
-        RunnerDriver::ReadingRunner(args.runner, shard.file_path, shard.name);
-    RunnerDriver::RunResult run_result = driver.Run(runner_options);
-
-    absl::Duration elapsed_time = absl::Now() - start_time;
-
-    std::string log_msg = absl::StrCat(
-        "T", args.thread_idx, " cpu: ", target_cpu, " corpus: ", shard.name,
-        " time: ", absl::ToInt64Seconds(elapsed_time),
-        " exit_status: ", RunResultToDebugString(run_result));
-    if (!run_result.execution_result().ok()) {
-      LOG_ERROR(log_msg, " ", run_result.execution_result().DebugString());
-      if (run_result.postfailure_checksum_status() ==
-          RunnerPostfailureChecksumStatus::kMismatch) {
-        LOG_ERROR("Snapshot checksum mismatch");
-      }
-    } else {
-      VLOG_INFO(0, log_msg);
+  ctx->Stop();
+  VLOG_INFO(0, "T", args.thread_idx, " stopped after ",
+            worker.num_invocations(), " iterations");
+}
+
+// ==================================================================
+
+namespace {
+
+// A RunnerSupervisor worker and its runner, if any.
+struct SupervisedRunner {
+  explicit SupervisedRunner(const RunnerThreadArgs &args) : worker(args) {}
+
+  RunnerWorker worker;
+  std::optional<RunnerInvocation> invocation;
+  std::optional<RunnerDriver> driver;
+  std::unique_ptr<Subprocess> process;
+  std::string runner_stdout;
+  int pidfd = -1;
+  bool stdout_open = false;
+  bool exited = false;
+  bool waiting_for_memory = false;
+};
+
+// epoll_event::data of runner `idx`. The low bit tells the pidfd from stdout.
+uint64_t EpollData(size_t idx, bool pidfd) { return (idx << 1) | pidfd; }
+
+void EpollAdd(int epoll_fd, int fd, uint64_t data) {
+  struct epoll_event event = {.events = EPOLLIN, .data = {.u64 = data}};
+  CHECK_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event), 0);
+}
+
+void EpollDel(int epoll_fd, int fd) {
+  CHECK_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr), 0);
+}
+
+// Starts the admitted `runner.invocation`. Returns false if the runner could
+// not be started.
+bool LaunchSupervisedRunner(ExecutionContext *ctx, int epoll_fd, size_t idx,
+                            SupervisedRunner &runner) {
+  const InMemoryShard &shard =
+      runner.worker.args().corpora->shards[runner.invocation->shard_idx];
+  runner.driver.emplace(RunnerDriver::ReadingRunner(
+      runner.worker.args().runner, shard.file_path, shard.name));
+  absl::StatusOr<std::unique_ptr<Subprocess>> process =
+      runner.driver->StartRun(runner.invocation->runner_options);
+  if (!process.ok()) {
+    runner.worker.Finish(
+        ctx, *runner.invocation,
+        RunnerDriver::RunResult::InternalError(process.status().message()));
+    return false;
+  }
+  runner.process = *std::move(process);
+  runner.runner_stdout.clear();
+  runner.stdout_open = true;
+  EpollAdd(epoll_fd, runner.process->stdout_fd(), EpollData(idx, false));
+  // Without pidfds, EOF on stdout stands in for the exit of the runner.
+  runner.pidfd = runner.process->OpenPidFd();
+  runner.exited = runner.pidfd == -1;
+  if (runner.pidfd != -1) {
+    EpollAdd(epoll_fd, runner.pidfd, EpollData(idx, true));
+  }
+  return true;
+}
+
+// Starts the next runner of `runner`. Returns false when the worker is done.
+// A runner that does not fit into the memory limit yet is left waiting for
+// ResumeSupervisedRunner().
+bool StartSupervisedRunner(ExecutionContext *ctx, int epoll_fd, size_t idx,
+                           SupervisedRunner &runner) {
+  while ((runner.invocation = runner.worker.Next(ctx)).has_value()) {
+    if (!runner.worker.Admit(ctx, *runner.invocation, absl::ZeroDuration())) {
+      runner.waiting_for_memory = !ctx->ShouldStop();
+      return runner.waiting_for_memory;
     }
+    if (LaunchSupervisedRunner(ctx, epoll_fd, idx, runner)) {
+      return true;
+    }
+  }
+  return false;
+}
 
-    if (!ctx->OfferRunResult(std::move(run_result))) {
-      LOG_ERROR(
-          "T", args.thread_idx,
-          " Result processing queue is stuck, some results won't be logged");
+// Retries admission of a runner waiting for memory. Returns false when the
+// worker is done.
+bool ResumeSupervisedRunner(ExecutionContext *ctx, int epoll_fd, size_t idx,
+                            SupervisedRunner &runner) {
+  if (!runner.worker.Admit(ctx, *runner.invocation, absl::ZeroDuration())) {
+    runner.waiting_for_memory = !ctx->ShouldStop();
+    return runner.waiting_for_memory;
+  }
+  runner.waiting_for_memory = false;
+  return LaunchSupervisedRunner(ctx, epoll_fd, idx, runner) ||
+         StartSupervisedRunner(ctx, epoll_fd, idx, runner);
+}
+
+}  // namespace
+
+void RunnerSupervisor(ExecutionContext *ctx,
+                      const std::vector<RunnerThreadArgs> &args) {
+  VLOG_INFO(0, "Supervisor of ", args.size(), " runners started");
+  const int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  CHECK_NE(epoll_fd, -1);
+  std::vector<SupervisedRunner> runners;
+  runners.reserve(args.size());
+  int num_running = 0;
+  for (size_t idx = 0; idx < args.size(); ++idx) {
+    runners.emplace_back(args[idx]);
+    num_running += StartSupervisedRunner(ctx, epoll_fd, idx, runners[idx]);
+  }
+
+  // Runners enforce their own CPU and wall time budgets (see
+  // RunnerOptions::set_wall_time_budget()) so it is safe to block here until
+  // one of them makes progress. Runners waiting for memory are retried
+  // periodically as other supervisors may release it too.
+  constexpr int kMaxEvents = 64;
+  constexpr int kMemoryRetryIntervalMs = 100;
+  struct epoll_event events[kMaxEvents];
+  while (num_running > 0) {
+    const bool waiting_for_memory = std::any_of(
+        runners.begin(), runners.end(), [](const SupervisedRunner &runner) {
+          return runner.waiting_for_memory;
+        });
+    int num_events =
+        epoll_wait(epoll_fd, events, kMaxEvents,
+                   waiting_for_memory ? kMemoryRetryIntervalMs : -1);
+    if (num_events == -1) {
+      CHECK_EQ(errno, EINTR);
+      continue;
+    }
+    for (int i = 0; i < num_events; ++i) {
+      const size_t idx = events[i].data.u64 >> 1;
+      SupervisedRunner &runner = runners[idx];
+      if (events[i].data.u64 & 1) {
+        EpollDel(epoll_fd, runner.pidfd);
+        close(runner.pidfd);
+        runner.pidfd = -1;
+        runner.exited = true;
+      } else if (!runner.process->ReadStdout(&runner.runner_stdout)) {
+        EpollDel(epoll_fd, runner.process->stdout_fd());
+        runner.stdout_open = false;
+      }
+      if (runner.stdout_open || !runner.exited) {
+        continue;
+      }
+      ProcessInfo info = runner.process->Wait();
+      runner.process.reset();
+      RunnerDriver::RunResult run_result = runner.driver->FinishRun(
+          runner.invocation->runner_options, runner.runner_stdout, info);
+      runner.worker.Finish(ctx, *runner.invocation, std::move(run_result));
+      if (!StartSupervisedRunner(ctx, epoll_fd, idx, runner)) {
+        --num_running;
+      }
+    }
+    for (size_t idx = 0; idx < runners.size(); ++idx) {
+      if (runners[idx].waiting_for_memory &&
+          !ResumeSupervisedRunner(ctx, epoll_fd, idx, runners[idx])) {
+        --num_running;
+      }
     }
   }
+  close(epoll_fd);
 
   ctx->Stop();
-  VLOG_INFO(0, "T", args.thread_idx, " stopped after ", iteration,
-            " iterations");
+  int num_invocations = 0;
+  for (const SupervisedRunner &runner : runners) {
+    num_invocations += runner.worker.num_invocations();
+  }
+  VLOG_INFO(0, "Supervisor of ", args.size(), " runners stopped after ",
+            num_invocations, " iterations");
 }
 
 }  // namespace silifuzz
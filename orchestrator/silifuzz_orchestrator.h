@@ -17,6 +17,7 @@
 
 #include <atomic>
 #include <functional>
+#include <optional>
 #include <random>
 #include <string>
 #include <vector>
@@ -27,6 +28,11 @@
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "./orchestrator/corpus_util.h"
+#include "./orchestrator/cpu_topology.h"
+#include "./orchestrator/failure_confirmation.h"
+#include "./orchestrator/memory_admission.h"
+#include "./orchestrator/shard_scheduler.h"
+#include "./proto/snapshot_execution_result.pb.h"
 #include "./runner/driver/runner_driver.h"
 #include "./runner/driver/runner_options.h"
 
@@ -49,6 +55,27 @@ struct RunnerThreadArgs {
 
   // Additional parameters passed to each runner binary.
   RunnerOptions runner_options = RunnerOptions::Default();
+
+  // When not null, picks shards and per-runner iteration counts instead of
+  // NextCorpusGenerator. Shared by all threads. Ignored in sequential mode.
+  ShardScheduler *shard_scheduler = nullptr;
+
+  // When > 0, runners are forked from zygotes (see RunnerDriver::StartZygote)
+  // and the thread keeps the zygotes of up to this many most recently used
+  // shards alive. Ignored in sequential mode.
+  int max_zygotes = 0;
+
+  // When not null, each runner is started only after it was admitted by the
+  // controller. Shared by all threads.
+  MemoryAdmissionController *memory_admission = nullptr;
+
+  // When not null, failed snapshots are replayed before the result is posted
+  // and quarantined CPUs are skipped. Shared by all threads.
+  FailureConfirmer *failure_confirmer = nullptr;
+
+  // When not null, every runner invocation is tallied against the physical
+  // core of its CPU. Shared by all threads.
+  CoreCoverage *core_coverage = nullptr;
 };
 
 // Orchestrator execution context.
@@ -66,6 +93,12 @@ class ExecutionContext {
   // stop.
   using ResultCallback = std::function<bool(const RunnerDriver::RunResult &)>;
 
+  // Same as ResultCallback but also receives the FailureConfirmation posted
+  // with the result, or nullptr if there is none.
+  using ConfirmedResultCallback =
+      std::function<bool(const RunnerDriver::RunResult &,
+                         const proto::FailureConfirmation *)>;
+
   // Constructs an ExecutionContext with the given deadline. Once the deadline
   // is reached ShouldStop() will return true.
   // num_threads is a hint used to size internal data structures.
@@ -73,6 +106,14 @@ class ExecutionContext {
   // produced by any of the worker threads.
   ExecutionContext(absl::Time deadline, int num_threads,
                    const ResultCallback &result_cb)
+      : ExecutionContext(deadline, num_threads,
+                         [result_cb](const RunnerDriver::RunResult &result,
+                                     const proto::FailureConfirmation *) {
+                           return result_cb(result);
+                         }) {}
+
+  ExecutionContext(absl::Time deadline, int num_threads,
+                   const ConfirmedResultCallback &result_cb)
       : deadline_(deadline),
         num_threads_(num_threads),
         result_cb_(result_cb),
@@ -90,9 +131,12 @@ class ExecutionContext {
 
   ~ExecutionContext();
 
-  // Attempts to post RunResult on the result queue. Returns true if the element
-  // was added, false otherwise.
-  bool OfferRunResult(absl::StatusOr<RunnerDriver::RunResult> &&result);
+  // Attempts to post RunResult on the result queue together with the
+  // `confirmation` of its failure, if any. Returns true if the element was
+  // added, false otherwise.
+  bool OfferRunResult(
+      absl::StatusOr<RunnerDriver::RunResult> &&result,
+      std::optional<proto::FailureConfirmation> confirmation = std::nullopt);
 
   // Returns true if the execution should stop.
   bool ShouldStop() const { return stop_execution_ || absl::Now() > deadline_; }
@@ -113,8 +157,12 @@ class ExecutionContext {
   absl::Time deadline() const { return deadline_; }
 
  private:
-  void ProcessResultQueueImpl(
-      const std::vector<RunnerDriver::RunResult> &results);
+  struct QueuedResult {
+    RunnerDriver::RunResult result;
+    std::optional<proto::FailureConfirmation> confirmation;
+  };
+
+  void ProcessResultQueueImpl(const std::vector<QueuedResult> &results);
 
   // EventLoop() helper. Returns true iif the EventLoop() should wake up.
   bool ShouldWakeUp() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
@@ -124,7 +172,7 @@ class ExecutionContext {
   // C-tor parameters.
   const absl::Time deadline_;
   const int num_threads_;
-  ResultCallback result_cb_;
+  ConfirmedResultCallback result_cb_;
 
   // Mutex guarding all mutable state of this class.
   mutable absl::Mutex mu_;
@@ -133,7 +181,7 @@ class ExecutionContext {
   std::atomic<bool> stop_execution_;
 
   // A queue of execution results.
-  std::vector<RunnerDriver::RunResult> invocation_results_ ABSL_GUARDED_BY(mu_);
+  std::vector<QueuedResult> invocation_results_ ABSL_GUARDED_BY(mu_);
 };
 
 // Helper class to generate the next corpus file name.
@@ -159,6 +207,15 @@ class NextCorpusGenerator {
 // Worker thread main function.
 void RunnerThread(ExecutionContext *ctx, const RunnerThreadArgs &args);
 
+// Alternative to running one RunnerThread per element of `args`: supervises
+// all these workers from the calling thread. Runners are started without
+// blocking and their stdout pipes and pidfds are multiplexed with epoll(7), so
+// a few threads can keep hundreds of runners busy. Results are posted to `ctx`
+// exactly like RunnerThread does. Zygotes are not supported.
+// `args` must outlive the call.
+void RunnerSupervisor(ExecutionContext *ctx,
+                      const std::vector<RunnerThreadArgs> &args);
+
 }  // namespace silifuzz
 
 #endif  // THIRD_PARTY_SILIFUZZ_ORCHESTRATOR_SILIFUZZ_ORCHESTRATOR_H_
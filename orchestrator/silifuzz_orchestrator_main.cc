@@ -48,8 +48,11 @@
 #include <cstdlib>
 #include <filesystem>  // NOLINT
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <limits>
+#include <memory>
+#include <optional>
 #include <string>
 #include <thread>  // NOLINT
 #include <utility>
@@ -57,7 +60,6 @@
 
 #include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
-#include "absl/functional/bind_front.h"
 #include "absl/log/flags.h"  // IWYU pragma: keep
 #include "absl/log/initialize.h"
 #include "absl/random/random.h"
@@ -69,18 +71,23 @@
 #include "absl/strings/string_view.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
-#include "absl/types/span.h"
 #include "google/protobuf/message.h"
 #include "google/protobuf/text_format.h"
 #include "./orchestrator/corpus_util.h"
+#include "./orchestrator/cpu_topology.h"
+#include "./orchestrator/failure_confirmation.h"
+#include "./orchestrator/memory_admission.h"
 #include "./orchestrator/orchestrator_util.h"
 #include "./orchestrator/result_collector.h"
+#include "./orchestrator/shard_scheduler.h"
 #include "./orchestrator/silifuzz_orchestrator.h"
 #include "./proto/corpus_metadata.pb.h"
+#include "./proto/session_summary.pb.h"
+#include "./proto/snapshot_execution_result.pb.h"
+#include "./runner/driver/runner_driver.h"
 #include "./runner/driver/runner_options.h"
 #include "./util/checks.h"
 #include "./util/cpu_id.h"
-#include "./util/span_util.h"
 #include "./util/tool_util.h"
 
 ABSL_FLAG(absl::Duration, duration, absl::InfiniteDuration(),
@@ -117,7 +124,25 @@ ABSL_FLAG(std::string, orchestrator_version, "",
 ABSL_FLAG(absl::Duration, watchdog_allowed_overrun, absl::ZeroDuration(),
           "When > 0, a watchdog thread will terminate this process after "
           "exceeding duration+overrun");
-ABSL_FLAG(int64_t, num_iterations, 5000000, "Number of iterations per runner.");
+ABSL_FLAG(int64_t, num_iterations, 5000000,
+          "Number of iterations per runner. With --target_runner_cpu_time "
+          "this is the upper bound.");
+ABSL_FLAG(int, num_supervisor_threads, 0,
+          "When > 0, supervise all concurrent runners from this many threads "
+          "with an event loop instead of one blocking thread per runner. "
+          "Not compatible with --runner_zygotes_per_thread and "
+          "--confirm_failures.");
+ABSL_FLAG(int, runner_zygotes_per_thread, 0,
+          "When > 0, fork runners from pre-initialized zygote processes that "
+          "have already loaded and mapped their shard instead of starting a "
+          "new runner binary every time. Each worker thread keeps zygotes of "
+          "this many most recently used shards. Note that "
+          "--limit_memory_usage_mb does not account for zygotes.");
+ABSL_FLAG(absl::Duration, target_runner_cpu_time, absl::ZeroDuration(),
+          "When > 0, learn per-shard startup cost and throughput and pick the "
+          "number of iterations of each runner such that it consumes about "
+          "this much CPU time. Shards with the least per-CPU coverage are "
+          "preferred. Must be below --per_runner_cpu_time_budget.");
 ABSL_FLAG(
     std::string, limit_memory_usage_mb, "unlimited",
     "How much memory (in Mb) can the scanning process use. The default is "
@@ -126,8 +151,25 @@ ABSL_FLAG(
     "fraction of the shards. A special value `auto` can be used to "
     "automatically determine the amount of free memory from /proc/meminfo");
 // TODO(b/233457080): [bug] Investigate the cause of EXECUTION_RUNAWAY errors.
+ABSL_FLAG(bool, adaptive_memory_admission, false,
+          "With --limit_memory_usage_mb, run one worker per CPU and start "
+          "each runner only when its projected peak RSS fits into the limit. "
+          "The projection is learned per shard from the peak RSS of finished "
+          "runners instead of assuming 512MB per runner.");
 ABSL_FLAG(bool, report_runaways_as_errors, false,
           "Whether runaway snapshot should be reported as errors");
+ABSL_FLAG(bool, confirm_failures, false,
+          "Replay every failed snapshot on the reporting CPU and on a few "
+          "other CPUs, log whether the failure is core-local, flaky or global "
+          "and stop scanning CPUs with core-local failures. Not compatible "
+          "with --num_supervisor_threads as confirmation blocks the thread "
+          "supervising the failed runner.");
+ABSL_FLAG(std::string, cpu_placement, "shuffle",
+          "How worker threads are mapped to CPUs: shuffle (topology "
+          "agnostic), one_per_core (never run two runners on SMT siblings), "
+          "sibling_pairs (pairs of threads scan the siblings of the same "
+          "cores side by side) or spread_l3 (threads stay within and are "
+          "spread across L3 domains).");
 ABSL_FLAG(int, fail_after_n_errors, std::numeric_limits<int>::max(),
           "Fail soon after detecting this many errors.");
 
@@ -146,7 +188,7 @@ std::vector<int> AvailableCpus() {
 // Initializes the orchestrator environment.
 ExecutionContext *OrchestratorInit(
     absl::Time deadline, int num_threads,
-    const ExecutionContext::ResultCallback &result_cb) {
+    const ExecutionContext::ConfirmedResultCallback &result_cb) {
   static ExecutionContext ctx(deadline, num_threads, result_cb);
 
   struct sigaction sigact = {};
@@ -244,27 +286,98 @@ int OrchestratorMain(const OrchestratorResources &resources,
     LOG_INFO("Running in sequential mode");
     num_threads = 1;
   }
-  std::vector<RunnerThreadArgs> thread_args;
+  // Set up adaptive scheduling if requested.
+  std::unique_ptr<ShardScheduler> shard_scheduler;
+  if (const absl::Duration target_runner_cpu_time =
+          absl::GetFlag(FLAGS_target_runner_cpu_time);
+      target_runner_cpu_time > absl::ZeroDuration() && !sequential_mode) {
+    if (target_runner_cpu_time >= runner_cpu_time_budget) {
+      LOG_ERROR("--target_runner_cpu_time must be below "
+                "--per_runner_cpu_time_budget");
+      return EXIT_FAILURE;
+    }
+    std::vector<std::string> shard_names;
+    for (const InMemoryShard &shard : in_memory_corpora->shards) {
+      shard_names.push_back(shard.name);
+    }
+    ShardScheduler::Options scheduler_options = {
+        .target_runner_cpu_time = target_runner_cpu_time,
+        .runner_cpu_time_budget = runner_cpu_time_budget,
+        .max_iterations = absl::GetFlag(FLAGS_num_iterations),
+    };
+    scheduler_options.probe_iterations = std::min(
+        scheduler_options.probe_iterations, scheduler_options.max_iterations);
+    shard_scheduler = std::make_unique<ShardScheduler>(
+        shard_names, scheduler_options,
+        absl::Uniform<uint64_t>(absl::BitGen()));
+  }
+
+  // Set up memory admission control if requested. Shards stay in memory for
+  // the whole session, the rest of the limit is available to the runners.
+  std::unique_ptr<MemoryAdmissionController> memory_admission;
+  if (absl::GetFlag(FLAGS_adaptive_memory_admission) &&
+      resources.memory_usage_limit_mb > 0) {
+    std::vector<uint64_t> shard_sizes;
+    uint64_t runner_memory_bytes = resources.memory_usage_limit_mb << 20;
+    for (const InMemoryShard &shard : in_memory_corpora->shards) {
+      shard_sizes.push_back(shard.file_size);
+      runner_memory_bytes -= std::min(runner_memory_bytes, shard.file_size);
+    }
+    VLOG_INFO(0, "Runners may use ", runner_memory_bytes >> 20, "MB");
+    memory_admission = std::make_unique<MemoryAdmissionController>(
+        shard_sizes, MemoryAdmissionController::Options{
+                         .memory_limit_bytes = runner_memory_bytes});
+  }
+
+  absl::StatusOr<CpuPlacement> cpu_placement =
+      ParseCpuPlacement(absl::GetFlag(FLAGS_cpu_placement));
+  if (!cpu_placement.ok()) {
+    LOG_ERROR(cpu_placement.status().message());
+    return EXIT_FAILURE;
+  }
+
   std::vector<int> cpus = AvailableCpus();
+  const CpuTopology topology = CpuTopology::Read(cpus);
+  VLOG_INFO(0, cpus.size(), " CPUs on ", topology.cores().size(),
+            " physical cores in ", topology.num_l3_domains(), " L3 domains");
+  CoreCoverage core_coverage(topology);
+  std::unique_ptr<FailureConfirmer> failure_confirmer;
+  if (absl::GetFlag(FLAGS_confirm_failures)) {
+    failure_confirmer = std::make_unique<FailureConfirmer>(
+        cpus, FailureConfirmer::Options{},
+        absl::Uniform<uint64_t>(absl::BitGen()));
+  }
+
+  std::vector<RunnerThreadArgs> thread_args;
   // Introduces the randomness in the order of CPUs to be scanned. This is to
   // avoid the case where silifuzz only scans CPUs with lower IDs on machines
   // with many cores and limited memory.
-  std::shuffle(cpus.begin(), cpus.end(), absl::BitGen());
-  auto cpus_per_thread = PartitionEvenly(cpus, num_threads);
+  absl::BitGen gen;
+  std::vector<std::vector<int>> cpus_per_thread = AssignCpus(
+      topology,
+      sequential_mode ? CpuPlacement::kShuffle : *cpu_placement,
+      num_threads, gen);
+  // Some placements cannot use all threads, e.g. one_per_core.
+  num_threads = cpus_per_thread.size();
   for (int thread_idx = 0; thread_idx < num_threads; ++thread_idx) {
     RunnerOptions runner_options = RunnerOptions::Default();
     runner_options.set_cpu_time_budget(runner_cpu_time_budget)
         .set_sequential_mode(sequential_mode)
         .set_extra_argv(runner_extra_argv);
-    absl::Span<int> target_cpus = cpus_per_thread[thread_idx];
+    std::vector<int>& target_cpus = cpus_per_thread[thread_idx];
     CHECK_GT(target_cpus.size(), 0);
     VLOG_INFO(0, target_cpus.size(), " CPUs are assigned to T", thread_idx);
     thread_args.push_back(
         {.thread_idx = thread_idx,
          .runner = runner,
          .corpora = &*in_memory_corpora,
-         .cpus = std::vector<int>(target_cpus.begin(), target_cpus.end()),
-         .runner_options = runner_options});
+         .cpus = std::move(target_cpus),
+         .runner_options = runner_options,
+         .shard_scheduler = shard_scheduler.get(),
+         .max_zygotes = absl::GetFlag(FLAGS_runner_zygotes_per_thread),
+         .memory_admission = memory_admission.get(),
+         .failure_confirmer = failure_confirmer.get(),
+         .core_coverage = &core_coverage});
   }
 
   ResultCollector result_collector(
@@ -284,18 +397,46 @@ int OrchestratorMain(const OrchestratorResources &resources,
 
   ExecutionContext *ctx = OrchestratorInit(
       deadline, num_threads,
-      absl::bind_front(&ResultCollector::operator(), &result_collector));
+      [&result_collector](const RunnerDriver::RunResult &result,
+                          const proto::FailureConfirmation *confirmation) {
+        return result_collector(result, confirmation);
+      });
 
   absl::Duration staggering_delay = absl::GetFlag(FLAGS_worker_thread_delay);
   // Create worker threads.
   std::vector<std::thread> threads;
-  threads.reserve(num_threads);
-  for (const RunnerThreadArgs &args : thread_args) {
-    if (ctx->ShouldStop()) {
-      break;
+  std::vector<std::vector<RunnerThreadArgs>> supervisor_args;
+  if (const int num_supervisor_threads =
+          absl::GetFlag(FLAGS_num_supervisor_threads);
+      num_supervisor_threads > 0) {
+    if (absl::GetFlag(FLAGS_runner_zygotes_per_thread) > 0) {
+      LOG_ERROR("--num_supervisor_threads does not support zygotes");
+      return EXIT_FAILURE;
+    }
+    // Confirmation replays the failed snapshot synchronously and would stall
+    // every other runner of the supervisor thread.
+    if (failure_confirmer != nullptr) {
+      LOG_ERROR("--num_supervisor_threads does not support --confirm_failures");
+      return EXIT_FAILURE;
+    }
+    supervisor_args.resize(std::min<uint64_t>(num_supervisor_threads,
+                                              thread_args.size()));
+    for (size_t i = 0; i < thread_args.size(); ++i) {
+      supervisor_args[i % supervisor_args.size()].push_back(thread_args[i]);
+    }
+    threads.reserve(supervisor_args.size());
+    for (const std::vector<RunnerThreadArgs> &args : supervisor_args) {
+      threads.emplace_back(RunnerSupervisor, ctx, std::cref(args));
+    }
+  } else {
+    threads.reserve(num_threads);
+    for (const RunnerThreadArgs &args : thread_args) {
+      if (ctx->ShouldStop()) {
+        break;
+      }
+      threads.emplace_back(RunnerThread, ctx, args);
+      absl::SleepFor(staggering_delay);
     }
-    threads.emplace_back(RunnerThread, ctx, args);
-    absl::SleepFor(staggering_delay);
   }
 
   ctx->EventLoop();
@@ -311,8 +452,19 @@ int OrchestratorMain(const OrchestratorResources &resources,
   result_collector.LogSummary(true);
   Summary summary = result_collector.summary();
   if (SessionLoggingEnabled() || summary.num_failed_snapshots > 0) {
+    std::vector<proto::logging::ShardCost> shard_costs;
+    if (shard_scheduler != nullptr) {
+      shard_costs = shard_scheduler->ToProto();
+    }
+    std::optional<proto::logging::MemoryAdmission> memory_admission_summary;
+    if (memory_admission != nullptr) {
+      memory_admission_summary = memory_admission->ToProto();
+    }
     if (absl::Status s = result_collector.LogSessionSummary(
-            runtime_meta->corpus_metadata, runtime_meta->orchestrator_version);
+            runtime_meta->corpus_metadata, runtime_meta->orchestrator_version,
+            shard_costs,
+            memory_admission_summary ? &*memory_admission_summary : nullptr,
+            core_coverage.ToProto());
         !s.ok()) {
       LOG_ERROR(s.message());
     }
@@ -400,17 +552,28 @@ int main(int argc, char **argv) {
       LOG_ERROR("Failed to parse: ", limit_memory_usage_mb);
       return EXIT_FAILURE;
     }
+    const uint64_t max_concurrent_runners = resources.num_concurrent_runners;
     absl::Status cap_resources_status = silifuzz::CapResourcesToMemLimit(
         limit_memory_usage_mb_as_int, resources);
     if (!cap_resources_status.ok()) {
       LOG_ERROR(cap_resources_status.message());
       return EXIT_FAILURE;
     }
+    resources.memory_usage_limit_mb = limit_memory_usage_mb_as_int;
+    // The shard selection above still assumes the worst case for every
+    // runner. Concurrency is left to MemoryAdmissionController.
+    if (absl::GetFlag(FLAGS_adaptive_memory_admission)) {
+      resources.num_concurrent_runners = max_concurrent_runners;
+    }
   }
 
   std::vector<std::string> runner_extra_argv;
-  runner_extra_argv.push_back(
-      absl::StrCat("--num_iterations=", absl::GetFlag(FLAGS_num_iterations)));
+  // With adaptive scheduling the iteration count is chosen per runner.
+  if (absl::GetFlag(FLAGS_target_runner_cpu_time) <= absl::ZeroDuration() ||
+      absl::GetFlag(FLAGS_sequential_mode)) {
+    runner_extra_argv.push_back(
+        absl::StrCat("--num_iterations=", absl::GetFlag(FLAGS_num_iterations)));
+  }
   // Collect runner arguments.
   for (size_t i = 1; i < remaining_args.size(); ++i) {
     runner_extra_argv.push_back(remaining_args[i]);
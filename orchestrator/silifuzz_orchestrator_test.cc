@@ -14,6 +14,7 @@
 
 #include "./orchestrator/silifuzz_orchestrator.h"
 
+#include <functional>
 #include <string>
 #include <thread>  // NOLINT
 #include <vector>
@@ -22,6 +23,9 @@
 #include "gtest/gtest.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "./orchestrator/corpus_util.h"
+#include "./orchestrator/memory_admission.h"
+#include "./proto/session_summary.pb.h"
 #include "./runner/driver/runner_driver.h"
 
 namespace silifuzz {
@@ -95,6 +99,69 @@ TEST(ExecutionContext, Multithreaded) {
   ASSERT_GT(posted, 0);
 }
 
+TEST(RunnerSupervisor, RunsAllWorkers) {
+  // /bin/true ignores the runner flags and exits successfully.
+  InMemoryCorpora corpora;
+  corpora.shards.resize(2);
+  corpora.shards[0].name = "shard_0";
+  corpora.shards[1].name = "shard_1";
+  std::vector<RunnerThreadArgs> args;
+  for (int i = 0; i < 3; ++i) {
+    args.push_back({.thread_idx = i,
+                    .runner = "/bin/true",
+                    .corpora = &corpora,
+                    .cpus = {0}});
+  }
+  // Runners started right before the deadline may be killed by their wall
+  // time budget, only count the successful ones.
+  int num_successes = 0;
+  ExecutionContext ctx(absl::Now() + absl::Milliseconds(500), args.size(),
+                       [&](const RunnerDriver::RunResult& r) {
+                         num_successes += r.success();
+                         return false;
+                       });
+  std::thread supervisor(RunnerSupervisor, &ctx, std::cref(args));
+  ctx.EventLoop();
+  supervisor.join();
+  ctx.ProcessResultQueue();
+  EXPECT_GE(num_successes, args.size());
+}
+
+TEST(RunnerSupervisor, AdmitsWithinMemoryLimit) {
+  InMemoryCorpora corpora;
+  corpora.shards.resize(1);
+  corpora.shards[0].name = "shard_0";
+  corpora.shards[0].file_size = 0;
+  // Only a single runner fits before the first measurement arrives.
+  MemoryAdmissionController memory_admission(
+      {0}, {.memory_limit_bytes = 64 << 20,
+            .initial_runner_estimate_bytes = 64 << 20});
+  std::vector<RunnerThreadArgs> args;
+  for (int i = 0; i < 3; ++i) {
+    args.push_back({.thread_idx = i,
+                    .runner = "/bin/true",
+                    .corpora = &corpora,
+                    .cpus = {0},
+                    .memory_admission = &memory_admission});
+  }
+  // Runners started right before the deadline may be killed by their wall
+  // time budget, only count the successful ones.
+  int num_successes = 0;
+  ExecutionContext ctx(absl::Now() + absl::Milliseconds(500), args.size(),
+                       [&](const RunnerDriver::RunResult& r) {
+                         num_successes += r.success();
+                         return false;
+                       });
+  std::thread supervisor(RunnerSupervisor, &ctx, std::cref(args));
+  ctx.EventLoop();
+  supervisor.join();
+  ctx.ProcessResultQueue();
+  EXPECT_GE(num_successes, args.size());
+  proto::logging::MemoryAdmission summary = memory_admission.ToProto();
+  EXPECT_GE(summary.num_deferred_launches(), 2);
+  EXPECT_GT(summary.max_runner_rss_bytes(), 0);
+}
+
 TEST(NextCorpusGenerator, Sequential) {
   NextCorpusGenerator gen(3, true, 0);
   std::vector<int> actual;
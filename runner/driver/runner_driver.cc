@@ -15,22 +15,29 @@
 #include "./runner/driver/runner_driver.h"
 
 #include <fcntl.h>
+#include <poll.h>
 #include <signal.h>
 #include <sys/mman.h>
 #include <sys/resource.h>
 #include <sys/time.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "absl/cleanup/cleanup.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
@@ -40,6 +47,7 @@
 #include "./player/player_result_proto.h"
 #include "./proto/snapshot_execution_result.pb.h"
 #include "./runner/driver/runner_options.h"
+#include "./runner/zygote_protocol.h"
 #include "./snap/gen/relocatable_snap_generator.h"
 #include "./util/arch.h"
 #include "./util/byte_io.h"
@@ -87,28 +95,131 @@ RunnerDriver::RunResult RunnerDriver::VerifyOneRepeatedly(
 
 RunnerDriver::RunResult RunnerDriver::Run(
     const RunnerOptions& runner_options) const {
+  if (zygote_ != nullptr) {
+    return RunInZygote(runner_options);
+  }
   return RunImpl(runner_options);
 }
 
-// Generic entry point for all methods that need to execute the runner binary
-// and handle its output.
-RunnerDriver::RunResult RunnerDriver::RunImpl(
-    const RunnerOptions& runner_options, absl::string_view snap_id,
-    std::optional<HarnessTracer::Callback> trace_cb) const {
-  std::vector<std::string> argv = {binary_path_};
+RunnerDriver::~RunnerDriver() { StopZygote(); }
+
+absl::Status RunnerDriver::StartZygote(const RunnerOptions& runner_options) {
+  CHECK(zygote_ == nullptr);
+  if (corpus_path_.empty()) {
+    return absl::FailedPreconditionError("Zygote mode requires a corpus");
+  }
+  // Children are pinned individually.
+  RunnerOptions zygote_options = runner_options;
+  zygote_options.set_cpu(kAnyCPUId);
+  std::vector<std::string> argv = RunnerArgv(zygote_options, "--zygote");
+
   Subprocess::Options options = Subprocess::Options::Default();
   options.DisableAslr(runner_options.disable_aslr())
-      .SetParentDeathSignal(SIGKILL);
+      .SetParentDeathSignal(SIGKILL)
+      .PipeStdin(true);
+  if (runner_options.map_stderr_to_dev_null()) {
+    options.MapStderr(Subprocess::kMapToDevNull);
+  }
+  auto zygote = std::make_unique<Subprocess>(options);
+  RETURN_IF_NOT_OK(zygote->Start(argv));
+  zygote_ = std::move(zygote);
+  return absl::OkStatus();
+}
+
+void RunnerDriver::StopZygote() {
+  if (zygote_ == nullptr) {
+    return;
+  }
+  // The zygote exits once it sees EOF on stdin.
+  std::string ignored;
+  ProcessInfo info = zygote_->Communicate(&ignored);
+  VLOG_INFO(1, "Zygote exit status = ", info.status);
+  zygote_.reset();
+}
+
+RunnerDriver::RunResult RunnerDriver::RunInZygote(
+    const RunnerOptions& runner_options) const {
+  // The child writes its stdout to this file. Same trick as in
+  // RunnerDriverFromSnapshot() for passing a memfd by path.
+  int output_fd = memfd_create("runner_output", MFD_CLOEXEC);
+  if (output_fd == -1) {
+    return RunResult::InternalError(
+        absl::StrCat("memfd_create: ", strerror(errno)));
+  }
+  absl::Cleanup close_output_fd = [output_fd] { close(output_fd); };
+  const std::string output_path =
+      absl::StrCat("/proc/", getpid(), "/fd/", output_fd);
+  CHECK_LT(output_path.size(), kZygoteMaxOutputPathLength);
+
+  ZygoteRequest request = {};
+  request.magic = kZygoteRequestMagic;
+  request.num_iterations = runner_options.num_iterations();
   if (auto cpu_time_budget = runner_options.cpu_time_budget();
       cpu_time_budget != absl::InfiniteDuration()) {
-    // Soft-cap at the runner_options.cpu_time_budget, hard-cap +1 second
-    // to give the process a chance to exit gracefully.
-    options.SetRLimit(RLIMIT_CPU, absl::ToInt64Seconds(cpu_time_budget),
-                      absl::ToInt64Seconds(cpu_time_budget + absl::Seconds(1)));
+    request.cpu_time_budget_seconds = absl::ToInt64Seconds(cpu_time_budget);
+  }
+  request.cpu = runner_options.cpu();
+  memcpy(request.output_path, output_path.c_str(), output_path.size() + 1);
+  if (Write(zygote_->stdin_fd(), &request, sizeof(request)) !=
+      sizeof(request)) {
+    return RunResult::InternalError("Cannot send request to the zygote");
+  }
+
+  ZygoteResponse response;
+  if (Read(zygote_->stdout_fd(), &response, sizeof(response)) !=
+          sizeof(response) ||
+      response.kind != ZygoteResponse::kStarted) {
+    return RunResult::InternalError("Zygote did not start a child");
   }
   if (auto wall_time_budget = runner_options.wall_time_budget();
       wall_time_budget != absl::InfiniteDuration()) {
-    options.SetITimer(ITIMER_REAL, wall_time_budget);
+    // Equivalent of SetITimer(ITIMER_REAL) for a freshly started runner. The
+    // zygote reports kExited only after reaping the child so the PID cannot
+    // have been reused while we wait.
+    struct pollfd pollfd = {.fd = zygote_->stdout_fd(), .events = POLLIN};
+    const int timeout_ms = std::min<int64_t>(
+        absl::ToInt64Milliseconds(wall_time_budget),
+        std::numeric_limits<int>::max());
+    int ready;
+    while ((ready = poll(&pollfd, 1, timeout_ms)) == -1 && errno == EINTR) {
+    }
+    if (ready == 0) {
+      kill(response.pid, SIGALRM);
+    }
+  }
+  if (Read(zygote_->stdout_fd(), &response, sizeof(response)) !=
+          sizeof(response) ||
+      response.kind != ZygoteResponse::kExited) {
+    return RunResult::InternalError("Zygote died");
+  }
+
+  ProcessInfo info = {};
+  info.status = response.status;
+  info.rusage.ru_utime =
+      absl::ToTimeval(absl::Microseconds(response.user_time_usec));
+  info.rusage.ru_stime =
+      absl::ToTimeval(absl::Microseconds(response.system_time_usec));
+  info.rusage.ru_maxrss = response.max_rss_kb;
+
+  std::string runner_stdout;
+  if (lseek(output_fd, 0, SEEK_SET) != 0) {
+    return RunResult::InternalError(absl::StrCat("lseek: ", strerror(errno)));
+  }
+  char buffer[4096];
+  ssize_t n;
+  while ((n = Read(output_fd, buffer, sizeof(buffer))) > 0) {
+    runner_stdout.append(buffer, n);
+  }
+  RunResult result = HandleRunnerOutput(runner_stdout, info);
+  ParseOptionalOutput(runner_options, runner_stdout, result);
+  return result;
+}
+
+std::vector<std::string> RunnerDriver::RunnerArgv(
+    const RunnerOptions& runner_options, absl::string_view mode_flag) const {
+  std::vector<std::string> argv = {binary_path_};
+  if (!mode_flag.empty()) {
+    argv.push_back(std::string(mode_flag));
   }
   if (runner_options.cpu() != kAnyCPUId) {
     argv.push_back(absl::StrCat("--cpu=", runner_options.cpu()));
@@ -116,6 +227,13 @@ RunnerDriver::RunResult RunnerDriver::RunImpl(
   if (runner_options.sequential_mode()) {
     argv.push_back("--sequential_mode");
   }
+  if (runner_options.profile()) {
+    argv.push_back("--profile");
+  }
+  if (runner_options.num_iterations() > 0) {
+    argv.push_back(
+        absl::StrCat("--num_iterations=", runner_options.num_iterations()));
+  }
   // Pass-thru VLOG levels to the runner.
   if (VLOG_IS_ON(1)) {
     argv.push_back("--v=1");
@@ -132,12 +250,55 @@ RunnerDriver::RunResult RunnerDriver::RunImpl(
   if (!corpus_path_.empty()) {
     argv.push_back(corpus_path_);
   }
+  return argv;
+}
+
+absl::StatusOr<std::unique_ptr<Subprocess>> RunnerDriver::StartRun(
+    const RunnerOptions& runner_options) const {
+  auto runner_proc =
+      std::make_unique<Subprocess>(SubprocessOptions(runner_options));
+  RETURN_IF_NOT_OK(runner_proc->Start(RunnerArgv(runner_options)));
+  return runner_proc;
+}
+
+RunnerDriver::RunResult RunnerDriver::FinishRun(
+    const RunnerOptions& runner_options, absl::string_view runner_stdout,
+    const ProcessInfo& info) const {
+  RunResult result = HandleRunnerOutput(runner_stdout, info);
+  ParseOptionalOutput(runner_options, runner_stdout, result);
+  return result;
+}
+
+Subprocess::Options RunnerDriver::SubprocessOptions(
+    const RunnerOptions& runner_options) {
+  Subprocess::Options options = Subprocess::Options::Default();
+  options.DisableAslr(runner_options.disable_aslr())
+      .SetParentDeathSignal(SIGKILL);
+  if (auto cpu_time_budget = runner_options.cpu_time_budget();
+      cpu_time_budget != absl::InfiniteDuration()) {
+    // Soft-cap at the runner_options.cpu_time_budget, hard-cap +1 second
+    // to give the process a chance to exit gracefully.
+    options.SetRLimit(RLIMIT_CPU, absl::ToInt64Seconds(cpu_time_budget),
+                      absl::ToInt64Seconds(cpu_time_budget + absl::Seconds(1)));
+  }
+  if (auto wall_time_budget = runner_options.wall_time_budget();
+      wall_time_budget != absl::InfiniteDuration()) {
+    options.SetITimer(ITIMER_REAL, wall_time_budget);
+  }
 
   if (runner_options.map_stderr_to_dev_null()) {
     options.MapStderr(Subprocess::kMapToDevNull);
   }
+  return options;
+}
 
-  Subprocess runner_proc(options);
+// Generic entry point for all methods that need to execute the runner binary
+// and handle its output.
+RunnerDriver::RunResult RunnerDriver::RunImpl(
+    const RunnerOptions& runner_options, absl::string_view snap_id,
+    std::optional<HarnessTracer::Callback> trace_cb) const {
+  std::vector<std::string> argv = RunnerArgv(runner_options);
+  Subprocess runner_proc(SubprocessOptions(runner_options));
   if (auto s = runner_proc.Start(argv); !s.ok()) {
     return RunResult::InternalError(s.message());
   }
@@ -160,7 +321,35 @@ RunnerDriver::RunResult RunnerDriver::RunImpl(
       info = tracee_info.value();
     }
   }
-  return HandleRunnerOutput(runner_stdout, info, snap_id);
+  RunResult result = HandleRunnerOutput(runner_stdout, info, snap_id);
+  ParseOptionalOutput(runner_options, runner_stdout, result);
+  return result;
+}
+
+void RunnerDriver::ParseOptionalOutput(const RunnerOptions& runner_options,
+                                       absl::string_view runner_stdout,
+                                       RunResult& result) {
+  // Exclusions are rare, avoid parsing the output of every run for them.
+  if (!runner_options.profile() &&
+      !absl::StrContains(runner_stdout, "excluded_snapshot_id")) {
+    return;
+  }
+  google::protobuf::TextFormat::Parser parser;
+  proto::RunnerOutput runner_output_proto;
+  if (!parser.ParseFromString(runner_stdout, &runner_output_proto)) {
+    LOG(WARNING) << "Cannot parse runner output";
+    return;
+  }
+  if (runner_options.profile()) {
+    proto::SnapCostMap& snap_profile = result.snap_profile_;
+    snap_profile.mutable_snap_profile()->Swap(
+        runner_output_proto.mutable_snap_profile());
+    snap_profile.mutable_execution_cycles_log2_histogram()->Swap(
+        runner_output_proto.mutable_execution_cycles_log2_histogram());
+  }
+  result.excluded_snapshot_ids_.assign(
+      runner_output_proto.excluded_snapshot_id().begin(),
+      runner_output_proto.excluded_snapshot_id().end());
 }
 
 RunnerDriver::RunResult RunnerDriver::HandleRunnerOutput(
@@ -23,13 +23,16 @@
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "./common/harness_tracer.h"
 #include "./common/snapshot.h"
 #include "./common/snapshot_enums.h"
+#include "./proto/snapshot_execution_result.pb.h"
 #include "./runner/driver/runner_options.h"
 #include "./util/checks.h"
 #include "./util/cpu_id.h"
@@ -132,6 +135,16 @@ class RunnerDriver {
       return postfailure_checksum_status_;
     }
 
+    // Per-snap execution profiles reported by the runner. Empty unless the
+    // runner ran with RunnerOptions::profile() set.
+    const proto::SnapCostMap& snap_profile() const { return snap_profile_; }
+
+    // IDs of the snapshots the runner did not run because their memory
+    // mappings conflict with the runner's own.
+    const std::vector<std::string>& excluded_snapshot_ids() const {
+      return excluded_snapshot_ids_;
+    }
+
    private:
     RunResult(const ExecutionResult& execution_result,
               const std::optional<PlayerResult>& player_result,
@@ -165,6 +178,10 @@ class RunnerDriver {
     ExecutionResult execution_result_;
 
     RunnerPostfailureChecksumStatus postfailure_checksum_status_;
+
+    proto::SnapCostMap snap_profile_;
+
+    std::vector<std::string> excluded_snapshot_ids_;
   };
 
   // Creates a RunnerDriver for a binary that reads corpus from `corpus_path`.
@@ -184,7 +201,7 @@ class RunnerDriver {
   RunnerDriver& operator=(const RunnerDriver&) = delete;
   RunnerDriver(RunnerDriver&& other) = default;
   RunnerDriver& operator=(RunnerDriver&& other) = default;
-  ~RunnerDriver() = default;
+  ~RunnerDriver();
 
   // Runs `snap_id` in play mode.
   // REQUIRES snap_id is not empty.
@@ -215,6 +232,33 @@ class RunnerDriver {
   // calling the binary that is intended for screening.
   RunResult Run(const RunnerOptions& runner_options) const;
 
+  // Asynchronous variant of Run() for callers that supervise many runners
+  // from a single thread. Starts the runner and returns its process. The
+  // caller collects stdout and the exit status of the process (see
+  // Subprocess::ReadStdout() and Subprocess::Wait()) and converts them with
+  // FinishRun(). Zygotes are not used.
+  absl::StatusOr<std::unique_ptr<Subprocess>> StartRun(
+      const RunnerOptions& runner_options) const;
+
+  // Converts the output of a runner started with StartRun(`runner_options`)
+  // into a RunResult.
+  RunResult FinishRun(const RunnerOptions& runner_options,
+                      absl::string_view runner_stdout,
+                      const ProcessInfo& info) const;
+
+  // Starts a runner in zygote mode (see ZygoteMain() in runner.h) which loads
+  // and maps the corpus once. Until StopZygote(), every Run() forks a child of
+  // the zygote instead of starting a new runner process. extra_argv and
+  // profile() in `runner_options` apply to all children. cpu(),
+  // num_iterations() and the time budgets are taken from each Run() call.
+  // REQUIRES: the driver has a corpus and no zygote is running.
+  absl::Status StartZygote(const RunnerOptions& runner_options);
+
+  // Terminates the zygote, if any. Called by the d-tor.
+  void StopZygote();
+
+  bool has_zygote() const { return zygote_ != nullptr; }
+
  private:
   // Wraps the binary at `binary_path`. When `corpus_path` not empty, it will
   // be passed as the last argument to the binary.
@@ -250,15 +294,36 @@ class RunnerDriver {
       const RunnerOptions& runner_options, absl::string_view snap_id = "",
       std::optional<HarnessTracer::Callback> trace_cb = std::nullopt) const;
 
+  // Returns the options of the runner subprocess for `runner_options`.
+  static Subprocess::Options SubprocessOptions(
+      const RunnerOptions& runner_options);
+
+  // Run() implementation in zygote mode.
+  RunResult RunInZygote(const RunnerOptions& runner_options) const;
+
+  // Returns the command line for running the runner with `runner_options`.
+  // `mode_flag` is passed first if not empty.
+  std::vector<std::string> RunnerArgv(const RunnerOptions& runner_options,
+                                      absl::string_view mode_flag = "") const;
+
   RunResult HandleRunnerOutput(absl::string_view runner_stdout,
                                const ProcessInfo& info,
                                absl::string_view snapshot_id = "") const;
 
+  // Extracts snap profiles (if requested by `runner_options`) and excluded
+  // snapshot ids from `runner_stdout` into `result`.
+  static void ParseOptionalOutput(const RunnerOptions& runner_options,
+                                  absl::string_view runner_stdout,
+                                  RunResult& result);
+
   // C-tor parameters.
   std::string binary_path_;
   std::string corpus_path_;
   std::string corpus_name_;
 
+  // Runner process started by StartZygote() or nullptr.
+  std::unique_ptr<Subprocess> zygote_;
+
   // Cleanup callback handle. Wraps the user-provided `cleanup` std::function in
   // a container with "at most once" cleanup semantics. When an instance of this
   // class is moved, the handle is moved with it and the moved-from
@@ -21,11 +21,13 @@
 #include <filesystem>  // NOLINT
 
 #include "gtest/gtest.h"
+#include "absl/time/time.h"
 #include "./common/harness_tracer.h"
 #include "./common/proxy_config.h"
 #include "./common/snapshot.h"
 #include "./common/snapshot_enums.h"
 #include "./common/snapshot_test_enum.h"
+#include "./runner/driver/runner_options.h"
 #include "./runner/runner_provider.h"
 #include "./snap/testing/snap_test_snapshots.h"
 #include "./util/arch.h"
@@ -131,6 +133,54 @@ TEST(RunnerDriver, BasicTrace) {
   EXPECT_GE(trace_result_or.rusage().ru_maxrss, 4);
 }
 
+TEST(RunnerDriver, Zygote) {
+  RunnerDriver driver = HelperDriver();
+  // Restrict the zygote to a single snap that is expected to pass.
+  RunnerOptions options =
+      RunnerOptions::PlayOptions(EnumStr(TestSnapshot::kEndsAsExpected));
+  ASSERT_OK(driver.StartZygote(options));
+  ASSERT_TRUE(driver.has_zygote());
+  // The zygote gets SIGCHLD for every child and must keep serving requests.
+  for (int i = 0; i < 3; ++i) {
+    RunnerDriver::RunResult run_result = driver.Run(options);
+    ASSERT_TRUE(run_result.success())
+        << run_result.execution_result().DebugString();
+    EXPECT_GE(run_result.rusage().ru_maxrss, 4);
+  }
+  driver.StopZygote();
+  EXPECT_FALSE(driver.has_zygote());
+}
+
+TEST(RunnerDriver, ZygoteSnapFailure) {
+  RunnerDriver driver = HelperDriver();
+  RunnerOptions options =
+      RunnerOptions::PlayOptions(EnumStr(TestSnapshot::kSigSegvRead));
+  ASSERT_OK(driver.StartZygote(options));
+  // Every child reports the failure independently.
+  for (int i = 0; i < 2; ++i) {
+    RunnerDriver::RunResult run_result = driver.Run(options);
+    ASSERT_FALSE(run_result.success());
+    EXPECT_EQ(run_result.failed_snapshot_id(),
+              EnumStr(TestSnapshot::kSigSegvRead));
+    EXPECT_EQ(run_result.failed_player_result().outcome,
+              PlaybackOutcome::kExecutionMisbehave);
+  }
+}
+
+TEST(RunnerDriver, ZygoteChildTimeout) {
+  RunnerDriver driver = HelperDriver();
+  RunnerOptions options =
+      RunnerOptions::PlayOptions(EnumStr(TestSnapshot::kRunaway));
+  options.set_wall_time_budget(absl::Seconds(1));
+  ASSERT_OK(driver.StartZygote(options));
+  // A child killed by the deadline does not take the zygote down with it.
+  for (int i = 0; i < 2; ++i) {
+    RunnerDriver::RunResult run_result = driver.Run(options);
+    ASSERT_TRUE(run_result.success())
+        << run_result.execution_result().DebugString();
+  }
+}
+
 TEST(RunnerDriver, Cleanup) {
   auto tmp_binary = CreateTempFile("binary");
   ASSERT_OK(tmp_binary);
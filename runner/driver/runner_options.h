@@ -16,6 +16,7 @@
 #define THIRD_PARTY_SILIFUZZ_RUNNER_DRIVER_RUNNER_OPTIONS_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -65,6 +66,16 @@ class RunnerOptions {
     return *this;
   }
 
+  RunnerOptions& set_num_iterations(int64_t num_iterations) {
+    this->num_iterations_ = num_iterations;
+    return *this;
+  }
+
+  RunnerOptions& set_profile(bool profile) {
+    this->profile_ = profile;
+    return *this;
+  }
+
   int cpu() const { return cpu_; }
   absl::Duration cpu_time_budget() const { return cpu_time_budget_; }
   absl::Duration wall_time_budget() const { return wall_time_budget_; }
@@ -73,6 +84,8 @@ class RunnerOptions {
   bool disable_aslr() const { return disable_aslr_; }
   bool sequential_mode() const { return sequential_mode_; }
   bool map_stderr_to_dev_null() const { return map_stderr_to_dev_null_; }
+  bool profile() const { return profile_; }
+  int64_t num_iterations() const { return num_iterations_; }
 
   RunnerOptions(const RunnerOptions&) = default;
   RunnerOptions(RunnerOptions&&) = default;
@@ -124,6 +137,13 @@ class RunnerOptions {
 
   // If true, map runner's stderr to /dev/null.
   bool map_stderr_to_dev_null_ = false;
+
+  // If true, the runner reports per-snap execution cost.
+  bool profile_ = false;
+
+  // Number of snaps to execute. 0 means the runner's default. An explicit
+  // --num_iterations in extra_argv takes precedence.
+  int64_t num_iterations_ = 0;
 };
 
 }  // namespace silifuzz
@@ -14,8 +14,10 @@
 
 #include "./runner/runner.h"
 
+#include <fcntl.h>
 #include <signal.h>
 #include <sys/mman.h>
+#include <sys/prctl.h>
 #include <sys/resource.h>
 #include <sys/ucontext.h>
 #include <ucontext.h>
@@ -34,13 +36,17 @@
 #include "./runner/endspot.h"
 #include "./runner/runner_main_options.h"
 #include "./runner/runner_util.h"
+#include "./runner/snap_profile.h"
 #include "./runner/snap_runner_util.h"
+#include "./runner/zygote_protocol.h"
 #include "./snap/exit_sequence.h"
 #include "./snap/snap.h"
 #include "./snap/snap_checksum.h"
 #include "./util/arch.h"
+#include "./util/byte_io.h"
 #include "./util/checks.h"
 #include "./util/cpu_id.h"
+#include "./util/cycle_counter.h"
 #include "./util/itoa.h"
 #include "./util/logging_util.h"
 #include "./util/mem_util.h"
@@ -51,6 +57,7 @@
 #include "./util/reg_group_io.h"
 #include "./util/reg_group_set.h"
 #include "./util/reg_groups.h"
+#include "./util/strcat.h"
 #include "./util/text_proto_printer.h"
 #include "./util/ucontext/serialize.h"
 #include "./util/ucontext/signal.h"
@@ -66,7 +73,8 @@
 //  stdout:   a single silifuzz.proto.SnapshotExecutionResult formatted as
 //            text proto. In "run" mode this happens for the first failed snap,
 //            in "make" mode the proto is always printed. This is intended to
-//            be machine-readable.
+//            be machine-readable. Snaps skipped because their memory mappings
+//            conflict with the runner's own are listed before anything else.
 //  stderr:   human-readable log messages. The verbosity is controlled by --v
 //            with the following levels.
 //             0: Quiet (default).
@@ -83,6 +91,10 @@
 //             TODO(ksteuck): [impl] an exit code for internal process failure
 //               (mapping conflict, unmappable region, etc).
 //
+// In zygote mode (--zygote) stdin and stdout instead carry the binary protocol
+// described in zygote_protocol.h and the API above applies to every forked
+// child, whose stdout is redirected to the file named in its request.
+//
 // Signal handling:
 //
 // This process supports receiving the following signals:
@@ -94,6 +106,12 @@
 //             The process will exit immediately with exit code 2 when this
 //             signal is received.
 //
+//    In profiling mode (--profile) and with delayed verification
+//    (--verify_interval > 1) the exit on SIGALRM and on SIGXCPU outside of a
+//    snap is deferred until the current snap finishes so that the collected
+//    profile can be written to stdout and the recorded end states verified
+//    first. SIGXCPU inside a snap is still reported as a runaway.
+//
 // This process can terminate with the following signals:
 //    SIGKILL: the process was limited by setrlimit(2) and exceeded its
 //             hard CPU bugdet or another process or the operating system
@@ -137,6 +155,25 @@ constexpr size_t kMaxAddedPageAddresses = 20;
 
 uint64_t added_page_addresses[kMaxAddedPageAddresses];
 
+// When true, SigAction() does not exit on a timeout signal but sets
+// `timeout_pending` and returns. The main loop checks `timeout_pending` after
+// every snap. This is enabled in profiling mode and with delayed verification
+// so that the collected data is not lost. See DelaysVerification().
+bool defer_timeout_exit = false;
+volatile bool timeout_pending = false;
+
+// Snaps left out of the corpus by MapCorpus() because their memory mappings
+// conflict with the runner's own. See LogExcludedSnaps().
+SnapArray<const Snap<Host>*> excluded_snaps = {};
+
+// ExpectedEndStateMemoryChecksum() of every snap of the corpus, indexed like
+// its snap list. Only set with delayed verification. See
+// InitExpectedMemoryChecksums().
+const uint32_t* expected_memory_checksums = nullptr;
+
+// Exit code for graceful shutdown due to timeout. See file-level comment.
+constexpr int kTimeoutExitCode = 2;
+
 // Logs RunnerOutput::ExecutionResult-formatted message to stdout. Every code
 // path that exits the runner (either via _exit() or LOG_FATAL) should call this
 // function.
@@ -224,9 +261,14 @@ bool TryToRecoverFromSignal(int signal, const siginfo_t& siginfo,
 // NOTE: even though this handler is installed for SIGSYS it will be
 // ignored. See file-level comment.
 void SigAction(int signal, siginfo_t* siginfo, void* uc) {
-  // SIGALRM signals deadline from the orchestrator. Exit immediately.
+  // SIGALRM signals deadline from the orchestrator. Exit immediately unless
+  // the exit is deferred.
   if (signal == SIGALRM) {
-    _exit(2);
+    if (defer_timeout_exit) {
+      timeout_pending = true;
+      return;
+    }
+    _exit(kTimeoutExitCode);
   }
   const ucontext_t* ucontext = reinterpret_cast<const ucontext_t*>(uc);
   if (IsInsideSnap()) {
@@ -246,10 +288,14 @@ void SigAction(int signal, siginfo_t* siginfo, void* uc) {
   }
   // A signal was not caused by any snapshot. If it is one of the
   // timeout signals we _exit(2). Otherwise crash.
+  if (signal == SIGXCPU && defer_timeout_exit) {
+    timeout_pending = true;
+    return;
+  }
   ASS_LOG_INFO("Received signal ", SignalNameStr(signal),
                " while outside of snap. Exiting");
   if (signal == SIGXCPU) {
-    _exit(2);
+    _exit(kTimeoutExitCode);
   }
   // A signal occurred while executing the runner code. Most likely indicates
   // a bug in the runner or a signal from the environment (keyboard, RLIMIT).
@@ -293,29 +339,26 @@ void CheckFixedMmapOK(void* mapped_address, void* target_address) {
   }
 }
 
-// Can this memory mapping be mapped directly from the backing file?
-bool CanDirectMap(const SnapMemoryMapping& memory_mapping) {
-  // We could support mmapping writeable pages with COW, but that's not a
-  // feature we need right now and it makes the code a little more complicated.
-  if ((memory_mapping.perms & PROT_WRITE) != 0) {
-    return false;
-  }
-  // There must be only one memory_bytes entry.
-  if (memory_mapping.memory_bytes.size != 1) {
-    return false;
-  }
-  const SnapMemoryBytes& memory_bytes = memory_mapping.memory_bytes[0];
-  // The bytes must be uncompressed.
-  if (memory_bytes.repeating()) {
-    return false;
+// Sets the final protections of a mapping created with
+// kInitialMappingProtection.
+void ProtectMapping(uint64_t start_address, uint64_t num_bytes, int perms) {
+  if (perms == kInitialMappingProtection) {
+    return;
   }
-  // The bytes must cover the mapping completely.
-  if (memory_bytes.start_address != memory_mapping.start_address ||
-      memory_bytes.size() != memory_mapping.num_bytes) {
-    return false;
+  VLOG_INFO(2, "mprotect mapping ", HexStr(start_address));
+  // mprotect should sync the data cache and invalidate the instruction
+  // cache as needed. No need to do it explicitly.
+  void* target_address = AsPtr(start_address);
+  if (mprotect(target_address, num_bytes, perms) != 0) {
+    LOG_FATAL("mprotect(", HexStr(AsInt(target_address)),
+              ") failed: ", ErrnoStr(errno));
   }
-  // The underlying data pointer must be page aligned.
-  return IsPageAligned(memory_bytes.data.byte_values.elements);
+}
+
+// Returns true iff end states are verified after a sequence of snaps ran.
+// See RunnerMainOptions::verify_interval.
+bool DelaysVerification(const RunnerMainOptions& options) {
+  return options.verify_interval > 1 && !options.skip_end_state_check;
 }
 
 SeccompOptions SeccompOptionsFromRunnerMainOptions(
@@ -326,6 +369,10 @@ SeccompOptions SeccompOptionsFromRunnerMainOptions(
     seccomp_options.allow_mmap = true;
     seccomp_options.allow_rt_sigreturn = true;
   }
+  // Deferred timeout handling returns from the signal handler.
+  if (options.profile || DelaysVerification(options)) {
+    seccomp_options.allow_rt_sigreturn = true;
+  }
   return seccomp_options;
 }
 
@@ -385,7 +432,7 @@ void CreateMemoryMapping(const SnapMemoryMapping& memory_mapping, int corpus_fd,
 
   // Make the initial mapping.
   void* target_address = AsPtr(start_address);
-  if (corpus_fd != -1 && CanDirectMap(memory_mapping)) {
+  if (corpus_fd != -1 && memory_mapping.direct_mappable()) {
     // We can map this data directly from the corpus file.
 
     // Calculate offset of the bytes from the start of the corpus file.
@@ -417,17 +464,8 @@ void CreateMemoryMapping(const SnapMemoryMapping& memory_mapping, int corpus_fd,
     }
 
     // Set the final protections.
-    if (memory_mapping.perms != kInitialMappingProtection) {
-      VLOG_INFO(2, "mprotect mapping ", HexStr(start_address));
-      // mprotect should sync the data cache and invalidate the instruction
-      // cache as needed. No need to do it explicitly.
-      int mprotect_result = mprotect(target_address, memory_mapping.num_bytes,
-                                     memory_mapping.perms);
-      if (mprotect_result != 0) {
-        LOG_FATAL("mprotect(", HexStr(AsInt(target_address)),
-                  ") failed: ", ErrnoStr(errno));
-      }
-    }
+    ProtectMapping(start_address, memory_mapping.num_bytes,
+                   memory_mapping.perms);
   }
 }
 
@@ -438,6 +476,52 @@ void MapSnap(const Snap<Host>& snap, int corpus_fd,
   }
 }
 
+// Establishes the memory mappings of all snaps in `corpus` from its mapping
+// plan. This creates one mapping per plan entry instead of one per memory
+// mapping of every snap.
+// REQUIRES: corpus.mapping_plan is not empty.
+void MapCorpusPlan(const SnapCorpus<Host>& corpus, int corpus_fd) {
+  for (const SnapCorpusMapping& entry : corpus.mapping_plan) {
+    VLOG_INFO(2, "Mapping ", HexStr(entry.start_address));
+    void* target_address = AsPtr(entry.start_address);
+    void* mapped_address;
+    if (corpus_fd != -1 && entry.direct_mapped()) {
+      mapped_address =
+          mmap(target_address, entry.num_bytes, entry.perms,
+               MAP_SHARED | MAP_FIXED, corpus_fd, entry.file_offset);
+    } else {
+      mapped_address = mmap(target_address, entry.num_bytes,
+                            kInitialMappingProtection,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+    }
+    CheckFixedMmapOK(mapped_address, target_address);
+  }
+
+  // Initialize the read-only data not mapped from the corpus file. Writable
+  // mappings are initialized before each snap runs.
+  size_t num_memory_mappings = 0;
+  for (const auto& snap : corpus.snaps) {
+    num_memory_mappings += snap->memory_mappings.size;
+    for (const auto& memory_mapping : snap->memory_mappings) {
+      if (memory_mapping.writable() ||
+          (corpus_fd != -1 && memory_mapping.direct_mappable())) {
+        continue;
+      }
+      for (const auto& memory_bytes : memory_mapping.memory_bytes) {
+        SetupMemoryBytes(memory_bytes);
+      }
+    }
+  }
+
+  for (const SnapCorpusMapping& entry : corpus.mapping_plan) {
+    if (corpus_fd == -1 || !entry.direct_mapped()) {
+      ProtectMapping(entry.start_address, entry.num_bytes, entry.perms);
+    }
+  }
+  VLOG_INFO(1, "Created ", corpus.mapping_plan.size, " mappings for ",
+            num_memory_mappings, " snap memory mappings");
+}
+
 // ApplyProcMapsFixups manipulates this process' memory mappings. Resizes the
 // [stack] mapping to occupy the maximum allowed stack size. Unmaps [vdso] and
 // [vvar] mappings.
@@ -466,14 +550,86 @@ void ApplyProcMapsFixups(ProcMapsEntry proc_maps_entries[],
   }
 }
 
-// MapCorpus establishes memory mappings for all snaps in 'corpus'. If a
-// snap uses a memory mapping that conflicts with the runner itself (binary,
-// stack, heap and VDSO), it can crash the runner. Therefore, it performs
-// range checks before adding memory mappings into the runners address
-// space and dies if a conflict is detected.
-void MapCorpus(const SnapCorpus<Host>& corpus, int corpus_fd,
-               const void* corpus_mapping) {
-  CHECK(corpus.IsExpectedArch());
+// Returns the snaps of `corpus` that do not conflict with the runner's memory
+// mappings in `proc_maps_entries`. That is `corpus` itself when no snap
+// conflicts. Otherwise it is a copy of `corpus` listing only the other snaps
+// and `excluded_snaps` lists the conflicting ones. Dies if every snap
+// conflicts.
+//
+// The snap list is allocated once with mmap() as there is no heap.
+const SnapCorpus<Host>* FilterCorpus(const SnapCorpus<Host>& corpus,
+                                     const ProcMapsEntry proc_maps_entries[],
+                                     size_t num_proc_maps_entries) {
+  auto conflicts = [&](const Snap<Host>* snap) {
+    return SnapOverlapsWithProcMapsEntries(*snap, proc_maps_entries,
+                                           num_proc_maps_entries);
+  };
+  size_t num_excluded = 0;
+  for (const auto& snap : corpus.snaps) {
+    if (conflicts(snap)) ++num_excluded;
+  }
+  if (num_excluded == 0) {
+    return &corpus;
+  }
+  if (num_excluded == corpus.snaps.size) {
+    LogExecutionResult(RunnerExecutionStatusCode::kOverlappingMappings);
+    LOG_FATAL("Cannot handle overlapping mappings");
+  }
+
+  // Active snaps go first, in corpus order, followed by the excluded ones.
+  const size_t num_bytes = corpus.snaps.size * sizeof(const Snap<Host>*);
+  void* snaps_ptr = mmap(nullptr, num_bytes, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (snaps_ptr == MAP_FAILED) {
+    LogExecutionResult(RunnerExecutionStatusCode::kMmapFailed);
+    LOG_FATAL("Cannot allocate the snap list: ", ErrnoStr(errno));
+  }
+  const Snap<Host>** snaps = static_cast<const Snap<Host>**>(snaps_ptr);
+  const size_t num_active = corpus.snaps.size - num_excluded;
+  size_t active_index = 0;
+  size_t excluded_index = num_active;
+  for (const auto& snap : corpus.snaps) {
+    if (conflicts(snap)) {
+      VLOG_INFO(1, "Excluding ", snap->id);
+      snaps[excluded_index++] = snap;
+    } else {
+      snaps[active_index++] = snap;
+    }
+  }
+  CHECK_EQ(active_index, num_active);
+  excluded_snaps = {.size = num_excluded, .elements = snaps + num_active};
+  LOG_ERROR("Excluded ", IntStr(num_excluded), " of ",
+            IntStr(corpus.snaps.size),
+            " snaps overlapping the runner's memory mappings");
+
+  static SnapCorpus<Host> active_corpus = {};
+  memcpy(&active_corpus, &corpus, sizeof(active_corpus));
+  active_corpus.snaps = {.size = num_active, .elements = snaps};
+  // The plan covers the mappings of the excluded snaps too.
+  active_corpus.mapping_plan = {.size = 0, .elements = nullptr};
+  return &active_corpus;
+}
+
+// Logs the ids of `excluded_snaps` to stdout as
+// proto.RunnerOutput.excluded_snapshot_id entries.
+void LogExcludedSnaps() {
+  for (const auto& snap : excluded_snaps) {
+    // One entry at a time, a long list does not fit into a TextProtoPrinter.
+    TextProtoPrinter runner_output;
+    runner_output.String("excluded_snapshot_id", snap->id);
+    LogToStdout(runner_output.c_str());
+  }
+}
+
+// MapCorpus establishes memory mappings for the snaps in 'corpus' and returns
+// the corpus of snaps to run. If a snap uses a memory mapping that conflicts
+// with the runner itself (binary, stack, heap and VDSO), it can crash the
+// runner. Therefore, it performs range checks before adding memory mappings
+// into the runners address space and leaves out the conflicting snaps. See
+// FilterCorpus().
+const SnapCorpus<Host>* MapCorpus(const SnapCorpus<Host>& full_corpus,
+                                  int corpus_fd, const void* corpus_mapping) {
+  CHECK(full_corpus.IsExpectedArch());
 
   // On x86_64, we should only need 8 entries to describe all memory ranges when
   // running a fully static runner. 20 is more than enough to avoid overflow.
@@ -491,31 +647,32 @@ void MapCorpus(const SnapCorpus<Host>& corpus, int corpus_fd,
   }
   ApplyProcMapsFixups(proc_maps_entries, num_proc_maps_entries);
 
+  const SnapCorpus<Host>& corpus =
+      *FilterCorpus(full_corpus, proc_maps_entries, num_proc_maps_entries);
+
   VLOG_INFO(1, "Creating memory mappings");
-  for (const auto& snap : corpus.snaps) {
-    // TODO(dougkwan): [impl] Make this fail more gracefully. We can skip
-    // conflicting snaps. To do that we need space to store the passing
-    // snaps. One possible way to do that without additional memory
-    // allocation at runtime is to make 'corpus' writable and remove
-    // conflicting snaps found here.
-    if (SnapOverlapsWithProcMapsEntries(*snap, proc_maps_entries,
-                                        num_proc_maps_entries)) {
-      LogExecutionResult(RunnerExecutionStatusCode::kOverlappingMappings);
-      LOG_FATAL("Cannot handle overlapping mappings");
-    }
-    // If any of these memory mappings overlap, the mapping earlier in this list
-    // will be silently overwritten by the mapping later in this list.
-    // Currently, the corpus creator should avoid overlapping RO pages, but
-    // there may be zero-initialized RW pages that overlap between snaps. The
-    // most obvious case will be that most Snaps will have stacks mapped in
-    // exactly the same location.
-    MapSnap(*snap, corpus_fd, corpus_mapping);
+  if (corpus.mapping_plan.size > 0) {
+    MapCorpusPlan(corpus, corpus_fd);
+  } else {
+    // The generator leaves the plan empty if read-only mappings overlap and
+    // FilterCorpus() drops it if it excluded any snaps. Map the snaps one at a
+    // time instead.
+    for (const auto& snap : corpus.snaps) {
+      // If any of these memory mappings overlap, the mapping earlier in this
+      // list will be silently overwritten by the mapping later in this list.
+      // Currently, the corpus creator should avoid overlapping RO pages, but
+      // there may be zero-initialized RW pages that overlap between snaps. The
+      // most obvious case will be that most Snaps will have stacks mapped in
+      // exactly the same location.
+      MapSnap(*snap, corpus_fd, corpus_mapping);
+    }
   }
   VLOG_INFO(1, "Done creating memory mappings");
 
   if (corpus_fd != -1) {
     CHECK_EQ(close(corpus_fd), 0);
   }
+  return &corpus;
 }
 
 bool VerifySnapChecksums(const Snap<Host>& snap) {
@@ -568,8 +725,9 @@ bool VerifySnapChecksums(const Snap<Host>& snap) {
     VLOG_INFO(1, "Checksumming ", snap.id, " end state registers");
     const SnapRegisterMemoryChecksum<Host>& expected =
         snap.end_state_registers_memory_checksum;
+    UContext<Host> storage;
     const SnapRegisterMemoryChecksum<Host> actual =
-        CalculateRegisterMemoryChecksum(snap.end_state_registers);
+        CalculateRegisterMemoryChecksum(EndStateRegisters(snap, storage));
     if (expected != actual) {
       LOG_ERROR(snap.id, " end state registers");
       LogRegisterChecksumDiffs(expected, actual);
@@ -590,29 +748,50 @@ void VerifyChecksums(const SnapCorpus<Host>& corpus) {
   }
 }
 
+// Returns the outcome of a snap that ended with `signum`.
+RunSnapOutcome SignalToOutcome(int signum) {
+  if (signum == SIGXCPU || signum == SIGALRM) {
+    return RunSnapOutcome::kExecutionRunaway;
+  }
+  return RunSnapOutcome::kExecutionMisbehave;
+}
+
+// Returns false iff `snap` has a register checksum of the same register groups
+// as `register_checksum` and the checksums differ.
+bool RegisterChecksumMatches(const Snap<Host>& snap,
+                             const RegisterChecksum<Host>& register_checksum) {
+  RegisterChecksum<Host> snap_checksum = snap.end_state_register_checksum;
+  if (!snap_checksum.register_groups.Empty() &&
+      snap_checksum.register_groups == register_checksum.register_groups &&
+      snap.end_state_register_checksum != register_checksum) {
+    VLOG_INFO(1, "Register checksum mismatch: ",
+              HexStr(snap.end_state_register_checksum.checksum), " vs ",
+              HexStr(register_checksum.checksum));
+    return false;
+  }
+  return true;
+}
+
 RunSnapOutcome EndSpotToOutcome(const Snap<Host>& snap,
                                 const EndSpot& end_spot) {
   if (end_spot.signum != 0) {
-    if (end_spot.signum == SIGXCPU || end_spot.signum == SIGALRM) {
-      return RunSnapOutcome::kExecutionRunaway;
-    }
-    return RunSnapOutcome::kExecutionMisbehave;
+    return SignalToOutcome(end_spot.signum);
   }
-  // Verify register state.
-  if (!MemEqT(*end_spot.gregs, *snap.end_state_registers.gregs) ||
-      !MemEqT(*end_spot.fpregs, *snap.end_state_registers.fpregs)) {
+  // Verify register state. A delta is compared without reconstructing the
+  // full register sets.
+  if (const SnapRegisterDelta<Host>* delta = EndStateRegistersDelta(snap);
+      delta != nullptr) {
+    if (!RegisterSetMatchesDelta(delta->gregs, *end_spot.gregs) ||
+        !RegisterSetMatchesDelta(delta->fpregs, *end_spot.fpregs)) {
+      return RunSnapOutcome::kRegisterStateMismatch;
+    }
+  } else if (!MemEqT(*end_spot.gregs, *snap.end_state_registers.gregs) ||
+             !MemEqT(*end_spot.fpregs, *snap.end_state_registers.fpregs)) {
     return RunSnapOutcome::kRegisterStateMismatch;
   }
   // Verify register checksum if there is one in the snap and it references the
   // same register groups.
-  RegisterChecksum<Host> snap_checksum = snap.end_state_register_checksum;
-  if (!snap_checksum.register_groups.Empty() &&
-      snap_checksum.register_groups ==
-          end_spot.register_checksum.register_groups &&
-      snap.end_state_register_checksum != end_spot.register_checksum) {
-    VLOG_INFO(1, "Register checksum mismatch: ",
-              HexStr(snap.end_state_register_checksum.checksum), " vs ",
-              HexStr(end_spot.register_checksum.checksum));
+  if (!RegisterChecksumMatches(snap, end_spot.register_checksum)) {
     return RunSnapOutcome::kRegisterStateMismatch;
   }
 
@@ -627,6 +806,117 @@ RunSnapOutcome EndSpotToOutcome(const Snap<Host>& snap,
   return RunSnapOutcome::kAsExpected;
 }
 
+// A compact record of the end state reached by a snap, verified after a
+// sequence of snaps ran. See RunnerMainOptions::verify_interval.
+struct EndSpotRecord {
+  // Index of the snap in the corpus.
+  size_t snap_index;
+
+  // Main loop iteration that ran the snap.
+  size_t iteration;
+
+  // Same as RunSnapResult::cpu_id.
+  int64_t cpu_id;
+
+  // Same as EndSpot::signum. The rest is not recorded if this is not 0.
+  int signum;
+
+  // Same as EndSpot::register_checksum.
+  RegisterChecksum<Host> register_checksum;
+
+  // Checksums of the registers in the EndSpot.
+  SnapRegisterMemoryChecksum<Host> registers_checksum;
+
+  // Checksum of the memory covered by the snap's end state memory bytes.
+  uint32_t memory_checksum;
+
+  // Only set if RunnerMainOptions::profile is true.
+  SnapCycles cycles;
+};
+
+// Returns the checksum of the current memory contents at the end state memory
+// bytes of `snap`.
+uint32_t EndStateMemoryChecksum(const Snap<Host>& snap) {
+  MemoryChecksumCalculator checksum;
+  for (const auto& memory_bytes : snap.end_state_memory_bytes) {
+    checksum.AddData(AsPtr(memory_bytes.start_address), memory_bytes.size());
+  }
+  return checksum.Checksum();
+}
+
+// Returns the checksum that EndStateMemoryChecksum() computes if the snap
+// ends as expected.
+uint32_t ExpectedEndStateMemoryChecksum(const Snap<Host>& snap) {
+  MemoryChecksumCalculator checksum;
+  for (const auto& memory_bytes : snap.end_state_memory_bytes) {
+    if (memory_bytes.repeating()) {
+      char run[256];
+      MemSet(run, memory_bytes.data.byte_run.value, sizeof(run));
+      for (size_t size = memory_bytes.size(); size > 0;) {
+        const size_t chunk_size = std::min(size, sizeof(run));
+        checksum.AddData(run, chunk_size);
+        size -= chunk_size;
+      }
+    } else {
+      checksum.AddData(memory_bytes.data.byte_values.elements,
+                       memory_bytes.size());
+    }
+  }
+  return checksum.Checksum();
+}
+
+// Records the end state in `end_spot` reached by `snap` in `record`.
+void RecordEndSpot(const Snap<Host>& snap, const EndSpot& end_spot,
+                   EndSpotRecord& record) {
+  record.signum = end_spot.signum;
+  if (end_spot.signum != 0) {
+    return;
+  }
+  record.register_checksum = end_spot.register_checksum;
+  record.registers_checksum.gregs_checksum =
+      CalculateMemoryChecksum(*end_spot.gregs);
+  record.registers_checksum.fpregs_checksum =
+      CalculateMemoryChecksum(*end_spot.fpregs);
+  record.memory_checksum = EndStateMemoryChecksum(snap);
+}
+
+// Computes `expected_memory_checksums` for `corpus` so that verifying a
+// record does not expand the end state memory bytes every time.
+//
+// The array is allocated once with mmap() as there is no heap.
+void InitExpectedMemoryChecksums(const SnapCorpus<Host>& corpus) {
+  void* checksums_ptr =
+      mmap(nullptr, corpus.snaps.size * sizeof(uint32_t),
+           PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (checksums_ptr == MAP_FAILED) {
+    LogExecutionResult(RunnerExecutionStatusCode::kMmapFailed);
+    LOG_FATAL("Cannot allocate memory checksums: ", ErrnoStr(errno));
+  }
+  uint32_t* checksums = static_cast<uint32_t*>(checksums_ptr);
+  for (size_t i = 0; i < corpus.snaps.size; ++i) {
+    checksums[i] = ExpectedEndStateMemoryChecksum(*corpus.snaps[i]);
+  }
+  expected_memory_checksums = checksums;
+}
+
+// Same as EndSpotToOutcome() but for an EndSpotRecord.
+// Requires InitExpectedMemoryChecksums().
+RunSnapOutcome EndSpotRecordToOutcome(const Snap<Host>& snap,
+                                      const EndSpotRecord& record) {
+  if (record.signum != 0) {
+    return SignalToOutcome(record.signum);
+  }
+  if (record.registers_checksum != snap.end_state_registers_memory_checksum ||
+      !RegisterChecksumMatches(snap, record.register_checksum)) {
+    return RunSnapOutcome::kRegisterStateMismatch;
+  }
+  if (record.memory_checksum != expected_memory_checksums[record.snap_index]) {
+    VLOG_INFO(1, "Memory checksum mismatch");
+    return RunSnapOutcome::kMemoryMismatch;
+  }
+  return RunSnapOutcome::kAsExpected;
+}
+
 // Copies read/writable memory contents needed to run the snap.
 void PrepareSnapMemory(const Snap<Host>& snap) {
   for (const auto& memory_mapping : snap.memory_mappings) {
@@ -679,19 +969,18 @@ void LogSnapRunResult(const Snap<Host>& snap, const RunnerMainOptions& options,
               "] failed, outcome = ", IntStr(ToInt(run_result.outcome)));
     LOG_ERROR("Corpus   [", options.corpus_name, "]");
     if (run_result.outcome == RunSnapOutcome::kRegisterStateMismatch) {
+      UContext<Host> storage;
+      const UContextView<Host> expected = EndStateRegisters(snap, storage);
       LOG_INFO("Registers (diff vs expected end_state 0):");
       LOG_INFO("  gregs (modified only):");
       // Use instruction pointer == 0 as a proxy for undefined state. The only
       // possible case where the value is 0 is for Snaps with the undefined end
       // state.
       // See SnapGenerator::Options::allow_undefined_end_state for details.
-      bool log_diff =
-          snap.end_state_registers.gregs->GetInstructionPointer() != 0;
-      LogGRegs(*run_result.end_spot.gregs, snap.end_state_registers.gregs,
-               log_diff);
+      bool log_diff = expected.gregs->GetInstructionPointer() != 0;
+      LogGRegs(*run_result.end_spot.gregs, expected.gregs, log_diff);
       LOG_INFO("  fpregs (modified only):");
-      LogFPRegs(*run_result.end_spot.fpregs, true,
-                snap.end_state_registers.fpregs, log_diff);
+      LogFPRegs(*run_result.end_spot.fpregs, true, expected.fpregs, log_diff);
       LogRegisterChecksum(run_result.end_spot.register_checksum,
                           &snap.end_state_register_checksum, log_diff);
     } else if (run_result.outcome == RunSnapOutcome::kMemoryMismatch) {
@@ -768,6 +1057,52 @@ void LogSnapRunResult(const Snap<Host>& snap, const RunnerMainOptions& options,
   LogToStdout(runner_output.c_str());
 }
 
+// Logs the per-snap profiles collected in `profiler` to stdout as a series of
+// proto.RunnerOutput.snap_profile entries followed by
+// proto.RunnerOutput.execution_cycles_log2_histogram. Snaps that never ran are
+// omitted.
+void LogSnapProfile(const SnapCorpus<Host>& corpus,
+                    const SnapProfiler& profiler) {
+  for (size_t i = 0; i < profiler.size(); ++i) {
+    const SnapProfileEntry& entry = profiler.entry(i);
+    if (entry.num_executions == 0) {
+      continue;
+    }
+    // Print entries one at a time since the whole profile of a large corpus
+    // does not fit into a single TextProtoPrinter.
+    TextProtoPrinter runner_output;
+    {
+      auto snap_profile_m = runner_output.Message("snap_profile");
+      snap_profile_m->String("snapshot_id", corpus.snaps[i]->id);
+      snap_profile_m->Int("num_executions", entry.num_executions);
+      snap_profile_m->Int("prepare_cycles", entry.prepare_cycles);
+      snap_profile_m->Int("execute_cycles", entry.execute_cycles);
+      snap_profile_m->Int("verify_cycles", entry.verify_cycles);
+      snap_profile_m->Int("max_cycles", entry.max_cycles);
+    }
+    LogToStdout(runner_output.c_str());
+  }
+  TextProtoPrinter runner_output;
+  for (size_t i = 0; i < profiler.histogram_size(); ++i) {
+    runner_output.Int("execution_cycles_log2_histogram", profiler.histogram(i));
+  }
+  LogToStdout(runner_output.c_str());
+}
+
+// Sets up profiling if requested by `options`. Must be called before entering
+// seccomp mode.
+void InitSnapProfiler(const SnapCorpus<Host>& corpus,
+                      const RunnerMainOptions& options,
+                      SnapProfiler& profiler) {
+  if (!options.profile) {
+    return;
+  }
+  if (!profiler.Init(corpus.snaps.size)) {
+    LOG_FATAL("Cannot allocate snap profile: ", ErrnoStr(errno));
+  }
+  defer_timeout_exit = true;
+}
+
 const SnapCorpus<Host>* CommonMain(const RunnerMainOptions& options) {
   // Pin CPU if pinning is requested.
   if (options.cpu != kAnyCPUId) {
@@ -808,7 +1143,11 @@ const SnapCorpus<Host>* CommonMain(const RunnerMainOptions& options) {
     }
     LOG_FATAL("Snap ", options.snap_id, " not found in the corpus");
   }();
-  MapCorpus(*corpus, options.corpus_fd, corpus_mapping);
+  corpus = MapCorpus(*corpus, options.corpus_fd, corpus_mapping);
+  if (DelaysVerification(options)) {
+    // Done before any zygote fork so that children share the result.
+    InitExpectedMemoryChecksums(*corpus);
+  }
   if (options.strict) {
     VerifyChecksums(*corpus);
   }
@@ -819,18 +1158,51 @@ const SnapCorpus<Host>* CommonMain(const RunnerMainOptions& options) {
 
 void RunSnap(const Snap<Host>& snap, const RunnerMainOptions& options,
              RunSnapResult& result) {
+  const uint64_t start_cycles = options.profile ? ReadCycleCounter() : 0;
   PrepareSnapMemory(snap);
+  const uint64_t prepared_cycles = options.profile ? ReadCycleCounter() : 0;
   result.cpu_id = GetCPUIdNoSyscall();
   RunSnap(snap.registers, options, result.end_spot);
   if (result.cpu_id != GetCPUIdNoSyscall()) {
     result.cpu_id = kUnknownCPUId;
   }
+  const uint64_t executed_cycles = options.profile ? ReadCycleCounter() : 0;
   result.outcome = options.skip_end_state_check
                        ? RunSnapOutcome::kAsExpected
                        : EndSpotToOutcome(snap, result.end_spot);
+  if (options.profile) {
+    const uint64_t verified_cycles = ReadCycleCounter();
+    result.cycles.prepare = prepared_cycles - start_cycles;
+    result.cycles.execute = executed_cycles - prepared_cycles;
+    result.cycles.verify = verified_cycles - executed_cycles;
+  }
+}
+
+// Same as RunSnap() but only records the end state in `record` instead of
+// verifying it.
+void RunSnapAndRecord(const Snap<Host>& snap, const RunnerMainOptions& options,
+                      EndSpotRecord& record) {
+  const uint64_t start_cycles = options.profile ? ReadCycleCounter() : 0;
+  PrepareSnapMemory(snap);
+  const uint64_t prepared_cycles = options.profile ? ReadCycleCounter() : 0;
+  record.cpu_id = GetCPUIdNoSyscall();
+  EndSpot end_spot;
+  RunSnap(snap.registers, options, end_spot);
+  if (record.cpu_id != GetCPUIdNoSyscall()) {
+    record.cpu_id = kUnknownCPUId;
+  }
+  const uint64_t executed_cycles = options.profile ? ReadCycleCounter() : 0;
+  RecordEndSpot(snap, end_spot, record);
+  if (options.profile) {
+    const uint64_t recorded_cycles = ReadCycleCounter();
+    record.cycles.prepare = prepared_cycles - start_cycles;
+    record.cycles.execute = executed_cycles - prepared_cycles;
+    record.cycles.verify = recorded_cycles - executed_cycles;
+  }
 }
 
 int MakerMain(const RunnerMainOptions& options) {
+  CHECK_EQ(options.verify_interval, 1);
   const SnapCorpus<Host>* corpus = CommonMain(options);
 
   max_pages_to_add = options.max_pages_to_add;
@@ -850,17 +1222,134 @@ int MakerMain(const RunnerMainOptions& options) {
   return EXIT_SUCCESS;
 }
 
-int RunnerMain(const RunnerMainOptions& options) {
-  CHECK(!options.sequential_mode);
-  const SnapCorpus<Host>* corpus = CommonMain(options);
-  CHECK_GT(corpus->snaps.size, 0);
-
+// Runs randomly scheduled snaps from `corpus` according to `options`. This is
+// the body of RunnerMain() after CommonMain() and of every zygote child.
+int RunCorpus(const SnapCorpus<Host>* corpus,
+              const RunnerMainOptions& options) {
+  SnapProfiler profiler;
+  InitSnapProfiler(*corpus, options, profiler);
+  // End states recorded before a timeout must still be verified.
+  const bool delay_verification = DelaysVerification(options);
+  if (delay_verification) {
+    defer_timeout_exit = true;
+  }
   EnterSeccompFilterMode(SeccompOptionsFromRunnerMainOptions(options));
+  LogExcludedSnaps();
 
   std::mt19937_64 gen(options.seed);  // 64-bit Mersenne Twister engine
   VLOG_INFO(1, "Seed = ", IntStr(options.seed));
   size_t snap_execution_count = 0;
   const char* previous_snap_id = "<none>";
+
+  // Logs the failure of `snap` in `run_result` at `iteration`.
+  auto ReportFailure = [&](const Snap<Host>& snap,
+                           const RunSnapResult& run_result, size_t iteration) {
+    if (options.profile) {
+      LogSnapProfile(*corpus, profiler);
+    }
+    LogSnapRunResult(snap, options, run_result);
+    LOG_ERROR("Seed = ", IntStr(options.seed), " iteration #",
+              IntStr(iteration));
+    LOG_ERROR("CPU id = ", IntStr(run_result.cpu_id));
+    LOG_ERROR("Previous snapshot [", previous_snap_id, "]");
+    // Done last since there's a chance this can cause a fault if things
+    // have gone seriously wrong.
+    if (VerifySnapChecksums(snap)) {
+      // Print a positive message so we know it completed.
+      LOG_INFO("Snap checksums verified");
+      LogPostfailureChecksumStatus(RunnerPostfailureChecksumStatus::kMatch);
+    } else {
+      LogPostfailureChecksumStatus(RunnerPostfailureChecksumStatus::kMismatch);
+    }
+    LogExecutionResult(RunnerExecutionStatusCode::kSnapshotFailed);
+  };
+
+  // Logs the failure of `snap` with `outcome` found by the delayed
+  // verification of `record` when running `snap` again ended as expected.
+  // The end state of the failed execution is gone, so only the digests in
+  // `record` are reported and there is no failed_snapshot_execution.
+  auto ReportUnreproducedFailure = [&](const Snap<Host>& snap,
+                                       RunSnapOutcome outcome,
+                                       const EndSpotRecord& record) {
+    if (options.profile) {
+      LogSnapProfile(*corpus, profiler);
+    }
+    LOG_ERROR("Snapshot [", snap.id, "] failed delayed verification, ",
+              "outcome = ", IntStr(ToInt(outcome)),
+              ", but ended as expected when run again");
+    LOG_ERROR("Corpus   [", options.corpus_name, "]");
+    if (record.signum != 0) {
+      LOG_ERROR("Signal = ", SignalNameStr(record.signum));
+    } else {
+      const SnapRegisterMemoryChecksum<Host>& expected =
+          snap.end_state_registers_memory_checksum;
+      LOG_ERROR("gregs checksum = ",
+                HexStr(record.registers_checksum.gregs_checksum), " expected ",
+                HexStr(expected.gregs_checksum));
+      LOG_ERROR("fpregs checksum = ",
+                HexStr(record.registers_checksum.fpregs_checksum),
+                " expected ", HexStr(expected.fpregs_checksum));
+      LOG_ERROR("memory checksum = ", HexStr(record.memory_checksum),
+                " expected ",
+                HexStr(expected_memory_checksums[record.snap_index]));
+      LogRegisterChecksum(record.register_checksum,
+                          &snap.end_state_register_checksum, true);
+    }
+    LOG_ERROR("Seed = ", IntStr(options.seed), " iteration #",
+              IntStr(record.iteration));
+    LOG_ERROR("CPU id = ", IntStr(record.cpu_id));
+    LOG_ERROR("Previous snapshot [", previous_snap_id, "]");
+    if (VerifySnapChecksums(snap)) {
+      LOG_INFO("Snap checksums verified");
+      LogPostfailureChecksumStatus(RunnerPostfailureChecksumStatus::kMatch);
+    } else {
+      LogPostfailureChecksumStatus(RunnerPostfailureChecksumStatus::kMismatch);
+    }
+    LogExecutionResult(
+        RunnerExecutionStatusCode::kSnapshotFailed,
+        StrCat<256>({"Snapshot ", snap.id,
+                     " failed delayed verification but not when run again"}));
+  };
+
+  // End states recorded since the last verification when verification is
+  // delayed. See RunnerMainOptions::verify_interval.
+  CHECK_LE(options.verify_interval, RunnerMainOptions::kMaxVerifyInterval);
+  EndSpotRecord records[RunnerMainOptions::kMaxVerifyInterval];
+  size_t num_records = 0;
+
+  // Verifies the recorded end states in execution order and clears them.
+  // The first snap that did not end as expected is run again with the full
+  // end state comparison. If it fails again, that failure is reported as
+  // usual. Otherwise only the recorded digests of the failed execution are
+  // reported. Returns false iff there is a failure.
+  auto VerifyRecords = [&]() {
+    for (size_t i = 0; i < num_records; ++i) {
+      const EndSpotRecord& record = records[i];
+      const Snap<Host>& snap = *(corpus->snaps[record.snap_index]);
+      const uint64_t start_cycles = options.profile ? ReadCycleCounter() : 0;
+      const RunSnapOutcome outcome = EndSpotRecordToOutcome(snap, record);
+      if (options.profile) {
+        SnapCycles cycles = record.cycles;
+        cycles.verify += ReadCycleCounter() - start_cycles;
+        profiler.Record(record.snap_index, cycles);
+      }
+      if (outcome != RunSnapOutcome::kAsExpected) {
+        LOG_ERROR("Delayed verification of ", snap.id, " failed, running it ",
+                  "again");
+        RunSnapResult run_result;
+        RunSnap(snap, options, run_result);
+        if (run_result.outcome == RunSnapOutcome::kAsExpected) {
+          ReportUnreproducedFailure(snap, outcome, record);
+        } else {
+          ReportFailure(snap, run_result, record.iteration);
+        }
+        return false;
+      }
+      previous_snap_id = snap.id;
+    }
+    num_records = 0;
+    return true;
+  };
   while (snap_execution_count < options.num_iterations) {
     // Generate Snap batch
     size_t batch[RunnerMainOptions::kMaxBatchSize];
@@ -882,42 +1371,176 @@ int RunnerMain(const RunnerMainOptions& options) {
         VLOG_INFO(1, "iter #", IntStr(snap_execution_count), " of ",
                   IntStr(options.num_iterations));
       }
-      const Snap<Host>& snap = *(corpus->snaps[batch[schedule_dist(gen)]]);
+      const size_t snap_index = batch[schedule_dist(gen)];
+      const Snap<Host>& snap = *(corpus->snaps[snap_index]);
       VLOG_INFO(3, "#", IntStr(snap_execution_count), " Running ", snap.id);
-      RunSnapResult run_result;
-      RunSnap(snap, options, run_result);
-      if (run_result.outcome != RunSnapOutcome::kAsExpected) {
-        LogSnapRunResult(snap, options, run_result);
-        LOG_ERROR("Seed = ", IntStr(options.seed), " iteration #",
-                  IntStr(snap_execution_count));
-        LOG_ERROR("CPU id = ", IntStr(run_result.cpu_id));
-        LOG_ERROR("Previous snapshot [", previous_snap_id, "]");
-        // Done last since there's a chance this can cause a fault if things
-        // have gone seriously wrong.
-        if (VerifySnapChecksums(snap)) {
-          // Print a positive message so we know it completed.
-          LOG_INFO("Snap checksums verified");
-          LogPostfailureChecksumStatus(RunnerPostfailureChecksumStatus::kMatch);
-        } else {
-          LogPostfailureChecksumStatus(
-              RunnerPostfailureChecksumStatus::kMismatch);
+      if (delay_verification) {
+        EndSpotRecord& record = records[num_records++];
+        record.snap_index = snap_index;
+        record.iteration = snap_execution_count;
+        RunSnapAndRecord(snap, options, record);
+        const bool last_iteration =
+            snap_execution_count + 1 == options.num_iterations;
+        if (num_records == options.verify_interval || last_iteration ||
+            timeout_pending) {
+          if (!VerifyRecords()) {
+            return EXIT_FAILURE;
+          }
         }
-        LogExecutionResult(RunnerExecutionStatusCode::kSnapshotFailed);
-        return EXIT_FAILURE;
+      } else {
+        RunSnapResult run_result;
+        RunSnap(snap, options, run_result);
+        if (options.profile) {
+          profiler.Record(snap_index, run_result.cycles);
+        }
+        if (run_result.outcome != RunSnapOutcome::kAsExpected) {
+          ReportFailure(snap, run_result, snap_execution_count);
+          return EXIT_FAILURE;
+        }
+        previous_snap_id = snap.id;
+      }
+      if (timeout_pending) {
+        if (options.profile) {
+          LogSnapProfile(*corpus, profiler);
+        }
+        return kTimeoutExitCode;
       }
-      previous_snap_id = snap.id;
     }
   }
 
+  if (options.profile) {
+    LogSnapProfile(*corpus, profiler);
+  }
   LogExecutionResult(RunnerExecutionStatusCode::kOk);
   return EXIT_SUCCESS;
 }
 
+int RunnerMain(const RunnerMainOptions& options) {
+  CHECK(!options.sequential_mode);
+  const SnapCorpus<Host>* corpus = CommonMain(options);
+  CHECK_GT(corpus->snaps.size, 0);
+  return RunCorpus(corpus, options);
+}
+
+// Sets up a forked zygote child according to `request` and runs the corpus.
+// Returns the exit code of the child.
+int ZygoteChildMain(const SnapCorpus<Host>* corpus, RunnerMainOptions options,
+                    const ZygoteRequest& request) {
+  // Do not outlive the zygote.
+  CHECK_EQ(sys_prctl(PR_SET_PDEATHSIG, SIGKILL, 0, 0, 0), 0);
+
+  // Requests arrive on stdin and responses go to stdout of the zygote. The
+  // child writes its RunnerOutput to a separate file instead.
+  const int output_fd = sys_open(request.output_path, O_WRONLY | O_TRUNC, 0);
+  if (output_fd < 0) {
+    LOG_FATAL("Cannot open ", request.output_path, ": ", ErrnoStr(errno));
+  }
+  CHECK_EQ(sys_dup3(output_fd, STDOUT_FILENO, 0), STDOUT_FILENO);
+  CHECK_EQ(sys_close(output_fd), 0);
+  CHECK_EQ(sys_close(STDIN_FILENO), 0);
+
+  options.pid = sys_getpid();
+  options.cpu = request.cpu;
+  if (options.cpu != kAnyCPUId) {
+    const int error = SetCPUAffinity(options.cpu);
+    if (error != 0) {
+      LOG_FATAL("Cannot pin cpu to core ", IntStr(options.cpu),
+                " error=", IntStr(error));
+    }
+  }
+  if (request.cpu_time_budget_seconds > 0) {
+    // Same soft/hard split as RunnerDriver uses for a freshly started runner.
+    struct kernel_rlimit rlimit = {
+        .rlim_cur = request.cpu_time_budget_seconds,
+        .rlim_max = request.cpu_time_budget_seconds + 1,
+    };
+    CHECK_EQ(sys_setrlimit(RLIMIT_CPU, &rlimit), 0);
+  }
+  if (request.num_iterations > 0) {
+    options.num_iterations = request.num_iterations;
+  }
+  // Children of the same zygote must not replay the same schedule, so each
+  // derives its seed from the zygote's seed and its own PID.
+  options.seed =
+      options.seed * 0x9e3779b97f4a7c15ULL + static_cast<uint64_t>(options.pid);
+  return RunCorpus(corpus, options);
+}
+
+int ZygoteMain(const RunnerMainOptions& options) {
+  CHECK(!options.sequential_mode);
+  // Every child is pinned individually.
+  CHECK_EQ(options.cpu, kAnyCPUId);
+  const SnapCorpus<Host>* corpus = CommonMain(options);
+  CHECK_GT(corpus->snaps.size, 0);
+
+  // CommonMain() installed SigAction() for SIGCHLD too, which would treat
+  // the exit of every child as a fatal signal outside of a snap. Restore the
+  // default disposition, which ignores it. Children never fork so they keep
+  // the default as well.
+  struct kernel_sigaction action = {};
+  action.sa_handler_ = SIG_DFL;
+  if (sys_sigaction(SIGCHLD, &action, nullptr) != 0) {
+    LOG_FATAL("sigaction() failed for SIGCHLD: ", ErrnoStr(errno));
+  }
+  VLOG_INFO(1, "Zygote ready");
+
+  ZygoteRequest request;
+  while (true) {
+    const ssize_t bytes_read = Read(STDIN_FILENO, &request, sizeof(request));
+    if (bytes_read == 0) {
+      // The driver closed the channel.
+      return EXIT_SUCCESS;
+    }
+    if (bytes_read != sizeof(request) || request.magic != kZygoteRequestMagic ||
+        request.output_path[kZygoteMaxOutputPathLength - 1] != '\0') {
+      LOG_FATAL("Malformed zygote request");
+    }
+
+    const pid_t pid = sys_fork();
+    if (pid < 0) {
+      LOG_FATAL("fork: ", ErrnoStr(errno));
+    }
+    if (pid == 0) {
+      _exit(ZygoteChildMain(corpus, options, request));
+    }
+
+    ZygoteResponse response = {.kind = ZygoteResponse::kStarted, .pid = pid};
+    CHECK_EQ(Write(STDOUT_FILENO, &response, sizeof(response)),
+             sizeof(response));
+
+    int status = 0;
+    struct kernel_rusage rusage = {};
+    while (sys_wait4(pid, &status, 0, &rusage) != pid) {
+      if (errno != EINTR) {
+        LOG_FATAL("wait4: ", ErrnoStr(errno));
+      }
+    }
+    response = {
+        .kind = ZygoteResponse::kExited,
+        .status = status,
+        .pid = pid,
+        .user_time_usec = static_cast<int64_t>(rusage.ru_utime.tv_sec) *
+                              1000000 +
+                          rusage.ru_utime.tv_usec,
+        .system_time_usec = static_cast<int64_t>(rusage.ru_stime.tv_sec) *
+                                1000000 +
+                            rusage.ru_stime.tv_usec,
+        .max_rss_kb = rusage.ru_maxrss,
+    };
+    CHECK_EQ(Write(STDOUT_FILENO, &response, sizeof(response)),
+             sizeof(response));
+  }
+}
+
 int RunnerMainSequential(const RunnerMainOptions& options) {
   CHECK(options.sequential_mode);
+  CHECK_EQ(options.verify_interval, 1);
   const SnapCorpus<Host>* corpus = CommonMain(options);
 
+  SnapProfiler profiler;
+  InitSnapProfiler(*corpus, options, profiler);
   EnterSeccompFilterMode(SeccompOptionsFromRunnerMainOptions(options));
+  LogExcludedSnaps();
   VLOG_INFO(1, "Running in sequential mode");
 
   for (size_t i = 0; i < corpus->snaps.size; ++i) {
@@ -928,12 +1551,25 @@ int RunnerMainSequential(const RunnerMainOptions& options) {
     VLOG_INFO(3, "#", IntStr(i), " Running ", snap.id);
     RunSnapResult run_result;
     RunSnap(snap, options, run_result);
+    if (options.profile) {
+      profiler.Record(i, run_result.cycles);
+    }
     if (run_result.outcome != RunSnapOutcome::kAsExpected) {
+      if (options.profile) {
+        LogSnapProfile(*corpus, profiler);
+      }
       LogSnapRunResult(snap, options, run_result);
       LogExecutionResult(RunnerExecutionStatusCode::kSnapshotFailed);
       LOG_ERROR("Id = ", snap.id, " Iteration #", IntStr(i));
       return EXIT_FAILURE;
     }
+    if (timeout_pending) {
+      LogSnapProfile(*corpus, profiler);
+      return kTimeoutExitCode;
+    }
+  }
+  if (options.profile) {
+    LogSnapProfile(*corpus, profiler);
   }
   LogExecutionResult(RunnerExecutionStatusCode::kOk);
   return EXIT_SUCCESS;
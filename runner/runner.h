@@ -21,6 +21,7 @@
 
 #include "./runner/endspot.h"
 #include "./runner/runner_main_options.h"
+#include "./runner/snap_profile.h"
 #include "./snap/snap.h"
 #include "./util/arch.h"
 
@@ -58,16 +59,22 @@ struct RunSnapResult {
   // CPU id (as in getcpu(2)) where the snapshot ran or
   // silifuzz::kUnknownCPUId if it couldn't be determined.
   int64_t cpu_id;
+
+  // Execution cost of the snap. Only set if RunnerMainOptions::profile is
+  // true.
+  SnapCycles cycles;
 };
 
-// Establishes memory mappings in 'corpus'.
+// Establishes memory mappings in 'corpus' and returns the corpus to run.
+// Snaps whose mappings conflict with the runner's own are left out of the
+// returned corpus, which is 'corpus' itself if there are none.
 // Takes ownership of 'corpus_fd' and closes it after the corpus is mapped.
 // If the corpus is not backed by a file object, 'corpus_fd' may be -1.
 // 'corpus_mapping' points to the address where corpus_fd is mapped. This is
 // usually identical to the SnapCorpus pointer. This value can be NULL if
 // corpus_fd == -1.
-void MapCorpus(const SnapCorpus<Host>& corpus, int corpus_fd,
-               const void* corpus_mapping);
+const SnapCorpus<Host>* MapCorpus(const SnapCorpus<Host>& corpus, int corpus_fd,
+                                  const void* corpus_mapping);
 
 // Executes 'snap' with 'options' and stores the execution result in 'result'.
 // REQUIRES: the runtime environment, including memory mapping used by 'snap'
@@ -97,6 +104,12 @@ int RunnerMain(const RunnerMainOptions& options);
 // FLAGS_sequential_mode for details.
 int RunnerMainSequential(const RunnerMainOptions& options);
 
+// Similar to RunnerMain() but loads and maps the corpus once and then forks a
+// fresh child running RunnerMain()'s loop for every request received on stdin.
+// Children inherit the mapped corpus copy-on-write. See FLAGS_zygote and
+// zygote_protocol.h for details.
+int ZygoteMain(const RunnerMainOptions& options);
+
 // Similar to RunnerMain() but runs in "make" mode. See FLAGS_make for details.
 int MakerMain(const RunnerMainOptions& options);
 
@@ -0,0 +1,65 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "absl/strings/str_cat.h"
+#include "./common/snapshot_test_enum.h"
+#include "./runner/driver/runner_driver.h"
+#include "./runner/driver/runner_options.h"
+#include "./runner/runner_provider.h"
+#include "./util/data_dependency.h"
+#include "./util/itoa.h"
+
+namespace silifuzz {
+
+namespace {
+
+constexpr int64_t kNumIterations = 1000000;
+
+// Runs a snap of the test corpus kNumIterations times in one runner process
+// with the end states verified every `verify_interval` snaps.
+// Reports snaps run per second, including the runner startup.
+// Arguments: verify_interval.
+void BM_RunSnaps(benchmark::State& state) {
+  RunnerDriver driver = RunnerDriver::ReadingRunner(
+      RunnerLocation(), GetDataDependencyFilepath("snap/testing/test_corpus"));
+  const std::string snap_id = EnumStr(TestSnapshot::kEndsAsExpected);
+  RunnerOptions opts = RunnerOptions::PlayOptions(snap_id);
+  opts.set_extra_argv({"--snap_id", snap_id, "--num_iterations",
+                       absl::StrCat(kNumIterations), "--verify_interval",
+                       absl::StrCat(state.range(0))});
+  for (auto s : state) {
+    if (!driver.Run(opts).success()) {
+      state.SkipWithError("Runner failed.");
+      return;
+    }
+  }
+  // items_per_second is the number of snaps run per second.
+  state.SetItemsProcessed(state.iterations() * kNumIterations);
+}
+
+// The work happens in the runner process, so measure wall time.
+BENCHMARK(BM_RunSnaps)
+    ->ArgName("verify_interval")
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(64)
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace silifuzz
@@ -37,10 +37,13 @@ bool FLAGS_make = false;
 bool FLAGS_enable_tracer = false;
 size_t FLAGS_batch_size = RunnerMainOptions::kDefaultBatchSize;
 size_t FLAGS_schedule_size = RunnerMainOptions::kDefaultScheduleSize;
+uint64_t FLAGS_verify_interval = 1;
 bool FLAGS_sequential_mode = false;
 bool FLAGS_skip_end_state_check = false;
 bool FLAGS_strict = false;
 uint64_t FLAGS_max_pages_to_add = 0;
+bool FLAGS_profile = false;
+bool FLAGS_zygote = false;
 
 // Print all flags and exit.
 void ShowUsage(const char* program_name) {
@@ -60,6 +63,9 @@ void ShowUsage(const char* program_name) {
   LOG_INFO("  --enable_tracer\tEnable ptrace cooperation.");
   LOG_INFO("  --batch_size [size]\tSnap execution batch size.");
   LOG_INFO("  --schedule_size [size]\tSnap execution schedule size.");
+  LOG_INFO(
+      "  --verify_interval [size]\tNumber of snaps run before their end "
+      "states are verified.");
   LOG_INFO("  --sequential_mode\tRun Snaps sequentially once.");
   LOG_INFO(
       "  --skip_end_state_check\tDo not check end state after snap execution.");
@@ -69,6 +75,8 @@ void ShowUsage(const char* program_name) {
   LOG_INFO(
       "  --max_pages_to_add [value]\tMaximum number of r/w pages added in snap "
       "making.");
+  LOG_INFO("  --profile\tReport per-snap execution cost at exit.");
+  LOG_INFO("  --zygote\tFork a child per request read from stdin.");
   LOG_INFO("  --help\tPrint usage information.");
 }
 
@@ -145,6 +153,16 @@ int ParseRunnerFlags(int argc, char* argv[]) {
         return -1;
       }
       FLAGS_schedule_size = schedule_size;
+    } else if (matcher.Match("verify_interval",
+                             CommandLineFlagMatcher::kRequiredArgument)) {
+      uint64_t verify_interval;
+      if (!DecToU64(matcher.optarg(), &verify_interval) ||
+          verify_interval == 0 ||
+          verify_interval > RunnerMainOptions::kMaxVerifyInterval) {
+        LOG_ERROR("Invalid verify_interval ", matcher.optarg());
+        return -1;
+      }
+      FLAGS_verify_interval = verify_interval;
     } else if (matcher.Match("sequential_mode",
                              CommandLineFlagMatcher::kNoArgument)) {
       FLAGS_sequential_mode = true;
@@ -161,6 +179,10 @@ int ParseRunnerFlags(int argc, char* argv[]) {
         return -1;
       }
       FLAGS_max_pages_to_add = max_pages_to_add;
+    } else if (matcher.Match("profile", CommandLineFlagMatcher::kNoArgument)) {
+      FLAGS_profile = true;
+    } else if (matcher.Match("zygote", CommandLineFlagMatcher::kNoArgument)) {
+      FLAGS_zygote = true;
     } else {
       // Exit loop if argument is not recognized.
       break;
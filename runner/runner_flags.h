@@ -63,6 +63,10 @@ extern uint64_t FLAGS_batch_size;
 // Snap execution schedule size.
 extern uint64_t FLAGS_schedule_size;
 
+// Number of snaps run back-to-back before their end states are verified. See
+// runner_main_options.h for details.
+extern uint64_t FLAGS_verify_interval;
+
 // If true, execute Snaps sequentially once.
 extern bool FLAGS_sequential_mode;
 
@@ -76,6 +80,15 @@ extern bool FLAGS_strict;
 // only in snap making mode.
 extern uint64_t FLAGS_max_pages_to_add;
 
+// If true, measure the execution cost of every snap and print per-snap
+// profiles as part of the runner output at exit. Ignored in make mode.
+extern bool FLAGS_profile;
+
+// If true, run as a zygote: map the corpus once, then fork a child running the
+// corpus for every request read from stdin. See zygote_protocol.h.
+// Incompatible with make and sequential mode.
+extern bool FLAGS_zygote;
+
 // Parses command line flags of runner and sets flags accordingly. 'argv[]' is
 // an array of 'argc' command line argument passed to main(). Parsing starts
 // at 'argv[1]' and stops at the first non-flag argument or end of 'argv[]'.
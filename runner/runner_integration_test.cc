@@ -158,6 +158,39 @@ TEST(RunnerTest, RunawaySnap) {
             PlaybackOutcome::kExecutionRunaway);
 }
 
+TEST(RunnerTest, DelayedVerification) {
+  RunnerDriver driver = RunnerDriver::ReadingRunner(
+      RunnerLocation(), GetDataDependencyFilepath("snap/testing/test_corpus"));
+  auto run = [&driver](TestSnapshot test_snap_type) {
+    RunnerOptions opts = RunnerOptions::PlayOptions(EnumStr(test_snap_type));
+    opts.set_extra_argv({"--snap_id", EnumStr(test_snap_type),
+                         "--num_iterations", "3", "--verify_interval", "2"});
+    return driver.Run(opts);
+  };
+  ASSERT_TRUE(run(TestSnapshot::kEndsAsExpected).success());
+
+  // Failures are reported the same way as without delayed verification.
+  auto result = run(TestSnapshot::kRegsMismatch);
+  ASSERT_FALSE(result.success());
+  EXPECT_EQ(result.failed_player_result().outcome,
+            PlaybackOutcome::kRegisterStateMismatch);
+  result = run(TestSnapshot::kMemoryMismatch);
+  ASSERT_FALSE(result.success());
+  EXPECT_EQ(result.failed_player_result().outcome,
+            PlaybackOutcome::kMemoryMismatch);
+  EXPECT_THAT(result.failed_player_result().actual_end_state->memory_bytes(),
+              Not(IsEmpty()));
+
+  // Sequential mode does not support delayed verification.
+  RunnerOptions opts = RunnerOptions::Default();
+  opts.set_sequential_mode(true);
+  opts.set_extra_argv({"--verify_interval", "2"});
+  result = driver.Run(opts);
+  ASSERT_FALSE(result.success());
+  EXPECT_EQ(result.execution_result().code,
+            RunnerDriver::ExecutionResult::Code::kInternalError);
+}
+
 TEST(RunnerTest, Deadline) {
   auto result = RunOneSnap(TestSnapshot::kRunaway, absl::Seconds(2));
   ASSERT_TRUE(result.success());
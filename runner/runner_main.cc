@@ -123,16 +123,25 @@ int Main(int argc, char* argv[]) {
   }
   options.batch_size = FLAGS_batch_size;
   options.schedule_size = FLAGS_schedule_size;
+  options.verify_interval = FLAGS_verify_interval;
   options.sequential_mode = FLAGS_sequential_mode;
   options.max_pages_to_add = FLAGS_make ? FLAGS_max_pages_to_add : 0;
+  options.profile = FLAGS_profile;
 
   // These cannot be set together.
   if (FLAGS_make && FLAGS_sequential_mode) {
     LOG_FATAL("Cannot set both make and sequential mode");
   }
+  if (FLAGS_zygote && (FLAGS_make || FLAGS_sequential_mode)) {
+    LOG_FATAL("Zygote mode is incompatible with make and sequential mode");
+  }
+  if (FLAGS_verify_interval > 1 && (FLAGS_make || FLAGS_sequential_mode)) {
+    LOG_FATAL("verify_interval is incompatible with make and sequential mode");
+  }
 
   return (FLAGS_make              ? MakerMain(options)
           : FLAGS_sequential_mode ? RunnerMainSequential(options)
+          : FLAGS_zygote          ? ZygoteMain(options)
                                   : RunnerMain(options));
 }
 
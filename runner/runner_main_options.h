@@ -96,6 +96,24 @@ struct RunnerMainOptions {
   // In sequential mode this is ignored.
   uint64_t schedule_size = kDefaultScheduleSize;
 
+  // Delayed end state verification:
+  //
+  // Verifying the end state right after every Snap brings the comparison code
+  // and the expected end state into the caches between consecutive Snaps.
+  // When verify_interval is greater than 1, up to that many Snaps run
+  // back-to-back and only a compact digest of each end state is recorded.
+  // The digests are verified after the sequence. A Snap whose digest does not
+  // match is run again with the full comparison so that failures are
+  // reported as usual. If that run ends as expected, the failure is reported
+  // with the recorded digests only.
+  //
+  // A digest can miss a mismatch with a probability of about 2^-32.
+  inline static constexpr uint64_t kMaxVerifyInterval = 64;
+
+  // Number of Snaps to run before verifying their end states. Must be between
+  // [1, kMaxVerifyInterval]. Must be 1 in make and sequential modes.
+  uint64_t verify_interval = 1;
+
   // If true, runner sequentially goes through all Snaps once. Batch and
   // schedule sizes in options are ignored. This is used for Snap verification.
   bool sequential_mode = false;
@@ -114,6 +132,10 @@ struct RunnerMainOptions {
   // The maximum number of pages to add during making. This is ignored if
   // runner is not in make mode.
   int max_pages_to_add = 0;
+
+  // If true, collect per-snap execution cost and print it at exit. See
+  // FLAGS_profile for details. This is ignored in make mode.
+  bool profile = false;
 };
 
 }  // namespace silifuzz
@@ -0,0 +1,77 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./runner/snap_profile.h"
+
+#include <sys/mman.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "./util/checks.h"
+
+namespace silifuzz {
+
+SnapProfiler::~SnapProfiler() {
+  if (entries_ != nullptr) {
+    munmap(entries_, num_entries_ * sizeof(SnapProfileEntry));
+  }
+}
+
+bool SnapProfiler::Init(size_t num_snaps) {
+  CHECK_EQ(entries_, nullptr);
+  if (num_snaps == 0) {
+    return true;
+  }
+  // Anonymous mappings are zero-filled.
+  void* entries = mmap(nullptr, num_snaps * sizeof(SnapProfileEntry),
+                       PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                       -1, 0);
+  if (entries == MAP_FAILED) {
+    return false;
+  }
+  entries_ = static_cast<SnapProfileEntry*>(entries);
+  num_entries_ = num_snaps;
+  return true;
+}
+
+void SnapProfiler::Record(size_t snap_index, const SnapCycles& cycles) {
+  CHECK_LT(snap_index, num_entries_);
+  SnapProfileEntry& e = entries_[snap_index];
+  const uint64_t total = cycles.total();
+  e.num_executions++;
+  e.prepare_cycles += cycles.prepare;
+  e.execute_cycles += cycles.execute;
+  e.verify_cycles += cycles.verify;
+  if (total > e.max_cycles) {
+    e.max_cycles = total;
+  }
+  const size_t bucket = total == 0 ? 0 : 63 - __builtin_clzll(total);
+  histogram_[bucket]++;
+}
+
+const SnapProfileEntry& SnapProfiler::entry(size_t snap_index) const {
+  CHECK_LT(snap_index, num_entries_);
+  return entries_[snap_index];
+}
+
+size_t SnapProfiler::histogram_size() const {
+  size_t size = kNumHistogramBuckets;
+  while (size > 0 && histogram_[size - 1] == 0) {
+    --size;
+  }
+  return size;
+}
+
+}  // namespace silifuzz
@@ -0,0 +1,98 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_SILIFUZZ_RUNNER_SNAP_PROFILE_H_
+#define THIRD_PARTY_SILIFUZZ_RUNNER_SNAP_PROFILE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace silifuzz {
+
+// Cycle counts of a single snap execution split by phase. All values are in
+// ReadCycleCounter() units.
+struct SnapCycles {
+  // Restoring writable memory (PrepareSnapMemory).
+  uint64_t prepare = 0;
+
+  // Entering the snap, running it and reaching the exit point.
+  uint64_t execute = 0;
+
+  // Comparing the end state (EndSpotToOutcome), or recording and verifying
+  // its digest with delayed verification.
+  uint64_t verify = 0;
+
+  uint64_t total() const { return prepare + execute + verify; }
+};
+
+// Accumulated execution cost of one snap.
+struct SnapProfileEntry {
+  uint64_t num_executions;
+  uint64_t prepare_cycles;
+  uint64_t execute_cycles;
+  uint64_t verify_cycles;
+  // Cost of the most expensive single execution.
+  uint64_t max_cycles;
+};
+
+// Aggregates per-snap execution cost in the runner's profiling mode.
+//
+// The profiler keeps one fixed-size entry per snap of the corpus plus a
+// runner-wide log2 histogram of per-execution cost. Storage is allocated
+// once by Init() with mmap() so this works without libc and heap. Init() must
+// be called before the runner enters seccomp mode.
+//
+// This class is thread-compatible.
+class SnapProfiler {
+ public:
+  // Number of histogram buckets. Bucket `i` counts executions whose total
+  // cost is in [2^i, 2^(i+1)) cycles. Bucket 0 also counts zero-cycle
+  // executions.
+  static constexpr size_t kNumHistogramBuckets = 64;
+
+  SnapProfiler() = default;
+  ~SnapProfiler();
+
+  // Not copyable or movable.
+  SnapProfiler(const SnapProfiler&) = delete;
+  SnapProfiler& operator=(const SnapProfiler&) = delete;
+
+  // Allocates zeroed entries for `num_snaps` snaps. Returns false if memory
+  // cannot be allocated.
+  // REQUIRES: Init() has not been called before.
+  bool Init(size_t num_snaps);
+
+  // Accounts one execution of the snap with index `snap_index`.
+  void Record(size_t snap_index, const SnapCycles& cycles);
+
+  // Number of entries.
+  size_t size() const { return num_entries_; }
+
+  const SnapProfileEntry& entry(size_t snap_index) const;
+
+  uint64_t histogram(size_t bucket) const { return histogram_[bucket]; }
+
+  // Returns one past the index of the last non-empty histogram bucket or 0 if
+  // nothing has been recorded.
+  size_t histogram_size() const;
+
+ private:
+  SnapProfileEntry* entries_ = nullptr;
+  size_t num_entries_ = 0;
+  uint64_t histogram_[kNumHistogramBuckets] = {};
+};
+
+}  // namespace silifuzz
+
+#endif  // THIRD_PARTY_SILIFUZZ_RUNNER_SNAP_PROFILE_H_
@@ -0,0 +1,80 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./runner/snap_profile.h"
+
+#include "./util/checks.h"
+#include "./util/nolibc_gunit.h"
+
+namespace silifuzz {
+namespace {
+
+TEST(SnapProfiler, Empty) {
+  SnapProfiler profiler;
+  CHECK(profiler.Init(0));
+  CHECK_EQ(profiler.size(), 0);
+  CHECK_EQ(profiler.histogram_size(), 0);
+}
+
+TEST(SnapProfiler, Record) {
+  SnapProfiler profiler;
+  CHECK(profiler.Init(3));
+  CHECK_EQ(profiler.size(), 3);
+  for (size_t i = 0; i < profiler.size(); ++i) {
+    CHECK_EQ(profiler.entry(i).num_executions, 0);
+  }
+
+  profiler.Record(1, {.prepare = 1, .execute = 10, .verify = 5});
+  profiler.Record(1, {.prepare = 2, .execute = 20, .verify = 6});
+  profiler.Record(2, {.prepare = 0, .execute = 1000, .verify = 0});
+
+  const SnapProfileEntry& e0 = profiler.entry(0);
+  CHECK_EQ(e0.num_executions, 0);
+  CHECK_EQ(e0.max_cycles, 0);
+
+  const SnapProfileEntry& e1 = profiler.entry(1);
+  CHECK_EQ(e1.num_executions, 2);
+  CHECK_EQ(e1.prepare_cycles, 3);
+  CHECK_EQ(e1.execute_cycles, 30);
+  CHECK_EQ(e1.verify_cycles, 11);
+  CHECK_EQ(e1.max_cycles, 28);
+
+  const SnapProfileEntry& e2 = profiler.entry(2);
+  CHECK_EQ(e2.num_executions, 1);
+  CHECK_EQ(e2.max_cycles, 1000);
+
+  // 16 and 28 are in [2^4, 2^5), 1000 is in [2^9, 2^10).
+  CHECK_EQ(profiler.histogram(4), 2);
+  CHECK_EQ(profiler.histogram(9), 1);
+  CHECK_EQ(profiler.histogram_size(), 10);
+}
+
+TEST(SnapProfiler, ZeroCycles) {
+  SnapProfiler profiler;
+  CHECK(profiler.Init(1));
+  profiler.Record(0, {});
+  CHECK_EQ(profiler.histogram(0), 1);
+  CHECK_EQ(profiler.histogram_size(), 1);
+}
+
+}  // namespace
+}  // namespace silifuzz
+
+// ========================================================================= //
+
+NOLIBC_TEST_MAIN({
+  RUN_TEST(SnapProfiler, Empty);
+  RUN_TEST(SnapProfiler, Record);
+  RUN_TEST(SnapProfiler, ZeroCycles);
+})
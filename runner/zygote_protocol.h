@@ -0,0 +1,79 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_SILIFUZZ_RUNNER_ZYGOTE_PROTOCOL_H_
+#define THIRD_PARTY_SILIFUZZ_RUNNER_ZYGOTE_PROTOCOL_H_
+
+// Wire format between RunnerDriver and a runner started with --zygote.
+//
+// The driver writes ZygoteRequest records to the stdin of the zygote. For each
+// request the zygote forks a child that runs the already mapped corpus with
+// the requested parameters and writes its RunnerOutput to
+// ZygoteRequest::output_path. The zygote writes two ZygoteResponse records
+// to its stdout per request: kStarted right after the fork and kExited once
+// the child has been reaped. The zygote exits when its stdin is closed.
+//
+// Both sides run on the same host so records are sent in native byte order.
+// This file must be nolibc-compatible.
+
+#include <cstdint>
+
+namespace silifuzz {
+
+inline constexpr uint64_t kZygoteRequestMagic = 0x7165'7571'6572'7a67;
+
+// Size of ZygoteRequest::output_path including the terminating NUL.
+inline constexpr int kZygoteMaxOutputPathLength = 256;
+
+struct ZygoteRequest {
+  // Must be kZygoteRequestMagic.
+  uint64_t magic;
+
+  // Number of snaps to execute. When 0, the zygote's --num_iterations is used.
+  uint64_t num_iterations;
+
+  // CPU time limit (RLIMIT_CPU) of the child in seconds or 0 for no limit.
+  uint64_t cpu_time_budget_seconds;
+
+  // CPU to pin the child to or kAnyCPUId.
+  int32_t cpu;
+
+  uint32_t reserved;
+
+  // NUL-terminated path of the file the child writes its stdout to.
+  char output_path[kZygoteMaxOutputPathLength];
+};
+
+struct ZygoteResponse {
+  enum Kind : uint32_t {
+    kStarted = 1,
+    kExited = 2,
+  };
+  Kind kind;
+
+  // wait(2) status of the child. Only valid for kExited.
+  int32_t status;
+
+  // PID of the child.
+  int64_t pid;
+
+  // Resource usage of the child. Only valid for kExited.
+  int64_t user_time_usec;
+  int64_t system_time_usec;
+  int64_t max_rss_kb;
+};
+
+}  // namespace silifuzz
+
+#endif  // THIRD_PARTY_SILIFUZZ_RUNNER_ZYGOTE_PROTOCOL_H_
@@ -0,0 +1,98 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./snap/gen/corpus_mapping_plan.h"
+
+#include <sys/mman.h>
+
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <vector>
+
+#include "./snap/snap.h"
+
+namespace silifuzz {
+
+namespace {
+
+uint64_t Limit(const SnapCorpusMapping& mapping) {
+  return mapping.start_address + mapping.num_bytes;
+}
+
+bool Writable(const SnapCorpusMapping& mapping) {
+  return (mapping.perms & PROT_WRITE) != 0;
+}
+
+// Returns true if `next` directly follows `prev` and can be merged into it.
+bool CanMerge(const SnapCorpusMapping& prev, const SnapCorpusMapping& next) {
+  if (Limit(prev) != next.start_address || prev.perms != next.perms ||
+      prev.flags != next.flags) {
+    return false;
+  }
+  return !prev.direct_mapped() ||
+         prev.file_offset + prev.num_bytes == next.file_offset;
+}
+
+}  // namespace
+
+std::vector<SnapCorpusMapping> PlanCorpusMappings(
+    const std::vector<SnapCorpusMapping>& mappings) {
+  // Non-overlapping ranges keyed by start address.
+  std::map<uint64_t, SnapCorpusMapping> ranges;
+  for (const SnapCorpusMapping& mapping : mappings) {
+    if (mapping.num_bytes == 0) {
+      continue;
+    }
+    const uint64_t limit = Limit(mapping);
+    auto it = ranges.upper_bound(mapping.start_address);
+    if (it != ranges.begin() && Limit(std::prev(it)->second) >
+                                    mapping.start_address) {
+      --it;
+    }
+    while (it != ranges.end() && it->first < limit) {
+      const SnapCorpusMapping old = it->second;
+      if (!Writable(old) || !Writable(mapping)) {
+        return {};
+      }
+      it = ranges.erase(it);
+      // Keep the parts of the old range outside of `mapping`. Writable ranges
+      // are never direct mapped so there is no file offset to adjust.
+      if (old.start_address < mapping.start_address) {
+        SnapCorpusMapping head = old;
+        head.num_bytes = mapping.start_address - old.start_address;
+        ranges.emplace(head.start_address, head);
+      }
+      if (Limit(old) > limit) {
+        SnapCorpusMapping tail = old;
+        tail.start_address = limit;
+        tail.num_bytes = Limit(old) - limit;
+        it = ranges.emplace(tail.start_address, tail).first;
+      }
+    }
+    ranges.emplace(mapping.start_address, mapping);
+  }
+
+  std::vector<SnapCorpusMapping> plan;
+  for (const auto& [unused, range] : ranges) {
+    if (!plan.empty() && CanMerge(plan.back(), range)) {
+      plan.back().num_bytes += range.num_bytes;
+    } else {
+      plan.push_back(range);
+    }
+  }
+  return plan;
+}
+
+}  // namespace silifuzz
@@ -0,0 +1,38 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_SILIFUZZ_SNAP_GEN_CORPUS_MAPPING_PLAN_H_
+#define THIRD_PARTY_SILIFUZZ_SNAP_GEN_CORPUS_MAPPING_PLAN_H_
+
+#include <vector>
+
+#include "./snap/snap.h"
+
+namespace silifuzz {
+
+// Returns the SnapCorpus::mapping_plan for `mappings`, the memory mappings of
+// all Snaps in a corpus in the order the runner would map them one at a time.
+// Like the runner, a later mapping replaces the parts of earlier ones that it
+// overlaps. Adjacent ranges with the same perms are merged. Direct mapped
+// ranges are only merged if their data is also adjacent in the corpus file.
+//
+// Returns an empty plan if a read-only mapping overlaps any other mapping.
+// The contents of the overlap then depend on the order the Snaps are mapped
+// in, so the runner must map them one at a time.
+std::vector<SnapCorpusMapping> PlanCorpusMappings(
+    const std::vector<SnapCorpusMapping>& mappings);
+
+}  // namespace silifuzz
+
+#endif  // THIRD_PARTY_SILIFUZZ_SNAP_GEN_CORPUS_MAPPING_PLAN_H_
@@ -0,0 +1,123 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./snap/gen/corpus_mapping_plan.h"
+
+#include <sys/mman.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "./snap/snap.h"
+
+namespace silifuzz {
+namespace {
+
+constexpr uint64_t kPage = 0x1000;
+constexpr int32_t kRO = PROT_READ;
+constexpr int32_t kRW = PROT_READ | PROT_WRITE;
+constexpr int32_t kRX = PROT_READ | PROT_EXEC;
+
+SnapCorpusMapping Anon(uint64_t start, uint64_t num_bytes, int32_t perms) {
+  return SnapCorpusMapping{
+      .start_address = start,
+      .num_bytes = num_bytes,
+      .perms = perms,
+      .flags = 0,
+      .file_offset = 0,
+  };
+}
+
+SnapCorpusMapping Direct(uint64_t start, uint64_t num_bytes, int32_t perms,
+                         uint64_t file_offset) {
+  return SnapCorpusMapping{
+      .start_address = start,
+      .num_bytes = num_bytes,
+      .perms = perms,
+      .flags = SnapCorpusMapping::kDirectMapped,
+      .file_offset = file_offset,
+  };
+}
+
+void ExpectEq(const SnapCorpusMapping& actual,
+              const SnapCorpusMapping& expected) {
+  EXPECT_EQ(actual.start_address, expected.start_address);
+  EXPECT_EQ(actual.num_bytes, expected.num_bytes);
+  EXPECT_EQ(actual.perms, expected.perms);
+  EXPECT_EQ(actual.flags, expected.flags);
+  EXPECT_EQ(actual.file_offset, expected.file_offset);
+}
+
+TEST(CorpusMappingPlan, Empty) {
+  EXPECT_TRUE(PlanCorpusMappings({}).empty());
+}
+
+TEST(CorpusMappingPlan, MergesAdjacent) {
+  std::vector<SnapCorpusMapping> plan = PlanCorpusMappings({
+      Anon(2 * kPage, kPage, kRX),
+      Anon(0, kPage, kRX),
+      Anon(kPage, kPage, kRX),
+      Anon(3 * kPage, kPage, kRW),
+      Anon(5 * kPage, kPage, kRW),
+  });
+  ASSERT_EQ(plan.size(), 3);
+  ExpectEq(plan[0], Anon(0, 3 * kPage, kRX));
+  ExpectEq(plan[1], Anon(3 * kPage, kPage, kRW));
+  ExpectEq(plan[2], Anon(5 * kPage, kPage, kRW));
+}
+
+TEST(CorpusMappingPlan, MergesContiguousDirect) {
+  std::vector<SnapCorpusMapping> plan = PlanCorpusMappings({
+      Direct(0, kPage, kRO, 4 * kPage),
+      Direct(kPage, kPage, kRO, 5 * kPage),
+      // Not contiguous in the file.
+      Direct(2 * kPage, kPage, kRO, 8 * kPage),
+      // Not direct mapped.
+      Anon(3 * kPage, kPage, kRO),
+  });
+  ASSERT_EQ(plan.size(), 3);
+  ExpectEq(plan[0], Direct(0, 2 * kPage, kRO, 4 * kPage));
+  ExpectEq(plan[1], Direct(2 * kPage, kPage, kRO, 8 * kPage));
+  ExpectEq(plan[2], Anon(3 * kPage, kPage, kRO));
+}
+
+TEST(CorpusMappingPlan, WritableOverlap) {
+  // Later mappings win, like when Snaps are mapped one at a time.
+  std::vector<SnapCorpusMapping> plan = PlanCorpusMappings({
+      Anon(0, 4 * kPage, kRW),
+      Anon(kPage, kPage, kRW | PROT_EXEC),
+      Anon(0, 4 * kPage, kRW),
+      Anon(3 * kPage, 2 * kPage, kRW | PROT_EXEC),
+  });
+  ASSERT_EQ(plan.size(), 2);
+  ExpectEq(plan[0], Anon(0, 3 * kPage, kRW));
+  ExpectEq(plan[1], Anon(3 * kPage, 2 * kPage, kRW | PROT_EXEC));
+}
+
+TEST(CorpusMappingPlan, ReadOnlyOverlap) {
+  EXPECT_TRUE(PlanCorpusMappings({
+                                     Anon(0, 2 * kPage, kRW),
+                                     Anon(kPage, kPage, kRX),
+                                 })
+                  .empty());
+  EXPECT_TRUE(PlanCorpusMappings({
+                                     Direct(0, kPage, kRO, 0),
+                                     Direct(0, kPage, kRO, 0),
+                                 })
+                  .empty());
+}
+
+}  // namespace
+}  // namespace silifuzz
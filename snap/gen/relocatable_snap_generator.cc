@@ -14,18 +14,24 @@
 
 #include "./snap/gen/relocatable_snap_generator.h"
 
+#include <sys/mman.h>
+
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/hash/hash.h"
 #include "absl/log/check.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "./common/memory_perms.h"
 #include "./common/snapshot.h"
 #include "./common/snapshot_util.h"
+#include "./snap/gen/corpus_mapping_plan.h"
 #include "./snap/gen/relocatable_data_block.h"
 #include "./snap/gen/repeating_byte_runs.h"
 #include "./snap/snap.h"
@@ -133,6 +139,48 @@ class Traversal {
       absl::flat_hash_map<const Snapshot::ByteData*, RelocatableDataBlock::Ref,
                           HashByteData, ByteDataEq>;
 
+  // SnapMemoryBytes arrays are deduplicated by their generated contents. The
+  // key has 3 words per element: start address, size and either the byte
+  // value of a repeating run or the location of the byte data. Byte data is
+  // deduplicated before the array so equal contents imply equal locations.
+  // SnapRelocator relies on a shared array always being referenced first by
+  // the Snap that caused its allocation.
+  using MemoryBytesArrayKey = std::vector<uint64_t>;
+  using DedupedArrayRefMap =
+      absl::flat_hash_map<MemoryBytesArrayKey, RelocatableDataBlock::Ref>;
+
+  // Counters of a deduplicated kind of data.
+  struct DedupStats {
+    // Number of times data of this kind was referenced.
+    uint64_t num_refs = 0;
+
+    // Number of distinct copies emitted.
+    uint64_t num_unique = 0;
+
+    // Bytes not emitted because a shared copy was referenced instead.
+    uint64_t saved_bytes = 0;
+
+    void Record(bool unique, size_t size) {
+      ++num_refs;
+      if (unique) {
+        ++num_unique;
+      } else {
+        saved_bytes += size;
+      }
+    }
+
+    // Adds counters for this kind as `prefix`_* to `counters`.
+    void AddTo(absl::string_view prefix,
+               absl::flat_hash_map<std::string, uint64_t>& counters) const {
+      counters[absl::StrCat(prefix, "_refs")] = num_refs;
+      counters[absl::StrCat(prefix, "_unique")] = num_unique;
+      counters[absl::StrCat(prefix, "_saved_bytes")] = saved_bytes;
+      // Percentage of references served by a shared copy.
+      counters[absl::StrCat(prefix, "_dedup_percent")] =
+          num_refs > 0 ? (num_refs - num_unique) * 100 / num_refs : 0;
+    }
+  };
+
   // Wrappers for Deserialize*Regs so that we can use them in templates.
   inline bool DeserializeRegs(const std::string& src, GRegSet<Arch>* dst) {
     return DeserializeGRegs(src, dst);
@@ -160,15 +208,16 @@ class Traversal {
                             RelocatableDataBlock::Ref memory_mapping_ref);
 
   // Processes a single Snapshot::MemoryBytes object `memory_bytes` for
-  // `pass` using a preallocated ref from caller.
+  // `pass` using a preallocated ref from caller. `byte_values_ref` refers to
+  // the byte data or is null if `memory_bytes` is a compressed byte run.
   void ProcessAllocated(PassType pass,
                         const Snapshot::MemoryBytes& memory_bytes,
+                        RelocatableDataBlock::Ref byte_values_ref,
                         RelocatableDataBlock::Ref memory_bytes_ref);
 
   // Processes a Snapshot::MemoryBytesList object `memory_bytes_list` for
-  // `pass`. `mapped_memory_map` contains information of all memory mappings
-  // in the source Snapshot. This allocates a ref the elements of the
-  // SnapMemoryBytes array and returns it.
+  // `pass`. This returns a deduplicated ref to the elements of the
+  // SnapMemoryBytes array.
   RelocatableDataBlock::Ref ProcessMemoryBytesList(
       PassType pass, const BorrowedMemoryBytesList& memory_bytes_list);
 
@@ -182,7 +231,23 @@ class Traversal {
   RelocatableDataBlock::Ref ProcessRegisterSet(
       PassType pass, const Snapshot::ByteData* serialized_registers,
       bool allow_empty_register_state, RelocatableDataBlock& data_block,
-      DedupedRefMap& deduped_ref_map);
+      DedupedRefMap& deduped_ref_map, DedupStats& dedup_stats);
+
+  // Deserializes `serialized_registers` into `register_set`. If
+  // `allow_empty_register_state` is true, `serialized_registers` can be empty
+  // and `register_set` is then zeroed.
+  template <typename RegisterSetType>
+  void DeserializeRegisterSet(const Snapshot::ByteData& serialized_registers,
+                              bool allow_empty_register_state,
+                              RegisterSetType* register_set);
+
+  // Fills in `delta` with the words of `register_set` that differ from
+  // `base` and the checksum of the others. The values of the changed words
+  // are allocated in `byte_data_block_`.
+  template <typename RegisterSetType>
+  void ProcessRegisterSetDelta(PassType pass, const RegisterSetType& base,
+                               const RegisterSetType& register_set,
+                               SnapRegisterSetDelta<RegisterSetType>& delta);
 
   // Processes a Snapshot::RegisterState object `register_state` for `pass`.
   // This returns a RegisterStateRefs struct containing deduplicate Refs for
@@ -193,9 +258,24 @@ class Traversal {
       bool allow_empty_register_state,
       SnapRegisterMemoryChecksum<Arch>* registers_memory_checksum);
 
+  // Processes end state registers `end_state_registers` of a snapshot with
+  // initial registers `registers` for `pass`, storing them as a delta against
+  // the initial registers. Returns a ref to the SnapRegisterDelta. If `pass`
+  // is PassType::kGeneration, also sets value of `*registers_memory_checksum`
+  // to the checksum of the full end state registers.
+  RelocatableDataBlock::Ref ProcessRegisterDelta(
+      PassType pass, const Snapshot::RegisterState& registers,
+      const Snapshot::RegisterState& end_state_registers,
+      SnapRegisterMemoryChecksum<Arch>* registers_memory_checksum);
+
   void ProcessAllocated(PassType pass, const Snapshot& snapshot,
                         RelocatableDataBlock::Ref ref);
 
+  // Records `memory_mapping` for the corpus mapping plan. Must be called after
+  // the byte data of `memory_bytes_list` has been processed.
+  void RecordCorpusMapping(const Snapshot::MemoryMapping& memory_mapping,
+                           const BorrowedMemoryBytesList& memory_bytes_list);
+
   // Options.
   RelocatableSnapGeneratorOptions options_;
 
@@ -206,6 +286,7 @@ class Traversal {
   // Sub data blocks.
   RelocatableDataBlock snap_block_;
   RelocatableDataBlock memory_bytes_block_;
+  RelocatableDataBlock register_delta_block_;
   RelocatableDataBlock memory_mapping_block_;
   RelocatableDataBlock byte_data_block_;
   RelocatableDataBlock string_block_;
@@ -217,6 +298,20 @@ class Traversal {
   DedupedRefMap byte_data_ref_map_;
   DedupedRefMap fpregs_ref_map_;
   DedupedRefMap gregs_ref_map_;
+  DedupedArrayRefMap memory_bytes_array_ref_map_;
+
+  // Deduplication counters. Reported by the generation pass.
+  DedupStats byte_data_stats_;
+  DedupStats fpregs_stats_;
+  DedupStats gregs_stats_;
+  DedupStats memory_bytes_array_stats_;
+
+  // Number of changed words stored in SnapRegisterDeltas.
+  uint64_t register_delta_words_ = 0;
+
+  // Memory mappings of all Snaps in the order they are processed. File offsets
+  // of direct mapped ones are relative to the start of `page_data_block_`.
+  std::vector<SnapCorpusMapping> corpus_mappings_;
 };
 
 template <typename Arch>
@@ -227,6 +322,7 @@ RelocatableDataBlock::Ref Traversal<Arch>::ProcessMemoryBytes(
   static constexpr RelocatableDataBlock::Ref kNullRef;
   auto [it, success] = byte_data_ref_map_.try_emplace(&byte_data, kNullRef);
   auto&& [unused, ref] = *it;
+  byte_data_stats_.Record(success, byte_data.size());
 
   // try_emplace() above failed because byte_data is a duplicate. Return early
   // as there is no need to do anything for the generation pass.
@@ -274,6 +370,7 @@ void Traversal<Arch>::ProcessMemoryMapping(
     RelocatableDataBlock::Ref memory_mapping_ref) {
   RelocatableDataBlock::Ref memory_bytes_elements_ref =
       ProcessMemoryBytesList(pass, memory_bytes_list);
+  RecordCorpusMapping(memory_mapping, memory_bytes_list);
 
   if (pass == PassType::kGeneration) {
     MemoryChecksumCalculator checksum;
@@ -297,6 +394,37 @@ void Traversal<Arch>::ProcessMemoryMapping(
   }
 }
 
+template <typename Arch>
+void Traversal<Arch>::RecordCorpusMapping(
+    const Snapshot::MemoryMapping& memory_mapping,
+    const BorrowedMemoryBytesList& memory_bytes_list) {
+  SnapCorpusMapping corpus_mapping{
+      .start_address = memory_mapping.start_address(),
+      .num_bytes = memory_mapping.num_bytes(),
+      .perms = memory_mapping.perms().ToMProtect(),
+      .flags = 0,
+      .file_offset = 0,
+  };
+  // Same conditions as SnapMemoryMapping::direct_mappable(). Page aligned
+  // data covering a whole mapping always goes to `page_data_block_`.
+  if ((corpus_mapping.perms & PROT_WRITE) == 0 &&
+      memory_bytes_list.size() == 1) {
+    const Snapshot::MemoryBytes& memory_bytes = *memory_bytes_list[0];
+    const bool repeating = options_.compress_repeating_bytes &&
+                           IsRepeatingByteRun(memory_bytes.byte_values());
+    if (!repeating &&
+        memory_bytes.start_address() == corpus_mapping.start_address &&
+        memory_bytes.num_bytes() == corpus_mapping.num_bytes) {
+      const RelocatableDataBlock::Ref ref =
+          byte_data_ref_map_.at(&memory_bytes.byte_values());
+      CHECK_EQ(ref.relocatable_data_block(), &page_data_block_);
+      corpus_mapping.flags = SnapCorpusMapping::kDirectMapped;
+      corpus_mapping.file_offset = ref.byte_offset();
+    }
+  }
+  corpus_mappings_.push_back(corpus_mapping);
+}
+
 template <typename Arch>
 RelocatableDataBlock::Ref Traversal<Arch>::ProcessMemoryMappings(
     PassType pass, const Snapshot::MemoryMappingList& memory_mappings,
@@ -320,18 +448,11 @@ RelocatableDataBlock::Ref Traversal<Arch>::ProcessMemoryMappings(
 template <typename Arch>
 void Traversal<Arch>::ProcessAllocated(
     PassType pass, const Snapshot::MemoryBytes& memory_bytes,
+    RelocatableDataBlock::Ref byte_values_ref,
     RelocatableDataBlock::Ref memory_bytes_ref) {
-  const bool compress_repeating_bytes =
-      options_.compress_repeating_bytes &&
-      IsRepeatingByteRun(memory_bytes.byte_values());
-  RelocatableDataBlock::Ref byte_values_elements_ref;
-  if (!compress_repeating_bytes) {
-    byte_values_elements_ref = ProcessMemoryBytes(pass, memory_bytes);
-  }
-
   if (pass == PassType::kGeneration) {
     // Construct MemoryBytes in contents buffer.
-    if (compress_repeating_bytes) {
+    if (byte_values_ref.relocatable_data_block() == nullptr) {
       new (memory_bytes_ref.contents_as_pointer_of<SnapMemoryBytes>())
           SnapMemoryBytes{
               .start_address = memory_bytes.start_address(),
@@ -348,7 +469,7 @@ void Traversal<Arch>::ProcessAllocated(
               .flags = 0,
               .data{.byte_values{
                   .size = memory_bytes.num_bytes(),
-                  .elements = byte_values_elements_ref
+                  .elements = byte_values_ref
                                   .load_address_as_pointer_of<const uint8_t>(),
               }},
           };
@@ -359,14 +480,48 @@ void Traversal<Arch>::ProcessAllocated(
 template <typename Arch>
 RelocatableDataBlock::Ref Traversal<Arch>::ProcessMemoryBytesList(
     PassType pass, const BorrowedMemoryBytesList& memory_bytes_list) {
-  // Allocate space for elements of SnapArray<MemoryBytes>.
-  const RelocatableDataBlock::Ref ref =
-      memory_bytes_block_.AllocateObjectsOfType<SnapMemoryBytes>(
-          memory_bytes_list.size());
+  // Process byte data first. This determines the array contents and hence
+  // whether an identical array exists already.
+  std::vector<RelocatableDataBlock::Ref> byte_values_refs;
+  byte_values_refs.reserve(memory_bytes_list.size());
+  MemoryBytesArrayKey key;
+  key.reserve(3 * memory_bytes_list.size());
+  for (const auto& memory_bytes : memory_bytes_list) {
+    RelocatableDataBlock::Ref byte_values_ref;
+    key.push_back(memory_bytes->start_address());
+    key.push_back(memory_bytes->num_bytes());
+    if (options_.compress_repeating_bytes &&
+        IsRepeatingByteRun(memory_bytes->byte_values())) {
+      key.push_back(memory_bytes->byte_values()[0]);
+    } else {
+      byte_values_ref = ProcessMemoryBytes(pass, *memory_bytes);
+      // Offsets are unique within a block and page data is page aligned, so
+      // the low bits tell the blocks apart. Tag with the top bit to separate
+      // this from a byte value.
+      key.push_back((uint64_t{1} << 63) | byte_values_ref.byte_offset() |
+                    (byte_values_ref.relocatable_data_block() ==
+                     &page_data_block_));
+    }
+    byte_values_refs.push_back(byte_values_ref);
+  }
+
+  static constexpr RelocatableDataBlock::Ref kNullRef;
+  auto [it, success] =
+      memory_bytes_array_ref_map_.try_emplace(std::move(key), kNullRef);
+  auto&& [unused, ref] = *it;
+  memory_bytes_array_stats_.Record(
+      success, sizeof(SnapMemoryBytes) * memory_bytes_list.size());
+  if (!success) {
+    return ref;
+  }
 
+  // Allocate space for elements of SnapArray<MemoryBytes>.
+  ref = memory_bytes_block_.AllocateObjectsOfType<SnapMemoryBytes>(
+      memory_bytes_list.size());
   RelocatableDataBlock::Ref snap_memory_bytes_ref = ref;
-  for (const auto& memory_bytes : memory_bytes_list) {
-    ProcessAllocated(pass, *memory_bytes, snap_memory_bytes_ref);
+  for (size_t i = 0; i < memory_bytes_list.size(); ++i) {
+    ProcessAllocated(pass, *memory_bytes_list[i], byte_values_refs[i],
+                     snap_memory_bytes_ref);
     snap_memory_bytes_ref += sizeof(SnapMemoryBytes);
   }
   return ref;
@@ -377,12 +532,13 @@ template <typename RegisterSetType>
 RelocatableDataBlock::Ref Traversal<Arch>::ProcessRegisterSet(
     PassType pass, const Snapshot::ByteData* serialized_registers,
     bool allow_empty_register_state, RelocatableDataBlock& data_block,
-    DedupedRefMap& deduped_ref_map) {
+    DedupedRefMap& deduped_ref_map, DedupStats& dedup_stats) {
   // Check to see if we can dedupe byte data.
   static constexpr RelocatableDataBlock::Ref kNullRef;
   auto [it, success] =
       deduped_ref_map.try_emplace(serialized_registers, kNullRef);
   auto&& [unused, ref] = *it;
+  dedup_stats.Record(success, sizeof(RegisterSetType));
 
   // try_emplace() above failed because serialized_registers is a duplicate.
   // Return early as there is no need to do anything for the generation pass.
@@ -393,15 +549,87 @@ RelocatableDataBlock::Ref Traversal<Arch>::ProcessRegisterSet(
   // Allocate a new reference for register set.
   ref = data_block.AllocateObjectsOfType<RegisterSetType>(1);
   if (pass == PassType::kGeneration) {
-    RegisterSetType* register_set =
-        ref.template contents_as_pointer_of<RegisterSetType>();
-    if (!serialized_registers->empty()) {
-      CHECK(DeserializeRegs(*serialized_registers, register_set));
-    } else {
-      CHECK(allow_empty_register_state);
-      memset(register_set, 0, sizeof(RegisterSetType));
+    DeserializeRegisterSet(
+        *serialized_registers, allow_empty_register_state,
+        ref.template contents_as_pointer_of<RegisterSetType>());
+  }
+  return ref;
+}
+
+template <typename Arch>
+template <typename RegisterSetType>
+void Traversal<Arch>::DeserializeRegisterSet(
+    const Snapshot::ByteData& serialized_registers,
+    bool allow_empty_register_state, RegisterSetType* register_set) {
+  if (!serialized_registers.empty()) {
+    CHECK(DeserializeRegs(serialized_registers, register_set));
+  } else {
+    CHECK(allow_empty_register_state);
+    memset(register_set, 0, sizeof(RegisterSetType));
+  }
+}
+
+template <typename Arch>
+template <typename RegisterSetType>
+void Traversal<Arch>::ProcessRegisterSetDelta(
+    PassType pass, const RegisterSetType& base,
+    const RegisterSetType& register_set,
+    SnapRegisterSetDelta<RegisterSetType>& delta) {
+  using Delta = SnapRegisterSetDelta<RegisterSetType>;
+  const uint64_t* base_words = reinterpret_cast<const uint64_t*>(&base);
+  const uint64_t* words = reinterpret_cast<const uint64_t*>(&register_set);
+  std::vector<uint64_t> values;
+  memset(delta.changed_mask, 0, sizeof(delta.changed_mask));
+  for (size_t i = 0; i < Delta::kNumWords; ++i) {
+    if (words[i] != base_words[i]) {
+      delta.changed_mask[i / 64] |= uint64_t{1} << (i % 64);
+      values.push_back(words[i]);
+    }
+  }
+  register_delta_words_ += values.size();
+  delta.unchanged_checksum = UnchangedWordsChecksum(delta, base);
+
+  delta.values = {.size = values.size(), .elements = nullptr};
+  if (!values.empty()) {
+    const RelocatableDataBlock::Ref values_ref =
+        byte_data_block_.AllocateObjectsOfType<uint64_t>(values.size());
+    if (pass == PassType::kGeneration) {
+      memcpy(values_ref.contents(), values.data(),
+             values.size() * sizeof(uint64_t));
+      delta.values.elements =
+          values_ref.load_address_as_pointer_of<const uint64_t>();
     }
   }
+}
+
+template <typename Arch>
+RelocatableDataBlock::Ref Traversal<Arch>::ProcessRegisterDelta(
+    PassType pass, const Snapshot::RegisterState& registers,
+    const Snapshot::RegisterState& end_state_registers,
+    SnapRegisterMemoryChecksum<Arch>* registers_memory_checksum) {
+  UContext<Arch> base, end_state;
+  DeserializeRegisterSet(registers.gregs(),
+                         /*allow_empty_register_state=*/false, &base.gregs);
+  DeserializeRegisterSet(registers.fpregs(),
+                         /*allow_empty_register_state=*/false, &base.fpregs);
+  DeserializeRegisterSet(end_state_registers.gregs(),
+                         /*allow_empty_register_state=*/true,
+                         &end_state.gregs);
+  DeserializeRegisterSet(end_state_registers.fpregs(),
+                         /*allow_empty_register_state=*/true,
+                         &end_state.fpregs);
+
+  const RelocatableDataBlock::Ref ref =
+      register_delta_block_.AllocateObjectsOfType<SnapRegisterDelta<Arch>>(1);
+  SnapRegisterDelta<Arch> delta;
+  ProcessRegisterSetDelta(pass, base.gregs, end_state.gregs, delta.gregs);
+  ProcessRegisterSetDelta(pass, base.fpregs, end_state.fpregs, delta.fpregs);
+  if (pass == PassType::kGeneration) {
+    new (ref.contents_as_pointer_of<SnapRegisterDelta<Arch>>())
+        SnapRegisterDelta<Arch>(delta);
+    *registers_memory_checksum =
+        CalculateRegisterMemoryChecksum(UContextView<Arch>(end_state));
+  }
   return ref;
 }
 
@@ -414,10 +642,10 @@ Traversal<Arch>::ProcessRegisterState(
   RegisterStateRefs register_state_refs;
   register_state_refs.gregs = ProcessRegisterSet<GRegSet<Arch>>(
       pass, &register_states.gregs(), allow_empty_register_state, gregs_block_,
-      gregs_ref_map_);
+      gregs_ref_map_, gregs_stats_);
   register_state_refs.fpregs = ProcessRegisterSet<FPRegSet<Arch>>(
       pass, &register_states.fpregs(), allow_empty_register_state,
-      fpregs_block_, fpregs_ref_map_);
+      fpregs_block_, fpregs_ref_map_, fpregs_stats_);
   if (pass == PassType::kGeneration) {
     GRegSet<Arch>* gregs =
         register_state_refs.gregs
@@ -459,9 +687,18 @@ void Traversal<Arch>::ProcessAllocated(PassType pass, const Snapshot& snapshot,
   RegisterStateRefs register_state_refs = ProcessRegisterState(
       pass, snapshot.registers(), /*allow_empty_register_state=*/false,
       &registers_memory_checksum);
-  RegisterStateRefs end_state_register_state_refs = ProcessRegisterState(
-      pass, end_state.registers(), /*allow_empty_register_state=*/true,
-      &end_state_registers_memory_checksum);
+  RegisterStateRefs end_state_register_state_refs;
+  RelocatableDataBlock::Ref end_state_registers_delta_ref;
+  const bool delta_encoded = options_.delta_encode_end_state_registers;
+  if (delta_encoded) {
+    end_state_registers_delta_ref =
+        ProcessRegisterDelta(pass, snapshot.registers(), end_state.registers(),
+                             &end_state_registers_memory_checksum);
+  } else {
+    end_state_register_state_refs = ProcessRegisterState(
+        pass, end_state.registers(), /*allow_empty_register_state=*/true,
+        &end_state_registers_memory_checksum);
+  }
 
   if (pass == PassType::kGeneration) {
     memcpy(id_ref.contents(), snapshot.id().c_str(), snapshot.id().size() + 1);
@@ -494,7 +731,15 @@ void Traversal<Arch>::ProcessAllocated(PassType pass, const Snapshot& snapshot,
         .registers = BuildUContextView(register_state_refs),
         .end_state_instruction_address =
             end_state.endpoint().instruction_address(),
-        .end_state_registers = BuildUContextView(end_state_register_state_refs),
+        // A delta is stored in place of the fpregs pointer. See
+        // Snap::end_state_registers.
+        .end_state_registers =
+            delta_encoded
+                ? UContextView<Arch>(
+                      end_state_registers_delta_ref
+                          .load_address_as_pointer_of<const FPRegSet<Arch>>(),
+                      nullptr)
+                : BuildUContextView(end_state_register_state_refs),
         .end_state_memory_bytes{
             .size = end_state.memory_bytes().size(),
             .elements =
@@ -530,6 +775,14 @@ absl::flat_hash_map<std::string, uint64_t> Traversal<Arch>::Process(
     ProcessAllocated(pass, snapshots[i], snaps_ref + i * sizeof(Snap<Arch>));
   }
 
+  // The plan only depends on the layout of `page_data_block_`, so it has the
+  // same size in both passes.
+  std::vector<SnapCorpusMapping> mapping_plan =
+      PlanCorpusMappings(corpus_mappings_);
+  const RelocatableDataBlock::Ref mapping_plan_elements_ref =
+      memory_mapping_block_.AllocateObjectsOfType<SnapCorpusMapping>(
+          mapping_plan.size());
+
   // Merge component data blocks into a single main data block.
   // Parts with and without pointers are group separately to minimize
   // memory pages that needs to be modified. This is desirable if a
@@ -538,6 +791,7 @@ absl::flat_hash_map<std::string, uint64_t> Traversal<Arch>::Process(
   // These have pointers.
   main_block_.Allocate(snap_block_);
   main_block_.Allocate(memory_bytes_block_);
+  main_block_.Allocate(register_delta_block_);
 
   // These are pointer-free
   main_block_.Allocate(memory_mapping_block_);
@@ -561,6 +815,7 @@ absl::flat_hash_map<std::string, uint64_t> Traversal<Arch>::Process(
                     sizeof(typename Snap<Arch>::RegisterState),
                 .architecture_id = static_cast<uint8_t>(Arch::architecture_id),
                 .padding = {},
+                .load_address = 0,
             },
         .snaps =
             {
@@ -569,8 +824,28 @@ absl::flat_hash_map<std::string, uint64_t> Traversal<Arch>::Process(
                     snap_array_elements_ref
                         .load_address_as_pointer_of<const Snap<Arch>*>(),
             },
+        .mapping_plan =
+            {
+                .size = mapping_plan.size(),
+                .elements =
+                    mapping_plan_elements_ref
+                        .load_address_as_pointer_of<const SnapCorpusMapping>(),
+            },
     };
 
+    // Create mapping plan elements. File offsets are relative to the start of
+    // the corpus.
+    const uint64_t page_data_offset =
+        page_data_block_.load_address() - main_block_.load_address();
+    for (size_t i = 0; i < mapping_plan.size(); ++i) {
+      SnapCorpusMapping& entry = mapping_plan[i];
+      if (entry.direct_mapped()) {
+        entry.file_offset += page_data_offset;
+      }
+      *(mapping_plan_elements_ref + i * sizeof(SnapCorpusMapping))
+           .contents_as_pointer_of<SnapCorpusMapping>() = entry;
+    }
+
     // Create const pointer array elements.
     for (size_t i = 0; i < snapshots.size(); ++i) {
       const RelocatableDataBlock::Ref snap_ref =
@@ -593,13 +868,21 @@ absl::flat_hash_map<std::string, uint64_t> Traversal<Arch>::Process(
       {"main_block", main_block_.size()},
       {"snap_block", snap_block_.size()},
       {"memory_bytes_block", memory_bytes_block_.size()},
+      {"register_delta_block", register_delta_block_.size()},
+      {"register_delta_words", register_delta_words_},
       {"memory_mapping_block", memory_mapping_block_.size()},
       {"byte_data_block", byte_data_block_.size()},
       {"string_block", string_block_.size()},
       {"fpregs_block", fpregs_block_.size()},
       {"gregs_block", gregs_block_.size()},
       {"page_data_block", page_data_block_.size()},
+      {"snap_memory_mappings", corpus_mappings_.size()},
+      {"mapping_plan_size", mapping_plan.size()},
   };
+  byte_data_stats_.AddTo("byte_data", block_sizes);
+  fpregs_stats_.AddTo("fpregs", block_sizes);
+  gregs_stats_.AddTo("gregs", block_sizes);
+  memory_bytes_array_stats_.AddTo("memory_bytes_array", block_sizes);
   return block_sizes;
 }
 
@@ -622,6 +905,7 @@ void Traversal<Arch>::PrepareSnapGeneration(char* content_buffer,
   main_block_.ResetSizeAndAlignment();
   prepare_sub_data_block(snap_block_);
   prepare_sub_data_block(memory_bytes_block_);
+  prepare_sub_data_block(register_delta_block_);
   prepare_sub_data_block(memory_mapping_block_);
   prepare_sub_data_block(byte_data_block_);
   prepare_sub_data_block(string_block_);
@@ -632,10 +916,17 @@ void Traversal<Arch>::PrepareSnapGeneration(char* content_buffer,
   // Reset main block again for generation pass.
   main_block_.ResetSizeAndAlignment();
 
-  // Reset byte data deduping hash map.
+  // Reset deduping hash maps and counters.
   byte_data_ref_map_.clear();
   fpregs_ref_map_.clear();
   gregs_ref_map_.clear();
+  memory_bytes_array_ref_map_.clear();
+  byte_data_stats_ = {};
+  fpregs_stats_ = {};
+  gregs_stats_ = {};
+  memory_bytes_array_stats_ = {};
+  register_delta_words_ = 0;
+  corpus_mappings_.clear();
 }
 
 }  // namespace
@@ -52,6 +52,8 @@ namespace silifuzz {
 // +---------------------------+
 // | SnapMemoryBytes array     |
 // +---------------------------+
+// | SnapRegisterDelta array   |
+// +---------------------------+
 // | SnapMemoryMapping array   |
 // +---------------------------+
 // | byte array                |
@@ -86,24 +88,30 @@ namespace silifuzz {
 //
 // 4. SnapMemoryBytes array.
 // These are Snap::MemoryBytes structures. Byte data referenced by these are
-// stored in another part of the corpus.
+// stored in another part of the corpus. Identical arrays are stored once and
+// shared by all Snaps that use them.
+//
+// 5. SnapRegisterDelta array.
+// End state registers of Snaps stored as deltas against their initial
+// registers. Only present with delta_encode_end_state_registers. The values of
+// the changed words are stored in the byte array.
 //
-// 5. SnapMemoryMapping array.
+// 6. SnapMemoryMapping array.
 // Fixed-sized Memory mappings structures.
 //
-// 6. Byte array.
+// 7. Byte array.
 // Variable-sized part of memory bytes.  These are aligned to 64-bit boundaries
 // to speed up access.
 //
-// 7. String array.
+// 8. String array.
 // Snapshot IDs.
 //
-// 8. Snap::RegisterState array.
+// 9. Snap::RegisterState array.
 // These are the registers that specify the entry and exit state of each Snap.
 // This data is stored out-of-line from the Snap structure so that relocating
 // the Snap doesn't dirty the pages containing register data.
 //
-// 9. Page-aligned data.
+// 10. Page-aligned data.
 // Page-aligned memory bytes may be put in this section if we want to mmap them
 // directly from the file when the corpus is loaded. Page-aligned data will not
 // be RLE compressed, however, so there is a tradeoff between load speed and
@@ -114,9 +122,18 @@ struct RelocatableSnapGeneratorOptions {
   // If true, apply run-length compression to memory bytes data.
   bool compress_repeating_bytes = true;
 
+  // If true, store the expected end state registers of each Snap as a
+  // SnapRegisterDelta against its initial registers instead of full register
+  // sets. This makes the corpus smaller since most snapshots change only a
+  // few registers. The layout of Snap does not change, so a runner that
+  // predates the encoding does not reject such a corpus but cannot run it.
+  bool delta_encode_end_state_registers = false;
+
   // When present, this map will be populated with various _debug-only_
-  // counters representing sizes of different parts of the generated corpus.
-  // The keys are human-readable but are not guaranteed to be stable.
+  // counters representing sizes of different parts of the generated corpus
+  // and how well byte data, register sets and SnapMemoryBytes arrays were
+  // deduplicated. The keys are human-readable but are not guaranteed to be
+  // stable.
   absl::flat_hash_map<std::string, uint64_t>* counters = nullptr;
 };
 
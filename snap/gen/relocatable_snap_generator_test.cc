@@ -368,5 +368,141 @@ TYPED_TEST(RelocatableSnapGenerator, DedupeRegisterBytes) {
   EXPECT_EQ(snap.registers.fpregs, snap.end_state_registers.fpregs);
 }
 
+// Test that delta encoded end state registers round trip and are smaller.
+TYPED_TEST(RelocatableSnapGenerator, DeltaEncodedEndStateRegisters) {
+  SnapifyOptions opts = SnapifyOptions::V2InputRunOpts(Host::architecture_id);
+  std::vector<Snapshot> snapified_corpus;
+  for (int index = 0; index < static_cast<int>(TestSnapshot::kNumTestSnapshot);
+       ++index) {
+    TestSnapshot type = static_cast<TestSnapshot>(index);
+    if (!TestSnapshotExists<TypeParam>(type)) {
+      continue;
+    }
+    Snapshot snapshot = MakeSnapRunnerTestSnapshot<TypeParam>(type);
+    ASSERT_OK_AND_ASSIGN(Snapshot snapified, Snapify(snapshot, opts));
+    snapified_corpus.push_back(std::move(snapified));
+  }
+
+  absl::flat_hash_map<std::string, uint64_t> full_counters, delta_counters;
+  GenerateRelocatedCorpus<TypeParam>(snapified_corpus,
+                                     {.counters = &full_counters});
+  auto relocated_corpus = GenerateRelocatedCorpus<TypeParam>(
+      snapified_corpus, {.delta_encode_end_state_registers = true,
+                         .counters = &delta_counters});
+  EXPECT_EQ(full_counters["register_delta_block"], 0);
+  EXPECT_GT(delta_counters["register_delta_block"], 0);
+  EXPECT_LT(delta_counters["main_block"], full_counters["main_block"]);
+
+  ASSERT_EQ(snapified_corpus.size(), relocated_corpus->snaps.size);
+  for (size_t i = 0; i < snapified_corpus.size(); ++i) {
+    const Snap<TypeParam>& snap = *relocated_corpus->snaps.at(i);
+    EXPECT_EQ(snap.end_state_registers.gregs, nullptr);
+    EXPECT_NE(EndStateRegistersDelta(snap), nullptr);
+    VerifyTestSnap(snapified_corpus[i], snap, opts);
+
+    UContext<TypeParam> storage;
+    const UContextView<TypeParam> end_state_registers =
+        EndStateRegisters(snap, storage);
+    EXPECT_EQ(end_state_registers.gregs, &storage.gregs);
+    EXPECT_EQ(CalculateRegisterMemoryChecksum(end_state_registers),
+              snap.end_state_registers_memory_checksum);
+
+    // The runner compares the delta to the actual end state directly.
+    const SnapRegisterDelta<TypeParam>& delta = *EndStateRegistersDelta(snap);
+    EXPECT_TRUE(RegisterSetMatchesDelta(delta.gregs, storage.gregs));
+    EXPECT_TRUE(RegisterSetMatchesDelta(delta.fpregs, storage.fpregs));
+  }
+}
+
+// Test that identical SnapMemoryBytes arrays are shared between Snaps and
+// survive relocation.
+TYPED_TEST(RelocatableSnapGenerator, DedupeMemoryBytesArrays) {
+  Snapshot snapshot =
+      CreateTestSnapshot<TypeParam>(TestSnapshot::kEndsAsExpected);
+  SnapifyOptions snapify_opts =
+      SnapifyOptions::V2InputRunOpts(snapshot.architecture_id());
+  ASSERT_OK_AND_ASSIGN(auto snapified, Snapify(snapshot, snapify_opts));
+
+  // Same contents, different ids.
+  std::vector<Snapshot> snapified_corpus;
+  for (const char* id : {"first", "second", "third"}) {
+    Snapshot copy = snapified.Copy();
+    copy.set_id(id);
+    snapified_corpus.push_back(std::move(copy));
+  }
+
+  absl::flat_hash_map<std::string, uint64_t> counters;
+  auto relocated_corpus = GenerateRelocatedCorpus<TypeParam>(
+      snapified_corpus, {.counters = &counters});
+  const Snap<TypeParam>& first = *relocated_corpus->snaps.at(0);
+  for (size_t i = 1; i < snapified_corpus.size(); ++i) {
+    const Snap<TypeParam>& snap = *relocated_corpus->snaps.at(i);
+    ASSERT_EQ(snap.memory_mappings.size, first.memory_mappings.size);
+    for (size_t j = 0; j < snap.memory_mappings.size; ++j) {
+      EXPECT_EQ(snap.memory_mappings[j].memory_bytes.elements,
+                first.memory_mappings[j].memory_bytes.elements);
+    }
+    EXPECT_EQ(snap.end_state_memory_bytes.elements,
+              first.end_state_memory_bytes.elements);
+    EXPECT_EQ(snap.registers.gregs, first.registers.gregs);
+    // Shared arrays are relocated exactly once.
+    VerifyTestSnap(snapified_corpus[i], snap, snapify_opts);
+  }
+
+  EXPECT_EQ(counters["gregs_refs"], 6);
+  EXPECT_LE(counters["gregs_unique"], 2);
+  EXPECT_GE(counters["memory_bytes_array_dedup_percent"], 66);
+  EXPECT_GT(counters["byte_data_saved_bytes"], 0);
+}
+
+// Test that the mapping plan covers all memory mappings.
+TYPED_TEST(RelocatableSnapGenerator, MappingPlan) {
+  Snapshot snapshot =
+      CreateTestSnapshot<TypeParam>(TestSnapshot::kEndsAsExpected);
+  SnapifyOptions snapify_opts =
+      SnapifyOptions::V2InputRunOpts(snapshot.architecture_id());
+  ASSERT_OK_AND_ASSIGN(auto snapified, Snapify(snapshot, snapify_opts));
+
+  std::vector<Snapshot> snapified_corpus;
+  snapified_corpus.push_back(snapified.Copy());
+  absl::flat_hash_map<std::string, uint64_t> counters;
+  auto relocated_corpus = GenerateRelocatedCorpus<TypeParam>(
+      snapified_corpus, {.counters = &counters});
+  const SnapCorpus<TypeParam>& corpus = *relocated_corpus;
+  const Snap<TypeParam>& snap = *corpus.snaps.at(0);
+  ASSERT_GT(corpus.mapping_plan.size, 0);
+  EXPECT_LE(corpus.mapping_plan.size, snap.memory_mappings.size);
+  EXPECT_EQ(counters["mapping_plan_size"], corpus.mapping_plan.size);
+  EXPECT_EQ(counters["snap_memory_mappings"], snap.memory_mappings.size);
+
+  const char* corpus_start = reinterpret_cast<const char*>(&corpus);
+  for (const SnapMemoryMapping& mapping : snap.memory_mappings) {
+    const SnapCorpusMapping* entry = nullptr;
+    for (const SnapCorpusMapping& e : corpus.mapping_plan) {
+      if (e.start_address <= mapping.start_address &&
+          mapping.start_address + mapping.num_bytes <=
+              e.start_address + e.num_bytes) {
+        entry = &e;
+      }
+    }
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->perms, mapping.perms);
+    EXPECT_EQ(entry->direct_mapped(), mapping.direct_mappable());
+    if (entry->direct_mapped()) {
+      EXPECT_EQ(corpus_start + entry->file_offset +
+                    (mapping.start_address - entry->start_address),
+                reinterpret_cast<const char*>(
+                    mapping.memory_bytes[0].data.byte_values.elements));
+    }
+  }
+
+  // Read-only mappings of the copies overlap, so there is no plan.
+  Snapshot copy = snapified.Copy();
+  copy.set_id("copy");
+  snapified_corpus.push_back(std::move(copy));
+  relocated_corpus = GenerateRelocatedCorpus<TypeParam>(snapified_corpus);
+  EXPECT_EQ(relocated_corpus->mapping_plan.size, 0);
+}
+
 }  // namespace
 }  // namespace silifuzz
@@ -29,6 +29,8 @@
 #include <cstring>
 
 #include "./util/checks.h"
+#include "./util/mem_util.h"
+#include "./util/page_util.h"
 #include "./util/reg_checksum.h"
 #include "./util/ucontext/ucontext_types.h"
 
@@ -102,6 +104,32 @@ struct SnapMemoryMapping {
   // Returns true if memory mapping is writable.
   bool writable() const { return (perms & PROT_WRITE) != 0; }
 
+  // Returns true if the mapping can be mapped directly from the corpus file
+  // that holds its data.
+  bool direct_mappable() const {
+    // We could support mmapping writeable pages with COW, but that's not a
+    // feature we need right now and it makes the code a little more
+    // complicated.
+    if (writable()) {
+      return false;
+    }
+    // There must be only one memory_bytes entry.
+    if (memory_bytes.size != 1) {
+      return false;
+    }
+    const SnapMemoryBytes& bytes = memory_bytes[0];
+    // The bytes must be uncompressed.
+    if (bytes.repeating()) {
+      return false;
+    }
+    // The bytes must cover the mapping completely.
+    if (bytes.start_address != start_address || bytes.size() != num_bytes) {
+      return false;
+    }
+    // The underlying data pointer must be page aligned.
+    return IsPageAligned(bytes.data.byte_values.elements);
+  }
+
   // Start address of region mapped.
   uint64_t start_address;
 
@@ -138,6 +166,54 @@ struct SnapRegisterMemoryChecksum {
   uint32_t gregs_checksum;
 };
 
+// Sparse encoding of a register set as the 64-bit words that differ from a
+// base register set. Most snapshots change only a few registers, so this is
+// much smaller than a full copy of the register set.
+template <typename RegisterSet>
+struct SnapRegisterSetDelta {
+  static_assert(sizeof(RegisterSet) % sizeof(uint64_t) == 0,
+                "Register set is not a whole number of words");
+  static constexpr size_t kNumWords = sizeof(RegisterSet) / sizeof(uint64_t);
+  static constexpr size_t kNumMaskWords = (kNumWords + 63) / 64;
+
+  // Tells if the i-th word differs from the base.
+  bool changed(size_t i) const {
+    return ((changed_mask[i / 64] >> (i % 64)) & 1) != 0;
+  }
+
+  // Stores `base` with the changed words replaced by `values` in `result`.
+  void Apply(const RegisterSet& base, RegisterSet& result) const {
+    MemCopy(&result, &base, sizeof(RegisterSet));
+    uint64_t* result_words = reinterpret_cast<uint64_t*>(&result);
+    const uint64_t* value = values.elements;
+    for (size_t m = 0; m < kNumMaskWords; ++m) {
+      for (uint64_t changed = changed_mask[m]; changed != 0;
+           changed &= changed - 1) {
+        result_words[m * 64 + __builtin_ctzll(changed)] = *value++;
+      }
+    }
+  }
+
+  // Bit i % 64 of changed_mask[i / 64] is set iff the i-th word differs from
+  // the base.
+  uint64_t changed_mask[kNumMaskWords];
+
+  // Values of the changed words in increasing word order. The size is the
+  // number of bits set in `changed_mask`.
+  SnapArray<uint64_t> values;
+
+  // Checksum of the words of the base that are not changed, in increasing
+  // word order. See UnchangedWordsChecksum() in snap_checksum.h.
+  uint32_t unchanged_checksum;
+};
+
+// Register state stored as a delta against another register state.
+template <typename Arch>
+struct SnapRegisterDelta {
+  SnapRegisterSetDelta<GRegSet<Arch>> gregs;
+  SnapRegisterSetDelta<FPRegSet<Arch>> fpregs;
+};
+
 // A simplified snapshot representation.
 template <typename Arch>
 struct Snap {
@@ -170,6 +246,12 @@ struct Snap {
   uint64_t end_state_instruction_address;
 
   // The expected state of the registers to exist at `endpoint`.
+  //
+  // The registers may instead be stored as a SnapRegisterDelta against
+  // `registers`. Then `gregs` is null and `fpregs` holds the address of the
+  // delta, which keeps the layout of Snap the same for both encodings. Use
+  // EndStateRegisters() to get the registers in either case. The fields may
+  // only be read directly after EndStateRegistersDelta() returned nullptr.
   RegisterState end_state_registers;
 
   // The expected memory state to exist at `endpoint`.
@@ -197,6 +279,31 @@ struct Snap {
   SnapRegisterMemoryChecksum<Arch> end_state_registers_memory_checksum;
 };
 
+// Returns the delta the expected end state registers of `snap` are stored as,
+// or nullptr if they are stored as full register sets.
+template <typename Arch>
+const SnapRegisterDelta<Arch>* EndStateRegistersDelta(const Snap<Arch>& snap) {
+  if (snap.end_state_registers.gregs != nullptr) {
+    return nullptr;
+  }
+  return reinterpret_cast<const SnapRegisterDelta<Arch>*>(
+      snap.end_state_registers.fpregs);
+}
+
+// Returns the expected end state registers of `snap`. Registers stored as a
+// delta are reconstructed in `storage`, which must outlive the returned view.
+template <typename Arch>
+UContextView<Arch> EndStateRegisters(const Snap<Arch>& snap,
+                                     UContext<Arch>& storage) {
+  const SnapRegisterDelta<Arch>* delta = EndStateRegistersDelta(snap);
+  if (delta == nullptr) {
+    return snap.end_state_registers;
+  }
+  delta->gregs.Apply(*snap.registers.gregs, storage.gregs);
+  delta->fpregs.Apply(*snap.registers.fpregs, storage.fpregs);
+  return UContextView<Arch>(storage);
+}
+
 namespace snap_internal {
 
 template <typename T>
@@ -245,6 +352,41 @@ struct SnapCorpusHeader {
 
   // Make the unused space in this struct explicit.
   uint8_t padding[3];
+
+  // The address the corpus is relocated for. Zero for a relocatable corpus,
+  // whose pointers are offsets from the start of the corpus. A corpus mapped
+  // at this address can be used without relocation.
+  uint64_t load_address;
+};
+
+// A range of memory that is mapped for a whole corpus before any Snap runs.
+// Mapping ranges rather than the memory mappings of every Snap avoids
+// remapping pages that many Snaps share, such as the stack, and merges
+// adjacent mappings with the same permissions into a single VMA.
+struct SnapCorpusMapping {
+  // Flags
+  enum {
+    kDirectMapped = 1 << 0,  // If set, the range is mapped from the corpus
+                             // file at `file_offset`.
+  };
+
+  bool direct_mapped() const { return (flags & kDirectMapped) != 0; }
+
+  // Start address of region mapped.
+  uint64_t start_address;
+
+  // Byte size of region.
+  uint64_t num_bytes;
+
+  // Bit mask of memory protections. Same as those used in mprotect().
+  int32_t perms;
+
+  // Flags
+  uint32_t flags;
+
+  // Offset of the data of a direct mapped range from the start of the corpus.
+  // The data of the other ranges comes from the memory mappings of the Snaps.
+  uint64_t file_offset;
 };
 
 template <typename Arch>
@@ -255,6 +397,11 @@ struct SnapCorpus {
   // The corpus data.
   SnapArray<const Snap<Arch>*> snaps;
 
+  // Sorted, non-overlapping ranges covering the memory mappings of all snaps,
+  // or empty if the generator could not merge the mappings. See
+  // SnapCorpusMapping.
+  SnapArray<SnapCorpusMapping> mapping_plan;
+
   bool IsExpectedArch() const {
     return header.architecture_id == static_cast<int>(Arch::architecture_id);
   }
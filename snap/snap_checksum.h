@@ -64,6 +64,49 @@ class CorpusChecksumCalculator {
   uint32_t checksum_;
 };
 
+// Returns the checksum of the words of `registers` that `delta` does not
+// change, in increasing word order. This is `delta.unchanged_checksum` if
+// `registers` is the base of `delta`.
+template <typename RegisterSet>
+uint32_t UnchangedWordsChecksum(const SnapRegisterSetDelta<RegisterSet>& delta,
+                                const RegisterSet& registers) {
+  using Delta = SnapRegisterSetDelta<RegisterSet>;
+  const uint64_t* words = reinterpret_cast<const uint64_t*>(&registers);
+  MemoryChecksumCalculator checksum;
+  size_t run_start = 0;
+  for (size_t m = 0; m < Delta::kNumMaskWords; ++m) {
+    for (uint64_t changed = delta.changed_mask[m]; changed != 0;
+         changed &= changed - 1) {
+      const size_t i = m * 64 + __builtin_ctzll(changed);
+      checksum.AddData(words + run_start, (i - run_start) * sizeof(uint64_t));
+      run_start = i + 1;
+    }
+  }
+  checksum.AddData(words + run_start,
+                   (Delta::kNumWords - run_start) * sizeof(uint64_t));
+  return checksum.Checksum();
+}
+
+// Tells if `registers` are the base of `delta` with `delta` applied. Only the
+// changed words are compared. The unchanged ones are compared by checksum, so
+// the base is not needed.
+template <typename RegisterSet>
+bool RegisterSetMatchesDelta(const SnapRegisterSetDelta<RegisterSet>& delta,
+                             const RegisterSet& registers) {
+  using Delta = SnapRegisterSetDelta<RegisterSet>;
+  const uint64_t* words = reinterpret_cast<const uint64_t*>(&registers);
+  const uint64_t* value = delta.values.elements;
+  for (size_t m = 0; m < Delta::kNumMaskWords; ++m) {
+    for (uint64_t changed = delta.changed_mask[m]; changed != 0;
+         changed &= changed - 1) {
+      if (words[m * 64 + __builtin_ctzll(changed)] != *value++) {
+        return false;
+      }
+    }
+  }
+  return UnchangedWordsChecksum(delta, registers) == delta.unchanged_checksum;
+}
+
 // Computes SnapRegisterMemoryChecksum from `view`. See snap.h for details.
 template <typename Arch>
 SnapRegisterMemoryChecksum<Arch> CalculateRegisterMemoryChecksum(
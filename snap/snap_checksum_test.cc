@@ -120,5 +120,35 @@ TEST(SnapChecksumTest, RegisterMemoryChecksumChecksum) {
   EXPECT_EQ(expect_gregs_checksum, actual_checksum.gregs_checksum);
 }
 
+TEST(SnapChecksumTest, RegisterSetMatchesDelta) {
+  using RegisterSet = GRegSet<X86_64>;
+  using Delta = SnapRegisterSetDelta<RegisterSet>;
+  RegisterSet base;
+  memset(&base, 0xbb, sizeof(base));
+  uint64_t* base_words = reinterpret_cast<uint64_t*>(&base);
+  base_words[0] = 1;
+  base_words[Delta::kNumWords - 1] = 2;
+
+  // Words 1 and 5 change.
+  const uint64_t kValues[] = {3, 4};
+  Delta delta = {
+      .changed_mask = {(1ULL << 1) | (1ULL << 5)},
+      .values = {.size = 2, .elements = kValues},
+  };
+  delta.unchanged_checksum = UnchangedWordsChecksum(delta, base);
+
+  RegisterSet end_state;
+  delta.Apply(base, end_state);
+  EXPECT_TRUE(RegisterSetMatchesDelta(delta, end_state));
+  EXPECT_FALSE(RegisterSetMatchesDelta(delta, base));
+
+  // A difference in any word is caught, changed or not.
+  for (size_t i = 0; i < Delta::kNumWords; ++i) {
+    RegisterSet mutant = end_state;
+    reinterpret_cast<uint64_t*>(&mutant)[i] ^= 1ULL << (i % 64);
+    EXPECT_FALSE(RegisterSetMatchesDelta(delta, mutant)) << i;
+  }
+}
+
 }  // namespace
 }  // namespace silifuzz
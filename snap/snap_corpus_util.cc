@@ -32,8 +32,46 @@
 #include "./util/misc_util.h"
 #include "./util/mmapped_memory_ptr.h"
 
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
 namespace silifuzz {
 
+namespace {
+
+// Maps the corpus in `fd` shared and read-only at the load address in its
+// header if the corpus is already relocated for an address and nothing else
+// is mapped there. This lets all processes loading the same file share its
+// pages.
+// RETURNS: the mapping or nullptr if the corpus has to be relocated.
+char* MapRelocatedCorpus(int fd, off_t file_size, bool preload) {
+  SnapCorpusHeader header;
+  if (read(fd, &header, sizeof(header)) != sizeof(header) ||
+      header.magic != kSnapCorpusMagic ||
+      header.header_size != sizeof(header) || header.load_address == 0) {
+    return nullptr;
+  }
+  void* const load_address = AsPtr(header.load_address);
+  void* mapped =
+      mmap(load_address, file_size, PROT_READ,
+           MAP_SHARED | MAP_FIXED_NOREPLACE | (preload ? MAP_POPULATE : 0), fd,
+           0);
+  if (mapped == MAP_FAILED) {
+    VLOG_INFO(1, "Cannot map corpus at ", HexStr(header.load_address), ": ",
+              ErrnoStr(errno));
+    return nullptr;
+  }
+  // Kernels older than 4.17 treat the address as a hint.
+  if (mapped != load_address) {
+    CHECK_EQ(munmap(mapped, file_size), 0);
+    return nullptr;
+  }
+  return reinterpret_cast<char*>(mapped);
+}
+
+}  // namespace
+
 template <typename Arch>
 MmappedMemoryPtr<const SnapCorpus<Arch>> LoadCorpusFromFile(
     const char* filename, bool preload, bool verify, int* corpus_fd) {
@@ -56,10 +94,18 @@ MmappedMemoryPtr<const SnapCorpus<Arch>> LoadCorpusFromFile(
   off_t file_size = lseek(fd, 0, SEEK_END);
   CHECK_NE(file_size, -1);
   VLOG_INFO(1, "Corpus size (bytes) ", IntStr(file_size));
-  void* relocatable = mmap(nullptr, file_size, PROT_READ | PROT_WRITE,
-                           MAP_PRIVATE | (preload ? MAP_POPULATE : 0), fd, 0);
-  CHECK_NE(relocatable, MAP_FAILED);
-  VLOG_INFO(1, "Mapped corpus at ", HexStr(AsInt(relocatable)));
+  CHECK_EQ(lseek(fd, 0, SEEK_SET), 0);
+  void* relocatable = MapRelocatedCorpus(fd, file_size, preload);
+  if (relocatable != nullptr) {
+    VLOG_INFO(1, "Mapped relocated corpus at ", HexStr(AsInt(relocatable)));
+  } else {
+    // Relocation writes to the corpus, so every process gets a private copy
+    // of the pages it touches.
+    relocatable = mmap(nullptr, file_size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | (preload ? MAP_POPULATE : 0), fd, 0);
+    CHECK_NE(relocatable, MAP_FAILED);
+    VLOG_INFO(1, "Mapped corpus at ", HexStr(AsInt(relocatable)));
+  }
   auto mapped = MakeMmappedMemoryPtr<char>(reinterpret_cast<char*>(relocatable),
                                            file_size);
 
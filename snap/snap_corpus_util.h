@@ -24,6 +24,10 @@
 namespace silifuzz {
 
 // Loads relocatable Snap corpus from `filename`. CHECK-fails on any error.
+// A corpus already relocated for a load address (see
+// SnapCorpusHeader::load_address) is mapped shared and read-only at that
+// address if it is free, so that processes loading the same file share the
+// corpus. Otherwise the corpus is mapped privately and relocated.
 // When `preload` is true, preloads the file into memory using MAP_POPULATE
 // except for files in /proc and /dev/shm.
 // When `corpus_fd` is not NULL, passes ownership of the corpus FD to the caller
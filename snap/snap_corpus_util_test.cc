@@ -14,7 +14,10 @@
 
 #include "./snap/snap_corpus_util.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -58,6 +61,53 @@ TEST(SnapCorpusUtilTest, LoadCorpusFromFile) {
   EXPECT_EQ(loaded_corpus->snaps.at(0)->id, snapified_corpus[0].id());
 }
 
+TEST(SnapCorpusUtilTest, LoadRelocatedCorpus) {
+  std::vector<Snapshot> snapified_corpus;
+  {
+    Snapshot snapshot =
+        MakeSnapRunnerTestSnapshot<Host>(TestSnapshot::kEndsAsExpected);
+    SnapifyOptions opts =
+        SnapifyOptions::V2InputRunOpts(snapshot.architecture_id());
+    ASSERT_OK_AND_ASSIGN(Snapshot snapified, Snapify(snapshot, opts));
+    snapified_corpus.emplace_back(std::move(snapified));
+  }
+  MmappedMemoryPtr<char> buffer =
+      GenerateRelocatableSnaps(Host::architecture_id, snapified_corpus);
+  const size_t size = MmappedMemorySize(buffer);
+  auto tmpfile = CreateTempFile(
+      UnitTest::GetInstance()->current_test_info()->test_case_name());
+  ASSERT_TRUE(SetContents(*tmpfile, {buffer.get(), size}));
+
+  // Save a copy of the corpus relocated for where it was loaded. The header
+  // changed, so the checksum is not verified below.
+  uintptr_t load_address;
+  std::string relocated;
+  {
+    auto loaded_corpus = LoadCorpusFromFile<Host>(tmpfile->c_str());
+    load_address = reinterpret_cast<uintptr_t>(loaded_corpus.get());
+    EXPECT_EQ(loaded_corpus->header.load_address, load_address);
+    relocated.assign(reinterpret_cast<const char*>(loaded_corpus.get()), size);
+  }
+  ASSERT_TRUE(SetContents(*tmpfile, relocated));
+
+  // The address is free again, so the corpus is mapped there as is.
+  auto shared_corpus = LoadCorpusFromFile<Host>(tmpfile->c_str(), false,
+                                                /*verify=*/false);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(shared_corpus.get()), load_address);
+  ASSERT_EQ(shared_corpus->snaps.size, 1);
+  EXPECT_EQ(shared_corpus->snaps.at(0)->id, snapified_corpus[0].id());
+
+  // The address is taken now, so the corpus is relocated.
+  auto relocated_corpus = LoadCorpusFromFile<Host>(tmpfile->c_str(), false,
+                                                   /*verify=*/false);
+  EXPECT_NE(reinterpret_cast<uintptr_t>(relocated_corpus.get()),
+            load_address);
+  EXPECT_EQ(relocated_corpus->header.load_address,
+            reinterpret_cast<uintptr_t>(relocated_corpus.get()));
+  ASSERT_EQ(relocated_corpus->snaps.size, 1);
+  EXPECT_EQ(relocated_corpus->snaps.at(0)->id, snapified_corpus[0].id());
+}
+
 TEST(SnapCorpusUtilTest, LoadEmptyCorpus) {
   std::vector<Snapshot> snapified_corpus;
   MmappedMemoryPtr<char> buffer =
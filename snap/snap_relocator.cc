@@ -25,6 +25,7 @@
 #include "./util/itoa.h"
 #include "./util/misc_util.h"  // IWYU pragma: keep
 #include "./util/mmapped_memory_ptr.h"
+#include "./util/page_util.h"
 
 namespace silifuzz {
 
@@ -118,15 +119,19 @@ template <typename T>
 SnapRelocatorError SnapRelocator<Arch>::AdjustPointer(T*& ptr) {
   // A pointer in a relocatable Snap corpus offset is just offset from the
   // start of the corpus. The actual run time address of the pointed object
-  // is recovered by simply adding the start address of the corpus.
-  uintptr_t adjusted_address;
-  if (__builtin_add_overflow(start_address_, reinterpret_cast<uintptr_t>(ptr),
-                             &adjusted_address)) {
+  // is recovered by simply adding the start address of the corpus. A corpus
+  // relocated for another load address has that address added already.
+  uintptr_t offset, adjusted_address;
+  if (__builtin_sub_overflow(reinterpret_cast<uintptr_t>(ptr), load_address_,
+                             &offset) ||
+      __builtin_add_overflow(start_address_, offset, &adjusted_address)) {
     return SnapRelocatorError::kOutOfBound;
   }
   RETURN_IF_RELOCATION_FAILED(ValidateRelocatedAddress<T>(adjusted_address));
 
-  ptr = reinterpret_cast<T*>(adjusted_address);
+  if (!validate_only_) {
+    ptr = reinterpret_cast<T*>(adjusted_address);
+  }
   return SnapRelocatorError::kOk;
 }
 
@@ -153,7 +158,9 @@ SnapRelocatorError SnapRelocator<Arch>::AdjustArray(SnapArray<T>& array) {
 
     return SnapRelocatorError::kOk;
   } else {
-    array.elements = nullptr;
+    if (!validate_only_) {
+      array.elements = nullptr;
+    }
     return SnapRelocatorError::kOk;
   }
 }
@@ -162,15 +169,52 @@ template <typename Arch>
 SnapRelocatorError SnapRelocator<Arch>::RelocateMemoryBytesArray(
     SnapArray<SnapMemoryBytes>& memory_bytes_array) {
   RETURN_IF_RELOCATION_FAILED(AdjustArray(memory_bytes_array));
-  for (SnapMemoryBytes& memory_byte : RelocationIterator(memory_bytes_array)) {
+  RelocationIterator iterator(memory_bytes_array);
+  if (iterator.begin() == iterator.end()) {
+    return SnapRelocatorError::kOk;
+  }
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(iterator.begin());
+  const size_t size = iterator.end() - iterator.begin();
+  if (begin < memory_bytes_relocated_limit_) {
+    // Shared with an earlier Snap. Anything else that starts in relocated
+    // territory may contain elements that were never relocated.
+    return IsRelocatedMemoryBytesArray(begin, size)
+               ? SnapRelocatorError::kOk
+               : SnapRelocatorError::kBadData;
+  }
+  for (SnapMemoryBytes& memory_byte : iterator) {
     if (!memory_byte.repeating()) {
       RETURN_IF_RELOCATION_FAILED(
           AdjustPointer(memory_byte.data.byte_values.elements));
     }
   }
+  // Non-empty arrays do not overlap, so they cannot outnumber the capacity.
+  if (num_relocated_arrays_ >= relocated_arrays_capacity_) {
+    return SnapRelocatorError::kBadData;
+  }
+  relocated_arrays_.get()[num_relocated_arrays_++] = {begin, size};
+  memory_bytes_relocated_limit_ = reinterpret_cast<uintptr_t>(iterator.end());
   return SnapRelocatorError::kOk;
 }
 
+template <typename Arch>
+bool SnapRelocator<Arch>::IsRelocatedMemoryBytesArray(uintptr_t begin,
+                                                      size_t size) const {
+  // Binary search for `begin`.
+  const RelocatedArray* arrays = relocated_arrays_.get();
+  size_t low = 0, high = num_relocated_arrays_;
+  while (low < high) {
+    const size_t mid = low + (high - low) / 2;
+    if (arrays[mid].begin < begin) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low < num_relocated_arrays_ && arrays[low].begin == begin &&
+         arrays[low].size == size;
+}
+
 template <typename Arch>
 SnapRelocatorError SnapRelocator<Arch>::RelocateRegisterState(
     typename Snap<Arch>::RegisterState& register_state) {
@@ -179,6 +223,39 @@ SnapRelocatorError SnapRelocator<Arch>::RelocateRegisterState(
   return SnapRelocatorError::kOk;
 }
 
+template <typename Arch>
+SnapRelocatorError SnapRelocator<Arch>::RelocateRegisterDelta(
+    typename Snap<Arch>::RegisterState& register_state) {
+  const SnapRegisterDelta<Arch>* delta =
+      reinterpret_cast<const SnapRegisterDelta<Arch>*>(
+          read_once(register_state.fpregs));
+  RETURN_IF_RELOCATION_FAILED(AdjustPointer(delta));
+  if (!validate_only_) {
+    register_state.fpregs = reinterpret_cast<const FPRegSet<Arch>*>(delta);
+  }
+  SnapRegisterDelta<Arch>& mutable_delta =
+      *const_cast<SnapRegisterDelta<Arch>*>(delta);
+  RETURN_IF_RELOCATION_FAILED(RelocateRegisterSetDelta(mutable_delta.gregs));
+  RETURN_IF_RELOCATION_FAILED(RelocateRegisterSetDelta(mutable_delta.fpregs));
+  return SnapRelocatorError::kOk;
+}
+
+template <typename Arch>
+template <typename RegisterSet>
+SnapRelocatorError SnapRelocator<Arch>::RelocateRegisterSetDelta(
+    SnapRegisterSetDelta<RegisterSet>& delta) {
+  RETURN_IF_RELOCATION_FAILED(AdjustArray(delta.values));
+  // SnapRegisterSetDelta reads one value for each changed word.
+  size_t num_changed = 0;
+  for (uint64_t mask : delta.changed_mask) {
+    num_changed += __builtin_popcountll(mask);
+  }
+  if (num_changed != read_once(delta.values.size)) {
+    return SnapRelocatorError::kBadData;
+  }
+  return SnapRelocatorError::kOk;
+}
+
 template <typename Arch>
 SnapRelocatorError SnapRelocator<Arch>::RelocateCorpus(bool verify) {
   // We know the pointer is in bounds, but check that the struct fits in memory
@@ -234,6 +311,17 @@ SnapRelocatorError SnapRelocator<Arch>::RelocateCorpus(bool verify) {
     return SnapRelocatorError::kBadData;
   }
 
+  // A corpus already relocated for this address, e.g. a shared image mapped
+  // read-only, has nothing to adjust. It is still checked as thoroughly as a
+  // corpus being relocated, since the memory holding it is not sealed.
+  load_address_ = read_once(corpus.header.load_address);
+  validate_only_ = load_address_ == start_address_;
+
+  relocated_arrays_capacity_ =
+      corpus.header.num_bytes / sizeof(SnapMemoryBytes) + 1;
+  relocated_arrays_ = AllocateMmappedBuffer<RelocatedArray>(
+      relocated_arrays_capacity_ * sizeof(RelocatedArray));
+
   RETURN_IF_RELOCATION_FAILED(AdjustArray(corpus.snaps));
   for (const Snap<Arch>*& snap_ptr : RelocationIterator(corpus.snaps)) {
     // Adjust the pointer in the array.
@@ -253,13 +341,33 @@ SnapRelocatorError SnapRelocator<Arch>::RelocateCorpus(bool verify) {
 
     // Adjust register pointers.
     RETURN_IF_RELOCATION_FAILED(RelocateRegisterState(snap.registers));
-    RETURN_IF_RELOCATION_FAILED(
-        RelocateRegisterState(snap.end_state_registers));
+    if (read_once(snap.end_state_registers.gregs) == nullptr) {
+      RETURN_IF_RELOCATION_FAILED(
+          RelocateRegisterDelta(snap.end_state_registers));
+    } else {
+      RETURN_IF_RELOCATION_FAILED(
+          RelocateRegisterState(snap.end_state_registers));
+    }
 
     // Adjust memory bytes for end state.
     RETURN_IF_RELOCATION_FAILED(
         RelocateMemoryBytesArray(snap.end_state_memory_bytes));
   }
+
+  RETURN_IF_RELOCATION_FAILED(AdjustArray(corpus.mapping_plan));
+  const uint64_t num_bytes = corpus.header.num_bytes;
+  for (const SnapCorpusMapping& entry :
+       RelocationIterator(corpus.mapping_plan)) {
+    // The runner maps the data of direct mapped entries from the corpus file.
+    if (entry.direct_mapped() &&
+        (!IsPageAligned(entry.file_offset) || entry.file_offset > num_bytes ||
+         entry.num_bytes > num_bytes - entry.file_offset)) {
+      return SnapRelocatorError::kBadData;
+    }
+  }
+  if (!validate_only_) {
+    corpus.header.load_address = start_address_;
+  }
   return SnapRelocatorError::kOk;
 }
 
@@ -15,6 +15,7 @@
 #ifndef THIRD_PARTY_SILIFUZZ_SNAP_SNAP_RELOCATOR_H_
 #define THIRD_PARTY_SILIFUZZ_SNAP_SNAP_RELOCATOR_H_
 
+#include <cstddef>
 #include <cstdint>
 
 #include "./snap/snap.h"
@@ -33,14 +34,18 @@ enum class [[nodiscard]] SnapRelocatorError {
   kBadChecksum,  // Corpus checksum is incorrect.
 };
 
-// SnapRelocator relocates a relocatable Snap corpus loaded at an address
-// different from the nominal load address of 0. Relocation involves adding
-// the start address of the Snap corpus to every pointer inside the corpus.
+// SnapRelocator relocates a Snap corpus loaded at an address different from
+// its nominal load address, SnapCorpusHeader::load_address. That is 0 for a
+// relocatable corpus. Relocation involves adding the difference between the
+// start address of the Snap corpus and its load address to every pointer
+// inside the corpus and updating the load address in the header. A corpus
+// loaded at its load address needs no relocation and is only validated.
 template <typename Arch>
 class SnapRelocator {
  public:
-  // Relocates a relocatable Snap corpus pointed by `relocatable` and then
-  // mprotect the memory to be read-only.
+  // Relocates a Snap corpus pointed by `relocatable` and then mprotect the
+  // memory to be read-only. The memory is not written if the corpus is
+  // already relocated for its current address, so it may be mapped read-only.
   // Performs additional integrity checks if `verify` is set.
   // RETURNS: A mmapped memory pointer to the relocated corpus and an error
   // code indicating if relocation succeeded. If relocation failed, the return
@@ -70,9 +75,10 @@ class SnapRelocator {
   template <typename T>
   SnapRelocatorError ValidateRelocatedAddress(uintptr_t address);
 
-  // Adjusts a relocatable pointer in place. This adds the start address
-  // of the relocatable corpus to a pointer, which is a relative
-  // offset from the start address to the address of the pointed object.
+  // Adjusts a relocatable pointer in place. This replaces the load address
+  // of the corpus in a pointer with the start address, so that the relative
+  // offset from the start address to the address of the pointed object is
+  // preserved.
   // This also checks that the relocated pointer is still within the
   // relocatable corpus and is properly aligned for type T.
   //
@@ -90,7 +96,10 @@ class SnapRelocator {
   template <typename T>
   SnapRelocatorError AdjustArray(SnapArray<T>& array);
 
-  // Relocates a SnapArray<SnapMemoryBytes>.
+  // Relocates a SnapArray<SnapMemoryBytes>. The generator shares identical
+  // arrays between Snaps. An array that starts below the end of the last
+  // relocated array must be exactly one of the arrays relocated before and
+  // is left alone.
   //
   // RETURNS: whether relocation succeeded. If it failed, contents of
   // `memory_byte_array` are undefined.
@@ -104,6 +113,23 @@ class SnapRelocator {
   SnapRelocatorError RelocateRegisterState(
       typename Snap<Arch>::RegisterState& register_state);
 
+  // Relocates a RegisterState that holds a SnapRegisterDelta. See
+  // Snap::end_state_registers.
+  //
+  // RETURNS: whether relocation succeeded. If it failed, contents of
+  // `register_state` are undefined.
+  SnapRelocatorError RelocateRegisterDelta(
+      typename Snap<Arch>::RegisterState& register_state);
+
+  // Relocates the arrays of a SnapRegisterSetDelta and checks that the
+  // number of values matches the changed mask.
+  //
+  // RETURNS: whether relocation succeeded. If it failed, contents of `delta`
+  // are undefined.
+  template <typename RegisterSet>
+  SnapRelocatorError RelocateRegisterSetDelta(
+      SnapRegisterSetDelta<RegisterSet>& delta);
+
   // Relocates corpus by adjusting all pointers inside the corpus.
   // If `verify` is true, calculate and verify the corpus checksum before
   // relocation.
@@ -117,6 +143,34 @@ class SnapRelocator {
 
   // Address after the last byte of the corpus.
   uintptr_t limit_address_;
+
+  // The load address in the corpus header before relocation. Pointers in the
+  // corpus are relative to this.
+  uintptr_t load_address_ = 0;
+
+  // If true, the corpus is already relocated for its current address and
+  // possibly mapped read-only. Pointers and arrays are only validated, the
+  // corpus is never written.
+  bool validate_only_ = false;
+
+  // Address after the last byte of the last SnapMemoryBytes array whose
+  // elements were relocated. Arrays are laid out in relocation order.
+  uintptr_t memory_bytes_relocated_limit_ = 0;
+
+  // A SnapMemoryBytes array whose elements were relocated.
+  struct RelocatedArray {
+    uintptr_t begin;
+    size_t size;
+  };
+
+  // Tells if [begin, begin + size) is exactly one of the relocated arrays.
+  bool IsRelocatedMemoryBytesArray(uintptr_t begin, size_t size) const;
+
+  // All relocated SnapMemoryBytes arrays in relocation order, which is also
+  // address order. Room for as many non-empty arrays as fit into the corpus.
+  MmappedMemoryPtr<RelocatedArray> relocated_arrays_;
+  size_t relocated_arrays_capacity_ = 0;
+  size_t num_relocated_arrays_ = 0;
 };
 
 }  // namespace silifuzz
@@ -14,6 +14,9 @@
 
 #include "./snap/snap_relocator.h"
 
+#include <sys/mman.h>
+
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <limits>
@@ -37,7 +40,8 @@ namespace silifuzz {
 namespace {
 
 template <typename Arch>
-absl::StatusOr<MmappedMemoryPtr<char>> GetTestRelocatableCorpus() {
+absl::StatusOr<MmappedMemoryPtr<char>> GetTestRelocatableCorpus(
+    const RelocatableSnapGeneratorOptions& options = {}) {
   // Generate relocatable snaps from runner test snaps.
   Snapshot snapshot =
       MakeSnapRunnerTestSnapshot<Arch>(TestSnapshot::kEndsAsExpected);
@@ -50,8 +54,8 @@ absl::StatusOr<MmappedMemoryPtr<char>> GetTestRelocatableCorpus() {
   std::vector<Snapshot> snapified_corpus;
   snapified_corpus.emplace_back(std::move(snapified_or.value()));
 
-  MmappedMemoryPtr<char> buffer =
-      GenerateRelocatableSnaps(Arch::architecture_id, snapified_corpus);
+  MmappedMemoryPtr<char> buffer = GenerateRelocatableSnaps(
+      Arch::architecture_id, snapified_corpus, options);
   return buffer;
 }
 
@@ -72,6 +76,34 @@ class SnapRelocatorTest : public ::testing::Test {
     EXPECT_EQ(error, expected_error);
   }
 
+  // Relocates the corpus for its current address, after which relocating it
+  // again only validates it. The corpus stays writable for tests to modify.
+  void RelocateInPlace() {
+    const size_t size = MmappedMemorySize(relocatable_);
+    SnapRelocatorError error;
+    MmappedMemoryPtr<const SnapCorpus<Arch>> relocated =
+        SnapRelocator<Arch>::RelocateCorpus(std::move(relocatable_), false,
+                                            &error);
+    ASSERT_EQ(error, SnapRelocatorError::kOk);
+    char* start = reinterpret_cast<char*>(
+        const_cast<SnapCorpus<Arch>*>(relocated.release()));
+    ASSERT_EQ(mprotect(start, size, PROT_READ | PROT_WRITE), 0);
+    relocatable_ = MakeMmappedMemoryPtr(start, size);
+    corpus_ = reinterpret_cast<SnapCorpus<Arch>*>(start);
+  }
+
+  // Returns the object at `offset` in the relocatable corpus.
+  template <typename T>
+  T* AtOffset(const T* offset) {
+    return const_cast<T*>(reinterpret_cast<const T*>(
+        relocatable_.get() + reinterpret_cast<uintptr_t>(offset)));
+  }
+
+  // Returns the first Snap in the relocatable corpus.
+  Snap<Arch>* FirstSnap() {
+    return AtOffset(*AtOffset(corpus_->snaps.elements));
+  }
+
   MmappedMemoryPtr<char> relocatable_;  // A relocatable corpus for testing.
   SnapCorpus<Arch>* corpus_;  // relocatable_ cast as a SnapCorpus pointer.
 };
@@ -122,6 +154,87 @@ TYPED_TEST(SnapRelocatorTest, ArrayElementAddressOverflow) {
   this->ExpectRelocationResultIs(SnapRelocatorError::kOutOfBound);
 }
 
+TYPED_TEST(SnapRelocatorTest, RegisterDeltaSizeMismatch) {
+  ASSERT_OK_AND_ASSIGN(this->relocatable_,
+                       GetTestRelocatableCorpus<TypeParam>(
+                           {.delta_encode_end_state_registers = true}));
+  // Pointers in a relocatable corpus are offsets from its start.
+  char* const start = this->relocatable_.get();
+  auto* corpus = reinterpret_cast<SnapCorpus<TypeParam>*>(start);
+  const uintptr_t snap_offset = *reinterpret_cast<const uintptr_t*>(
+      start + reinterpret_cast<uintptr_t>(corpus->snaps.elements));
+  auto* snap = reinterpret_cast<Snap<TypeParam>*>(start + snap_offset);
+  // The delta is stored in place of the fpregs pointer.
+  ASSERT_EQ(snap->end_state_registers.gregs, nullptr);
+  auto* delta = reinterpret_cast<SnapRegisterDelta<TypeParam>*>(
+      start + reinterpret_cast<uintptr_t>(snap->end_state_registers.fpregs));
+  // Flipping a bit of the changed mask makes it disagree with the number of
+  // values.
+  delta->gregs.changed_mask[0] ^= 1;
+  this->ExpectRelocationResultIs(SnapRelocatorError::kBadData);
+}
+
+TYPED_TEST(SnapRelocatorTest, AlreadyRelocatedCorpusIsNotWritten) {
+  this->RelocateInPlace();
+  ASSERT_EQ(this->corpus_->header.load_address,
+            reinterpret_cast<uintptr_t>(this->corpus_));
+  // Any write to the corpus would crash the test.
+  ASSERT_EQ(mprotect(this->relocatable_.get(),
+                     MmappedMemorySize(this->relocatable_), PROT_READ),
+            0);
+  this->ExpectRelocationResultIs(SnapRelocatorError::kOk);
+}
+
+TYPED_TEST(SnapRelocatorTest, AlreadyRelocatedCorpusIsValidated) {
+  this->RelocateInPlace();
+  // This pushes the last element out of the mmapped area.
+  this->corpus_->snaps.size = MmappedMemorySize(this->relocatable_);
+  this->ExpectRelocationResultIs(SnapRelocatorError::kOutOfBound);
+}
+
+TYPED_TEST(SnapRelocatorTest, AlreadyRelocatedMappingPlanIsValidated) {
+  this->RelocateInPlace();
+  ASSERT_GT(this->corpus_->mapping_plan.size, 0);
+  auto* plan =
+      const_cast<SnapCorpusMapping*>(this->corpus_->mapping_plan.elements);
+  // A direct mapped range reaching past the end of the corpus file.
+  plan[0].flags |= SnapCorpusMapping::kDirectMapped;
+  plan[0].file_offset = 0;
+  plan[0].num_bytes = MmappedMemorySize(this->relocatable_) + 1;
+  this->ExpectRelocationResultIs(SnapRelocatorError::kBadData);
+}
+
+TYPED_TEST(SnapRelocatorTest, SharedMemoryBytesArray) {
+  Snap<TypeParam>* snap = this->FirstSnap();
+  const SnapMemoryMapping* mappings =
+      this->AtOffset(snap->memory_mappings.elements);
+  ASSERT_EQ(snap->memory_mappings.size, 2);
+  // An array shared with an earlier one is relocated only once.
+  snap->end_state_memory_bytes = mappings[1].memory_bytes;
+  this->ExpectRelocationResultIs(SnapRelocatorError::kOk);
+}
+
+TYPED_TEST(SnapRelocatorTest, OverlappingMemoryBytesArray) {
+  Snap<TypeParam>* snap = this->FirstSnap();
+  const SnapMemoryMapping* mappings =
+      this->AtOffset(snap->memory_mappings.elements);
+  ASSERT_EQ(snap->memory_mappings.size, 2);
+  // Starts like an earlier array but its last element was never relocated.
+  snap->end_state_memory_bytes.elements = mappings[1].memory_bytes.elements;
+  snap->end_state_memory_bytes.size = mappings[1].memory_bytes.size + 1;
+  this->ExpectRelocationResultIs(SnapRelocatorError::kBadData);
+}
+
+TYPED_TEST(SnapRelocatorTest, OutOfOrderMemoryBytesArray) {
+  Snap<TypeParam>* snap = this->FirstSnap();
+  SnapMemoryMapping* mappings = this->AtOffset(snap->memory_mappings.elements);
+  ASSERT_EQ(snap->memory_mappings.size, 2);
+  // Relocating the last array first leaves the array of the second mapping
+  // below the relocated limit without ever being relocated.
+  mappings[0].memory_bytes = snap->end_state_memory_bytes;
+  this->ExpectRelocationResultIs(SnapRelocatorError::kBadData);
+}
+
 }  // namespace
 
 }  // namespace silifuzz
@@ -14,7 +14,12 @@
 
 #include "./snap/snap.h"
 
+#include <cstdint>
+#include <cstring>
+
 #include "gtest/gtest.h"
+#include "./util/arch.h"
+#include "./util/ucontext/ucontext_types.h"
 
 namespace silifuzz {
 namespace {
@@ -35,5 +40,62 @@ TEST(Snap, ConstIterator) {
   EXPECT_EQ(i, kNumElements);
 }
 
+TEST(Snap, RegisterSetDelta) {
+  GRegSet<X86_64> base, expected;
+  memset(&base, 0, sizeof(base));
+  expected = base;
+  expected.rax = 1;
+  expected.rip = 0x1234;
+  expected.gs_base = 0x5678;
+
+  // rax, rip and gs_base are words 13, 16 and 21.
+  const uint64_t kValues[] = {1, 0x1234, 0x5678};
+  const SnapRegisterSetDelta<GRegSet<X86_64>> delta = {
+      .changed_mask = {(1ULL << 13) | (1ULL << 16) | (1ULL << 21)},
+      .values = {.size = 3, .elements = kValues},
+  };
+  EXPECT_TRUE(delta.changed(13));
+  EXPECT_FALSE(delta.changed(14));
+
+  GRegSet<X86_64> applied;
+  memset(&applied, 0xff, sizeof(applied));
+  delta.Apply(base, applied);
+  EXPECT_EQ(applied, expected);
+}
+
+TEST(Snap, EndStateRegisters) {
+  UContext<X86_64> registers, end_state;
+  memset(&registers, 0, sizeof(registers));
+  end_state = registers;
+  end_state.gregs.rip = 0x1234;
+  end_state.fpregs.mxcsr = 0x1f80;
+
+  Snap<X86_64> snap = {
+      .registers = UContextView<X86_64>(registers),
+      .end_state_registers = UContextView<X86_64>(end_state),
+  };
+  UContext<X86_64> storage;
+  EXPECT_EQ(EndStateRegistersDelta(snap), nullptr);
+  EXPECT_EQ(EndStateRegisters(snap, storage).gregs, &end_state.gregs);
+
+  // rip is word 16 of the gregs, mxcsr is in word 3 of the fpregs.
+  const uint64_t kGRegValues[] = {0x1234};
+  const uint64_t kFPRegValues[] = {
+      reinterpret_cast<const uint64_t*>(&end_state.fpregs)[3]};
+  const SnapRegisterDelta<X86_64> delta = {
+      .gregs = {.changed_mask = {1ULL << 16},
+                .values = {.size = 1, .elements = kGRegValues}},
+      .fpregs = {.changed_mask = {1ULL << 3},
+                 .values = {.size = 1, .elements = kFPRegValues}},
+  };
+  snap.end_state_registers = UContextView<X86_64>(
+      reinterpret_cast<const FPRegSet<X86_64>*>(&delta), nullptr);
+  EXPECT_EQ(EndStateRegistersDelta(snap), &delta);
+  const UContextView<X86_64> view = EndStateRegisters(snap, storage);
+  EXPECT_EQ(view.gregs, &storage.gregs);
+  EXPECT_EQ(storage.gregs, end_state.gregs);
+  EXPECT_EQ(storage.fpregs, end_state.fpregs);
+}
+
 }  // namespace
 }  // namespace silifuzz
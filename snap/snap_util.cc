@@ -22,6 +22,7 @@
 #include "./snap/snap.h"
 #include "./util/checks.h"
 #include "./util/platform.h"
+#include "./util/ucontext/ucontext_types.h"
 
 namespace silifuzz {
 
@@ -63,10 +64,13 @@ absl::StatusOr<Snapshot> SnapToSnapshot(const Snap<Arch>& snap,
       ConvertRegsToSnapshot(*snap.registers.gregs, *snap.registers.fpregs);
   snapshot.set_registers(rs);
 
+  UContext<Arch> storage;
+  const UContextView<Arch> end_state_registers =
+      EndStateRegisters(snap, storage);
   Snapshot::EndState es(
       Snapshot::Endpoint(snap.end_state_instruction_address),
-      ConvertRegsToSnapshot(*snap.end_state_registers.gregs,
-                            *snap.end_state_registers.fpregs));
+      ConvertRegsToSnapshot(*end_state_registers.gregs,
+                            *end_state_registers.fpregs));
   for (const SnapMemoryBytes& snap_mb : snap.end_state_memory_bytes) {
     Snapshot::ByteData data = SnapMemoryBytesData(snap_mb);
     Snapshot::MemoryBytes mb = {snap_mb.start_address, data};
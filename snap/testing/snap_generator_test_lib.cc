@@ -31,6 +31,7 @@
 #include "./util/reg_checksum.h"
 #include "./util/reg_checksum_util.h"
 #include "./util/ucontext/serialize.h"
+#include "./util/ucontext/ucontext_types.h"
 
 namespace silifuzz {
 namespace {
@@ -177,8 +178,9 @@ void VerifyTestSnap(const Snapshot& snapshot, const Snap<Arch>& snap,
   VerifySnapField("end_state_instruction_address",
                   endpoint.instruction_address(),
                   snap.end_state_instruction_address);
+  UContext<Arch> storage;
   VerifySnapRegisterState<Arch>(end_state.registers(),
-                                snap.end_state_registers);
+                                EndStateRegisters(snap, storage));
 
   VerifySnapMemoryBytesArray(
       "memory_bytes", ToBorrowedMemoryBytesList(end_state.memory_bytes()),
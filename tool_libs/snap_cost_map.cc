@@ -0,0 +1,104 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./tool_libs/snap_cost_map.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "./proto/snapshot_execution_result.pb.h"
+
+namespace silifuzz {
+
+double MeanCyclesPerExecution(const proto::SnapProfile& profile) {
+  if (profile.num_executions() == 0) {
+    return 0;
+  }
+  const uint64_t total = profile.prepare_cycles() + profile.execute_cycles() +
+                         profile.verify_cycles();
+  return static_cast<double>(total) / profile.num_executions();
+}
+
+void SnapCostMapBuilder::Add(const proto::RunnerOutput& runner_output) {
+  for (const proto::SnapProfile& snap_profile : runner_output.snap_profile()) {
+    AddSnapProfile(snap_profile);
+  }
+  AddHistogram(runner_output.execution_cycles_log2_histogram());
+}
+
+void SnapCostMapBuilder::Add(const proto::SnapCostMap& cost_map) {
+  for (const proto::SnapProfile& snap_profile : cost_map.snap_profile()) {
+    AddSnapProfile(snap_profile);
+  }
+  AddHistogram(cost_map.execution_cycles_log2_histogram());
+}
+
+void SnapCostMapBuilder::AddSnapProfile(
+    const proto::SnapProfile& snap_profile) {
+  auto [it, inserted] =
+      profiles_.try_emplace(snap_profile.snapshot_id(), snap_profile);
+  if (inserted) {
+    return;
+  }
+  proto::SnapProfile& merged = it->second;
+  merged.set_num_executions(merged.num_executions() +
+                            snap_profile.num_executions());
+  merged.set_prepare_cycles(merged.prepare_cycles() +
+                            snap_profile.prepare_cycles());
+  merged.set_execute_cycles(merged.execute_cycles() +
+                            snap_profile.execute_cycles());
+  merged.set_verify_cycles(merged.verify_cycles() +
+                           snap_profile.verify_cycles());
+  merged.set_max_cycles(
+      std::max(merged.max_cycles(), snap_profile.max_cycles()));
+}
+
+void SnapCostMapBuilder::AddHistogram(
+    const google::protobuf::RepeatedField<uint64_t>& histogram) {
+  if (histogram_.size() < histogram.size()) {
+    histogram_.resize(histogram.size(), 0);
+  }
+  for (int i = 0; i < histogram.size(); ++i) {
+    histogram_[i] += histogram[i];
+  }
+}
+
+proto::SnapCostMap SnapCostMapBuilder::Build() const {
+  std::vector<const proto::SnapProfile*> sorted;
+  sorted.reserve(profiles_.size());
+  for (const auto& [id, snap_profile] : profiles_) {
+    sorted.push_back(&snap_profile);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const proto::SnapProfile* a, const proto::SnapProfile* b) {
+              const double mean_a = MeanCyclesPerExecution(*a);
+              const double mean_b = MeanCyclesPerExecution(*b);
+              if (mean_a != mean_b) {
+                return mean_a > mean_b;
+              }
+              return a->snapshot_id() < b->snapshot_id();
+            });
+
+  proto::SnapCostMap cost_map;
+  for (const proto::SnapProfile* snap_profile : sorted) {
+    *cost_map.add_snap_profile() = *snap_profile;
+  }
+  for (uint64_t count : histogram_) {
+    cost_map.add_execution_cycles_log2_histogram(count);
+  }
+  return cost_map;
+}
+
+}  // namespace silifuzz
@@ -0,0 +1,70 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_SILIFUZZ_TOOL_LIBS_SNAP_COST_MAP_H_
+#define THIRD_PARTY_SILIFUZZ_TOOL_LIBS_SNAP_COST_MAP_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "./proto/snapshot_execution_result.pb.h"
+
+namespace silifuzz {
+
+// Returns the mean cost of a single execution in `profile` or 0 if the
+// snapshot never ran.
+double MeanCyclesPerExecution(const proto::SnapProfile& profile);
+
+// Merges per-snap execution profiles reported by runners in profiling mode
+// into a single per-snap cost map.
+//
+// This class is thread-compatible.
+class SnapCostMapBuilder {
+ public:
+  SnapCostMapBuilder() = default;
+  ~SnapCostMapBuilder() = default;
+
+  // Not copyable (no need).
+  SnapCostMapBuilder(const SnapCostMapBuilder&) = delete;
+  SnapCostMapBuilder& operator=(const SnapCostMapBuilder&) = delete;
+
+  // Accumulates the profile of a single runner.
+  void Add(const proto::RunnerOutput& runner_output);
+
+  // Accumulates a previously merged cost map.
+  void Add(const proto::SnapCostMap& cost_map);
+
+  // Number of distinct snapshots seen so far.
+  size_t size() const { return profiles_.size(); }
+
+  // Returns the merged cost map. Entries are sorted by descending mean cost
+  // per execution, ties are broken by snapshot ID.
+  proto::SnapCostMap Build() const;
+
+ private:
+  void AddSnapProfile(const proto::SnapProfile& snap_profile);
+  void AddHistogram(const google::protobuf::RepeatedField<uint64_t>& histogram);
+
+  // Merged profiles keyed by snapshot ID.
+  absl::flat_hash_map<std::string, proto::SnapProfile> profiles_;
+
+  // Merged log2 histogram of per-execution cost.
+  std::vector<uint64_t> histogram_;
+};
+
+}  // namespace silifuzz
+
+#endif  // THIRD_PARTY_SILIFUZZ_TOOL_LIBS_SNAP_COST_MAP_H_
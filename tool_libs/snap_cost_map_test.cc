@@ -0,0 +1,105 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./tool_libs/snap_cost_map.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "google/protobuf/text_format.h"
+#include "./proto/snapshot_execution_result.pb.h"
+#include "./util/checks.h"
+
+namespace silifuzz {
+namespace {
+
+using ::testing::ElementsAre;
+
+proto::RunnerOutput ParseRunnerOutput(const char* text) {
+  proto::RunnerOutput runner_output;
+  CHECK(google::protobuf::TextFormat::ParseFromString(text, &runner_output));
+  return runner_output;
+}
+
+TEST(SnapCostMap, MeanCyclesPerExecution) {
+  proto::SnapProfile profile;
+  EXPECT_EQ(MeanCyclesPerExecution(profile), 0);
+  profile.set_num_executions(4);
+  profile.set_prepare_cycles(10);
+  profile.set_execute_cycles(20);
+  profile.set_verify_cycles(10);
+  EXPECT_EQ(MeanCyclesPerExecution(profile), 10);
+}
+
+TEST(SnapCostMap, Merge) {
+  SnapCostMapBuilder builder;
+  // This is what the runner prints at exit in profiling mode.
+  builder.Add(ParseRunnerOutput(R"pb(
+    snap_profile {
+      snapshot_id: 'a'
+      num_executions: 2
+      prepare_cycles: 2
+      execute_cycles: 10
+      verify_cycles: 8
+      max_cycles: 12
+    }
+    snap_profile {
+      snapshot_id: 'b'
+      num_executions: 1
+      execute_cycles: 100
+      max_cycles: 100
+    }
+    execution_cycles_log2_histogram: 0
+    execution_cycles_log2_histogram: 1
+    execution_cycles_log2_histogram: 2
+    execution_result { code: OK }
+  )pb"));
+  builder.Add(ParseRunnerOutput(R"pb(
+    snap_profile {
+      snapshot_id: 'a'
+      num_executions: 1
+      prepare_cycles: 1
+      execute_cycles: 30
+      verify_cycles: 9
+      max_cycles: 40
+    }
+    execution_cycles_log2_histogram: 1
+  )pb"));
+  EXPECT_EQ(builder.size(), 2);
+
+  proto::SnapCostMap cost_map = builder.Build();
+  ASSERT_EQ(cost_map.snap_profile_size(), 2);
+  // 'b' is more expensive per execution and comes first.
+  EXPECT_EQ(cost_map.snap_profile(0).snapshot_id(), "b");
+  const proto::SnapProfile& a = cost_map.snap_profile(1);
+  EXPECT_EQ(a.snapshot_id(), "a");
+  EXPECT_EQ(a.num_executions(), 3);
+  EXPECT_EQ(a.prepare_cycles(), 3);
+  EXPECT_EQ(a.execute_cycles(), 40);
+  EXPECT_EQ(a.verify_cycles(), 17);
+  EXPECT_EQ(a.max_cycles(), 40);
+  EXPECT_THAT(cost_map.execution_cycles_log2_histogram(), ElementsAre(1, 1, 2));
+
+  // Merging a merged map with itself doubles the counts.
+  SnapCostMapBuilder builder2;
+  builder2.Add(cost_map);
+  builder2.Add(cost_map);
+  proto::SnapCostMap doubled = builder2.Build();
+  ASSERT_EQ(doubled.snap_profile_size(), 2);
+  EXPECT_EQ(doubled.snap_profile(1).num_executions(), 6);
+  EXPECT_EQ(doubled.snap_profile(1).max_cycles(), 40);
+  EXPECT_THAT(doubled.execution_cycles_log2_histogram(), ElementsAre(2, 2, 4));
+}
+
+}  // namespace
+}  // namespace silifuzz
@@ -14,18 +14,95 @@
 
 #include "./tools/fuzz_filter_tool.h"
 
+#include <string>
+#include <vector>
+
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "./runner/make_snapshot.h"
 #include "./runner/runner_provider.h"
+#include "./tracing/unicorn_tracer.h"
+#include "./util/arch.h"
+#include "./util/checks.h"
 
 namespace silifuzz {
 
+namespace {
+
+// Instruction limit for the emulator prefilter. Inputs that execute more
+// instructions are passed on to the making process.
+constexpr size_t kMaxEmulatedInstructions = 10000;
+
+// Returns an error if the emulator shows that `raw_insns_bytes` cannot become
+// a snapshot and OK if undecided.
+absl::Status EmulatorPrefilter(absl::string_view raw_insns_bytes) {
+  UnicornTracer<Host> tracer;
+  // InitSnippet() converts the input with the same InstructionsToSnapshot()
+  // call as MakeRawInstructions(), including the static instruction filter.
+  RETURN_IF_NOT_OK(tracer.InitSnippet(raw_insns_bytes));
+  absl::Status s = tracer.Run(kMaxEmulatedInstructions);
+  if (s.ok()) return absl::OkStatus();
+  switch (tracer.last_emu_error()) {
+    // Unicorn maps exactly the memory the making process is allowed to add to
+    // the snapshot. Any access outside of it or against its permissions
+    // faults natively as well.
+    case UC_ERR_READ_UNMAPPED:
+    case UC_ERR_WRITE_UNMAPPED:
+    case UC_ERR_FETCH_UNMAPPED:
+    case UC_ERR_READ_PROT:
+    case UC_ERR_WRITE_PROT:
+    case UC_ERR_FETCH_PROT:
+      return absl::InvalidArgumentError(
+          absl::StrCat("Emulator prefilter: ", s.message()));
+    default:
+      // Unsupported instructions, timeouts, etc. say nothing definite about
+      // native execution.
+      return absl::OkStatus();
+  }
+}
+
+}  // namespace
+
 // Kept as a separate function so that we can test this exact config.
-absl::Status FilterToolMain(absl::string_view raw_insns_bytes) {
+absl::Status FilterToolMain(absl::string_view raw_insns_bytes,
+                            const FilterToolOptions& options) {
+  if (options.emulator_prefilter) {
+    RETURN_IF_NOT_OK(EmulatorPrefilter(raw_insns_bytes));
+  }
   return MakeRawInstructions(raw_insns_bytes,
                              MakingConfig::Quick(RunnerLocation()))
       .status();
 }
 
+FilterComparison CompareFilters(const std::vector<std::string>& inputs) {
+  FilterComparison comparison;
+  for (const std::string& input : inputs) {
+    absl::Time start = absl::Now();
+    const bool accepted = FilterToolMain(input).ok();
+    const absl::Duration make_time = absl::Now() - start;
+
+    // The prefiltered filter runs the same making process after the
+    // prefilter so there is no need to run it twice.
+    start = absl::Now();
+    const bool prefilter_rejected = !EmulatorPrefilter(input).ok();
+    const absl::Duration prefilter_time = absl::Now() - start;
+    const bool accepted_prefiltered = !prefilter_rejected && accepted;
+
+    ++comparison.num_inputs;
+    comparison.num_accepted += accepted;
+    comparison.num_accepted_prefiltered += accepted_prefiltered;
+    comparison.num_agreed += accepted == accepted_prefiltered;
+    comparison.num_rejected_by_prefilter += prefilter_rejected;
+    comparison.time += make_time;
+    comparison.time_prefiltered += prefilter_time;
+    if (!prefilter_rejected) {
+      comparison.time_prefiltered += make_time;
+    }
+  }
+  return comparison;
+}
+
 }  // namespace silifuzz
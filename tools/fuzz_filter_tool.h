@@ -24,12 +24,53 @@
 #ifndef THIRD_PARTY_SILIFUZZ_TOOLS_FUZZ_FILTER_TOOL_H_
 #define THIRD_PARTY_SILIFUZZ_TOOLS_FUZZ_FILTER_TOOL_H_
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 
 namespace silifuzz {
 
-absl::Status FilterToolMain(absl::string_view raw_insns_bytes);
-}
+struct FilterToolOptions {
+  // Before running the full making process, execute the input in the
+  // in-process Unicorn emulator and reject it right away if it touches
+  // memory outside of what the snapshot can map. The making process would
+  // reject such inputs too but only after starting one or more runner
+  // subprocesses. Everything else falls through to the making process so
+  // the emulator never causes an input to be accepted.
+  bool emulator_prefilter = false;
+};
+
+// Returns OK iff `raw_insns_bytes` can be converted into a Snap-compatible
+// snapshot.
+absl::Status FilterToolMain(absl::string_view raw_insns_bytes,
+                            const FilterToolOptions& options = {});
+
+// Result of running the plain and the prefiltered filter over the same inputs.
+struct FilterComparison {
+  int64_t num_inputs = 0;
+
+  // Number of inputs both filters gave the same verdict for.
+  int64_t num_agreed = 0;
+
+  int64_t num_accepted = 0;
+  int64_t num_accepted_prefiltered = 0;
+
+  // Number of inputs rejected before the making process: by the static
+  // instruction filter or by the emulator.
+  int64_t num_rejected_by_prefilter = 0;
+
+  absl::Duration time = absl::ZeroDuration();
+  absl::Duration time_prefiltered = absl::ZeroDuration();
+};
+
+// Runs FilterToolMain() with and without the emulator prefilter on every input
+// and compares the verdicts and the time spent.
+FilterComparison CompareFilters(const std::vector<std::string>& inputs);
+
+}  // namespace silifuzz
 
 #endif  // THIRD_PARTY_SILIFUZZ_TOOLS_FUZZ_FILTER_TOOL_H_
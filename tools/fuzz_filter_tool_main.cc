@@ -17,19 +17,69 @@
 // SiliFuzz Snapshot.
 // The bytes are converted into Snapshot using InstructionsToSnapshot() which
 // is the same as what our fuzzers and the fix pipeline use.
+//
+// With --compare the tool instead reads any number of input files, runs the
+// filter with and without --emulator_prefilter on each of them and prints
+// throughput and agreement of the two.
 
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/time.h"
 #include "./tools/fuzz_filter_tool.h"
 #include "./util/checks.h"
 #include "./util/tool_util.h"
 
+ABSL_FLAG(bool, emulator_prefilter, false,
+          "Reject inputs that access unmappable memory in the Unicorn "
+          "emulator before running the full making process.");
+ABSL_FLAG(bool, compare, false,
+          "Compare the filter with and without --emulator_prefilter on all "
+          "input files.");
+
+namespace silifuzz {
+namespace {
+
+int CompareMain(const std::vector<char*>& files) {
+  std::vector<std::string> inputs;
+  for (const char* file : files) {
+    absl::StatusOr<std::string> bytes = GetFileContents(file);
+    if (!bytes.ok()) {
+      LOG_ERROR(bytes.status().message());
+      return 1;
+    }
+    inputs.push_back(*std::move(bytes));
+  }
+  const FilterComparison c = CompareFilters(inputs);
+  auto rate = [&c](absl::Duration time) {
+    const double seconds = absl::ToDoubleSeconds(time);
+    return seconds > 0 ? c.num_inputs / seconds : 0;
+  };
+  absl::PrintF("inputs: %d\n", c.num_inputs);
+  absl::PrintF("accepted: %d (prefiltered: %d)\n", c.num_accepted,
+               c.num_accepted_prefiltered);
+  absl::PrintF("rejected by prefilter: %d\n", c.num_rejected_by_prefilter);
+  absl::PrintF("agreement: %d/%d\n", c.num_agreed, c.num_inputs);
+  absl::PrintF("inputs/sec: %.2f (prefiltered: %.2f)\n", rate(c.time),
+               rate(c.time_prefiltered));
+  return ToExitCode(c.num_agreed == c.num_inputs);
+}
+
+}  // namespace
+}  // namespace silifuzz
+
 int main(int argc, char** argv) {
   std::vector<char*> non_flag_args = absl::ParseCommandLine(argc, argv);
+  if (absl::GetFlag(FLAGS_compare)) {
+    return silifuzz::CompareMain(
+        std::vector<char*>(non_flag_args.begin() + 1, non_flag_args.end()));
+  }
   if (non_flag_args.size() != 2) {
     LOG_ERROR("Expected exactly 1 input file");
     return 1;
@@ -40,7 +90,9 @@ int main(int argc, char** argv) {
     LOG_ERROR(bytes.status().message());
     return 1;
   }
-  absl::Status s = silifuzz::FilterToolMain(*bytes);
+  absl::Status s = silifuzz::FilterToolMain(
+      *bytes,
+      {.emulator_prefilter = absl::GetFlag(FLAGS_emulator_prefilter)});
   if (!s.ok()) LOG_ERROR(s.message());
   return silifuzz::ToExitCode(s.ok());
 }
@@ -66,6 +66,23 @@ TEST(FuzzFilterTool, Syscall) {
   EXPECT_FILTER_REJECT(GetTestSnippet<Host>(TestSnapshot::kSyscall));
 }
 
+TEST(FuzzFilterTool, EmulatorPrefilter) {
+  std::vector<std::string> inputs = {
+      GetTestSnippet<Host>(TestSnapshot::kEndsAsExpected),
+      GetTestSnippet<Host>(TestSnapshot::kEndsUnexpectedly),
+      GetTestSnippet<Host>(TestSnapshot::kBreakpoint),
+      GetTestSnippet<Host>(TestSnapshot::kSyscall),
+      GetTestSnippet<Host>(TestSnapshot::kSigSegvRead),
+  };
+  FilterComparison c = CompareFilters(inputs);
+  EXPECT_EQ(c.num_inputs, inputs.size());
+  EXPECT_EQ(c.num_agreed, inputs.size());
+  EXPECT_EQ(c.num_accepted, 1);
+  EXPECT_EQ(c.num_accepted_prefiltered, 1);
+  // At least the wild read is caught without the making process.
+  EXPECT_GE(c.num_rejected_by_prefilter, 1);
+}
+
 #if defined(__x86_64__)
 
 // Mostly to check that FromBytes can produce something that will be accepted.
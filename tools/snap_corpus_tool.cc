@@ -25,8 +25,14 @@
 //  # List all snaps in the corpus
 //  snap_corpus_tool list_snaps <corpus_file>
 //
+//  # Merge profiles printed by runners with --profile into a per-snap cost map
+//  # and write it to cost_map.pb as proto::SnapCostMap
+//  snap_corpus_tool merge_profiles <corpus_file> <cost_map.pb> \
+//    <runner_output>...
+//
 #include <sys/mman.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
 #include <optional>
@@ -40,6 +46,7 @@
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "google/protobuf/text_format.h"
 #include "./common/snapshot.h"
 #include "./common/snapshot_file_util.h"
 #include "./common/snapshot_printer.h"
@@ -49,6 +56,7 @@
 #include "./snap/snap.h"
 #include "./snap/snap_corpus_util.h"
 #include "./snap/snap_util.h"
+#include "./tool_libs/snap_cost_map.h"
 #include "./util/arch.h"
 #include "./util/checks.h"
 #include "./util/enum_flag_types.h"
@@ -57,6 +65,7 @@
 #include "./util/mmapped_memory_ptr.h"
 #include "./util/platform.h"
 #include "./util/proto_util.h"
+#include "./util/tool_util.h"
 
 ABSL_FLAG(silifuzz::PlatformId, target_platform,
           silifuzz::PlatformId::kUndefined,
@@ -171,6 +180,50 @@ absl::Status ToolMainImpl(absl::string_view command,
         result.player_result().Outcome_Name(result.player_result().outcome()),
         " snapshot = ", result.snapshot_id(), " on CPU ", player_result.cpu_id);
     printer.PrintActualEndState(snapshot, *player_result.actual_end_state);
+  } else if (command == "merge_profiles") {
+    if (args.size() < 2) {
+      return absl::InvalidArgumentError("Too few arguments");
+    }
+    absl::string_view output_file = ConsumeArg(args);
+    SnapCostMapBuilder builder;
+    while (!args.empty()) {
+      absl::string_view input_file = ConsumeArg(args);
+      ASSIGN_OR_RETURN_IF_NOT_OK(std::string contents,
+                                 GetFileContents(input_file));
+      proto::RunnerOutput runner_output;
+      if (!google::protobuf::TextFormat::ParseFromString(contents,
+                                                         &runner_output)) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Cannot parse ", input_file, " as proto::RunnerOutput"));
+      }
+      builder.Add(runner_output);
+    }
+    proto::SnapCostMap cost_map = builder.Build();
+
+    size_t num_unknown = 0;
+    for (const proto::SnapProfile& snap_profile : cost_map.snap_profile()) {
+      if (corpus->Find(snap_profile.snapshot_id().c_str()) == nullptr) {
+        lp.Line("Snap ", snap_profile.snapshot_id(), " is not in the corpus");
+        ++num_unknown;
+      }
+    }
+    // Entries are sorted by mean cost, show the most expensive ones.
+    constexpr int kNumTopSnaps = 10;
+    lp.Line("Most expensive snaps (mean / max cycles per execution):");
+    lp.Indent();
+    for (int i = 0; i < std::min(kNumTopSnaps, cost_map.snap_profile_size());
+         ++i) {
+      const proto::SnapProfile& snap_profile = cost_map.snap_profile(i);
+      lp.Line(snap_profile.snapshot_id(), " ",
+              static_cast<uint64_t>(MeanCyclesPerExecution(snap_profile)),
+              " / ", snap_profile.max_cycles(), " (",
+              snap_profile.num_executions(), " executions)");
+    }
+    lp.Unindent();
+    lp.Line("Profiled ", cost_map.snap_profile_size() - num_unknown, " of ",
+            corpus->snaps.size, " snaps");
+    RETURN_IF_NOT_OK(WriteToFile(cost_map, output_file));
+    LOG_INFO("Wrote cost map to ", output_file);
   } else if (command == "list_snaps") {
     for (const Snap<Arch>* snap : corpus->snaps) {
       lp.Line(snap->id);
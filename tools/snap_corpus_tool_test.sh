@@ -49,8 +49,25 @@ function extract_code_address_test() {
   rm -f "${OUTPUT}"
 }
 
+function merge_profiles_test() {
+  PROFILE="$(mktemp)"
+  OUTPUT="$(mktemp)"
+  cat > "${PROFILE}" <<EOF
+snap_profile { snapshot_id: 'kEndsAsExpected' num_executions: 2
+  prepare_cycles: 10 execute_cycles: 100 verify_cycles: 20 max_cycles: 70 }
+execution_cycles_log2_histogram: 0
+execution_cycles_log2_histogram: 2
+execution_result { code: OK }
+EOF
+  "${TOOL}" merge_profiles "${CORPUS}" "${OUTPUT}" "${PROFILE}" \
+    "${PROFILE}" 2>&1 | grep -q 'kEndsAsExpected 65 / 70 (4 executions)' \
+    || die "merge_profiles test failed"
+  rm -f "${PROFILE}" "${OUTPUT}"
+}
+
 snap_corpus_tool_test
 extract_test
 extract_code_address_test
+merge_profiles_test
 
 echo "PASS"
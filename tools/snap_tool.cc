@@ -18,10 +18,18 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
+#include <cstddef>
 #include <cstdint>
+#include <filesystem>  // NOLINT
+#include <functional>
+#include <iterator>
 #include <optional>
 #include <string>
+#include <system_error>  // NOLINT
+#include <thread>        // NOLINT(build/c++11)
 #include <utility>
 #include <vector>
 
@@ -34,7 +42,10 @@
 #include "absl/strings/match.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_replace.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "./common/memory_state.h"
 #include "./common/raw_insns_util.h"
 #include "./common/snapshot.h"
@@ -50,6 +61,7 @@
 #include "./snap/gen/snap_generator.h"
 #include "./util/arch.h"
 #include "./util/checks.h"
+#include "./util/cpu_id.h"
 #include "./util/enum_flag.h"
 #include "./util/enum_flag_types.h"
 #include "./util/file_util.h"
@@ -106,6 +118,17 @@ ABSL_FLAG(bool, endpoints_only, false, "Whether to only print the endpoints.");
 ABSL_FLAG(silifuzz::PlatformId, target_platform,
           silifuzz::PlatformId::kUndefined,
           "Target platform for commands like generate_corpus");
+ABSL_FLAG(bool, delta_end_state_registers, false,
+          "Whether generate_corpus stores the end state registers of each "
+          "snapshot as a delta against its initial registers.");
+
+// Flags that control `make_batch` command:
+ABSL_FLAG(int, parallelism, 0,
+          "Number of snapshots make_batch makes in parallel. If it is 0, "
+          "make_batch uses one worker per available CPU.");
+ABSL_FLAG(bool, pin_cpus, true,
+          "Whether each make_batch worker and the runners it starts are "
+          "pinned to a CPU of their own.");
 
 // ========================================================================= //
 
@@ -192,6 +215,8 @@ absl::Status GenerateCorpus(const std::vector<std::string>& input_protos,
   // TODO(ksteuck): Call PartitionSnapshots() to ensure there are no conflicts.
 
   RelocatableSnapGeneratorOptions options;
+  options.delta_encode_end_state_registers =
+      absl::GetFlag(FLAGS_delta_end_state_registers);
   MmappedMemoryPtr<char> buffer =
       GenerateRelocatableSnaps(arch_id, snapified_corpus, options);
   absl::string_view buf(buffer.get(), MmappedMemorySize(buffer));
@@ -327,6 +352,199 @@ std::string OutputPath(absl::string_view input_path) {
   return std::string(input_path);
 }
 
+// Implements the `make` command for one snapshot. The runners that make,
+// verify and trace it are pinned to `cpu` unless it is kAnyCPUId.
+absl::StatusOr<Snapshot> RemakeSnapshot(Snapshot snapshot, int cpu) {
+  std::optional<uint64_t> code_address = absl::GetFlag(FLAGS_code_address);
+  if (code_address.has_value()) {
+    ASSIGN_OR_RETURN_IF_NOT_OK_PLUS(
+        snapshot,
+        ARCH_DISPATCH(RecreateSnapshotWithCodeAddress,
+                      snapshot.architecture_id(), snapshot,
+                      code_address.value()),
+        "set_code_address: ");
+  }
+  MakingConfig config = MakingConfig::Default(RunnerLocation());
+  config.enforce_fuzzing_config = false;
+  config.cpu = cpu;
+  return MakeSnapshot(snapshot, config);
+}
+
+// Expands `args` of the `make_batch` command into a list of snapshot files.
+// A directory stands for all the regular files in it, in name order.
+absl::StatusOr<std::vector<std::string>> ListBatchInputs(
+    const std::vector<std::string>& args) {
+  namespace fs = std::filesystem;
+  std::vector<std::string> inputs;
+  for (const std::string& arg : args) {
+    std::error_code ec;
+    if (!fs::is_directory(arg, ec)) {
+      inputs.push_back(arg);
+      continue;
+    }
+    fs::directory_iterator dir_iter(arg, ec);
+    if (ec) {
+      return absl::UnknownError(
+          absl::StrCat("Cannot list ", arg, ": ", ec.message()));
+    }
+    std::vector<std::string> dir_inputs;
+    for (const auto& entry : dir_iter) {
+      if (entry.is_regular_file(ec)) {
+        dir_inputs.push_back(entry.path().string());
+      }
+    }
+    std::sort(dir_inputs.begin(), dir_inputs.end());
+    std::move(dir_inputs.begin(), dir_inputs.end(),
+              std::back_inserter(inputs));
+  }
+  return inputs;
+}
+
+// Periodically prints how many of `num_inputs` snapshots `num_processed`
+// says have been made until `stop` is set. Like the progress monitor of the
+// fix tool, the reporting interval doubles up to a limit.
+void MakeBatchProgressMonitor(size_t num_inputs,
+                              const std::atomic<size_t>& num_processed,
+                              const std::atomic<bool>& stop) {
+  LinePrinter line_printer(LinePrinter::StdErrPrinter);
+  absl::Time start = absl::Now();
+  absl::Duration interval = absl::Seconds(1);
+  absl::Time next_checkpoint = start + interval;
+  const absl::Duration kMaxInterval = absl::Minutes(5);
+  while (true) {
+    const bool stop_monitoring = stop.load();
+    // Print progress at checkpoint or exit.
+    if (stop_monitoring || absl::Now() >= next_checkpoint) {
+      line_printer.Line("Make snapshot count: ", num_processed.load(), " of ",
+                        num_inputs, " in ",
+                        absl::FormatDuration(absl::Now() - start));
+      if (stop_monitoring) {
+        break;  // exit progress monitor.
+      } else {
+        next_checkpoint += interval;
+        interval = std::min(interval * 2, kMaxInterval);
+      }
+    }
+    absl::SleepFor(absl::Seconds(1));
+  }
+}
+
+// Implements the `make_batch` command.
+//
+// Makes, verifies and traces each of `inputs` like the `make` command does
+// and writes the made snapshot under the same file name into `output_dir`.
+// Workers take snapshots from a shared queue so that a few slow snapshots do
+// not hold up the rest. Each worker and the runners it starts are pinned to
+// a CPU of their own with --pin_cpus. The status of each input is written to
+// `output_dir`/make_batch_status.tsv as a line of "<input>\t<status>".
+//
+// RETURNS: the number of snapshots that could not be made or an error if the
+// batch could not be processed at all.
+absl::StatusOr<size_t> MakeBatch(const std::vector<std::string>& inputs,
+                                 bool raw, const std::string& output_dir,
+                                 LinePrinter* line_printer) {
+  namespace fs = std::filesystem;
+  if (inputs.empty()) {
+    return absl::InvalidArgumentError("No snapshots to make");
+  }
+  // Inputs from different directories may share a file name.
+  std::vector<std::string> output_paths;
+  output_paths.reserve(inputs.size());
+  for (const std::string& input : inputs) {
+    output_paths.push_back(
+        (fs::path(output_dir) / fs::path(input).filename()).string());
+  }
+  {
+    std::vector<std::string> sorted_paths = output_paths;
+    std::sort(sorted_paths.begin(), sorted_paths.end());
+    auto it = std::adjacent_find(sorted_paths.begin(), sorted_paths.end());
+    if (it != sorted_paths.end()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("More than one input would be written to ", *it));
+    }
+  }
+  std::error_code ec;
+  fs::create_directories(output_dir, ec);
+  if (ec) {
+    return absl::UnknownError(absl::StrCat("Cannot create ", output_dir, ": ",
+                                           ec.message()));
+  }
+
+  std::vector<int> cpus;
+  if (absl::GetFlag(FLAGS_pin_cpus)) {
+    ForEachAvailableCPU([&cpus](int cpu) { cpus.push_back(cpu); });
+  }
+  size_t num_workers = absl::GetFlag(FLAGS_parallelism);
+  if (num_workers == 0) {
+    num_workers = cpus.empty() ? std::thread::hardware_concurrency()
+                               : cpus.size();
+  }
+  num_workers = std::max<size_t>(std::min(num_workers, inputs.size()), 1);
+  line_printer->Line("Making ", inputs.size(), " snapshots with ", num_workers,
+                     " workers");
+
+  // Each worker claims inputs by incrementing `next_input` and only writes
+  // the statuses of the inputs it claimed.
+  std::vector<absl::Status> statuses(inputs.size());
+  std::atomic<size_t> next_input = 0;
+  std::atomic<size_t> num_processed = 0;
+  auto worker = [&](int cpu) {
+    if (cpu != kAnyCPUId && SetCPUAffinity(cpu) != 0) {
+      LOG_ERROR("Cannot pin make_batch worker to CPU ", cpu);
+    }
+    for (size_t i = next_input++; i < inputs.size(); i = next_input++) {
+      absl::StatusOr<Snapshot> made = LoadSnapshot(inputs[i], raw);
+      if (made.ok()) {
+        made = RemakeSnapshot(std::move(made).value(), cpu);
+      }
+      if (made.ok()) {
+        if (absl::GetFlag(FLAGS_normalize)) made->NormalizeAll();
+        statuses[i] = made->IsCompleteSomeState();
+        if (statuses[i].ok()) {
+          statuses[i] = WriteSnapshotToFile(*made, output_paths[i]);
+        }
+      } else {
+        statuses[i] = made.status();
+      }
+      ++num_processed;
+    }
+  };
+
+  std::atomic<bool> stop_progress_monitor = false;
+  std::thread progress_monitor(MakeBatchProgressMonitor, inputs.size(),
+                               std::cref(num_processed),
+                               std::cref(stop_progress_monitor));
+  std::vector<std::thread> workers;
+  workers.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers.emplace_back(worker,
+                         cpus.empty() ? kAnyCPUId : cpus[i % cpus.size()]);
+  }
+  for (std::thread& t : workers) {
+    t.join();
+  }
+  stop_progress_monitor.store(true);
+  progress_monitor.join();
+
+  std::string status_report;
+  size_t num_failed = 0;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    if (!statuses[i].ok()) ++num_failed;
+    absl::StrAppend(&status_report, inputs[i], "\t",
+                    absl::StrReplaceAll(statuses[i].ToString(),
+                                        {{"\t", " "}, {"\n", " "}}),
+                    "\n");
+  }
+  const std::string status_path =
+      (fs::path(output_dir) / "make_batch_status.tsv").string();
+  if (!SetContents(status_path, status_report)) {
+    return absl::InternalError(absl::StrCat("Cannot write ", status_path));
+  }
+  line_printer->Line("Made ", inputs.size() - num_failed, " of ",
+                     inputs.size(), " snapshots, status in ", status_path);
+  return num_failed;
+}
+
 // ========================================================================= //
 
 // Implements main().
@@ -340,8 +558,9 @@ bool SnapToolMain(std::vector<char*>& args) {
   if (args.size() < 2) {
     line_printer.Line(
         "Expected one of "
-        "{print,set_id,set_end,make,play,generate_corpus,get_instructions,"
-        "trace,set_bytes,set_pc} and a snapshot file name(s).");
+        "{print,set_id,set_end,make,make_batch,play,generate_corpus,"
+        "get_instructions,trace,set_bytes,set_pc} and a snapshot file "
+        "name(s).");
     return false;
   } else {
     command = ConsumeArg(args);
@@ -355,6 +574,36 @@ bool SnapToolMain(std::vector<char*>& args) {
     platform_id = CurrentPlatformId();
   }
 
+  if (command == "make_batch") {
+    // Makes many snapshots in one process, e.g.
+    //   snap_tool make_batch --out=made_dir snapshot_dir other.pb
+    // Directory arguments stand for all the files in them.
+    std::optional<std::string> out = absl::GetFlag(FLAGS_out);
+    if (!out.has_value()) {
+      line_printer.Line("make_batch requires --out=<output directory>");
+      return false;
+    }
+    if (absl::GetFlag(FLAGS_dry_run)) {
+      line_printer.Line("make_batch does not support --dry_run");
+      return false;
+    }
+    std::vector<std::string> args_list({snapshot_file});
+    while (!args.empty()) args_list.push_back(ConsumeArg(args));
+    absl::StatusOr<std::vector<std::string>> inputs =
+        ListBatchInputs(args_list);
+    if (!inputs.ok()) {
+      line_printer.Line("make_batch: ", inputs.status().message());
+      return false;
+    }
+    absl::StatusOr<size_t> num_failed =
+        MakeBatch(*inputs, raw, *out, &line_printer);
+    if (!num_failed.ok()) {
+      line_printer.Line("make_batch: ", num_failed.status().message());
+      return false;
+    }
+    return *num_failed == 0;
+  }
+
   // Load the snapshot
   absl::StatusOr<Snapshot> snapshot_or = LoadSnapshot(snapshot_file, raw);
   if (!snapshot_or.ok()) {
@@ -438,20 +687,8 @@ bool SnapToolMain(std::vector<char*>& args) {
   } else if (command == "make") {
     if (ExtraArgs(args)) return false;
 
-    std::optional<uint64_t> code_address = absl::GetFlag(FLAGS_code_address);
-    if (code_address.has_value()) {
-      absl::StatusOr<Snapshot> edited = ARCH_DISPATCH(
-          RecreateSnapshotWithCodeAddress, snapshot.architecture_id(), snapshot,
-          code_address.value());
-      if (!edited.ok()) {
-        line_printer.Line("set_code_address: ", edited.status().ToString());
-        return false;
-      }
-      snapshot = std::move(edited).value();
-    }
-    MakingConfig config = MakingConfig::Default(RunnerLocation());
-    config.enforce_fuzzing_config = false;
-    absl::StatusOr<Snapshot> recorded_snapshot = MakeSnapshot(snapshot, config);
+    absl::StatusOr<Snapshot> recorded_snapshot =
+        RemakeSnapshot(std::move(snapshot), kAnyCPUId);
     if (!recorded_snapshot.ok()) {
       line_printer.Line(recorded_snapshot.status().ToString());
       return false;
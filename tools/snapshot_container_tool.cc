@@ -0,0 +1,148 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A tool to convert between proto::Snapshot files and snapshot containers.
+// See common/snapshot_container.h.
+//
+// Sample usage
+//
+//  # Create container.snapc from snapshot files
+//  snapshot_container_tool pack <container.snapc> <snapshot.pb>...
+//
+//  # Add snapshot files to an existing container
+//  snapshot_container_tool append <container.snapc> <snapshot.pb>...
+//
+//  # Write every snapshot in the container to <output_dir>/<id>.pb
+//  snapshot_container_tool unpack <container.snapc> <output_dir>
+//
+//  # Write the snapshot with id my_snap to output.pb
+//  snapshot_container_tool extract <container.snapc> <my_snap> <output.pb>
+//
+//  # List all snapshots in the container
+//  snapshot_container_tool list <container.snapc>
+//
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/flags/parse.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "./common/snapshot.h"
+#include "./common/snapshot_container.h"
+#include "./common/snapshot_file_util.h"
+#include "./util/checks.h"
+#include "./util/line_printer.h"
+
+namespace silifuzz {
+namespace {
+
+// Consumes pops a single arg from the front of the list and returns it.
+absl::string_view ConsumeArg(std::vector<char*>& args) {
+  CHECK(!args.empty());
+  auto rv = args.front();
+  args.erase(args.begin());
+  return rv;
+}
+
+// Adds the snapshot files in `args` to `writer` and finishes the container.
+absl::Status AddSnapshotFiles(SnapshotContainerWriter writer,
+                              std::vector<char*>& args) {
+  size_t num_added = 0;
+  while (!args.empty()) {
+    absl::string_view input_file = ConsumeArg(args);
+    ASSIGN_OR_RETURN_IF_NOT_OK(Snapshot snapshot,
+                               ReadSnapshotFromFile(input_file));
+    RETURN_IF_NOT_OK_PLUS(writer.Add(snapshot),
+                          absl::StrCat(input_file, ": "));
+    ++num_added;
+  }
+  const size_t size = writer.size();
+  RETURN_IF_NOT_OK(writer.Finish());
+  LOG_INFO("Added ", num_added, " snapshots, ", size, " total");
+  return absl::OkStatus();
+}
+
+absl::Status ToolMain(std::vector<char*>& args) {
+  ConsumeArg(args);  // consume argv[0]
+  if (args.size() < 2) {
+    return absl::InvalidArgumentError("Too few arguments");
+  }
+  std::string command = std::string(ConsumeArg(args));
+  std::string container_file = std::string(ConsumeArg(args));
+
+  LinePrinter lp(LinePrinter::StdErrPrinter);
+
+  if (command == "pack") {
+    ASSIGN_OR_RETURN_IF_NOT_OK(
+        SnapshotContainerWriter writer,
+        SnapshotContainerWriter::Create(container_file));
+    return AddSnapshotFiles(std::move(writer), args);
+  } else if (command == "append") {
+    ASSIGN_OR_RETURN_IF_NOT_OK(
+        SnapshotContainerWriter writer,
+        SnapshotContainerWriter::Append(container_file));
+    return AddSnapshotFiles(std::move(writer), args);
+  }
+
+  ASSIGN_OR_RETURN_IF_NOT_OK(SnapshotContainerReader reader,
+                             SnapshotContainerReader::Open(container_file));
+  if (command == "unpack") {
+    if (args.size() != 1) {
+      return absl::InvalidArgumentError("Expected an output directory");
+    }
+    absl::string_view output_dir = ConsumeArg(args);
+    RETURN_IF_NOT_OK(reader.ForEach([&](Snapshot snapshot) {
+      return WriteSnapshotToFile(
+          snapshot, absl::StrCat(output_dir, "/", snapshot.id(), ".pb"));
+    }));
+    LOG_INFO("Wrote ", reader.size(), " snapshots to ", output_dir);
+  } else if (command == "extract") {
+    if (args.size() != 2) {
+      return absl::InvalidArgumentError("Expected a snapshot id and an output");
+    }
+    absl::string_view snap_id = ConsumeArg(args);
+    ASSIGN_OR_RETURN_IF_NOT_OK(Snapshot snapshot, reader.Read(snap_id));
+    absl::string_view output_file = ConsumeArg(args);
+    RETURN_IF_NOT_OK(WriteSnapshotToFile(snapshot, output_file));
+    LOG_INFO("Wrote snapshot to ", output_file);
+  } else if (command == "list") {
+    for (size_t i = 0; i < reader.size(); ++i) {
+      lp.Line(reader.id(i));
+    }
+    lp.Line("Total ", reader.size());
+  } else {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unknown command ", command));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+}  // namespace silifuzz
+
+int main(int argc, char* argv[]) {
+  std::vector<char*> positional_args = absl::ParseCommandLine(argc, argv);
+
+  absl::Status result = silifuzz::ToolMain(positional_args);
+  if (!result.ok()) {
+    LOG_ERROR(result.message());
+  }
+
+  return result.ok() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
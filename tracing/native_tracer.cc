@@ -88,24 +88,36 @@ void SetFPRegs(const pid_t pid, UserFPRegsStruct& fp_regs) {
 // Enough to store all AVX512 components.
 // Copy from X86_XSTATE_AVX512_SIZE in "gdb/common/x86-xstate.h"
 constexpr size_t kXStateBufferSize = 2688;
-// TODO(herooutman): Currently, we use another ptrace call to get FPRegs. Since
-// XState always contains FPRegs, we can get them from XState and save the
-// redundant ptrace call.
-void GetX86XState(const pid_t pid, RegisterGroupIOBuffer<Host>& eregs) {
+// The XSAVE area starts with the legacy FXSAVE region which has the layout
+// of user_fpregs_struct.
+static_assert(sizeof(UserFPRegsStruct) == 512);
+
+// Fetches the extension registers of the tracee into `eregs`. The same
+// GETREGSET call also returns the FP registers so they are stored in `fp_regs`
+// to save a separate NT_PRFPREG call. Returns false without fetching anything
+// if neither AVX nor AVX512 is enabled. `fp_regs` is not filled in that case.
+bool GetX86XState(const pid_t pid, RegisterGroupIOBuffer<Host>& eregs,
+                  UserFPRegsStruct& fp_regs) {
   eregs.register_groups =
       GetCurrentPlatformRegisterGroups().SetGPR(0).SetFPRAndSSE(0);
   if (!eregs.register_groups.GetAVX512() && !eregs.register_groups.GetAVX()) {
     VLOG_INFO(2,
               "Skipping XState collection because AVX and AVX512 are not "
               "enabled.");
-    return;
+    return false;
   }
   alignas(64) uint8_t host_xstate[kXStateBufferSize] = {};
   alignas(64) uint8_t tracee_xstate[kXStateBufferSize] = {};
 
   struct iovec io = {tracee_xstate, kXStateBufferSize};
   PTraceOrDie(PTRACE_GETREGSET, pid, (void*)NT_X86_XSTATE, &io);
+  CHECK_GE(io.iov_len, sizeof(fp_regs));
+  memcpy(&fp_regs, tracee_xstate, sizeof(fp_regs));
+  // In XSAVE format the kernel fills the tail of the legacy region with
+  // software-defined bytes that NT_PRFPREG does not report.
+  memset(fp_regs.padding, 0, sizeof(fp_regs.padding));
   SaveX86XState(tracee_xstate, host_xstate, eregs);
+  return true;
 }
 #endif
 
@@ -276,6 +288,7 @@ absl::Status NativeTracer::Run(size_t max_insn_executed) {
           return NextContinuationMode();
 
         uint64_t addr = GetIPFromUserRegs(regs);
+        InvalidateRegisterCache();
         gregs_cache_.emplace(regs);
         if (state_ == TracerState::kPreTracing) {
           if (addr == code_start_address_) {
@@ -383,31 +396,51 @@ void NativeTracer::SetRegisters(const UContext<Host>& ucontext) {
   // Ptrace may silently discard some bits of the register state.  If this
   // happens, the subsequent GetRegisters() call will return different data.
   // Reset the cache to force a refetch.
-  gregs_cache_.reset();
+  InvalidateRegisterCache();
 }
 
 void NativeTracer::GetRegisters(UContext<Host>& ucontext,
                                 RegisterGroupIOBuffer<Host>* eregs) {
+  // Fetch the extension registers first: on x86 the same call also yields the
+  // FP registers.
+  if (eregs != nullptr && !eregs_cache_.has_value()) {
+    eregs_cache_.emplace();
+    memset(&eregs_cache_.value(), 0, sizeof(eregs_cache_.value()));
+#if defined(__x86_64__)
+    UserFPRegsStruct fp_regs;
+    if (GetX86XState(pid_, *eregs_cache_, fp_regs) &&
+        !fpregs_cache_.has_value()) {
+      fpregs_cache_.emplace();
+      DeserializeUserFPRegsStruct(fp_regs, &fpregs_cache_.value());
+    }
+#elif defined(__aarch64__)
+    GetSVE(pid_, *eregs_cache_);
+#endif
+  }
+
   const user_regs_struct& regs = GetGRegStruct();
   // Not all registers will be read. memset so the result is consistent.
   memset(&ucontext, 0, sizeof(ucontext));
   DeserializeUserRegsStruct(regs, &ucontext.gregs);
 #if defined(__aarch64__)
-  GetTLSRegs(pid_, &ucontext.gregs.tpidr);
+  if (!tpidr_cache_.has_value()) {
+    tpidr_cache_.emplace(0);
+    GetTLSRegs(pid_, &tpidr_cache_.value());
+  }
+  ucontext.gregs.tpidr = *tpidr_cache_;
   // tpidrro is not easily accessible using ptrace.
 #endif
 
-  UserFPRegsStruct fp_regs;
-  GetFPRegs(pid_, fp_regs);
-  DeserializeUserFPRegsStruct(fp_regs, &ucontext.fpregs);
+  if (!fpregs_cache_.has_value()) {
+    UserFPRegsStruct fp_regs;
+    GetFPRegs(pid_, fp_regs);
+    fpregs_cache_.emplace();
+    DeserializeUserFPRegsStruct(fp_regs, &fpregs_cache_.value());
+  }
+  ucontext.fpregs = *fpregs_cache_;
 
   if (eregs != nullptr) {
-    memset(eregs, 0, sizeof(*eregs));
-#if defined(__x86_64__)
-    GetX86XState(pid_, *eregs);
-#elif defined(__aarch64__)
-    GetSVE(pid_, *eregs);
-#endif
+    *eregs = *eregs_cache_;
   }
 }
 
@@ -460,6 +493,15 @@ uint32_t NativeTracer::PartialChecksumOfMutableMemory() {
   return static_cast<uint32_t>(checksum);
 }
 
+void NativeTracer::InvalidateRegisterCache() {
+  gregs_cache_.reset();
+  fpregs_cache_.reset();
+  eregs_cache_.reset();
+#if defined(__aarch64__)
+  tpidr_cache_.reset();
+#endif
+}
+
 const user_regs_struct& NativeTracer::GetGRegStruct() {
   if (!gregs_cache_.has_value()) {
     gregs_cache_.emplace(user_regs_struct{});
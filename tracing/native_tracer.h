@@ -91,10 +91,22 @@ class NativeTracer final : public Tracer<Host> {
   // kernel using ptrace.
   const user_regs_struct& GetGRegStruct();
 
+  // Drops all cached register state. Must be called whenever the tracee
+  // advances or its registers are overwritten.
+  void InvalidateRegisterCache();
+
   TracerState state_ = TracerState::kInit;
   std::unique_ptr<Snapshot> snapshot_ = nullptr;
   // Cache the gregs provided by HarnessTracer.
   std::optional<user_regs_struct> gregs_cache_ = std::nullopt;
+  // Register groups of the current stop fetched lazily by GetRegisters(). Each
+  // group costs a ptrace call so only the ones the caller asks for are
+  // fetched, at most once per stop.
+  std::optional<FPRegSet<Host>> fpregs_cache_ = std::nullopt;
+  std::optional<RegisterGroupIOBuffer<Host>> eregs_cache_ = std::nullopt;
+#if defined(__aarch64__)
+  std::optional<uint64_t> tpidr_cache_ = std::nullopt;
+#endif
   pid_t pid_ = 0;  // pid of the tracee
   bool stop_requested_ = false;
   bool insn_limit_reached_ = false;
@@ -0,0 +1,100 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the number of instructions per second the native tracer can step
+// through depending on how much register state the per-instruction callback
+// asks for.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "./tracing/native_tracer.h"
+#include "./tracing/tracer.h"
+#include "./util/arch.h"
+#include "./util/reg_group_io.h"
+#include "./util/ucontext/ucontext_types.h"
+
+namespace silifuzz {
+namespace {
+
+// Returns a snippet of `n` NOPs.
+std::string Nops(size_t n) {
+#if defined(__x86_64__)
+  return std::string(n, '\x90');
+#elif defined(__aarch64__)
+  std::string nops;
+  for (size_t i = 0; i < n; ++i) {
+    nops.append("\x1f\x20\x03\xd5", 4);
+  }
+  return nops;
+#endif
+}
+
+enum class RegisterFetch {
+  kNone,              // Only the instruction pointer.
+  kRegisters,         // GetRegisters() without extension registers.
+  kExtendedRegisters  // GetRegisters() with extension registers.
+};
+
+void TraceNops(benchmark::State& state, RegisterFetch fetch) {
+  const size_t num_insns = state.range(0);
+  const std::string instructions = Nops(num_insns);
+  UContext<Host> ucontext;
+  RegisterGroupIOBuffer<Host> eregs;
+  uint64_t sink = 0;
+  size_t traced = 0;
+  for (auto s : state) {
+    NativeTracer tracer;
+    CHECK_OK(tracer.InitSnippet(instructions));
+    tracer.SetBeforeInstructionCallback([&](TracerControl<Host>& control) {
+      ++traced;
+      switch (fetch) {
+        case RegisterFetch::kNone:
+          sink += control.GetInstructionPointer();
+          break;
+        case RegisterFetch::kRegisters:
+          control.GetRegisters(ucontext);
+          break;
+        case RegisterFetch::kExtendedRegisters:
+          control.GetRegisters(ucontext, &eregs);
+          break;
+      }
+    });
+    CHECK_OK(tracer.Run(num_insns));
+  }
+  benchmark::DoNotOptimize(sink);
+  state.SetItemsProcessed(traced);
+}
+
+void BM_TraceInstructionPointer(benchmark::State& state) {
+  TraceNops(state, RegisterFetch::kNone);
+}
+
+void BM_TraceRegisters(benchmark::State& state) {
+  TraceNops(state, RegisterFetch::kRegisters);
+}
+
+void BM_TraceExtendedRegisters(benchmark::State& state) {
+  TraceNops(state, RegisterFetch::kExtendedRegisters);
+}
+
+BENCHMARK(BM_TraceInstructionPointer)->Arg(100)->Arg(1000);
+BENCHMARK(BM_TraceRegisters)->Arg(100)->Arg(1000);
+BENCHMARK(BM_TraceExtendedRegisters)->Arg(100)->Arg(1000);
+
+}  // namespace
+}  // namespace silifuzz
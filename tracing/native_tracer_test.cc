@@ -198,6 +198,37 @@ TEST(NativeTracerTest, SetGetRegisters) {
 }
 
 #if defined(__x86_64__)
+// FP registers are taken from XSTATE when extension registers are requested.
+// They must match what a plain GetRegisters() call reports.
+TEST(NativeTracerTest, FPRegistersWithExtensionRegisters) {
+  std::string instructions =
+      GetTestSnippet<Host>(TestSnapshot::kSetThreeRegisters);
+  auto get_fpregs = [&](bool with_eregs) {
+    NativeTracer tracer;
+    CHECK_OK(tracer.InitSnippet(instructions));
+    UContext<Host> ucontext;
+    RegisterGroupIOBuffer<Host> eregs;
+    tracer.SetAfterExecutionCallback([&](TracerControl<Host>& control) {
+      control.GetRegisters(ucontext, with_eregs ? &eregs : nullptr);
+    });
+    CHECK_OK(tracer.Run(99));
+    return ucontext.fpregs;
+  };
+  const FPRegSet<Host> expected = get_fpregs(false);
+  const FPRegSet<Host> actual = get_fpregs(true);
+  EXPECT_EQ(expected.fcw, actual.fcw);
+  EXPECT_EQ(expected.fsw, actual.fsw);
+  EXPECT_EQ(expected.ftw, actual.ftw);
+  EXPECT_EQ(expected.mxcsr, actual.mxcsr);
+  EXPECT_EQ(expected.mxcsr_mask, actual.mxcsr_mask);
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_TRUE(expected.st[i] == actual.st[i]) << "st" << i;
+  }
+  for (int i = 0; i < 16; ++i) {
+    EXPECT_TRUE(expected.xmm[i] == actual.xmm[i]) << "xmm" << i;
+  }
+}
+
 TEST(NativeTracerTest, GetExtensionRegisters) {
   RegisterGroupIOBuffer<Host> eregs;
   eregs.register_groups = GetCurrentPlatformRegisterGroups();
@@ -117,6 +117,7 @@ class UnicornTracer final : public Tracer<Arch> {
     uint64_t timeout_microseconds = 1000000;
     uc_err err = uc_emu_start(uc_, code_start_address_, code_end_address_,
                               timeout_microseconds, 0);
+    last_emu_error_ = err;
     AfterExecution();
 
     // Check if the emulator stopped cleanly.
@@ -224,6 +225,9 @@ class UnicornTracer final : public Tracer<Arch> {
     UNICORN_CHECK(uc_mem_read(uc_, address, buffer, size));
   }
 
+  // Returns the error uc_emu_start() reported in the last Run().
+  uc_err last_emu_error() const { return last_emu_error_; }
+
  private:
   // With a template-parameter-dependent base class, we need to use qualified
   // name lookup for protected members. See
@@ -293,6 +297,8 @@ class UnicornTracer final : public Tracer<Arch> {
 
   uc_hook hook_code_;
 
+  uc_err last_emu_error_ = UC_ERR_OK;
+
   std::vector<MemoryMapping> memory_mappings_;
 };
 
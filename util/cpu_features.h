@@ -25,6 +25,7 @@ enum class X86CPUFeatures {
   kBegin = 0,
   kAMX_TILE = kBegin,  // for accessing tile and tileconfig registers.
   kAVX,                // for accessing ymm registers.
+  kAVX2,               // for 256-bit integer instructions.
   kAVX512BW,           // for accessing upper 48 bits of opmask registers.
   kAVX512F,  // for accessing zmm and lower 16 bits of opmask registers.
   kOSXSAVE,  // OS provides processor extended state management.
@@ -42,8 +43,8 @@ static_assert(static_cast<int>(X86CPUFeatures::kEnd) < 64);
 template <>
 inline constexpr const char*
     EnumNameMap<X86CPUFeatures>[static_cast<int>(X86CPUFeatures::kEnd)] = {
-        "AMX_TILE", "AVX", "AVX512BW", "AVX512F",
-        "OSXSAVE",  "SSE", "SSE4_2",   "XSAVE",
+        "AMX_TILE", "AVX", "AVX2",   "AVX512BW", "AVX512F",
+        "OSXSAVE",  "SSE", "SSE4_2", "XSAVE",
 };
 
 #ifdef __x86_64__
@@ -132,6 +132,78 @@ SSE4_2_TARGET_ATTRIBUTE uint32_t crc32c_accelerated_impl(uint32_t seed,
   return value ^ 0xffffffffU;
 }
 
+// Computes CRC32C of multiple buffers using hardware acceleration. Like the
+// multi-stream part of crc32c_accelerated_impl() above, this hides latency of
+// the CRC instruction by computing kNumStreams CRC values simultaneously, but
+// the streams come from different buffers so no combination is needed.
+template <typename CRC32CFunctions>
+SSE4_2_TARGET_ATTRIBUTE void crc32c_multi_accelerated_impl(
+    uint32_t seed, const CRC32CBuffer* buffers, size_t num_buffers,
+    uint32_t* crcs) {
+  constexpr size_t kNumStreams = 3;
+  // Interleaving only pays for the extra bookkeeping if the buffers have
+  // enough 64-bit words in common. Smaller groups are done one at a time.
+  constexpr size_t kMinCommonU64s = 16;
+  size_t i = 0;
+  for (; i + kNumStreams <= num_buffers; i += kNumStreams) {
+    const uint8_t* data[kNumStreams];
+    size_t n[kNumStreams];
+    size_t head_size[kNumStreams];
+    size_t num_u64s = SIZE_MAX;
+    for (size_t j = 0; j < kNumStreams; ++j) {
+      // Align input to 64-bit boundary.
+      const CRC32CBuffer& buffer = buffers[i + j];
+      const size_t offset_in_qword =
+          reinterpret_cast<uintptr_t>(buffer.data) % sizeof(uint64_t);
+      head_size[j] = offset_in_qword != 0
+                         ? std::min<size_t>(buffer.size, 8 - offset_in_qword)
+                         : 0;
+      data[j] = buffer.data + head_size[j];
+      n[j] = buffer.size - head_size[j];
+      num_u64s = std::min(num_u64s, n[j] / sizeof(uint64_t));
+    }
+    if (num_u64s < kMinCommonU64s) {
+      for (size_t j = 0; j < kNumStreams; ++j) {
+        crcs[i + j] = crc32c_accelerated_impl<CRC32CFunctions>(
+            seed, buffers[i + j].data, buffers[i + j].size);
+      }
+      continue;
+    }
+    uint32_t value[kNumStreams];
+    for (size_t j = 0; j < kNumStreams; ++j) {
+      value[j] = crc32c_accelerated_impl<CRC32CFunctions>(
+                     seed, buffers[i + j].data, head_size[j]) ^
+                 0xffffffffU;
+    }
+
+    // Go through the common length of the buffers in lockstep.
+    const uint64_t* u64_data_1 = reinterpret_cast<const uint64_t*>(data[0]);
+    const uint64_t* u64_data_2 = reinterpret_cast<const uint64_t*>(data[1]);
+    const uint64_t* u64_data_3 = reinterpret_cast<const uint64_t*>(data[2]);
+    uint32_t value1 = value[0], value2 = value[1], value3 = value[2];
+    for (size_t k = 0; k < num_u64s; ++k) {
+      value1 = CRC32CFunctions::crc32c_uint64(value1, u64_data_1[k]);
+      value2 = CRC32CFunctions::crc32c_uint64(value2, u64_data_2[k]);
+      value3 = CRC32CFunctions::crc32c_uint64(value3, u64_data_3[k]);
+    }
+    value[0] = value1;
+    value[1] = value2;
+    value[2] = value3;
+
+    // Finish the rest of each buffer separately.
+    const size_t common_size = num_u64s * sizeof(uint64_t);
+    for (size_t j = 0; j < kNumStreams; ++j) {
+      crcs[i + j] = crc32c_accelerated_impl<CRC32CFunctions>(
+          value[j] ^ 0xffffffffU, data[j] + common_size, n[j] - common_size);
+    }
+  }
+
+  for (; i < num_buffers; ++i) {
+    crcs[i] = crc32c_accelerated_impl<CRC32CFunctions>(seed, buffers[i].data,
+                                                       buffers[i].size);
+  }
+}
+
 #ifdef __x86_64__
 struct X86CRC32CFunctions {
   SSE4_2_TARGET_ATTRIBUTE static inline uint32_t crc32c_uint8(uint32_t crc,
@@ -160,14 +232,28 @@ struct ARMCRC32CFunctions {
 uint32_t crc32c_accelerated(uint32_t seed, const uint8_t* data, size_t n) {
   return crc32c_accelerated_impl<ARMCRC32CFunctions>(seed, data, n);
 }
+void crc32c_multi_accelerated(uint32_t seed, const CRC32CBuffer* buffers,
+                              size_t num_buffers, uint32_t* crcs) {
+  crc32c_multi_accelerated_impl<ARMCRC32CFunctions>(seed, buffers, num_buffers,
+                                                    crcs);
+}
 #elif defined(__x86_64__)
 uint32_t crc32c_accelerated(uint32_t seed, const uint8_t* data, size_t n) {
   return crc32c_accelerated_impl<X86CRC32CFunctions>(seed, data, n);
 }
+void crc32c_multi_accelerated(uint32_t seed, const CRC32CBuffer* buffers,
+                              size_t num_buffers, uint32_t* crcs) {
+  crc32c_multi_accelerated_impl<X86CRC32CFunctions>(seed, buffers, num_buffers,
+                                                    crcs);
+}
 #else
 uint32_t crc32c_accelerated(uint32_t seed, const uint8_t* data, size_t n) {
   return crc32c_unaccelerated(seed, data, n);
 }
+void crc32c_multi_accelerated(uint32_t seed, const CRC32CBuffer* buffers,
+                              size_t num_buffers, uint32_t* crcs) {
+  crc32c_multi_unaccelerated(seed, buffers, num_buffers, crcs);
+}
 #endif
 
 // Tells if CRC32C acceleration is available at runtime.
@@ -190,6 +276,16 @@ uint32_t crc32c_init(uint32_t seed, const uint8_t* data, size_t n) {
   return (*impl)(seed, data, n);
 }
 
+// Initializes best_crc32c_multi_impl upon the first call to crc32c_multi.
+void crc32c_multi_init(uint32_t seed, const CRC32CBuffer* buffers,
+                       size_t num_buffers, uint32_t* crcs) {
+  crc32c_multi_function_ptr impl = has_crc32c_accelerated()
+                                       ? &crc32c_multi_accelerated
+                                       : &crc32c_multi_unaccelerated;
+  best_crc32c_multi_impl.exchange(impl);
+  (*impl)(seed, buffers, num_buffers, crcs);
+}
+
 }  // namespace
 
 // Pointer to the best CRC-32C implementation we can use at run-time.
@@ -197,6 +293,18 @@ uint32_t crc32c_init(uint32_t seed, const uint8_t* data, size_t n) {
 std::atomic<crc32c_function_ptr> best_crc32c_impl =
     ATOMIC_VAR_INIT(&crc32c_init);
 
+// Pointer to the best crc32c_multi() implementation we can use at run-time.
+// Initially it points to crc32c_multi_init.
+std::atomic<crc32c_multi_function_ptr> best_crc32c_multi_impl =
+    ATOMIC_VAR_INIT(&crc32c_multi_init);
+
+void crc32c_multi_unaccelerated(uint32_t seed, const CRC32CBuffer* buffers,
+                                size_t num_buffers, uint32_t* crcs) {
+  for (size_t i = 0; i < num_buffers; ++i) {
+    crcs[i] = crc32c_unaccelerated(seed, buffers[i].data, buffers[i].size);
+  }
+}
+
 uint32_t crc32c_zero_extend(uint32_t crc, size_t n) {
   // TODO(dougkwan): Precompute zero extension tables for the most frequently
   // occurring values of 'n' so that we only do extension once instead of
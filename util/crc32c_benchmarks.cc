@@ -18,6 +18,7 @@
 
 #include "benchmark/benchmark.h"
 #include "./util/crc32c.h"
+#include "./util/crc32c_parallel.h"
 
 namespace silifuzz {
 
@@ -47,8 +48,65 @@ void BM_CRC32CUnaccelerated(benchmark::State& state) {
   state.SetBytesProcessed(state.iterations() * block_size);
 }
 
+// Checksums 16 independent buffers of the same size, one at a time.
+// This is the baseline for BM_CRC32CMulti below.
+static constexpr size_t kNumMultiBuffers = 16;
+
+std::vector<CRC32CBuffer> MultiBuffers(std::vector<uint8_t>& storage,
+                                       size_t block_size) {
+  storage.assign(kNumMultiBuffers * block_size, 0);
+  std::vector<CRC32CBuffer> buffers(kNumMultiBuffers);
+  for (size_t i = 0; i < kNumMultiBuffers; ++i) {
+    buffers[i] = {.data = &storage[i * block_size], .size = block_size};
+  }
+  return buffers;
+}
+
+void BM_CRC32CSerial(benchmark::State& state) {
+  size_t block_size = state.range(0);
+  std::vector<uint8_t> storage;
+  std::vector<CRC32CBuffer> buffers = MultiBuffers(storage, block_size);
+  uint32_t crcs[kNumMultiBuffers];
+  for (auto s : state) {
+    for (size_t i = 0; i < kNumMultiBuffers; ++i) {
+      crcs[i] = crc32c(0, buffers[i].data, buffers[i].size);
+    }
+    benchmark::DoNotOptimize(crcs);
+  }
+  state.SetBytesProcessed(state.iterations() * kNumMultiBuffers * block_size);
+}
+
+void BM_CRC32CMulti(benchmark::State& state) {
+  size_t block_size = state.range(0);
+  std::vector<uint8_t> storage;
+  std::vector<CRC32CBuffer> buffers = MultiBuffers(storage, block_size);
+  uint32_t crcs[kNumMultiBuffers];
+  for (auto s : state) {
+    crc32c_multi(0, buffers.data(), buffers.size(), crcs);
+    benchmark::DoNotOptimize(crcs);
+  }
+  state.SetBytesProcessed(state.iterations() * kNumMultiBuffers * block_size);
+}
+
+// Checksums one large buffer with the number of threads in range(1).
+void BM_CRC32CParallel(benchmark::State& state) {
+  size_t block_size = state.range(0);
+  size_t num_threads = state.range(1);
+  std::vector<uint8_t> buffer(block_size, 0);
+  uint32_t crc = 0;
+  for (auto s : state) {
+    crc = crc32c_parallel(crc, buffer.data(), block_size, num_threads);
+  }
+  state.SetBytesProcessed(state.iterations() * block_size);
+}
+
 static constexpr size_t kMaxBlockSize = 1 << 16;
 BENCHMARK(BM_CRC32C)->RangeMultiplier(4)->Range(1, kMaxBlockSize);
 BENCHMARK(BM_CRC32CUnaccelerated)->RangeMultiplier(4)->Range(1, kMaxBlockSize);
+BENCHMARK(BM_CRC32CSerial)->RangeMultiplier(4)->Range(16, kMaxBlockSize);
+BENCHMARK(BM_CRC32CMulti)->RangeMultiplier(4)->Range(16, kMaxBlockSize);
+BENCHMARK(BM_CRC32CParallel)
+    ->ArgsProduct({{1 << 22, 1 << 26}, {1, 2, 4, 8}})
+    ->UseRealTime();
 
 }  // namespace silifuzz
@@ -0,0 +1,61 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./util/crc32c_parallel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "./util/crc32c.h"
+
+namespace silifuzz {
+
+uint32_t crc32c_parallel(uint32_t seed, const uint8_t* data, size_t n,
+                         size_t num_threads) {
+  const size_t num_pieces =
+      std::clamp<size_t>(n / kCRC32CParallelMinPieceSize, 1, num_threads);
+  if (num_pieces <= 1) {
+    return crc32c(seed, data, n);
+  }
+
+  // All pieces have the same size except the last one, which also takes the
+  // remainder. Every piece but the first is checksummed with seed 0 so that
+  // it can be merged with crc32c_combine().
+  const size_t piece_size = n / num_pieces;
+  std::vector<uint32_t> crcs(num_pieces);
+  std::vector<std::thread> threads;
+  threads.reserve(num_pieces - 1);
+  for (size_t i = 1; i < num_pieces; ++i) {
+    const size_t size = i + 1 == num_pieces ? n - i * piece_size : piece_size;
+    threads.emplace_back([&crcs, i, size, piece = data + i * piece_size] {
+      crcs[i] = crc32c(0, piece, size);
+    });
+  }
+  crcs[0] = crc32c(seed, data, piece_size);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  uint32_t crc = crcs[0];
+  for (size_t i = 1; i < num_pieces; ++i) {
+    const size_t size = i + 1 == num_pieces ? n - i * piece_size : piece_size;
+    crc = crc32c_combine(crc, crcs[i], size);
+  }
+  return crc;
+}
+
+}  // namespace silifuzz
@@ -0,0 +1,40 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_SILIFUZZ_UTIL_CRC32C_PARALLEL_H_
+#define THIRD_PARTY_SILIFUZZ_UTIL_CRC32C_PARALLEL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace silifuzz {
+
+// Buffers smaller than this are not worth splitting. Below this size the cost
+// of starting a thread exceeds the time to checksum the whole buffer.
+inline constexpr size_t kCRC32CParallelMinPieceSize = 1 << 20;
+
+// Computes the CRC32C checksum of 'n' bytes at 'data' with 'seed', using up to
+// 'num_threads' threads including the calling one. The buffer is split into
+// pieces of at least kCRC32CParallelMinPieceSize bytes that are checksummed
+// independently and then merged with crc32c_combine(). The result is always
+// the same as crc32c(seed, data, n).
+//
+// This is for large buffers like whole corpus files. It uses libc threads and
+// cannot be used in nolibc code.
+uint32_t crc32c_parallel(uint32_t seed, const uint8_t* data, size_t n,
+                         size_t num_threads);
+
+}  // namespace silifuzz
+
+#endif  // THIRD_PARTY_SILIFUZZ_UTIL_CRC32C_PARALLEL_H_
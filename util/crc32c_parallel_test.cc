@@ -0,0 +1,57 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "./util/crc32c_parallel.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "./util/crc32c.h"
+
+namespace silifuzz {
+namespace {
+
+std::vector<uint8_t> TestBuffer(size_t size) {
+  std::vector<uint8_t> buffer(size);
+  uint32_t x = 1;
+  for (uint8_t& byte : buffer) {
+    // Any non-repeating pattern is fine.
+    x = x * 1103515245 + 12345;
+    byte = x >> 24;
+  }
+  return buffer;
+}
+
+TEST(CRC32CParallel, MatchesSerial) {
+  constexpr uint32_t kSeed = 0xdeadbeef;
+  const std::vector<uint8_t> buffer =
+      TestBuffer(4 * kCRC32CParallelMinPieceSize + 123);
+  // Try sizes that are too small to split, that split evenly and that leave a
+  // remainder for the last piece.
+  for (size_t size : {size_t{0}, size_t{1}, kCRC32CParallelMinPieceSize - 1,
+                      2 * kCRC32CParallelMinPieceSize,
+                      3 * kCRC32CParallelMinPieceSize + 7, buffer.size()}) {
+    const uint32_t expected = crc32c(kSeed, buffer.data(), size);
+    for (size_t num_threads : {0, 1, 2, 3, 4, 16}) {
+      EXPECT_EQ(crc32c_parallel(kSeed, buffer.data(), size, num_threads),
+                expected)
+          << "size = " << size << " num_threads = " << num_threads;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace silifuzz
@@ -131,6 +131,52 @@ TEST(crc32c, BigBlockSizes) {
   }
 }
 
+template <internal::crc32c_multi_function_ptr crc32c_multi_function>
+void MultiTestImpl() {
+  constexpr size_t kBufferSize = 4096;
+  alignas(sizeof(uint64_t)) uint8_t buffer[kBufferSize];
+  for (size_t i = 0; i < kBufferSize; ++i) {
+    buffer[i] = i * 7 + 1;
+  }
+
+  // Buffers of different sizes and alignments, some big enough to trigger
+  // multi-stream CRC computation within a buffer. Using 7 buffers leaves one
+  // after interleaving them in groups of 3.
+  constexpr size_t kNumBuffers = 7;
+  const CRC32CBuffer buffers[kNumBuffers] = {
+      {buffer, 0},          {buffer + 1, 9},     {buffer + 3, 1000},
+      {buffer + 8, 64},     {buffer + 5, 3},     {buffer + 16, 2048},
+      {buffer + 7, 4000},
+  };
+  constexpr uint32_t kSeed = 0x12345678;
+  uint32_t crcs[kNumBuffers];
+  for (size_t num_buffers = 0; num_buffers <= kNumBuffers; ++num_buffers) {
+    (*crc32c_multi_function)(kSeed, buffers, num_buffers, crcs);
+    for (size_t i = 0; i < num_buffers; ++i) {
+      CHECK_EQ(crcs[i], internal::crc32c_unaccelerated(
+                            kSeed, buffers[i].data, buffers[i].size));
+    }
+  }
+}
+
+// This tests crc32c_multi_accelerated if h/w acceleration is available.
+TEST(crc32c, MultiBestCrcImpl) { MultiTestImpl<&crc32c_multi>(); }
+
+TEST(crc32c, MultiUnaccelerated) {
+  MultiTestImpl<&internal::crc32c_multi_unaccelerated>();
+}
+
+TEST(crc32c, Combine) {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(kInput);
+  constexpr uint32_t kSeed = 0xdeadbeef;
+  const uint32_t expected = crc32c(kSeed, p, kInputSize);
+  for (size_t split = 0; split <= kInputSize; ++split) {
+    const uint32_t crc1 = crc32c(kSeed, p, split);
+    const uint32_t crc2 = crc32c(0, p + split, kInputSize - split);
+    CHECK_EQ(crc32c_combine(crc1, crc2, kInputSize - split), expected);
+  }
+}
+
 }  // namespace
 }  // namespace silifuzz
 
@@ -144,4 +190,7 @@ NOLIBC_TEST_MAIN({
   RUN_TEST(crc32c, ZeroExtendTables);
   RUN_TEST(crc32c, ZeroExtend);
   RUN_TEST(crc32c, BigBlockSizes);
+  RUN_TEST(crc32c, MultiBestCrcImpl);
+  RUN_TEST(crc32c, MultiUnaccelerated);
+  RUN_TEST(crc32c, Combine);
 })
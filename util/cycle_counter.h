@@ -0,0 +1,45 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_SILIFUZZ_UTIL_CYCLE_COUNTER_H_
+#define THIRD_PARTY_SILIFUZZ_UTIL_CYCLE_COUNTER_H_
+
+#include <cstdint>
+
+namespace silifuzz {
+
+// Returns the current value of a free-running, user-readable counter:
+// the TSC on x86_64 and CNTVCT_EL0 on aarch64. Neither counts core clock
+// cycles exactly and the frequency differs between platforms, so values are
+// only meaningful when compared with other values from the same machine.
+//
+// This does not make any syscalls and is safe to use in nolibc code and under
+// the runner's seccomp filter.
+inline uint64_t ReadCycleCounter() {
+#if defined(__x86_64__)
+  uint32_t lo, hi;
+  asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+  return (static_cast<uint64_t>(hi) << 32) | lo;
+#elif defined(__aarch64__)
+  uint64_t value;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+  return value;
+#else
+#error "Unsupported architecture"
+#endif
+}
+
+}  // namespace silifuzz
+
+#endif  // THIRD_PARTY_SILIFUZZ_UTIL_CYCLE_COUNTER_H_
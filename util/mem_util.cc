@@ -16,9 +16,22 @@
 
 #include <strings.h>
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+
+#include "./util/avx.h"
+#include "./util/cpu_features.h"
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "./util/checks.h"
+
 namespace silifuzz {
 
 namespace {
@@ -58,13 +71,11 @@ bool MemAllEqualToImpl(const void* src, uint8_t c, size_t n) {
   }
 }
 
-}  // namespace
-
 // The no_builtin attribute tells a compiler not replace any part of this
 // function with a call to memcpy(). An optimizing compiler can recognize
 // the uint64_t copying loop below and replace that with a call to memcpy(),
 // depending on optimization setting.
-void MemCopy(void* dest, const void* src, size_t n)
+void MemCopyScalar(void* dest, const void* src, size_t n)
     __attribute__((no_builtin("memcpy"))) {
   // Optimize only if dest, src and n are all 8-byte aligned.
   if (reinterpret_cast<uintptr_t>(dest) % sizeof(uint64_t) != 0 ||
@@ -86,8 +97,8 @@ void MemCopy(void* dest, const void* src, size_t n)
   }
 }
 
-void MemSet(void* dest, uint8_t c, size_t n)
-    __attribute__((no_builtin("memset"))) /* see MemCopy() above */ {
+void MemSetScalar(void* dest, uint8_t c, size_t n)
+    __attribute__((no_builtin("memset"))) /* see MemCopyScalar() above */ {
   // Optimize only if dest and n are both 8-byte aligned.
   if (reinterpret_cast<uintptr_t>(dest) % sizeof(uint64_t) != 0 ||
       n % sizeof(uint64_t) != 0) {
@@ -106,8 +117,8 @@ void MemSet(void* dest, uint8_t c, size_t n)
   }
 }
 
-bool MemEq(const void* s1, const void* s2, size_t n)
-    __attribute__((no_builtin("memcmp"))) /* See MemCopy() above */ {
+bool MemEqScalar(const void* s1, const void* s2, size_t n)
+    __attribute__((no_builtin("memcmp"))) /* See MemCopyScalar() above */ {
   // Optimize only if s1, s2 and n are all 8-byte aligned.
   if (reinterpret_cast<uintptr_t>(s1) % sizeof(uint64_t) != 0 ||
       reinterpret_cast<uintptr_t>(s2) % sizeof(uint64_t) != 0 ||
@@ -129,7 +140,7 @@ bool MemEq(const void* s1, const void* s2, size_t n)
   return diff == 0;
 }
 
-bool MemAllEqualTo(const void* src, uint8_t c, size_t n) {
+bool MemAllEqualToScalar(const void* src, uint8_t c, size_t n) {
   if (c == 0) {
     // See MemAllEqualToImpl() above for why we treat 0 differently.
     return MemAllEqualToImpl</* compare_with_zero=*/true>(src, 0, n);
@@ -138,4 +149,478 @@ bool MemAllEqualTo(const void* src, uint8_t c, size_t n) {
   }
 }
 
+// Returns the largest multiple of `vector_size` not greater than n.
+// The vector implementations below process that many bytes and leave the rest
+// to the scalar implementations.
+inline constexpr size_t VectorBulkSize(size_t n, size_t vector_size) {
+  return n - n % vector_size;
+}
+
+#if defined(__x86_64__)
+
+// Runner code may be compiled without vector instructions. Target attributes
+// let us use them in the functions below regardless.
+#define SSE2_FUNCTION __attribute__((target("sse2")))
+#define AVX2_FUNCTION __attribute__((target("avx2")))
+#define AVX512F_FUNCTION __attribute__((target("avx512f")))
+
+// SSE2 is always available on x86_64. The SSE2 functions use legacy encoding,
+// which leaves the upper halves of the ymm registers alone.
+
+SSE2_FUNCTION inline __m128i LoadSSE2(const uint8_t* src) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+}
+
+SSE2_FUNCTION inline void StoreSSE2(uint8_t* dest, __m128i value) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), value);
+}
+
+// Returns true iff all bits of `diff` are zero.
+SSE2_FUNCTION inline bool IsZeroSSE2(__m128i diff) {
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) ==
+         0xffff;
+}
+
+SSE2_FUNCTION void MemCopySSE2(void* dest, const void* src, size_t n) {
+  uint8_t* dest_u8 = reinterpret_cast<uint8_t*>(dest);
+  const uint8_t* src_u8 = reinterpret_cast<const uint8_t*>(src);
+  const size_t bulk = VectorBulkSize(n, sizeof(__m128i));
+  for (size_t i = 0; i < bulk; i += sizeof(__m128i)) {
+    StoreSSE2(&dest_u8[i], LoadSSE2(&src_u8[i]));
+  }
+  MemCopyScalar(&dest_u8[bulk], &src_u8[bulk], n - bulk);
+}
+
+SSE2_FUNCTION void MemSetSSE2(void* dest, uint8_t c, size_t n) {
+  uint8_t* dest_u8 = reinterpret_cast<uint8_t*>(dest);
+  const __m128i c_m128i = _mm_set1_epi8(c);
+  const size_t bulk = VectorBulkSize(n, sizeof(__m128i));
+  for (size_t i = 0; i < bulk; i += sizeof(__m128i)) {
+    StoreSSE2(&dest_u8[i], c_m128i);
+  }
+  MemSetScalar(&dest_u8[bulk], c, n - bulk);
+}
+
+SSE2_FUNCTION bool MemEqSSE2(const void* s1, const void* s2, size_t n) {
+  const uint8_t* u1 = reinterpret_cast<const uint8_t*>(s1);
+  const uint8_t* u2 = reinterpret_cast<const uint8_t*>(s2);
+  const size_t bulk = VectorBulkSize(n, sizeof(__m128i));
+  __m128i diff = _mm_setzero_si128();
+  for (size_t i = 0; i < bulk; i += sizeof(__m128i)) {
+    diff =
+        _mm_or_si128(diff, _mm_xor_si128(LoadSSE2(&u1[i]), LoadSSE2(&u2[i])));
+  }
+  return IsZeroSSE2(diff) && MemEqScalar(&u1[bulk], &u2[bulk], n - bulk);
+}
+
+SSE2_FUNCTION bool MemAllEqualToSSE2(const void* src, uint8_t c, size_t n) {
+  const uint8_t* src_u8 = reinterpret_cast<const uint8_t*>(src);
+  const __m128i c_m128i = _mm_set1_epi8(c);
+  const size_t bulk = VectorBulkSize(n, sizeof(__m128i));
+  __m128i diff = _mm_setzero_si128();
+  for (size_t i = 0; i < bulk; i += sizeof(__m128i)) {
+    diff = _mm_or_si128(diff, _mm_xor_si128(LoadSSE2(&src_u8[i]), c_m128i));
+  }
+  return IsZeroSSE2(diff) && MemAllEqualToScalar(&src_u8[bulk], c, n - bulk);
+}
+
+// The AVX2 and AVX-512 functions below only process the bulk of a range. The
+// rest is handled by the callers, so that no scalar code gets inlined and
+// vectorized in functions with a wider target.
+//
+// Without an AVX-512 target, the compiler can only use ymm0-ymm15 in the AVX2
+// functions. _mm256_zeroupper() clears their upper halves before we return.
+
+AVX2_FUNCTION inline __m256i LoadAVX2(const uint8_t* src) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+}
+
+AVX2_FUNCTION inline void StoreAVX2(uint8_t* dest, __m256i value) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), value);
+}
+
+AVX2_FUNCTION void MemCopyAVX2Bulk(uint8_t* dest, const uint8_t* src,
+                                   size_t bulk) {
+  for (size_t i = 0; i < bulk; i += sizeof(__m256i)) {
+    StoreAVX2(&dest[i], LoadAVX2(&src[i]));
+  }
+  _mm256_zeroupper();
+}
+
+AVX2_FUNCTION void MemSetAVX2Bulk(uint8_t* dest, uint8_t c, size_t bulk) {
+  const __m256i c_m256i = _mm256_set1_epi8(c);
+  for (size_t i = 0; i < bulk; i += sizeof(__m256i)) {
+    StoreAVX2(&dest[i], c_m256i);
+  }
+  _mm256_zeroupper();
+}
+
+AVX2_FUNCTION bool MemEqAVX2Bulk(const uint8_t* s1, const uint8_t* s2,
+                                 size_t bulk) {
+  __m256i diff = _mm256_setzero_si256();
+  for (size_t i = 0; i < bulk; i += sizeof(__m256i)) {
+    diff = _mm256_or_si256(
+        diff, _mm256_xor_si256(LoadAVX2(&s1[i]), LoadAVX2(&s2[i])));
+  }
+  const bool equal = _mm256_testz_si256(diff, diff);
+  _mm256_zeroupper();
+  return equal;
+}
+
+AVX2_FUNCTION bool MemAllEqualToAVX2Bulk(const uint8_t* src, uint8_t c,
+                                         size_t bulk) {
+  const __m256i c_m256i = _mm256_set1_epi8(c);
+  __m256i diff = _mm256_setzero_si256();
+  for (size_t i = 0; i < bulk; i += sizeof(__m256i)) {
+    diff =
+        _mm256_or_si256(diff, _mm256_xor_si256(LoadAVX2(&src[i]), c_m256i));
+  }
+  const bool equal = _mm256_testz_si256(diff, diff);
+  _mm256_zeroupper();
+  return equal;
+}
+
+// The AVX-512 loops are written in assembly. With an AVX-512 target, the
+// compiler is free to use zmm16-zmm31 and opmask registers, which vzeroupper
+// does not clear and fxrstor does not restore. The loops below only use
+// zmm0-zmm2 and no masks.
+//
+// REQUIRES: bulk is a non-zero multiple of 64.
+
+AVX512F_FUNCTION void MemCopyAVX512FBulk(uint8_t* dest, const uint8_t* src,
+                                         size_t bulk) {
+  size_t i = 0;
+  asm volatile(
+      "1:\n"
+      "vmovdqu64 (%[src], %[i]), %%zmm0\n"
+      "vmovdqu64 %%zmm0, (%[dest], %[i])\n"
+      "add $64, %[i]\n"
+      "cmp %[bulk], %[i]\n"
+      "jb 1b\n"
+      "vzeroupper\n"
+      : [i] "+r"(i)
+      : [dest] "r"(dest), [src] "r"(src), [bulk] "r"(bulk)
+      : "xmm0", "cc", "memory");
+}
+
+AVX512F_FUNCTION void MemSetAVX512FBulk(uint8_t* dest, uint8_t c,
+                                        size_t bulk) {
+  size_t i = 0;
+  const uint64_t c_u64 = c * 0x0101010101010101ULL;  // replicate 8 times.
+  asm volatile(
+      "vpbroadcastq %[c], %%zmm0\n"
+      "1:\n"
+      "vmovdqu64 %%zmm0, (%[dest], %[i])\n"
+      "add $64, %[i]\n"
+      "cmp %[bulk], %[i]\n"
+      "jb 1b\n"
+      "vzeroupper\n"
+      : [i] "+r"(i)
+      : [dest] "r"(dest), [c] "r"(c_u64), [bulk] "r"(bulk)
+      : "xmm0", "cc", "memory");
+}
+
+AVX512F_FUNCTION bool MemEqAVX512FBulk(const uint8_t* s1, const uint8_t* s2,
+                                       size_t bulk) {
+  size_t i = 0;
+  bool equal;
+  // Accumulates XOR differences in zmm0, folds it into ymm0 and tests that.
+  asm volatile(
+      "vpxorq %%zmm0, %%zmm0, %%zmm0\n"
+      "1:\n"
+      "vmovdqu64 (%[s1], %[i]), %%zmm1\n"
+      "vpxorq (%[s2], %[i]), %%zmm1, %%zmm1\n"
+      "vporq %%zmm1, %%zmm0, %%zmm0\n"
+      "add $64, %[i]\n"
+      "cmp %[bulk], %[i]\n"
+      "jb 1b\n"
+      "vextracti64x4 $1, %%zmm0, %%ymm1\n"
+      "vpor %%ymm1, %%ymm0, %%ymm0\n"
+      "vptest %%ymm0, %%ymm0\n"
+      "vzeroupper\n"
+      : [i] "+r"(i), "=@ccz"(equal)
+      : [s1] "r"(s1), [s2] "r"(s2), [bulk] "r"(bulk)
+      : "xmm0", "xmm1", "memory");
+  return equal;
+}
+
+AVX512F_FUNCTION bool MemAllEqualToAVX512FBulk(const uint8_t* src, uint8_t c,
+                                               size_t bulk) {
+  size_t i = 0;
+  bool equal;
+  const uint64_t c_u64 = c * 0x0101010101010101ULL;  // replicate 8 times.
+  // Same as MemEqAVX512FBulk() but compares with c in zmm2.
+  asm volatile(
+      "vpbroadcastq %[c], %%zmm2\n"
+      "vpxorq %%zmm0, %%zmm0, %%zmm0\n"
+      "1:\n"
+      "vpxorq (%[src], %[i]), %%zmm2, %%zmm1\n"
+      "vporq %%zmm1, %%zmm0, %%zmm0\n"
+      "add $64, %[i]\n"
+      "cmp %[bulk], %[i]\n"
+      "jb 1b\n"
+      "vextracti64x4 $1, %%zmm0, %%ymm1\n"
+      "vpor %%ymm1, %%ymm0, %%ymm0\n"
+      "vptest %%ymm0, %%ymm0\n"
+      "vzeroupper\n"
+      : [i] "+r"(i), "=@ccz"(equal)
+      : [src] "r"(src), [c] "r"(c_u64), [bulk] "r"(bulk)
+      : "xmm0", "xmm1", "xmm2", "memory");
+  return equal;
+}
+
+// Size of the vectors used by each implementation.
+constexpr size_t kYmmSize = 32;
+constexpr size_t kZmmSize = 64;
+
+// Runs the AVX2 or AVX-512 bulk functions above and the scalar code for the
+// rest of the range.
+template <size_t kVectorSize, auto CopyBulk>
+void MemCopyBulkAndScalar(void* dest, const void* src, size_t n) {
+  uint8_t* dest_u8 = reinterpret_cast<uint8_t*>(dest);
+  const uint8_t* src_u8 = reinterpret_cast<const uint8_t*>(src);
+  const size_t bulk = VectorBulkSize(n, kVectorSize);
+  if (bulk != 0) {
+    CopyBulk(dest_u8, src_u8, bulk);
+  }
+  MemCopyScalar(&dest_u8[bulk], &src_u8[bulk], n - bulk);
+}
+
+template <size_t kVectorSize, auto SetBulk>
+void MemSetBulkAndScalar(void* dest, uint8_t c, size_t n) {
+  uint8_t* dest_u8 = reinterpret_cast<uint8_t*>(dest);
+  const size_t bulk = VectorBulkSize(n, kVectorSize);
+  if (bulk != 0) {
+    SetBulk(dest_u8, c, bulk);
+  }
+  MemSetScalar(&dest_u8[bulk], c, n - bulk);
+}
+
+template <size_t kVectorSize, auto EqBulk>
+bool MemEqBulkAndScalar(const void* s1, const void* s2, size_t n) {
+  const uint8_t* u1 = reinterpret_cast<const uint8_t*>(s1);
+  const uint8_t* u2 = reinterpret_cast<const uint8_t*>(s2);
+  const size_t bulk = VectorBulkSize(n, kVectorSize);
+  if (bulk != 0 && !EqBulk(u1, u2, bulk)) {
+    return false;
+  }
+  return MemEqScalar(&u1[bulk], &u2[bulk], n - bulk);
+}
+
+template <size_t kVectorSize, auto AllEqualToBulk>
+bool MemAllEqualToBulkAndScalar(const void* src, uint8_t c, size_t n) {
+  const uint8_t* src_u8 = reinterpret_cast<const uint8_t*>(src);
+  const size_t bulk = VectorBulkSize(n, kVectorSize);
+  if (bulk != 0 && !AllEqualToBulk(src_u8, c, bulk)) {
+    return false;
+  }
+  return MemAllEqualToScalar(&src_u8[bulk], c, n - bulk);
+}
+
+// For details, see 15.2 of Intel SDM vol. 1.
+__attribute__((target("xsave"))) bool HasAVX2Registers() {
+  if (!HasX86CPUFeature(X86CPUFeatures::kOSXSAVE) ||
+      !HasX86CPUFeature(X86CPUFeatures::kAVX2)) {
+    return false;
+  }
+  constexpr uint64_t kAVXRequiredXCR0Bits = 0x6;  // YMM & XMM.
+  return (_xgetbv(0) & kAVXRequiredXCR0Bits) == kAVXRequiredXCR0Bits;
+}
+
+#elif defined(__aarch64__)
+
+// Advanced SIMD is mandatory on aarch64 and the snap harness restores all of
+// v0-v31 before running a snapshot.
+
+void MemCopyNEON(void* dest, const void* src, size_t n) {
+  uint8_t* dest_u8 = reinterpret_cast<uint8_t*>(dest);
+  const uint8_t* src_u8 = reinterpret_cast<const uint8_t*>(src);
+  const size_t bulk = VectorBulkSize(n, sizeof(uint8x16_t));
+  for (size_t i = 0; i < bulk; i += sizeof(uint8x16_t)) {
+    vst1q_u8(&dest_u8[i], vld1q_u8(&src_u8[i]));
+  }
+  MemCopyScalar(&dest_u8[bulk], &src_u8[bulk], n - bulk);
+}
+
+void MemSetNEON(void* dest, uint8_t c, size_t n) {
+  uint8_t* dest_u8 = reinterpret_cast<uint8_t*>(dest);
+  const uint8x16_t c_u8x16 = vdupq_n_u8(c);
+  const size_t bulk = VectorBulkSize(n, sizeof(uint8x16_t));
+  for (size_t i = 0; i < bulk; i += sizeof(uint8x16_t)) {
+    vst1q_u8(&dest_u8[i], c_u8x16);
+  }
+  MemSetScalar(&dest_u8[bulk], c, n - bulk);
+}
+
+bool MemEqNEON(const void* s1, const void* s2, size_t n) {
+  const uint8_t* u1 = reinterpret_cast<const uint8_t*>(s1);
+  const uint8_t* u2 = reinterpret_cast<const uint8_t*>(s2);
+  const size_t bulk = VectorBulkSize(n, sizeof(uint8x16_t));
+  uint8x16_t diff = vdupq_n_u8(0);
+  for (size_t i = 0; i < bulk; i += sizeof(uint8x16_t)) {
+    diff = vorrq_u8(diff, veorq_u8(vld1q_u8(&u1[i]), vld1q_u8(&u2[i])));
+  }
+  return vmaxvq_u8(diff) == 0 && MemEqScalar(&u1[bulk], &u2[bulk], n - bulk);
+}
+
+bool MemAllEqualToNEON(const void* src, uint8_t c, size_t n) {
+  const uint8_t* src_u8 = reinterpret_cast<const uint8_t*>(src);
+  const uint8x16_t c_u8x16 = vdupq_n_u8(c);
+  const size_t bulk = VectorBulkSize(n, sizeof(uint8x16_t));
+  uint8x16_t diff = vdupq_n_u8(0);
+  for (size_t i = 0; i < bulk; i += sizeof(uint8x16_t)) {
+    diff = vorrq_u8(diff, veorq_u8(vld1q_u8(&src_u8[i]), c_u8x16));
+  }
+  return vmaxvq_u8(diff) == 0 &&
+         MemAllEqualToScalar(&src_u8[bulk], c, n - bulk);
+}
+
+#endif
+
+// Value of mem_util_impl before an implementation is selected.
+constexpr MemUtilImpl kUnselected = MemUtilImpl::kEnd;
+
+// The implementation used by MemCopy() etc.
+//
+// Normally we would use a function scope static but that does not work in
+// the nolibc environment. We do our own thread-safe lazy initialization so that
+// this code can be used both in nolibc and google3.
+std::atomic<MemUtilImpl> mem_util_impl{kUnselected};
+
+MemUtilImpl BestMemUtilImpl() {
+  for (MemUtilImpl impl :
+       {MemUtilImpl::kAVX512F, MemUtilImpl::kAVX2, MemUtilImpl::kSSE2,
+        MemUtilImpl::kNEON}) {
+    if (MemUtilImplSupported(impl)) {
+      return impl;
+    }
+  }
+  return MemUtilImpl::kScalar;
+}
+
+inline MemUtilImpl CurrentMemUtilImpl() {
+  MemUtilImpl impl = mem_util_impl.load(std::memory_order_relaxed);
+  if (impl != kUnselected) return impl;
+
+  const MemUtilImpl best_impl = BestMemUtilImpl();
+
+  // If CAS failed, impl holds the current value, which may have been set by
+  // another thread or by SetMemUtilImpl().
+  if (mem_util_impl.compare_exchange_strong(impl, best_impl)) {
+    return best_impl;
+  }
+  return impl;
+}
+
+// Ranges shorter than this are handled by the scalar code. The vector code
+// does not pay for the dispatch and the extra calls below this size.
+constexpr size_t kMinVectorSize = 64;
+
+inline MemUtilImpl MemUtilImplForSize(size_t n) {
+  return n < kMinVectorSize ? MemUtilImpl::kScalar : CurrentMemUtilImpl();
+}
+
+}  // namespace
+
+bool MemUtilImplSupported(MemUtilImpl impl) {
+  switch (impl) {
+    case MemUtilImpl::kScalar:
+      return true;
+#if defined(__x86_64__)
+    case MemUtilImpl::kSSE2:
+      return true;
+    case MemUtilImpl::kAVX2:
+      return HasAVX2Registers();
+    case MemUtilImpl::kAVX512F:
+      return HasAVX512Registers();
+#elif defined(__aarch64__)
+    case MemUtilImpl::kNEON:
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+MemUtilImpl GetMemUtilImpl() { return CurrentMemUtilImpl(); }
+
+void SetMemUtilImpl(MemUtilImpl impl) {
+  CHECK(MemUtilImplSupported(impl));
+  mem_util_impl.store(impl, std::memory_order_relaxed);
+}
+
+void MemCopy(void* dest, const void* src, size_t n) {
+  switch (MemUtilImplForSize(n)) {
+#if defined(__x86_64__)
+    case MemUtilImpl::kSSE2:
+      return MemCopySSE2(dest, src, n);
+    case MemUtilImpl::kAVX2:
+      return MemCopyBulkAndScalar<kYmmSize, MemCopyAVX2Bulk>(dest, src, n);
+    case MemUtilImpl::kAVX512F:
+      return MemCopyBulkAndScalar<kZmmSize, MemCopyAVX512FBulk>(dest, src, n);
+#elif defined(__aarch64__)
+    case MemUtilImpl::kNEON:
+      return MemCopyNEON(dest, src, n);
+#endif
+    default:
+      return MemCopyScalar(dest, src, n);
+  }
+}
+
+void MemSet(void* dest, uint8_t c, size_t n) {
+  switch (MemUtilImplForSize(n)) {
+#if defined(__x86_64__)
+    case MemUtilImpl::kSSE2:
+      return MemSetSSE2(dest, c, n);
+    case MemUtilImpl::kAVX2:
+      return MemSetBulkAndScalar<kYmmSize, MemSetAVX2Bulk>(dest, c, n);
+    case MemUtilImpl::kAVX512F:
+      return MemSetBulkAndScalar<kZmmSize, MemSetAVX512FBulk>(dest, c, n);
+#elif defined(__aarch64__)
+    case MemUtilImpl::kNEON:
+      return MemSetNEON(dest, c, n);
+#endif
+    default:
+      return MemSetScalar(dest, c, n);
+  }
+}
+
+bool MemEq(const void* s1, const void* s2, size_t n) {
+  switch (MemUtilImplForSize(n)) {
+#if defined(__x86_64__)
+    case MemUtilImpl::kSSE2:
+      return MemEqSSE2(s1, s2, n);
+    case MemUtilImpl::kAVX2:
+      return MemEqBulkAndScalar<kYmmSize, MemEqAVX2Bulk>(s1, s2, n);
+    case MemUtilImpl::kAVX512F:
+      return MemEqBulkAndScalar<kZmmSize, MemEqAVX512FBulk>(s1, s2, n);
+#elif defined(__aarch64__)
+    case MemUtilImpl::kNEON:
+      return MemEqNEON(s1, s2, n);
+#endif
+    default:
+      return MemEqScalar(s1, s2, n);
+  }
+}
+
+bool MemAllEqualTo(const void* src, uint8_t c, size_t n) {
+  switch (MemUtilImplForSize(n)) {
+#if defined(__x86_64__)
+    case MemUtilImpl::kSSE2:
+      return MemAllEqualToSSE2(src, c, n);
+    case MemUtilImpl::kAVX2:
+      return MemAllEqualToBulkAndScalar<kYmmSize, MemAllEqualToAVX2Bulk>(
+          src, c, n);
+    case MemUtilImpl::kAVX512F:
+      return MemAllEqualToBulkAndScalar<kZmmSize, MemAllEqualToAVX512FBulk>(
+          src, c, n);
+#elif defined(__aarch64__)
+    case MemUtilImpl::kNEON:
+      return MemAllEqualToNEON(src, c, n);
+#endif
+    default:
+      return MemAllEqualToScalar(src, c, n);
+  }
+}
+
 }  // namespace silifuzz
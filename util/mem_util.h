@@ -17,10 +17,19 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "./util/itoa.h"
+
 // Memory utility functions. These are similar to some functions in <cstring>
-// but are optimized for uint64_t data. On x86_64, these are compiled into
-// integer code only and do not use SSE instructions. This is done to reduce
-// perturbation to the floating pointer/vector unit between snapshot executions.
+// but are optimized for uint64_t data. They never call libc and can be used in
+// the nolibc environment.
+//
+// Each function has a scalar implementation using 64-bit integer code and
+// vector implementations that are selected at run-time, see MemUtilImpl below.
+// The snap harness on x86_64 only restores the fxsave state before running a
+// snapshot, so the vector implementations are careful about the rest: they
+// only use xmm0-xmm15 or the lower 16 ymm/zmm registers, never touch
+// zmm16-zmm31 or the opmask registers, and the AVX2 and AVX-512 ones end with
+// vzeroupper.
 
 namespace silifuzz {
 
@@ -53,6 +62,40 @@ inline bool MemEqT(const T& s1, const T& s2) {
 // Performance may degrade significantly for all other cases.
 bool MemAllEqualTo(const void* src, uint8_t c, size_t n);
 
+// Implementations of the functions above. The vector implementations process
+// the bulk of a range with unaligned vector loads and stores regardless of
+// alignment and hand the remaining bytes to the scalar implementation. Ranges
+// shorter than 64 bytes always use the scalar implementation.
+enum class MemUtilImpl {
+  kScalar = 0,  // 64-bit integer code.
+  kSSE2,        // x86_64 only.
+  kAVX2,        // x86_64 only.
+  kAVX512F,     // x86_64 only.
+  kNEON,        // aarch64 only.
+  kEnd,         // One past the last valid value.
+};
+
+// EnumStr() works for MemUtilImpl.
+template <>
+inline constexpr const char*
+    EnumNameMap<MemUtilImpl>[static_cast<int>(MemUtilImpl::kEnd)] = {
+        "Scalar", "SSE2", "AVX2", "AVX512F", "NEON",
+};
+
+// Returns true iff `impl` can be used on the current CPU.
+bool MemUtilImplSupported(MemUtilImpl impl);
+
+// Returns the implementation used by the functions above. Unless
+// SetMemUtilImpl() is called, this is the fastest implementation supported by
+// the current CPU, selected upon first use.
+MemUtilImpl GetMemUtilImpl();
+
+// Makes the functions above use `impl`. This is for tests, benchmarks and
+// for callers that want the scalar code to keep the vector unit untouched.
+//
+// REQUIRES: MemUtilImplSupported(impl).
+void SetMemUtilImpl(MemUtilImpl impl);
+
 }  // namespace silifuzz
 
 #endif  // THIRD_PARTY_SILIFUZZ_UTIL_MEM_UTIL_H_
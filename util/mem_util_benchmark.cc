@@ -21,87 +21,43 @@
 // We have no gunit benchmarking functionality in nolibc environment.
 // Hence we need to do this.
 //
-// Here is result from running it on a 2.0GHz Skylake.
+// Each function is benchmarked with every MemUtilImpl supported by the CPU,
+// at the sizes the runner typically sees: registers, small data regions and
+// pages.
 //
-// I<DATE> <PID> mem_util_benchmark.cc:307] Benchmarking MemEq
-// I<DATE> <PID> mem_util_benchmark.cc:317] 16B : 4948 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 256B : 27627 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 4096B : 36567 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 65536B : 39640 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 1048576B : 39759 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:307] Benchmarking bcmp
-// I<DATE> <PID> mem_util_benchmark.cc:317] 16B : 1705 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 256B : 1942 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 4096B : 2055 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 65536B : 2074 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 1048576B : 2071 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:307] Benchmarking MemEqSSE
-// I<DATE> <PID> mem_util_benchmark.cc:317] 16B : 6804 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 256B : 32070 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 4096B : 37148 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 65536B : 39668 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 1048576B : 39901 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:307] Benchmarking MemEqAVX512F
-// I<DATE> <PID> mem_util_benchmark.cc:317] 16B : 4999 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 256B : 66726 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 4096B : 98419 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 65536B : 99548 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 1048576B : 88612 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:307] Benchmarking MemCopy
-// I<DATE> <PID> mem_util_benchmark.cc:317] 16B : 4158 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 256B : 32667 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 4096B : 44138 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 65536B : 37012 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 1048576B : 32882 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:307] Benchmarking MemCopyAVX512F
-// I<DATE> <PID> mem_util_benchmark.cc:317] 16B : 5457 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 256B : 51237 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 4096B : 84638 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 65536B : 43387 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 1048576B : 35165 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:307] Benchmarking memcpy
-// I<DATE> <PID> mem_util_benchmark.cc:317] 16B : 4541 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 256B : 33758 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 4096B : 46035 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 65536B : 37700 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 1048576B : 32881 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:307] Benchmarking MemSet
-// I<DATE> <PID> mem_util_benchmark.cc:317] 16B : 5458 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 256B : 43675 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 4096B : 48823 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 65536B : 35159 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 1048576B : 32853 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:307] Benchmarking MemSetAVX512F
-// I<DATE> <PID> mem_util_benchmark.cc:317] 16B : 5510 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 256B : 54429 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 4096B : 84500 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 65536B : 43412 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 1048576B : 33149 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:307] Benchmarking memset
-// I<DATE> <PID> mem_util_benchmark.cc:317] 16B : 4889 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 256B : 31370 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 4096B : 45330 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 65536B : 33595 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 1048576B : 32885 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:307] Benchmarking MemAllEqualTo
-// I<DATE> <PID> mem_util_benchmark.cc:317] 16B : 3839 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 256B : 29551 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 4096B : 40534 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 65536B : 44601 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 1048576B : 35512 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:307] Benchmarking MemAllEqualToZero
-// I<DATE> <PID> mem_util_benchmark.cc:317] 16B : 4953 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 256B : 37840 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 4096B : 48527 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 65536B : 47900 MiB/s
-// I<DATE> <PID> mem_util_benchmark.cc:317] 1048576B : 37038 MiB/s
+// Here is result from running it on a single-core Xeon VM with AVX-512.
+// Numbers are in MiB/s and noisy. All implementations use the scalar code
+// below 64B.
+//
+//   function          impl       16B    64B   256B   512B   4KiB  64KiB   1MiB
+//   MemEq             Scalar    3872   6811  13667  11350  17408  19549  19278
+//   MemEq             SSE2      2854   6248  12930  22117  26432  23003  25996
+//   MemEq             AVX2      3233   6599  19062  31484  37255  31260  28981
+//   MemEq             AVX512F   2239   6190  16793  25052  51077  34987  33654
+//   MemCopy           Scalar    3755   6648  10788  11406  15535  15382  19591
+//   MemCopy           SSE2      3684   6751  20209  20687  27346  25111  27839
+//   MemCopy           AVX2      3635   8901  20605  26970  35510  25202  29498
+//   MemCopy           AVX512F   3023   8078  21224  39068  53853  25090  21665
+//   MemSet            Scalar    3405   6205  11897  15378  17643  16155  16501
+//   MemSet            SSE2      3536   7438  15969  24493  32140  24087  21166
+//   MemSet            AVX2      3333   8485  18827  26640  38135  23407  24530
+//   MemSet            AVX512F   2370   6014  20698  42405  54267  29086  30889
+//   MemAllEqualTo     Scalar    2153   4649   8370  12512  10835  11050  11698
+//   MemAllEqualTo     SSE2      2936   5462  14437  23176  29928  38462  33025
+//   MemAllEqualTo     AVX2      3002   8154  21550  26521  38202  34849  42401
+//   MemAllEqualTo     AVX512F   2945   7152  18206  39350  61990  45684  44738
+//   MemAllEqualToZero Scalar    3393   6649  10830  11401  15284  10817  10955
+//   MemAllEqualToZero SSE2      2940   6911  19381  24525  24119  36821  33903
+//   MemAllEqualToZero AVX2      3298   8668  21446  29522  60758  41633  35023
+//   MemAllEqualToZero AVX512F   2660   7108  20940  32980  77929  53049  51723
+//   bcmp              libc      2300   8388  23889  33258  47667  38732  35493
+//   memcpy            libc      2091  11174  29515  47981  91008  37168  34946
+//   memset            libc      2764  11161  35856  56369  94817  32564  33391
 
 //
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
-#ifdef __x86_64__
-#include <immintrin.h>
-#endif
 
 #include "third_party/lss/lss/linux_syscall_support.h"
 #include "./util/checks.h"
@@ -109,15 +65,6 @@
 #include "./util/math.h"
 #include "./util/mem_util.h"
 
-#ifdef __x86_64__
-#include "./util/avx.h"
-
-// This file is compiled with "-mno-sse" by default. So we have to force
-// AVX512F target via a function attribute.
-#define AVX512F_FUNCTION __attribute__((target("avx512f")))
-
-#endif
-
 namespace silifuzz {
 namespace {
 
@@ -137,105 +84,6 @@ bool BcmpAdaptor(const void* s1, const void* s2, size_t n) {
   return bcmp(s1, s2, n) == 0;
 }
 
-#ifdef __x86_64__
-// A faster version of MemEq using SSE. This is not used for the time being
-// as SSE usage is considered not desirable. Not having SSE will make a Snapshot
-// player more sensitive to some bugs as the player itself does not perturb SSE
-// state.
-bool MemEqSSE(const void* s1, const void* s2, size_t n) {
-  CHECK_EQ(reinterpret_cast<uintptr_t>(s1) % sizeof(uint64_t), 0);
-  CHECK_EQ(reinterpret_cast<uintptr_t>(s2) % sizeof(uint64_t), 0);
-  CHECK_EQ(n % sizeof(uint64_t), 0);
-  size_t num_u64s = n / sizeof(uint64_t);
-  const uint64_t* u1 = reinterpret_cast<const uint64_t*>(s1);
-  const uint64_t* u2 = reinterpret_cast<const uint64_t*>(s2);
-  uint64_t diff_bits = 0;
-  for (size_t i = 0; i < num_u64s; ++i) {
-    diff_bits |= u1[i] ^ u2[i];
-  }
-  return diff_bits == 0;
-}
-
-AVX512F_FUNCTION void MemCopyAVX512F(void* dest, const void* src, size_t n) {
-  // Optimize only if n is 8-byte aligned.
-  uint8_t* dest_u8 = reinterpret_cast<uint8_t*>(dest);
-  const uint8_t* src_u8 = reinterpret_cast<const uint8_t*>(src);
-  if (n % sizeof(uint64_t) != 0) {
-    for (size_t i = 0; i < n; ++i) {
-      dest_u8[i] = src_u8[i];
-    }
-    return;
-  }
-
-  size_t i;
-  for (i = 0; i < n; i += sizeof(__m512i)) {
-    _mm512_storeu_epi64(&dest_u8[i], _mm512_loadu_epi64(&src_u8[i]));
-  }
-
-  if (i < n) {
-    const size_t remaining_u64s = (n - i) / sizeof(uint64_t);
-    const __mmask16 mask = _cvtu32_mask16((1 << remaining_u64s) - 1);
-    _mm512_mask_storeu_epi64(&dest_u8[i], mask, _mm512_loadu_epi64(&src_u8[i]));
-  }
-}
-
-AVX512F_FUNCTION void MemSetAVX512F(void* dest, uint8_t c, size_t n)
-    __attribute__((no_builtin("memset"))) /* see MemCopy() above */ {
-  uint8_t* dest_u8 = reinterpret_cast<uint8_t*>(dest);
-  // Optimize only if n is both 8-byte aligned.
-  if (n % sizeof(uint64_t) != 0) {
-    for (size_t i = 0; i < n; ++i) {
-      dest_u8[i] = c;
-    }
-    return;
-  }
-
-  const __m512i c_m512i = _mm512_set1_epi8(c);
-  size_t i;
-  for (i = 0; i < n; i += sizeof(__m512i)) {
-    _mm512_storeu_epi64(&dest_u8[i], c_m512i);
-  }
-
-  if (i < n) {
-    const size_t remaining_u64s = (n - i) / sizeof(uint64_t);
-    const __mmask16 mask = _cvtu32_mask16((1 << remaining_u64s) - 1);
-    _mm512_mask_storeu_epi64(&dest_u8[i], mask, c_m512i);
-  }
-}
-
-AVX512F_FUNCTION bool MemEqAVX512F(const void* s1, const void* s2, size_t n)
-    __attribute__((no_builtin("memcmp"))) {
-  // Optimize only if n is 8-byte aligned.
-  if (n % sizeof(uint64_t) != 0) {
-    return bcmp(s1, s2, n) == 0;
-  }
-  const char* char_ptr1 = reinterpret_cast<const char*>(s1);
-  const char* char_ptr2 = reinterpret_cast<const char*>(s2);
-
-  // Accumulate XOR differences. diff is non-zero is there are any pairs of
-  // different corresponding bits in s1 and s2.
-  const __m512i kZeros = _mm512_setzero_epi32();
-  __m512i diff = kZeros;
-
-  size_t i;
-  for (i = 0; i < n; i += sizeof(__m512i)) {
-    diff = _mm512_or_epi64(diff,
-                           _mm512_xor_epi64(_mm512_loadu_epi64(&char_ptr1[i]),
-                                            _mm512_loadu_epi64(&char_ptr2[i])));
-  }
-
-  if (i < n) {
-    const size_t remaining_epi64s = (n - i) / sizeof(uint64_t);
-    const __mmask16 mask = _cvtu32_mask16((1L << remaining_epi64s) - 1);
-    const __m512i remainder1 = _mm512_maskz_loadu_epi64(mask, &char_ptr1[i]);
-    const __m512i remainder2 = _mm512_maskz_loadu_epi64(mask, &char_ptr2[i]);
-    diff = _mm512_or_epi64(diff, _mm512_xor_epi64(remainder1, remainder2));
-  }
-
-  return _mm512_cmpeq_epi64_mask(diff, kZeros) == static_cast<__mmask8>(~0);
-}
-#endif
-
 void MemcpyAdaptor(void* dest, const void* src, size_t n) {
   memcpy(dest, src, n);
 }
@@ -292,15 +140,20 @@ inline uint64_t MeasureBandwidth(void (*do_one_iteration)(MemoryCompareFunc,
                                benchmarks_elapsed_secs);
 }
 
+// `impl_name` tells which implementation of `func_name` is benchmarked.
 template <typename MemoryCompareFunc>
 void RunBenchmark(void (*do_one_iteration)(MemoryCompareFunc, size_t),
-                  const char* func_name, MemoryCompareFunc func,
-                  bool should_memset = false, uint8_t memset_value = 0) {
-  constexpr size_t kTestSizes[] = {(1 << 4), (1 << 8), (1 << 12), (1 << 16),
+                  const char* func_name, const char* impl_name,
+                  MemoryCompareFunc func, bool should_memset = false,
+                  uint8_t memset_value = 0) {
+  // Small data regions, general registers (~200B), fxsave area (512B), a page,
+  // a large data region and a large one that does not fit in L1/L2 caches.
+  constexpr size_t kTestSizes[] = {(1 << 4), (1 << 6),  (1 << 8),
+                                   (1 << 9), (1 << 12), (1 << 16),
                                    (1 << 20)};
   constexpr size_t kNumTestSizes = sizeof(kTestSizes) / sizeof(kTestSizes[0]);
 
-  LOG_INFO("Benchmarking ", func_name);
+  LOG_INFO("Benchmarking ", func_name, " (", impl_name, ")");
   for (int i = 0; i < kNumTestSizes; ++i) {
     const size_t size = kTestSizes[i];
     if (should_memset) {
@@ -343,48 +196,50 @@ void AllEqualToZeroOneIteration(MemoryAllEqualToFunc func, size_t size) {
   func(test_buffer_1, 0, size);
 }
 
-int BenchmarkMain() {
+// Benchmarks the mem_util functions using the current MemUtilImpl.
+void BenchmarkMemUtil() {
+  const char* impl_name = EnumStr(GetMemUtilImpl());
+
   // Measures bandwidth in byte pairs compared per second for a memory
   // comparison function. The actual memory bandwidth is about double of that
   // because we need to read from two memory ranges.
-  RunBenchmark(CompareOneIteration, "MemEq", MemEq);
-  RunBenchmark(CompareOneIteration, "bcmp", BcmpAdaptor);
-#ifdef __x86_64__
-  RunBenchmark(CompareOneIteration, "MemEqSSE", MemEqSSE);
-  if (HasAVX512Registers()) {
-    RunBenchmark(CompareOneIteration, "MemEqAVX512F", MemEqAVX512F);
-  }
-#endif
+  RunBenchmark(CompareOneIteration, "MemEq", impl_name, MemEq);
 
   // Measures bandwidth in bytes copied per second for a memory copying
   // function. The raw memory bandwidth is about double of that because we need
   // to access two memory ranges for each byte copied.
-  RunBenchmark(CopyOneIteration, "MemCopy", MemCopy);
-#ifdef __x86_64__
-  if (HasAVX512Registers()) {
-    RunBenchmark(CopyOneIteration, "MemCopyAVX512F", MemCopyAVX512F);
-  }
-#endif
-  RunBenchmark(CopyOneIteration, "memcpy", MemcpyAdaptor);
+  RunBenchmark(CopyOneIteration, "MemCopy", impl_name, MemCopy);
 
   // Measures bandwidth in bytes set per second for a memory setting function.
-  RunBenchmark(SetOneIteration, "MemSet", MemSet);
-#ifdef __x86_64__
-  if (HasAVX512Registers()) {
-    RunBenchmark(SetOneIteration, "MemSetAVX512F", MemSetAVX512F);
-  }
-#endif
-  RunBenchmark(SetOneIteration, "memset", NolibcMemsetAdaptor);
+  RunBenchmark(SetOneIteration, "MemSet", impl_name, MemSet);
 
   // Measures bandwidth in bytes processed per second for a memory all equal to
   // function.
-  RunBenchmark(AllEqualToNonZeroOneIteration, "MemAllEqualTo", MemAllEqualTo,
-               /*should_memset=*/true, /*memset_value=*/1);
+  RunBenchmark(AllEqualToNonZeroOneIteration, "MemAllEqualTo", impl_name,
+               MemAllEqualTo, /*should_memset=*/true, /*memset_value=*/1);
 
   // Measures bandwidth in bytes processed per second for a memory all equal to
   // function for the special case of 0.
-  RunBenchmark(AllEqualToZeroOneIteration, "MemAllEqualToZero", MemAllEqualTo,
-               /*should_memset=*/true, /*memset_value=*/0);
+  RunBenchmark(AllEqualToZeroOneIteration, "MemAllEqualToZero", impl_name,
+               MemAllEqualTo, /*should_memset=*/true, /*memset_value=*/0);
+}
+
+int BenchmarkMain() {
+  const MemUtilImpl default_impl = GetMemUtilImpl();
+  LOG_INFO("Default implementation is ", EnumStr(default_impl));
+  for (int i = 0; i < static_cast<int>(MemUtilImpl::kEnd); ++i) {
+    const MemUtilImpl impl = static_cast<MemUtilImpl>(i);
+    if (MemUtilImplSupported(impl)) {
+      SetMemUtilImpl(impl);
+      BenchmarkMemUtil();
+    }
+  }
+  SetMemUtilImpl(default_impl);
+
+  // The libc functions for reference.
+  RunBenchmark(CompareOneIteration, "bcmp", "libc", BcmpAdaptor);
+  RunBenchmark(CopyOneIteration, "memcpy", "libc", MemcpyAdaptor);
+  RunBenchmark(SetOneIteration, "memset", "libc", NolibcMemsetAdaptor);
 
   return 0;
 }
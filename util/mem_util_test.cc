@@ -14,6 +14,7 @@
 
 #include "./util/mem_util.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 
@@ -233,6 +234,146 @@ TEST(MemAllEqualTo, BasicTest) {
   }
 }
 
+// Runs `test` with every implementation supported by the current CPU. The
+// implementation in use before the call is restored afterwards.
+template <typename Test>
+void ForEachSupportedImpl(Test test) {
+  const MemUtilImpl original_impl = GetMemUtilImpl();
+  for (int i = 0; i < static_cast<int>(MemUtilImpl::kEnd); ++i) {
+    const MemUtilImpl impl = static_cast<MemUtilImpl>(i);
+    if (MemUtilImplSupported(impl)) {
+      SetMemUtilImpl(impl);
+      test();
+    }
+  }
+  SetMemUtilImpl(original_impl);
+}
+
+TEST(MemUtilImpl, Selection) {
+  CHECK(MemUtilImplSupported(MemUtilImpl::kScalar));
+  CHECK(MemUtilImplSupported(GetMemUtilImpl()));
+#if defined(__x86_64__)
+  CHECK(MemUtilImplSupported(MemUtilImpl::kSSE2));
+  CHECK(!MemUtilImplSupported(MemUtilImpl::kNEON));
+#elif defined(__aarch64__)
+  CHECK(MemUtilImplSupported(MemUtilImpl::kNEON));
+  CHECK(!MemUtilImplSupported(MemUtilImpl::kSSE2));
+#endif
+}
+
+// Checks all implementations with sizes covering several vectors of each
+// width and every alignment, so that both the vector bulk and the scalar rest
+// of a range are exercised.
+TEST(MemUtilImpl, AllImplementations) {
+  constexpr size_t kMaxSize = 3 * 64 + 2 * sizeof(uint64_t) + 1;
+  constexpr uint8_t kGuard = 0x55;
+  constexpr uint8_t kData = 0xa5;
+  alignas(64) uint8_t src[kMaxSize + 2 * sizeof(uint64_t)];
+  alignas(64) uint8_t dest[kMaxSize + 2 * sizeof(uint64_t)];
+  for (size_t i = 0; i < sizeof(src); ++i) {
+    src[i] = i * 7 + 1;
+  }
+
+  ForEachSupportedImpl([&]() {
+    for (size_t offset = 0; offset < sizeof(uint64_t); ++offset) {
+      for (size_t size = 0; size <= kMaxSize; ++size) {
+        const uint8_t* s = &src[offset];
+        uint8_t* d = &dest[offset + 1];
+        for (size_t i = 0; i < sizeof(dest); ++i) {
+          dest[i] = kGuard;
+        }
+
+        MemCopy(d, s, size);
+        CHECK_EQ(d[-1], kGuard);
+        CHECK_EQ(d[size], kGuard);
+        for (size_t i = 0; i < size; ++i) {
+          CHECK_EQ(d[i], s[i]);
+        }
+        CHECK(MemEq(d, s, size));
+
+        // Flip bytes in the first vector, in the middle and in the scalar
+        // rest of the range.
+        for (size_t pos : {size_t{0}, size / 2, size - 1}) {
+          if (pos < size) {
+            d[pos] ^= 0xff;
+            CHECK(!MemEq(d, s, size));
+            d[pos] ^= 0xff;
+          }
+        }
+
+        MemSet(d, kData, size);
+        CHECK_EQ(d[-1], kGuard);
+        CHECK_EQ(d[size], kGuard);
+        CHECK(MemAllEqualTo(d, kData, size));
+        for (size_t pos : {size_t{0}, size / 2, size - 1}) {
+          if (pos < size) {
+            d[pos] ^= 0xff;
+            CHECK(!MemAllEqualTo(d, kData, size));
+            d[pos] ^= 0xff;
+          }
+        }
+
+        MemSet(d, 0, size);
+        CHECK(MemAllEqualTo(d, 0, size));
+        CHECK_EQ(MemAllEqualTo(d, kData, size), size == 0);
+      }
+    }
+  });
+}
+
+#if defined(__x86_64__)
+// Fills zmm16 and opmask register k1 with `value`.
+__attribute__((target("avx512f"))) void SetAVX512OnlyState(uint64_t value) {
+  asm volatile(
+      "vpbroadcastq %[value], %%zmm16\n"
+      "kmovw %k[value], %%k1\n"
+      :
+      : [value] "r"(value)
+      : "xmm16", "k1");
+}
+
+// Returns true iff zmm16 and k1 still hold what SetAVX512OnlyState() put there.
+__attribute__((target("avx512f"))) bool AVX512OnlyStateIs(uint64_t value) {
+  uint64_t zmm16[8];
+  uint32_t k1;
+  asm volatile(
+      "vmovdqu64 %%zmm16, %[zmm16]\n"
+      "kmovw %%k1, %[k1]\n"
+      : [zmm16] "=m"(zmm16), [k1] "=r"(k1));
+  for (size_t i = 0; i < 8; ++i) {
+    if (zmm16[i] != value) {
+      return false;
+    }
+  }
+  return k1 == (value & 0xffff);
+}
+
+// The snap harness does not restore AVX-512 only state before running a
+// snapshot, so the AVX-512 implementation must not touch it.
+TEST(MemUtilImpl, AVX512FPreservesAVX512OnlyState) {
+  if (!MemUtilImplSupported(MemUtilImpl::kAVX512F)) {
+    SILIFUZZ_TEST_SKIP();
+  }
+  const MemUtilImpl original_impl = GetMemUtilImpl();
+  SetMemUtilImpl(MemUtilImpl::kAVX512F);
+
+  constexpr size_t kSize = 4 * 64;
+  alignas(64) uint8_t buffer1[kSize];
+  alignas(64) uint8_t buffer2[kSize];
+  constexpr uint64_t kPattern = 0x0123456789abcdefULL;
+  SetAVX512OnlyState(kPattern);
+  MemSet(buffer1, 1, kSize);
+  MemCopy(buffer2, buffer1, kSize);
+  const bool equal = MemEq(buffer1, buffer2, kSize);
+  const bool all_equal = MemAllEqualTo(buffer1, 1, kSize);
+  CHECK(AVX512OnlyStateIs(kPattern));
+  CHECK(equal);
+  CHECK(all_equal);
+
+  SetMemUtilImpl(original_impl);
+}
+#endif
+
 }  // namespace
 }  // namespace silifuzz
 
@@ -244,4 +385,9 @@ NOLIBC_TEST_MAIN({
   RUN_TEST(MemCopy, BasicTest);
   RUN_TEST(MemSet, BasicTest);
   RUN_TEST(MemAllEqualTo, BasicTest);
+  RUN_TEST(MemUtilImpl, Selection);
+  RUN_TEST(MemUtilImpl, AllImplementations);
+#if defined(__x86_64__)
+  RUN_TEST(MemUtilImpl, AVX512FPreservesAVX512OnlyState);
+#endif
 })
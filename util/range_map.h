@@ -22,6 +22,7 @@
 #include <iostream>  // for ostream; NOLINT
 #include <iterator>
 #include <map>
+#include <optional>
 #include <type_traits>
 #include <utility>  // for pair<>
 
@@ -121,9 +122,33 @@ namespace silifuzz {
 //   static void Methods::MakeDifference(Value* dest, const Value& v1,
 //                                       const Value& v2, bool* empty);
 //
+//   // Optional. The ordered map used to store the ranges, std::map<> if not
+//   // defined. It needs the std::map<> interface, but its iterators may be
+//   // invalidated by insertion and erasure, so absl::btree_map<> works too.
+//   // A B-tree stores many small ranges per node, which makes iteration
+//   // more cache-friendly; see range_map_benchmarks.cc for the trade-offs.
+//   template <typename K, typename V, typename C>
+//   using Rep = absl::btree_map<K, V, C>;
+//
 // RangeMap<> is not thread-safe.
-// TODO(ksteuck): [design] Maybe should allow callers to specify what to use
-// instead of current map<> as the representation.
+
+namespace range_map_internal {
+
+// Picks Methods::Rep<> if Methods defines it and std::map<> otherwise.
+template <typename Methods, typename K, typename V, typename C,
+          typename = void>
+struct MapRepOf {
+  using type = std::map<K, V, C>;
+};
+
+template <typename Methods, typename K, typename V, typename C>
+struct MapRepOf<Methods, K, V, C,
+                std::void_t<typename Methods::template Rep<K, V, C>>> {
+  using type = typename Methods::template Rep<K, V, C>;
+};
+
+}  // namespace range_map_internal
+
 template<typename Key, typename Value, typename MethodsArg>
 class RangeMap {
  public:
@@ -158,7 +183,8 @@ class RangeMap {
 
   // The following typedefs should not be used outside of this file. Sorry.
   typedef key_type KeyRange;
-  typedef std::map<KeyRange, Value, key_compare> MapRep;
+  typedef typename range_map_internal::MapRepOf<Methods, KeyRange, Value,
+                                                key_compare>::type MapRep;
   typedef typename MapRep::iterator IterRep;
   typedef typename MapRep::const_iterator ConstIterRep;
 
@@ -634,6 +660,18 @@ class RangeMap {
   // is_same is true if ValueX is the same type as Value.
   template<typename ValueX, bool is_same> struct Convertor;
 
+  // Inserts [start, limit)->value right before *iter and makes iter point
+  // after it. Insertion may invalidate other iterators of MapRep, but not the
+  // one it returns, so iter is recomputed from that.
+  template <typename ValueT>
+  void InsertBefore(IterRep& iter, const Key& start, const Key& limit,
+                    ValueT&& value, Size* usage) {
+    IterRep n = map_.emplace_hint(iter, KeyRange(start, limit),
+                                  std::forward<ValueT>(value));
+    AddUsage(n, usage);
+    iter = std::next(n);
+  }
+
   // Helpers to adding/subtracting from *usage.
   void AddUsage(const IterRep& iter, Size* usage) {
     if (usage) *usage += Methods::Usage(&(*iter));
@@ -700,101 +738,73 @@ bool RangeMap<Key, Value, Methods>::Change(const Key& start, const Key& limit,
   const Value& value =
       Convertor<ValueX, std::is_same<ValueX, Value>::value>::Convert(value_x);
   bool result = mode == kRemove;
-  IteratorRange range = Find(start, limit);
+  // Iterators of MapRep may be invalidated by insertion and erasure, so `i` is
+  // always set from what those return. See InsertBefore().
+  IterRep i = LowerBound(start).rep_;
   Key prev_start = start;
-  for (iterator i(range.first); i != range.second;) {
-    // Split up the range behind i as affected by this Change():
-    int s = Methods::Compare(prev_start, i.start());
-    int l = Methods::Compare(limit, i.limit());
-    if (s < 0) {  // we start before *i
+  while (i != map_.end() && Methods::Compare(i->first.first, limit) < 0) {
+    const Key i_start = i->first.first;
+    const Key i_limit = i->first.second;
+    if (Methods::Compare(prev_start, i_start) < 0) {  // gap before *i
       if (mode == kAdd) {
-        auto v = Methods::Slice(start, limit, value, prev_start, i.start());
-        IterRep n =
-            map_.emplace(KeyRange(prev_start, i.start()), std::move(v)).first;
-        AddUsage(n, usage);
+        auto v = Methods::Slice(start, limit, value, prev_start, i_start);
+        InsertBefore(i, prev_start, i_start, std::move(v), usage);
         result = true;
       } else {
         result = false;
       }
     }
-    prev_start = i.limit();
+    prev_start = i_limit;
+    int s = Methods::Compare(start, i_start);
+    int l = Methods::Compare(limit, i_limit);
     if (s <= 0 && l >= 0) {  // new range covers all of *i
-      SubUsage(i.rep_, usage);
-      auto v = Methods::Slice(start, limit, value, i.start(), i.limit());
-      if (!ChangeValue(i.mutable_value(), std::move(v), mode, &result)) {
-        IterRep n = i.rep_;
-        ++i;
-        map_.erase(n);
-        continue;
-      }
-      AddUsage(i.rep_, usage);
-    } else if (s <= 0 && l < 0) {  // new range covers a prefix of *i
-      auto i_v1 =
-          Methods::Slice(i.start(), i.limit(), i.value(), i.start(), limit);
-      IterRep n =
-          map_.emplace(KeyRange(i.start(), limit), std::move(i_v1)).first;
-      auto v = Methods::Slice(start, limit, value, i.start(), limit);
-      if (!ChangeValue(&n->second, std::move(v), mode, &result)) {
-        map_.erase(n);
+      SubUsage(i, usage);
+      auto v = Methods::Slice(start, limit, value, i_start, i_limit);
+      if (!ChangeValue(&i->second, std::move(v), mode, &result)) {
+        i = map_.erase(i);
       } else {
-        AddUsage(n, usage);
+        AddUsage(i, usage);
+        ++i;
       }
-      auto i_v2 =
-          Methods::Slice(i.start(), i.limit(), i.value(), limit, i.limit());
-      n = map_.emplace(KeyRange(limit, i.limit()), std::move(i_v2)).first;
-      AddUsage(n, usage);
-      SubUsage(i.rep_, usage);
-      map_.erase(i.rep_);
-      i.rep_ = n;
-    } else if (s > 0 && l < 0) {  // new range covers a subrange of *i
-      auto i_v1 =
-          Methods::Slice(i.start(), i.limit(), i.value(), i.start(), start);
-      IterRep n =
-          map_.emplace(KeyRange(i.start(), start), std::move(i_v1)).first;
-      AddUsage(n, usage);
-      auto i_v2 = Methods::Slice(i.start(), i.limit(), i.value(), start, limit);
-      n = map_.emplace(KeyRange(start, limit), std::move(i_v2)).first;
+      continue;
+    }
+    // New range covers a prefix, a suffix or a subrange of *i: replace *i
+    // with its part before [lo, hi), [lo, hi) itself and its part after.
+    const Key lo = s > 0 ? start : i_start;
+    const Key hi = l < 0 ? limit : i_limit;
+    std::optional<Value> head;
+    if (s > 0) {
+      head.emplace(Methods::Slice(i_start, i_limit, i->second, i_start, lo));
+    }
+    Value middle = Methods::Slice(i_start, i_limit, i->second, lo, hi);
+    std::optional<Value> tail;
+    if (l < 0) {
+      tail.emplace(Methods::Slice(i_start, i_limit, i->second, hi, i_limit));
+    }
+    SubUsage(i, usage);
+    i = map_.erase(i);
+    if (head.has_value()) {
+      InsertBefore(i, i_start, lo, *std::move(head), usage);
+    }
+    bool keep;
+    if (s > 0 && l < 0) {
       // [start, limit) range, so no need to Methods::Slice() for `value`:
-      if (!ChangeValue(&n->second, value, mode, &result)) {
-        map_.erase(n);
-      } else {
-        AddUsage(n, usage);
-      }
-      auto i_v3 =
-          Methods::Slice(i.start(), i.limit(), i.value(), limit, i.limit());
-      n = map_.emplace(KeyRange(limit, i.limit()), i_v3).first;
-      AddUsage(n, usage);
-      SubUsage(i.rep_, usage);
-      map_.erase(i.rep_);
-      i.rep_ = n;
-    } else if (s > 0 && l >= 0) {  // new range covers a suffix of *i
-      auto i_v1 =
-          Methods::Slice(i.start(), i.limit(), i.value(), i.start(), start);
-      IterRep n0 =
-          map_.emplace(KeyRange(i.start(), start), std::move(i_v1)).first;
-      AddUsage(n0, usage);
-      auto i_v2 =
-          Methods::Slice(i.start(), i.limit(), i.value(), start, i.limit());
-      IterRep n =
-          map_.emplace(KeyRange(start, i.limit()), std::move(i_v2)).first;
-      auto v = Methods::Slice(start, limit, value, start, i.limit());
-      if (!ChangeValue(&n->second, std::move(v), mode, &result)) {
-        map_.erase(n);
-        n = n0;
-      } else {
-        AddUsage(n, usage);
-      }
-      SubUsage(i.rep_, usage);
-      map_.erase(i.rep_);
-      i.rep_ = n;
+      keep = ChangeValue(&middle, value, mode, &result);
+    } else {
+      keep = ChangeValue(&middle, Methods::Slice(start, limit, value, lo, hi),
+                         mode, &result);
+    }
+    if (keep) {
+      InsertBefore(i, lo, hi, std::move(middle), usage);
+    }
+    if (tail.has_value()) {
+      InsertBefore(i, hi, i_limit, *std::move(tail), usage);
     }
-    ++i;
   }
   if (Methods::Compare(prev_start, limit) < 0) {
     if (mode == kAdd) {
       auto v = Methods::Slice(start, limit, value, prev_start, limit);
-      IterRep n = map_.emplace(KeyRange(prev_start, limit), std::move(v)).first;
-      AddUsage(n, usage);
+      InsertBefore(i, prev_start, limit, std::move(v), usage);
       result = true;
     } else {
       result = false;
@@ -823,9 +833,7 @@ bool RangeMap<Key, Value, Methods>::ChangeEach(
     auto v = Methods::Slice(start, limit, value, iterator(i).start(),
                             iterator(i).limit());
     if (!ChangeValue(&i->second, std::move(v), mode, &result)) {
-      IterRep c = i;
-      ++i;
-      map_.erase(c);
+      i = map_.erase(i);
     } else {
       AddUsage(i, usage);
       ++i;
@@ -872,15 +880,20 @@ bool RangeMap<Key, Value, Methods>::ChangeRangeMap(
 
 template<typename Key, typename Value, typename Methods>
 void RangeMap<Key, Value, Methods>::Merge(IteratorRange range, Size* usage) {
-  if (range.second != end()) ++range.second;  // to merge with what's after
+  // Erasing may invalidate iterators of MapRep, so the last range to merge
+  // with, the one after `range`, is remembered by its start.
+  std::optional<Key> last_start;
+  if (range.second != end()) last_start = range.second.start();
   IterRep prev = range.first.rep_;
   if (range.first != begin()) {
     --prev;  // to merge with what's before
-  } else {
-    if (range.first == range.second) return;  // no pairs to merge
-    ++range.first;
+  } else if (range.first == range.second) {
+    return;  // no pairs to merge
   }
-  for (IterRep iter = range.first.rep_; iter != range.second.rep_; ++iter) {
+  IterRep iter = std::next(prev);
+  while (iter != map_.end() &&
+         (!last_start.has_value() ||
+          Methods::Compare(iter->first.first, *last_start) <= 0)) {
     // Loop invariant: ++prev == iter.
     if (Methods::Compare(prev->first.second, iter->first.first) == 0 &&
         Methods::CanMerge(prev->second, iter->second)) {
@@ -888,13 +901,14 @@ void RangeMap<Key, Value, Methods>::Merge(IteratorRange range, Size* usage) {
       SubUsage(iter, usage);
       Methods::Merge(&(prev->second), iter->second);
       Key new_limit = iter->first.second;
-      map_.erase(iter);
+      iter = map_.erase(iter);
+      prev = std::prev(iter);
       // This mutation does not change the ordering of prev in map_, so is safe.
       const_cast<key_type&>(prev->first).second = new_limit;
       AddUsage(prev, usage);
-      iter = prev;
     } else {
       prev = iter;
+      ++iter;
     }
   }
 }
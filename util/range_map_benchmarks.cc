@@ -0,0 +1,223 @@
+// Copyright 2025 The SiliFuzz Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks for RangeMap<> with its std::map<> and B-tree representations.
+// The workloads mirror range_map_test.cc and SnapshotGroup: many page-sized
+// ranges of small permission-like values.
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/container/btree_map.h"
+#include "absl/random/random.h"
+#include "./util/range_map.h"
+
+namespace silifuzz {
+namespace {
+
+// Maps address ranges to permission-like bit sets, like MemoryPermsMethods.
+class BitsMethods {
+ public:
+  using Key = uint64_t;
+  using Value = uint32_t;
+  using Size = int;
+
+  static int Compare(const Key& x, const Key& y) {
+    return x == y ? 0 : (x < y ? -1 : 1);
+  }
+
+  static Size Usage(const std::pair<const std::pair<Key, Key>, Value>* range) {
+    return sizeof(*range);
+  }
+
+  static const Value& Slice(const Key& start, const Key& limit,
+                            const Value& v, const Key& s, const Key& l) {
+    return v;
+  }
+
+  static bool AddTo(Value* dest, const Value& v, bool* empty) {
+    Value prev = *dest;
+    *dest |= v;
+    *empty = *dest == 0;
+    return *dest != prev;
+  }
+
+  static bool RemoveFrom(Value* dest, const Value& v, bool* empty) {
+    Value prev = *dest;
+    *dest &= ~v;
+    *empty = *dest == 0;
+    return *dest != prev;
+  }
+
+  static bool CanMerge(const Value& v1, const Value& v2) { return v1 == v2; }
+
+  static void Merge(Value* dest, const Value& v) {}
+
+  static void MakeIntersection(Value* dest, const Value& v1, const Value& v2,
+                               bool* empty) {
+    *dest = v1 & v2;
+    *empty = *dest == 0;
+  }
+
+  static void MakeDifference(Value* dest, const Value& v1, const Value& v2,
+                             bool* empty) {
+    *dest = v1 & ~v2;
+    *empty = *dest == 0;
+  }
+};
+
+// Same as BitsMethods, but stores the ranges in a B-tree.
+class BTreeBitsMethods : public BitsMethods {
+ public:
+  template <typename K, typename V, typename C>
+  using Rep = absl::btree_map<K, V, C>;
+};
+
+template <typename Methods>
+using BitsMap =
+    RangeMap<typename Methods::Key, typename Methods::Value, Methods>;
+
+constexpr uint64_t kPageSize = 4096;
+
+struct Range {
+  uint64_t start;
+  uint64_t limit;
+  uint32_t value;
+};
+
+// Returns `n` ranges of 1 to 4 pages in random order. Neighbouring ranges are
+// often adjacent and sometimes have the same value, so some of them merge.
+std::vector<Range> RandomRanges(int n, uint64_t seed) {
+  absl::SeedSeq seq({seed});
+  absl::BitGen random(seq);
+  std::vector<Range> ranges;
+  uint64_t start = 0;
+  for (int i = 0; i < n; ++i) {
+    start += kPageSize * absl::Uniform<int>(random, 0, 2);
+    const uint64_t limit = start + kPageSize * absl::Uniform<int>(random, 1, 5);
+    ranges.push_back({start, limit, 1u << absl::Uniform<int>(random, 0, 4)});
+    start = limit;
+  }
+  std::shuffle(ranges.begin(), ranges.end(), random);
+  return ranges;
+}
+
+template <typename Methods>
+BitsMap<Methods> MakeMap(const std::vector<Range>& ranges) {
+  BitsMap<Methods> map;
+  for (const Range& r : ranges) map.Add(r.start, r.limit, r.value);
+  return map;
+}
+
+template <typename Methods>
+void BM_Add(benchmark::State& state) {
+  const std::vector<Range> ranges = RandomRanges(state.range(0), 1);
+  for (auto s : state) {
+    benchmark::DoNotOptimize(MakeMap<Methods>(ranges));
+  }
+  state.SetItemsProcessed(state.iterations() * ranges.size());
+}
+
+// Removes ranges that split and trim the existing ones.
+template <typename Methods>
+void BM_Remove(benchmark::State& state) {
+  const std::vector<Range> ranges = RandomRanges(state.range(0), 1);
+  const BitsMap<Methods> map = MakeMap<Methods>(ranges);
+  const std::vector<Range> removed = RandomRanges(state.range(0), 2);
+  for (auto s : state) {
+    BitsMap<Methods> copy = map;
+    for (const Range& r : removed) copy.Remove(r.start, r.limit, r.value);
+    benchmark::DoNotOptimize(copy);
+  }
+  state.SetItemsProcessed(state.iterations() * removed.size());
+}
+
+template <typename Methods>
+void BM_Intersection(benchmark::State& state) {
+  const BitsMap<Methods> x = MakeMap<Methods>(RandomRanges(state.range(0), 1));
+  const BitsMap<Methods> y = MakeMap<Methods>(RandomRanges(state.range(0), 2));
+  for (auto s : state) {
+    BitsMap<Methods> isec;
+    isec.AddIntersectionOf(x, y);
+    benchmark::DoNotOptimize(isec);
+  }
+  state.SetItemsProcessed(state.iterations() * x.size());
+}
+
+template <typename Methods>
+void BM_Iterate(benchmark::State& state) {
+  const BitsMap<Methods> map =
+      MakeMap<Methods>(RandomRanges(state.range(0), 1));
+  for (auto s : state) {
+    uint64_t sum = 0;
+    for (auto i = map.begin(); i != map.end(); ++i) {
+      sum += (i.limit() - i.start()) * i.value();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * map.size());
+}
+
+// Like SnapshotGroup::CanAddSnapshot() and AddSnapshot(): each snapshot has a
+// few small mappings scattered over a large address space and is added to the
+// group only if none of them overlap the group's mappings.
+template <typename Methods>
+void BM_Partition(benchmark::State& state) {
+  constexpr int kMappingsPerSnapshot = 4;
+  const int num_snapshots = state.range(0);
+  absl::SeedSeq seq({3});
+  absl::BitGen random(seq);
+  std::vector<Range> mappings;
+  for (int i = 0; i < num_snapshots * kMappingsPerSnapshot; ++i) {
+    const uint64_t start =
+        kPageSize * absl::Uniform<uint64_t>(random, 0, 1 << 20);
+    mappings.push_back({start, start + kPageSize, 1});
+  }
+  for (auto s : state) {
+    BitsMap<Methods> group;
+    int num_added = 0;
+    for (int i = 0; i < num_snapshots; ++i) {
+      const Range* snapshot = &mappings[i * kMappingsPerSnapshot];
+      bool overlaps = false;
+      for (int m = 0; m < kMappingsPerSnapshot && !overlaps; ++m) {
+        auto found = group.Find(snapshot[m].start, snapshot[m].limit);
+        overlaps = found.first != found.second;
+      }
+      if (overlaps) continue;
+      for (int m = 0; m < kMappingsPerSnapshot; ++m) {
+        group.Add(snapshot[m].start, snapshot[m].limit, snapshot[m].value);
+      }
+      ++num_added;
+    }
+    benchmark::DoNotOptimize(num_added);
+  }
+  state.SetItemsProcessed(state.iterations() * num_snapshots);
+}
+
+BENCHMARK_TEMPLATE(BM_Add, BitsMethods)->Range(16, 16384);
+BENCHMARK_TEMPLATE(BM_Add, BTreeBitsMethods)->Range(16, 16384);
+BENCHMARK_TEMPLATE(BM_Remove, BitsMethods)->Range(16, 16384);
+BENCHMARK_TEMPLATE(BM_Remove, BTreeBitsMethods)->Range(16, 16384);
+BENCHMARK_TEMPLATE(BM_Intersection, BitsMethods)->Range(16, 16384);
+BENCHMARK_TEMPLATE(BM_Intersection, BTreeBitsMethods)->Range(16, 16384);
+BENCHMARK_TEMPLATE(BM_Iterate, BitsMethods)->Range(16, 16384);
+BENCHMARK_TEMPLATE(BM_Iterate, BTreeBitsMethods)->Range(16, 16384);
+BENCHMARK_TEMPLATE(BM_Partition, BitsMethods)->Range(16, 16384);
+BENCHMARK_TEMPLATE(BM_Partition, BTreeBitsMethods)->Range(16, 16384);
+
+}  // namespace
+}  // namespace silifuzz
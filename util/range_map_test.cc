@@ -19,8 +19,10 @@
 #include <cstdlib>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "absl/container/btree_map.h"
 #include "absl/random/random.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
@@ -105,6 +107,16 @@ class NumMethods {
 typedef NumMethods<int> IntMethods;
 typedef RangeMap<IntMethods::Key, IntMethods::Value, IntMethods> IntRangeMap;
 
+// Same as IntMethods, but stores the ranges in a B-tree.
+class BTreeIntMethods : public IntMethods {
+ public:
+  template <typename K, typename V, typename C>
+  using Rep = absl::btree_map<K, V, C>;
+};
+typedef RangeMap<BTreeIntMethods::Key, BTreeIntMethods::Value,
+                 BTreeIntMethods>
+    BTreeIntRangeMap;
+
 // ========================================================================= //
 
 struct Range {
@@ -1088,5 +1100,105 @@ TEST(RangeMapTest, OtherTypes) {
   }
 }
 
+// Checks that `map` is the merged run-length encoding of `points`, where 0
+// means no value.
+template <typename ThisRangeMap>
+static void ExpectMatchesPoints(const ThisRangeMap& map,
+                                const std::vector<int>& points) {
+  typename ThisRangeMap::const_iterator r = map.begin();
+  IntMethods::Size usage = 0;
+  const int num_points = points.size();
+  for (int k = 0; k < num_points;) {
+    int l = k + 1;
+    while (l < num_points && points[l] == points[k]) ++l;
+    if (points[k] != 0) {
+      ASSERT_TRUE(r != map.end()) << "missing [" << k << ", " << l << ")";
+      EXPECT_EQ(r.start(), k);
+      EXPECT_EQ(r.limit(), l);
+      EXPECT_EQ(r.value(), points[k]);
+      usage += (l - k) * points[k];
+      ++r;
+    }
+    k = l;
+  }
+  EXPECT_TRUE(r == map.end());
+  EXPECT_EQ(map.Usage(), usage);
+}
+
+// Applies the same random changes to a std::map-based and a B-tree-based
+// RangeMap and to a plain per-key model of them.
+TEST(RangeMapTest, BTreeRep) {
+  ASSERT_TRUE(more_is_empty_mode);
+  absl::SeedSeq seq({1});
+  absl::BitGen random(seq);
+  constexpr int kNumKeys = 64;
+  for (int i = 0; i < 100; ++i) {
+    std::vector<int> points(kNumKeys, 0);
+    IntRangeMap map;
+    BTreeIntRangeMap btree_map;
+    IntMethods::Size usage = 0;
+    IntMethods::Size btree_usage = 0;
+    for (int op = 0; op < 50; ++op) {
+      const int s = absl::Uniform<int>(random, 0, kNumKeys);
+      const int l = absl::Uniform<int>(absl::IntervalClosed, random, s + 1,
+                                       std::min(s + 16, kNumKeys));
+      const int v = absl::Uniform<int>(absl::IntervalClosed, random, 1, 3);
+      switch (absl::Uniform<int>(random, 0, 3)) {
+        case 0:
+          EXPECT_EQ(map.Add(s, l, v, &usage),
+                    btree_map.Add(s, l, v, &btree_usage));
+          for (int k = s; k < l; ++k) points[k] += v;
+          break;
+        case 1:
+          EXPECT_EQ(map.Remove(s, l, v, &usage),
+                    btree_map.Remove(s, l, v, &btree_usage));
+          for (int k = s; k < l; ++k) points[k] = std::max(points[k] - v, 0);
+          break;
+        case 2:
+          EXPECT_EQ(map.AddToEach(v, &usage),
+                    btree_map.AddToEach(v, &btree_usage));
+          for (int& p : points) {
+            if (p != 0) p += v;
+          }
+          break;
+      }
+      SCOPED_TRACE(absl::StrCat("test ", i, " op ", op));
+      ExpectMatchesPoints(map, points);
+      ExpectMatchesPoints(btree_map, points);
+      EXPECT_EQ(usage, map.Usage());
+      EXPECT_EQ(btree_usage, btree_map.Usage());
+    }
+
+    // Intersection and difference with a random crop range.
+    const int s = absl::Uniform<int>(random, 0, kNumKeys);
+    const int l = absl::Uniform<int>(absl::IntervalClosed, random, s + 1,
+                                     kNumKeys);
+    IntRangeMap crop;
+    crop.Add(s, l, 2);
+    IntRangeMap isec;
+    isec.AddIntersectionOf(map, crop);
+    BTreeIntRangeMap btree_isec;
+    btree_isec.AddIntersectionOf(btree_map, crop);
+    IntRangeMap diff;
+    diff.AddDifferenceOf(map, crop);
+    BTreeIntRangeMap btree_diff;
+    btree_diff.AddDifferenceOf(btree_map, crop);
+    std::vector<int> isec_points(kNumKeys, 0);
+    std::vector<int> diff_points(kNumKeys, 0);
+    for (int k = 0; k < kNumKeys; ++k) {
+      const bool in_crop = k >= s && k < l;
+      // See IntMethods::MakeIntersection() and MakeDifference().
+      if (points[k] != 0) {
+        isec_points[k] = in_crop ? std::min(points[k], 2) - 1 : 0;
+        diff_points[k] = in_crop ? std::max(points[k] - 2, 0) : points[k];
+      }
+    }
+    ExpectMatchesPoints(isec, isec_points);
+    ExpectMatchesPoints(btree_isec, isec_points);
+    ExpectMatchesPoints(diff, diff_points);
+    ExpectMatchesPoints(btree_diff, diff_points);
+  }
+}
+
 }  // unnamed namespace
 }  // namespace silifuzz
@@ -21,6 +21,7 @@
 #include <sys/prctl.h>  // prctl(), PR_SET_PDEATHSIG
 #include <sys/resource.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/time.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -46,7 +47,10 @@ ABSL_CONST_INIT absl::once_flag global_init_once_;
 }  // namespace
 
 Subprocess::Subprocess(const Options& options)
-    : child_pid_(-1), child_stdout_(-1), options_(options) {
+    : child_pid_(-1),
+      child_stdout_(-1),
+      child_stdin_(-1),
+      options_(options) {
   absl::call_once(global_init_once_, GlobalInit);
 }
 
@@ -54,6 +58,9 @@ Subprocess::~Subprocess() {
   if (child_stdout_ != -1) {
     close(child_stdout_);
   }
+  if (child_stdin_ != -1) {
+    close(child_stdin_);
+  }
 }
 
 absl::Status Subprocess::Start(const std::vector<std::string>& argv) {
@@ -73,8 +80,17 @@ absl::Status Subprocess::Start(const std::vector<std::string>& argv) {
   }
 
   // [0] is read end, [1] is write end.
+  // Keep both ends out of other children started concurrently: a leaked write
+  // end delays EOF and a leaked read end keeps the pipe alive. dup2() below
+  // clears O_CLOEXEC on the child's stdout.
   int stdout_pipe[2] = {-1, -1};
-  CHECK_NE(pipe(stdout_pipe), -1);
+  CHECK_NE(pipe2(stdout_pipe, O_CLOEXEC), -1);
+  // Our end of the stdin pipe is long-lived. Keep it from leaking into other
+  // children, which would prevent the child from ever seeing EOF.
+  int stdin_pipe[2] = {-1, -1};
+  if (options_.pipe_stdin_) {
+    CHECK_NE(pipe2(stdin_pipe, O_CLOEXEC), -1);
+  }
 
   auto argv_exec = std::make_unique<const char*[]>(argv.size() + 1);
   for (int argc = 0; argc < argv.size(); ++argc) {
@@ -105,6 +121,11 @@ absl::Status Subprocess::Start(const std::vector<std::string>& argv) {
       CHECK_EQ(prctl(PR_SET_PDEATHSIG, options_.parent_death_signal_), 0);
     }
     dup2(stdout_pipe[1], STDOUT_FILENO);
+    if (options_.pipe_stdin_) {
+      dup2(stdin_pipe[0], STDIN_FILENO);
+      close(stdin_pipe[0]);
+      close(stdin_pipe[1]);
+    }
     switch (options_.map_stderr_) {
       case kNoMapping:
         // Same stderr as the parent.
@@ -143,6 +164,10 @@ absl::Status Subprocess::Start(const std::vector<std::string>& argv) {
     // Parent
     close(stdout_pipe[1]);
     child_stdout_ = stdout_pipe[0];
+    if (options_.pipe_stdin_) {
+      close(stdin_pipe[0]);
+      child_stdin_ = stdin_pipe[1];
+    }
     return absl::OkStatus();
   }
 }
@@ -151,25 +176,60 @@ ProcessInfo Subprocess::Communicate(std::string* stdout_output) {
   if (child_pid_ == -1 || child_stdout_ == -1) {
     LOG_FATAL("Must call Start() first.");
   }
+  if (child_stdin_ != -1) {
+    close(child_stdin_);
+    child_stdin_ = -1;
+  }
+  while (ReadStdout(stdout_output)) {
+  }
+  return Wait();
+}
 
+bool Subprocess::ReadStdout(std::string* stdout_output) {
+  if (child_stdout_ == -1) {
+    return false;
+  }
   while (true) {
-    char buffer[4096] = {0};
+    char buffer[4096];
     int n = read(child_stdout_, buffer, sizeof(buffer));
+    if (n > 0) {
+      stdout_output->append(buffer, n);
+      return true;
+    }
     if (n == 0) {
       // We've reached a EOF.
-      break;
+      return false;
     }
-    if (n > 0) {
-      stdout_output->append(buffer, n);
-    } else {
-      if (errno == EINTR) {
-        continue;
-      }
-      LOG_FATAL("read: ", strerror(errno));
+    if (errno == EINTR) {
+      continue;
     }
+    LOG_FATAL("read: ", strerror(errno));
+  }
+}
+
+int Subprocess::OpenPidFd() const {
+  if (child_pid_ == -1) {
+    LOG_FATAL("Must call Start() first.");
+  }
+#ifdef SYS_pidfd_open
+  return syscall(SYS_pidfd_open, child_pid_, 0);
+#else
+  return -1;
+#endif
+}
+
+ProcessInfo Subprocess::Wait() {
+  if (child_pid_ == -1) {
+    LOG_FATAL("Must call Start() first.");
+  }
+  if (child_stdin_ != -1) {
+    close(child_stdin_);
+    child_stdin_ = -1;
+  }
+  if (child_stdout_ != -1) {
+    close(child_stdout_);
+    child_stdout_ = -1;
   }
-  close(child_stdout_);
-  child_stdout_ = -1;
 
   ProcessInfo info = {};
   while (wait4(child_pid_, &info.status, 0, &info.rusage) == -1) {
@@ -89,6 +89,12 @@ class Subprocess {
       return *this;
     }
 
+    // Connects stdin of the child to a pipe. See stdin_fd().
+    Options& PipeStdin(bool v) {
+      pipe_stdin_ = v;
+      return *this;
+    }
+
    private:
     friend class Subprocess;  // for rlimit_tuples_ and itimer_vals_ access.
 
@@ -103,6 +109,9 @@ class Subprocess {
     // process dies.
     int parent_death_signal_ = 0;
 
+    // If true, stdin of the child is a pipe instead of the parent's stdin.
+    bool pipe_stdin_ = false;
+
     // Represents setrlimit(2) args.
     struct RLimitTuple {
       int resource = 0;
@@ -136,12 +145,39 @@ class Subprocess {
   absl::Status Start(const std::vector<std::string>& argv);
 
   // Consumes the stdout of the process and waits for it to exit.
-  // Returns the process exit status.
+  // Returns the process exit status. Closes the stdin pipe first if any.
   ProcessInfo Communicate(std::string* stdout_output);
 
   // Returns the child process PID or -1 when no process is running.
   pid_t pid() const { return child_pid_; }
 
+  // Returns our end of the child's stdin pipe or -1 when Options::PipeStdin()
+  // was not set. Allows incremental interaction before Communicate().
+  int stdin_fd() const { return child_stdin_; }
+
+  // Returns our end of the child's stdout pipe. Allows incremental reads
+  // before Communicate().
+  int stdout_fd() const { return child_stdout_; }
+
+  // The following allow driving many subprocesses from a single thread with
+  // poll(2) or epoll(7) instead of blocking in Communicate().
+
+  // Performs a single read(2) from stdout_fd() and appends the data to
+  // `stdout_output`. Only blocks if stdout_fd() is not readable. Returns false
+  // once EOF is reached. stdout_fd() stays open until Wait() so that the
+  // caller can unregister it first.
+  bool ReadStdout(std::string* stdout_output);
+
+  // Returns a pidfd (see pidfd_open(2)) of the child that becomes readable
+  // when the child exits or -1 if the kernel does not support it. The caller
+  // owns the descriptor.
+  int OpenPidFd() const;
+
+  // Waits for the child to exit and returns its exit status. Closes the stdin
+  // and stdout pipes first. The stdout pipe must have been drained with
+  // ReadStdout() unless the child is known to have exited.
+  ProcessInfo Wait();
+
  private:
   static void GlobalInit();
   // PID of the child process.
@@ -150,6 +186,9 @@ class Subprocess {
   // File descriptor for our end of the child's stdout pipe.
   int child_stdout_;
 
+  // File descriptor for our end of the child's stdin pipe, if any.
+  int child_stdin_;
+
   // C-tor parameter.
   Options options_;
 };
@@ -14,9 +14,12 @@
 
 #include "./util/subprocess.h"
 
+#include <poll.h>
 #include <signal.h>
 #include <sys/resource.h>
 #include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include <string>
 #include <thread>  // NOLINT
@@ -64,6 +67,45 @@ TEST(Subprocess, StatusCode) {
   ProcessInfoLooksReasonable(info);
 }
 
+TEST(Subprocess, PipeStdin) {
+  Subprocess::Options opts = Subprocess::Options::Default();
+  opts.PipeStdin(true);
+  Subprocess sp(opts);
+  ASSERT_OK(sp.Start({"/bin/cat"}));
+  ASSERT_NE(sp.stdin_fd(), -1);
+  const std::string input = "ping";
+  ASSERT_EQ(write(sp.stdin_fd(), input.data(), input.size()), input.size());
+  char buffer[4];
+  ASSERT_EQ(read(sp.stdout_fd(), buffer, sizeof(buffer)), sizeof(buffer));
+  EXPECT_EQ(std::string(buffer, sizeof(buffer)), input);
+  // Communicate() closes stdin which lets cat exit.
+  std::string stdout;
+  ProcessInfo info = sp.Communicate(&stdout);
+  EXPECT_EQ(info.status, 0);
+  EXPECT_EQ(stdout, "");
+}
+
+TEST(Subprocess, PollAndWait) {
+  Subprocess sp;
+  ASSERT_OK(sp.Start({"/bin/sh", "-c", "echo Hello; exit 3"}));
+  int pidfd = sp.OpenPidFd();
+  std::string stdout;
+  while (true) {
+    struct pollfd pfd = {.fd = sp.stdout_fd(), .events = POLLIN};
+    ASSERT_EQ(poll(&pfd, 1, -1), 1);
+    if (!sp.ReadStdout(&stdout)) break;
+  }
+  if (pidfd != -1) {
+    struct pollfd pfd = {.fd = pidfd, .events = POLLIN};
+    EXPECT_EQ(poll(&pfd, 1, -1), 1);
+    close(pidfd);
+  }
+  ProcessInfo info = sp.Wait();
+  EXPECT_EQ(stdout, "Hello\n");
+  EXPECT_TRUE(WIFEXITED(info.status));
+  EXPECT_EQ(WEXITSTATUS(info.status), 3);
+}
+
 TEST(Subprocess, StderrDupParent) {
   Subprocess sp;
   ASSERT_OK(sp.Start({"/bin/sh", "-c", "echo -n stderr >&2"}));
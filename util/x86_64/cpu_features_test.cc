@@ -65,6 +65,7 @@ TEST(CPUFeatures, VerifyAgainstCPUInfo) {
 
   verify_features(X86CPUFeatures::kAMX_TILE, "amx_tile");
   verify_features(X86CPUFeatures::kAVX, "avx");
+  verify_features(X86CPUFeatures::kAVX2, "avx2");
   verify_features(X86CPUFeatures::kAVX512BW, "avx512bw");
   verify_features(X86CPUFeatures::kAVX512F, "avx512f");
   verify_features(X86CPUFeatures::kSSE, "sse");